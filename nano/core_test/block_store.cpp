@@ -2,6 +2,7 @@
 #include <nano/lib/utility.hpp>
 #include <nano/node/common.hpp>
 #include <nano/node/node.hpp>
+#include <nano/node/spill.hpp>
 #include <nano/secure/versioning.hpp>
 
 #include <fstream>
@@ -252,6 +253,39 @@ TEST (block_store, pending_iterator_comparison)
 	}
 }
 
+TEST (block_store, pending_summary)
+{
+	nano::logging logging;
+	bool init (false);
+	nano::mdb_store store (init, logging, nano::unique_path ());
+	ASSERT_TRUE (!init);
+	nano::account account (1);
+	auto transaction (store.tx_begin (true));
+	ASSERT_EQ (nano::pending_summary (), store.pending_summary_get (transaction, account));
+	store.pending_put (transaction, nano::pending_key (account, 10), nano::pending_info (2, 50, nano::epoch::epoch_0));
+	store.pending_put (transaction, nano::pending_key (account, 11), nano::pending_info (3, 500, nano::epoch::epoch_1));
+	store.pending_put (transaction, nano::pending_key (account, 12), nano::pending_info (4, 5, nano::epoch::epoch_0));
+	store.pending_put (transaction, nano::pending_key (account.number () + 1, 13), nano::pending_info (5, 1000, nano::epoch::epoch_0));
+	ASSERT_EQ (nano::pending_summary (3, 555), store.pending_summary_get (transaction, account));
+	// Largest amount first, other accounts follow
+	auto i (store.pending_amount_begin (transaction, nano::pending_amount_key (account, std::numeric_limits<nano::uint128_t>::max (), 0)));
+	ASSERT_EQ (nano::pending_amount_key (account, 500, 11), nano::pending_amount_key (i->first));
+	ASSERT_EQ (nano::account (3), nano::account (i->second));
+	++i;
+	ASSERT_EQ (nano::amount (50), nano::pending_amount_key (i->first).amount ());
+	++i;
+	ASSERT_EQ (nano::amount (5), nano::pending_amount_key (i->first).amount ());
+	++i;
+	ASSERT_EQ (nano::account (account.number () + 1), nano::pending_amount_key (i->first).account);
+	store.pending_del (transaction, nano::pending_key (account, 11));
+	ASSERT_EQ (nano::pending_summary (2, 55), store.pending_summary_get (transaction, account));
+	ASSERT_EQ (nano::amount (50), nano::pending_amount_key (store.pending_amount_begin (transaction, nano::pending_amount_key (account, std::numeric_limits<nano::uint128_t>::max (), 0))->first).amount ());
+	store.pending_del (transaction, nano::pending_key (account, 10));
+	store.pending_del (transaction, nano::pending_key (account, 12));
+	ASSERT_EQ (nano::pending_summary (), store.pending_summary_get (transaction, account));
+	ASSERT_EQ (1, store.pending_summary_get (transaction, account.number () + 1).count);
+}
+
 TEST (block_store, genesis)
 {
 	nano::logging logging;
@@ -396,6 +430,31 @@ TEST (unchecked, multiple_get)
 	ASSERT_EQ (unchecked5.size (), 0);
 }
 
+TEST (unchecked, cleanup)
+{
+	nano::logging logging;
+	bool init (false);
+	nano::mdb_store store (init, logging, nano::unique_path ());
+	ASSERT_FALSE (init);
+	auto block1 (std::make_shared<nano::send_block> (0, 1, 2, nano::keypair ().prv, 4, 5));
+	auto block2 (std::make_shared<nano::send_block> (0, 1, 3, nano::keypair ().prv, 4, 5));
+	auto block3 (std::make_shared<nano::send_block> (0, 1, 4, nano::keypair ().prv, 4, 5));
+	auto transaction (store.tx_begin (true));
+	store.unchecked_put (transaction, nano::unchecked_key (1, block1->hash ()), nano::unchecked_info (block1, 0, 100));
+	store.unchecked_put (transaction, nano::unchecked_key (1, block2->hash ()), nano::unchecked_info (block2, 0, 200));
+	store.unchecked_put (transaction, nano::unchecked_key (2, block3->hash ()), nano::unchecked_info (block3, 0, 300));
+	// Putting an entry again moves it in the index
+	store.unchecked_put (transaction, nano::unchecked_key (2, block3->hash ()), nano::unchecked_info (block3, 0, 100));
+	ASSERT_EQ (2, store.unchecked_cleanup (transaction, 150, 10));
+	ASSERT_EQ (1, store.unchecked_count (transaction));
+	ASSERT_EQ (1, store.unchecked_get (transaction, 1).size ());
+	ASSERT_EQ (0, store.unchecked_cleanup (transaction, 200, 10));
+	ASSERT_EQ (0, store.unchecked_cleanup (transaction, 250, 0));
+	store.unchecked_del (transaction, nano::unchecked_key (1, block2->hash ()));
+	ASSERT_EQ (0, store.unchecked_cleanup (transaction, 250, 10));
+	ASSERT_EQ (0, store.unchecked_count (transaction));
+}
+
 TEST (block_store, empty_accounts)
 {
 	nano::logging logging;
@@ -1116,6 +1175,237 @@ TEST (block_store, upgrade_v8_v9)
 	ASSERT_EQ (10, vote->sequence);
 }
 
+TEST (block_store, upgrade_v13_v14)
+{
+	auto path (nano::unique_path ());
+	auto block (std::make_shared<nano::send_block> (0, 1, 2, nano::keypair ().prv, 4, 5));
+	{
+		nano::logging logging;
+		bool init (false);
+		nano::mdb_store store (init, logging, path);
+		store.stop ();
+		auto transaction (store.tx_begin (true));
+		store.unchecked_put (transaction, nano::unchecked_key (1, block->hash ()), nano::unchecked_info (block, 0, 100));
+		// Entries written by earlier versions aren't indexed
+		ASSERT_EQ (0, mdb_drop (store.env.tx (transaction), store.unchecked_modified, 0));
+		ASSERT_EQ (0, store.unchecked_cleanup (transaction, 200, 10));
+		store.version_put (transaction, 13);
+	}
+	nano::logging logging;
+	bool init (false);
+	nano::mdb_store store (init, logging, path);
+	ASSERT_FALSE (init);
+	auto transaction (store.tx_begin (true));
+	ASSERT_LT (13, store.version_get (transaction));
+	ASSERT_EQ (1, store.unchecked_count (transaction));
+	ASSERT_EQ (1, store.unchecked_cleanup (transaction, 200, 10));
+	ASSERT_EQ (0, store.unchecked_count (transaction));
+}
+
+TEST (block_store, upgrade_v14_v15)
+{
+	auto path (nano::unique_path ());
+	nano::account account (1);
+	{
+		nano::logging logging;
+		bool init (false);
+		nano::mdb_store store (init, logging, path);
+		store.stop ();
+		auto transaction (store.tx_begin (true));
+		store.pending_put (transaction, nano::pending_key (account, 10), nano::pending_info (2, 50, nano::epoch::epoch_0));
+		store.pending_put (transaction, nano::pending_key (account, 11), nano::pending_info (3, 500, nano::epoch::epoch_1));
+		// Entries written by earlier versions aren't indexed
+		ASSERT_EQ (0, mdb_drop (store.env.tx (transaction), store.pending_summaries, 0));
+		ASSERT_EQ (0, mdb_drop (store.env.tx (transaction), store.pending_amounts, 0));
+		store.version_put (transaction, 14);
+	}
+	nano::logging logging;
+	bool init (false);
+	nano::mdb_store store (init, logging, path);
+	ASSERT_FALSE (init);
+	auto transaction (store.tx_begin_read ());
+	ASSERT_LT (14, store.version_get (transaction));
+	ASSERT_EQ (nano::pending_summary (2, 550), store.pending_summary_get (transaction, account));
+	auto i (store.pending_amount_begin (transaction, nano::pending_amount_key (account, std::numeric_limits<nano::uint128_t>::max (), 0)));
+	ASSERT_NE (store.pending_amount_end (), i);
+	ASSERT_EQ (nano::pending_amount_key (account, 500, 11), nano::pending_amount_key (i->first));
+}
+
+TEST (block_store, pending_unindexed)
+{
+	nano::logging logging;
+	bool init (false);
+	nano::mdb_store store (init, logging, nano::unique_path ());
+	ASSERT_FALSE (init);
+	nano::stat stats;
+	nano::ledger ledger (store, stats);
+	nano::account account (1);
+	auto transaction (store.tx_begin (true));
+	store.pending_put (transaction, nano::pending_key (account, 10), nano::pending_info (2, 50, nano::epoch::epoch_0));
+	// Entries written before the version 15 upgrade has run aren't indexed
+	ASSERT_EQ (0, mdb_drop (store.env.tx (transaction), store.pending_summaries, 0));
+	ASSERT_EQ (0, mdb_drop (store.env.tx (transaction), store.pending_amounts, 0));
+	store.version_put (transaction, 12);
+	store.pending_put (transaction, nano::pending_key (account, 11), nano::pending_info (3, 500, nano::epoch::epoch_1));
+	ASSERT_EQ (550, ledger.account_pending (transaction, account));
+	store.pending_del (transaction, nano::pending_key (account, 10));
+	ASSERT_EQ (500, ledger.account_pending (transaction, account));
+	ASSERT_EQ (nano::pending_summary (1, 500), store.pending_summary_get (transaction, account));
+}
+
+TEST (block_store, upgrade_v15_v16)
+{
+	auto path (nano::unique_path ());
+	nano::genesis genesis;
+	nano::keypair key1;
+	{
+		nano::logging logging;
+		bool init (false);
+		nano::mdb_store store (init, logging, path);
+		store.stop ();
+		auto transaction (store.tx_begin (true));
+		store.initialize (transaction, genesis);
+		store.representation_put (transaction, key1.pub, 7);
+		// Databases written by earlier versions don't have the indexes
+		ASSERT_EQ (0, mdb_drop (store.env.tx (transaction), store.representative_weights, 0));
+		ASSERT_EQ (0, mdb_drop (store.env.tx (transaction), store.delegators, 0));
+		store.version_put (transaction, 15);
+	}
+	nano::logging logging;
+	bool init (false);
+	nano::mdb_store store (init, logging, path);
+	ASSERT_FALSE (init);
+	auto transaction (store.tx_begin_read ());
+	ASSERT_LT (15, store.version_get (transaction));
+	auto i (store.representative_weights_begin (transaction));
+	ASSERT_NE (store.representative_weights_end (), i);
+	ASSERT_EQ (nano::representative_weight_key (nano::genesis_amount, nano::genesis_account), nano::representative_weight_key (i->first));
+	++i;
+	ASSERT_NE (store.representative_weights_end (), i);
+	ASSERT_EQ (nano::representative_weight_key (7, key1.pub), nano::representative_weight_key (i->first));
+	++i;
+	ASSERT_EQ (store.representative_weights_end (), i);
+	auto j (store.delegators_begin (transaction, nano::genesis_account));
+	ASSERT_NE (store.delegators_end (), j);
+	ASSERT_EQ (nano::delegator_key (nano::genesis_account, nano::genesis_account), nano::delegator_key (j->first));
+}
+
+TEST (block_store, upgrade_v16_v17)
+{
+	auto path (nano::unique_path ());
+	nano::genesis genesis;
+	nano::send_block send (genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::gFLR_ratio, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0);
+	{
+		nano::logging logging;
+		bool init (false);
+		nano::mdb_store store (init, logging, path);
+		store.stop ();
+		nano::stat stats;
+		nano::ledger ledger (store, stats);
+		auto transaction (store.tx_begin (true));
+		store.initialize (transaction, genesis);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send).code);
+		// Databases written by earlier versions don't have the index
+		ASSERT_EQ (0, mdb_drop (store.env.tx (transaction), store.account_heights, 0));
+		store.version_put (transaction, 16);
+	}
+	nano::logging logging;
+	bool init (false);
+	nano::mdb_store store (init, logging, path);
+	ASSERT_FALSE (init);
+	// The index is rebuilt in the background
+	auto done (false);
+	auto iterations (0);
+	while (!done)
+	{
+		std::this_thread::sleep_for (std::chrono::milliseconds (10));
+		auto transaction (store.tx_begin_read ());
+		done = store.version_get (transaction) == 17;
+		ASSERT_LT (iterations, 200);
+		++iterations;
+	}
+	auto transaction (store.tx_begin_read ());
+	ASSERT_EQ (genesis.hash (), store.account_height_get (transaction, nano::genesis_account, 1));
+	ASSERT_EQ (send.hash (), store.account_height_get (transaction, nano::genesis_account, 2));
+	ASSERT_TRUE (store.account_height_get (transaction, nano::genesis_account, 3).is_zero ());
+}
+
+TEST (block_store, account_heights)
+{
+	nano::logging logging;
+	bool init (false);
+	nano::mdb_store store (init, logging, nano::unique_path ());
+	ASSERT_FALSE (init);
+	nano::stat stats;
+	nano::ledger ledger (store, stats);
+	nano::genesis genesis;
+	nano::keypair key1;
+	auto transaction (store.tx_begin (true));
+	store.initialize (transaction, genesis);
+	nano::send_block send (genesis.hash (), key1.pub, nano::genesis_amount - nano::gFLR_ratio, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0);
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send).code);
+	nano::open_block open (send.hash (), key1.pub, key1.pub, key1.prv, key1.pub, 0);
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, open).code);
+	ASSERT_EQ (send.hash (), store.account_height_get (transaction, nano::genesis_account, 2));
+	ASSERT_EQ (open.hash (), store.account_height_get (transaction, key1.pub, 1));
+	ledger.rollback (transaction, send.hash ());
+	ASSERT_TRUE (store.account_height_get (transaction, nano::genesis_account, 2).is_zero ());
+	ASSERT_TRUE (store.account_height_get (transaction, key1.pub, 1).is_zero ());
+	ASSERT_EQ (genesis.hash (), store.account_height_get (transaction, nano::genesis_account, 1));
+}
+
+TEST (block_store, delegators)
+{
+	nano::logging logging;
+	bool init (false);
+	nano::mdb_store store (init, logging, nano::unique_path ());
+	ASSERT_FALSE (init);
+	nano::stat stats;
+	nano::ledger ledger (store, stats);
+	nano::genesis genesis;
+	nano::keypair key1;
+	auto transaction (store.tx_begin (true));
+	store.initialize (transaction, genesis);
+	nano::change_block change (genesis.hash (), key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0);
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, change).code);
+	ASSERT_EQ (store.delegators_end (), store.delegators_begin (transaction, nano::genesis_account));
+	auto i (store.delegators_begin (transaction, key1.pub));
+	ASSERT_NE (store.delegators_end (), i);
+	ASSERT_EQ (nano::delegator_key (key1.pub, nano::genesis_account), nano::delegator_key (i->first));
+	auto weights (store.representative_weights_begin (transaction));
+	ASSERT_EQ (nano::representative_weight_key (nano::genesis_amount, key1.pub), nano::representative_weight_key (weights->first));
+	ledger.rollback (transaction, change.hash ());
+	auto j (store.delegators_begin (transaction, nano::genesis_account));
+	ASSERT_NE (store.delegators_end (), j);
+	ASSERT_EQ (nano::delegator_key (nano::genesis_account, nano::genesis_account), nano::delegator_key (j->first));
+	++j;
+	ASSERT_EQ (store.delegators_end (), j);
+	auto weights2 (store.representative_weights_begin (transaction));
+	ASSERT_EQ (nano::representative_weight_key (nano::genesis_amount, nano::genesis_account), nano::representative_weight_key (weights2->first));
+}
+
+TEST (block_store, delegators_unindexed)
+{
+	nano::logging logging;
+	bool init (false);
+	nano::mdb_store store (init, logging, nano::unique_path ());
+	ASSERT_FALSE (init);
+	nano::stat stats;
+	nano::ledger ledger (store, stats);
+	nano::genesis genesis;
+	nano::keypair key1;
+	auto transaction (store.tx_begin (true));
+	store.initialize (transaction, genesis);
+	// Accounts written before the version 16 upgrade has run aren't indexed
+	ASSERT_EQ (0, mdb_drop (store.env.tx (transaction), store.delegators, 0));
+	store.version_put (transaction, 12);
+	nano::change_block change (genesis.hash (), key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0);
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, change).code);
+	auto i (store.delegators_begin (transaction, key1.pub));
+	ASSERT_NE (store.delegators_end (), i);
+	ASSERT_EQ (nano::delegator_key (key1.pub, nano::genesis_account), nano::delegator_key (i->first));
+}
+
 TEST (block_store, state_block)
 {
 	nano::logging logging;
@@ -1587,3 +1877,132 @@ TEST (block_store, online_weight)
 	ASSERT_EQ (0, store.online_weight_count (transaction));
 	ASSERT_EQ (store.online_weight_end (), store.online_weight_begin (transaction));
 }
+
+namespace
+{
+std::vector<nano::block_hash> random_hashes (size_t count_a)
+{
+	std::vector<nano::block_hash> result (count_a);
+	for (auto & hash : result)
+	{
+		nano::random_pool::generate_block (hash.bytes.data (), hash.bytes.size ());
+	}
+	return result;
+}
+}
+
+TEST (spill_map, memory)
+{
+	nano::logging logging;
+	nano::spill_store store (nano::unique_path (), 1024 * 1024, logging.log);
+	nano::spill_map<nano::amount> map (store, "test");
+	auto keys (random_hashes (2000));
+	for (size_t i (0); i < keys.size (); ++i)
+	{
+		map.put (keys[i], i);
+	}
+	ASSERT_EQ (keys.size (), map.size ());
+	ASSERT_EQ (0, map.spilled ());
+	// Erasing shifts entries back along their probe sequence, all remaining keys must still be found
+	for (size_t i (0); i < keys.size (); i += 2)
+	{
+		map.erase (keys[i]);
+	}
+	ASSERT_EQ (keys.size () / 2, map.size ());
+	for (size_t i (0); i < keys.size (); ++i)
+	{
+		nano::amount value;
+		ASSERT_EQ (i % 2 == 0, map.get (keys[i], value));
+		if (i % 2 == 1)
+		{
+			ASSERT_EQ (i, value.number ());
+		}
+	}
+}
+
+TEST (spill_map, spill)
+{
+	using map_t = nano::spill_map<nano::amount>;
+	auto capacity (map_t::initial_capacity);
+	// Only the first table fits in the budget
+	nano::logging logging;
+	nano::spill_store store (nano::unique_path (), capacity * sizeof (map_t::entry), logging.log);
+	map_t map (store, "test");
+	auto keys (random_hashes (capacity * 2));
+	for (size_t i (0); i < keys.size (); ++i)
+	{
+		map.put (keys[i], i);
+	}
+	ASSERT_EQ (keys.size (), map.size ());
+	ASSERT_EQ (capacity * 3 / 4, map.memory_count ());
+	ASSERT_EQ (keys.size () - capacity * 3 / 4, map.spilled ());
+	ASSERT_EQ (store.memory_limit, store.memory_used);
+	// Pending writes are readable before and after they're committed
+	for (auto flushed : { false, true })
+	{
+		if (flushed)
+		{
+			store.flush ();
+		}
+		for (size_t i (0); i < keys.size (); ++i)
+		{
+			nano::amount value;
+			ASSERT_FALSE (map.get (keys[i], value));
+			ASSERT_EQ (i, value.number ());
+		}
+	}
+	// Overwriting a spilled entry doesn't add another
+	map.put (keys.back (), 0);
+	ASSERT_EQ (keys.size (), map.size ());
+	nano::amount value;
+	ASSERT_FALSE (map.get (keys.back (), value));
+	ASSERT_TRUE (value.is_zero ());
+	map.erase (keys.back ());
+	ASSERT_FALSE (map.exists (keys.back ()));
+	ASSERT_EQ (keys.size () - 1, map.size ());
+	map.clear ();
+	ASSERT_EQ (0, map.size ());
+	ASSERT_EQ (0, store.memory_used);
+	ASSERT_FALSE (map.exists (keys.front ()));
+}
+
+TEST (spill_map, spill_unavailable)
+{
+	using map_t = nano::spill_map<nano::amount>;
+	auto capacity (map_t::initial_capacity);
+	// A regular file as the parent directory makes the environment fail to open
+	auto parent (nano::unique_path ());
+	std::ofstream (parent.string ()).put ('0');
+	nano::logging logging;
+	nano::spill_store store (parent / "spill.ldb", capacity * sizeof (map_t::entry), logging.log);
+	map_t map (store, "test");
+	auto keys (random_hashes (capacity * 2));
+	for (size_t i (0); i < keys.size (); ++i)
+	{
+		map.put (keys[i], i);
+	}
+	ASSERT_EQ (keys.size (), map.size ());
+	ASSERT_EQ (0, map.spilled ());
+	ASSERT_LT (store.memory_limit, store.memory_used);
+	for (size_t i (0); i < keys.size (); ++i)
+	{
+		nano::amount value;
+		ASSERT_FALSE (map.get (keys[i], value));
+		ASSERT_EQ (i, value.number ());
+	}
+	map.clear ();
+	ASSERT_EQ (0, store.memory_used);
+}
+
+TEST (spill_store, remove_stale)
+{
+	auto directory (nano::unique_path ());
+	boost::filesystem::create_directories (directory);
+	std::ofstream ((directory / "lazy_bootstrap_1.ldb").string ()).put ('0');
+	std::ofstream ((directory / "lazy_bootstrap_1.ldb-lock").string ()).put ('0');
+	std::ofstream ((directory / "data.ldb").string ()).put ('0');
+	nano::spill_store::remove_stale (directory, "lazy_bootstrap_");
+	ASSERT_FALSE (boost::filesystem::exists (directory / "lazy_bootstrap_1.ldb"));
+	ASSERT_FALSE (boost::filesystem::exists (directory / "lazy_bootstrap_1.ldb-lock"));
+	ASSERT_TRUE (boost::filesystem::exists (directory / "data.ldb"));
+}
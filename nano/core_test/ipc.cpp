@@ -85,3 +85,124 @@ TEST (ipc, synchronous)
 		ASSERT_NO_ERROR (system.poll ());
 	}
 }
+
+TEST (ipc, binary)
+{
+	nano::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	nano::rpc rpc (system.io_ctx, node1, nano::rpc_config (true));
+	node1.config.ipc_config.transport_tcp.enabled = true;
+	node1.config.ipc_config.transport_tcp.port = 24077;
+	nano::ipc::ipc_server ipc (node1, rpc);
+	nano::ipc::binary_ipc_client client (node1.io_ctx);
+	nano::genesis genesis;
+	nano::keypair key;
+
+	std::atomic<bool> call_completed{ false };
+	std::thread client_thread ([&client, &call_completed, &genesis, &key]() {
+		client.connect ("::1", 24077);
+		auto request = [&client](nano::ipc::binary_action action_a, nano::uint256_union const & key_a) {
+			std::vector<uint8_t> payload;
+			payload.push_back (static_cast<uint8_t> (action_a));
+			payload.insert (payload.end (), key_a.bytes.begin (), key_a.bytes.end ());
+			return payload;
+		};
+		auto response (client.request (request (nano::ipc::binary_action::account_info, nano::test_genesis_key.pub)));
+		ASSERT_EQ (1 + 4 * 32 + 8 + 8 + 1, response.size ());
+		ASSERT_EQ (static_cast<uint8_t> (nano::ipc::binary_status::success), response[0]);
+		nano::bufferstream stream (response.data () + 1, response.size () - 1);
+		nano::block_hash frontier;
+		ASSERT_FALSE (nano::try_read (stream, frontier.bytes));
+		ASSERT_EQ (genesis.hash (), frontier);
+		response = client.request (request (nano::ipc::binary_action::account_info, key.pub));
+		ASSERT_EQ (1, response.size ());
+		ASSERT_EQ (static_cast<uint8_t> (nano::ipc::binary_status::not_found), response[0]);
+
+		response = client.request (request (nano::ipc::binary_action::account_balance, nano::test_genesis_key.pub));
+		ASSERT_EQ (1 + 2 * 16, response.size ());
+		nano::bufferstream balance_stream (response.data () + 1, response.size () - 1);
+		nano::amount balance;
+		ASSERT_FALSE (nano::try_read (balance_stream, balance.bytes));
+		ASSERT_EQ (nano::genesis_amount, balance.number ());
+
+		response = client.request (request (nano::ipc::binary_action::block_info, genesis.hash ()));
+		ASSERT_EQ (static_cast<uint8_t> (nano::ipc::binary_status::success), response[0]);
+		nano::bufferstream block_stream (response.data () + 1, response.size () - 1);
+		nano::account account;
+		ASSERT_FALSE (nano::try_read (block_stream, account.bytes));
+		ASSERT_EQ (nano::test_genesis_key.pub, account);
+
+		auto pending (request (nano::ipc::binary_action::pending_exists, genesis.hash ()));
+		pending.push_back (1);
+		response = client.request (pending);
+		ASSERT_EQ (2, response.size ());
+		ASSERT_EQ (0, response[1]);
+
+		// Truncated arguments and unknown actions are rejected without closing the session
+		response = client.request (std::vector<uint8_t> (1, static_cast<uint8_t> (nano::ipc::binary_action::account_info)));
+		ASSERT_EQ (static_cast<uint8_t> (nano::ipc::binary_status::bad_request), response[0]);
+		response = client.request (request (static_cast<nano::ipc::binary_action> (0xff), nano::test_genesis_key.pub));
+		ASSERT_EQ (static_cast<uint8_t> (nano::ipc::binary_status::bad_request), response[0]);
+
+		call_completed = true;
+	});
+	client_thread.detach ();
+
+	system.deadline_set (5s);
+	while (!call_completed)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+}
+
+TEST (ipc, subscription)
+{
+	nano::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	nano::rpc rpc (system.io_ctx, node1, nano::rpc_config (true));
+	node1.config.ipc_config.transport_tcp.enabled = true;
+	node1.config.ipc_config.transport_tcp.port = 24077;
+	nano::ipc::ipc_server ipc (node1, rpc);
+	nano::ipc::subscription_ipc_client client (node1.io_ctx);
+	nano::keypair key;
+	auto parse = [](std::string const & message_a) {
+		std::stringstream ss (message_a);
+		boost::property_tree::ptree tree;
+		boost::property_tree::read_json (ss, tree);
+		return tree;
+	};
+
+	std::atomic<bool> subscribed{ false };
+	std::atomic<bool> call_completed{ false };
+	std::thread client_thread ([&client, &parse, &subscribed, &call_completed]() {
+		client.connect ("::1", 24077);
+		client.send (R"({"action": "subscribe", "topic": "unknown"})");
+		ASSERT_EQ ("Invalid topic", parse (client.receive ()).get<std::string> ("error"));
+		client.send (boost::str (boost::format (R"({"action": "subscribe", "topic": "confirmation", "accounts": ["%1%"]})") % nano::test_genesis_key.pub.to_account ()));
+		auto ack (parse (client.receive ()));
+		ASSERT_EQ ("subscribe", ack.get<std::string> ("ack"));
+		ASSERT_EQ ("confirmation", ack.get<std::string> ("topic"));
+		subscribed = true;
+
+		auto message (parse (client.receive ()));
+		ASSERT_EQ ("confirmation", message.get<std::string> ("topic"));
+		ASSERT_EQ (nano::test_genesis_key.pub.to_account (), message.get<std::string> ("account"));
+		call_completed = true;
+	});
+	client_thread.detach ();
+
+	system.deadline_set (5s);
+	while (!subscribed)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (1, ipc.broker->size ());
+	system.wallet (0)->insert_adhoc (nano::test_genesis_key.prv);
+	ASSERT_NE (nullptr, system.wallet (0)->send_action (nano::test_genesis_key.pub, key.pub, 1));
+	system.deadline_set (10s);
+	while (!call_completed)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_GE (node1.stats.count (nano::stat::type::ipc, nano::stat::detail::push, nano::stat::dir::out), 2);
+}
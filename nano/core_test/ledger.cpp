@@ -2,6 +2,7 @@
 #include <crypto/cryptopp/randpool.h>
 #include <gtest/gtest.h>
 #include <nano/core_test/testutil.hpp>
+#include <nano/node/ledger_archive.hpp>
 #include <nano/node/stats.hpp>
 #include <nano/node/testing.hpp>
 
@@ -2442,9 +2443,9 @@ TEST (ledger, unchecked_epoch)
 	node1.block_processor.flush ();
 	{
 		auto transaction (node1.store.tx_begin ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
-		auto blocks (node1.store.unchecked_get (transaction, epoch1->previous ()));
+		auto blocks (node1.unchecked.get (transaction, epoch1->previous ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::valid_epoch);
 	}
@@ -2454,7 +2455,7 @@ TEST (ledger, unchecked_epoch)
 	{
 		auto transaction (node1.store.tx_begin ());
 		ASSERT_TRUE (node1.store.block_exists (transaction, epoch1->hash ()));
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		nano::account_info info;
 		ASSERT_FALSE (node1.store.account_get (transaction, destination.pub, info));
@@ -2483,9 +2484,9 @@ TEST (ledger, unchecked_epoch_invalid)
 	node1.block_processor.flush ();
 	{
 		auto transaction (node1.store.tx_begin ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 2);
-		auto blocks (node1.store.unchecked_get (transaction, epoch1->previous ()));
+		auto blocks (node1.unchecked.get (transaction, epoch1->previous ()));
 		ASSERT_EQ (blocks.size (), 2);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::valid);
 		ASSERT_EQ (blocks[1].verified, nano::signature_verification::valid);
@@ -2498,7 +2499,7 @@ TEST (ledger, unchecked_epoch_invalid)
 		ASSERT_FALSE (node1.store.block_exists (transaction, epoch1->hash ()));
 		ASSERT_TRUE (node1.store.block_exists (transaction, epoch2->hash ()));
 		ASSERT_TRUE (node1.active.empty ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		nano::account_info info;
 		ASSERT_FALSE (node1.store.account_get (transaction, destination.pub, info));
@@ -2525,9 +2526,9 @@ TEST (ledger, unchecked_open)
 	node1.block_processor.flush ();
 	{
 		auto transaction (node1.store.tx_begin ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
-		auto blocks (node1.store.unchecked_get (transaction, open1->source ()));
+		auto blocks (node1.unchecked.get (transaction, open1->source ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::valid);
 	}
@@ -2536,7 +2537,7 @@ TEST (ledger, unchecked_open)
 	{
 		auto transaction (node1.store.tx_begin ());
 		ASSERT_TRUE (node1.store.block_exists (transaction, open1->hash ()));
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 	}
 }
@@ -2561,9 +2562,9 @@ TEST (ledger, unchecked_receive)
 	// Previous block for receive1 is unknown, signature cannot be validated
 	{
 		auto transaction (node1.store.tx_begin ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
-		auto blocks (node1.store.unchecked_get (transaction, receive1->previous ()));
+		auto blocks (node1.unchecked.get (transaction, receive1->previous ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::unknown);
 	}
@@ -2572,9 +2573,9 @@ TEST (ledger, unchecked_receive)
 	// Previous block for receive1 is known, signature was validated
 	{
 		auto transaction (node1.store.tx_begin ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
-		auto blocks (node1.store.unchecked_get (transaction, receive1->source ()));
+		auto blocks (node1.unchecked.get (transaction, receive1->source ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::valid);
 	}
@@ -2583,7 +2584,95 @@ TEST (ledger, unchecked_receive)
 	{
 		auto transaction (node1.store.tx_begin ());
 		ASSERT_TRUE (node1.store.block_exists (transaction, receive1->hash ()));
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 	}
 }
+
+TEST (ledger_archive, round_trip)
+{
+	nano::system system (24000, 2);
+	auto & node1 (*system.nodes[0]);
+	auto & node2 (*system.nodes[1]);
+	nano::genesis genesis;
+	nano::keypair key1;
+	nano::state_block send1 (nano::test_genesis_key.pub, genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::mFLR_ratio, key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (genesis.hash ()));
+	nano::state_block open1 (key1.pub, 0, key1.pub, nano::mFLR_ratio, send1.hash (), key1.prv, key1.pub, system.work.generate (key1.pub));
+	nano::state_block send2 (key1.pub, open1.hash (), key1.pub, 0, nano::test_genesis_key.pub, key1.prv, key1.pub, system.work.generate (open1.hash ()));
+	nano::state_block receive1 (nano::test_genesis_key.pub, send1.hash (), nano::test_genesis_key.pub, nano::genesis_amount, send2.hash (), nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (send1.hash ()));
+	{
+		auto transaction (node1.store.tx_begin_write ());
+		ASSERT_EQ (nano::process_result::progress, node1.ledger.process (transaction, send1).code);
+		ASSERT_EQ (nano::process_result::progress, node1.ledger.process (transaction, open1).code);
+		ASSERT_EQ (nano::process_result::progress, node1.ledger.process (transaction, send2).code);
+		ASSERT_EQ (nano::process_result::progress, node1.ledger.process (transaction, receive1).code);
+	}
+	auto path (nano::unique_path ());
+	std::stringstream output;
+	nano::ledger_export exporter (node1);
+	ASSERT_FALSE (exporter.run (path, output));
+	ASSERT_EQ (5, exporter.count);
+	nano::ledger_import importer (node2, 2);
+	ASSERT_FALSE (importer.run (path, output));
+	ASSERT_EQ (5, importer.count);
+	auto transaction (node2.store.tx_begin_read ());
+	ASSERT_EQ (5, node2.store.block_count (transaction).sum ());
+	ASSERT_EQ (0, node2.unchecked.count (transaction));
+	ASSERT_EQ (receive1.hash (), node2.ledger.latest (transaction, nano::test_genesis_key.pub));
+	ASSERT_EQ (send2.hash (), node2.ledger.latest (transaction, key1.pub));
+}
+
+TEST (ledger_archive, legacy_order)
+{
+	nano::system system (24000, 2);
+	auto & node1 (*system.nodes[0]);
+	auto & node2 (*system.nodes[1]);
+	nano::genesis genesis;
+	nano::keypair key1;
+	// Legacy opens used to wait for state block verification while the legacy send after them was already queued
+	nano::send_block send1 (genesis.hash (), key1.pub, nano::genesis_amount - nano::mFLR_ratio, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (genesis.hash ()));
+	nano::open_block open1 (send1.hash (), key1.pub, key1.pub, key1.prv, key1.pub, system.work.generate (key1.pub));
+	nano::send_block send2 (open1.hash (), nano::test_genesis_key.pub, 0, key1.prv, key1.pub, system.work.generate (open1.hash ()));
+	nano::receive_block receive1 (send1.hash (), send2.hash (), nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (send1.hash ()));
+	{
+		auto transaction (node1.store.tx_begin_write ());
+		ASSERT_EQ (nano::process_result::progress, node1.ledger.process (transaction, send1).code);
+		ASSERT_EQ (nano::process_result::progress, node1.ledger.process (transaction, open1).code);
+		ASSERT_EQ (nano::process_result::progress, node1.ledger.process (transaction, send2).code);
+		ASSERT_EQ (nano::process_result::progress, node1.ledger.process (transaction, receive1).code);
+	}
+	auto path (nano::unique_path ());
+	std::stringstream output;
+	ASSERT_FALSE (nano::ledger_export (node1).run (path, output));
+	nano::ledger_import importer (node2, 2);
+	ASSERT_FALSE (importer.run (path, output));
+	ASSERT_EQ (5, importer.count);
+	auto transaction (node2.store.tx_begin_read ());
+	ASSERT_EQ (5, node2.store.block_count (transaction).sum ());
+	ASSERT_EQ (0, node2.unchecked.count (transaction));
+	ASSERT_EQ (receive1.hash (), node2.ledger.latest (transaction, nano::test_genesis_key.pub));
+	ASSERT_EQ (send2.hash (), node2.ledger.latest (transaction, key1.pub));
+}
+
+TEST (ledger_archive, corrupt)
+{
+	nano::system system (24000, 2);
+	auto path (nano::unique_path ());
+	std::stringstream output;
+	nano::ledger_export exporter (*system.nodes[0]);
+	ASSERT_FALSE (exporter.run (path, output));
+	{
+		// Flip a byte inside the genesis block payload
+		std::fstream file (path.string (), std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+		file.seekg (nano::ledger_archive::magic.size () + 1 + 16 + 10);
+		auto byte (file.get ());
+		file.seekp (nano::ledger_archive::magic.size () + 1 + 16 + 10);
+		file.put (static_cast<char> (byte ^ 0xff));
+	}
+	nano::ledger_import importer (*system.nodes[1], 1);
+	ASSERT_TRUE (importer.run (path, output));
+	ASSERT_EQ (0, importer.count);
+	// A truncated file is rejected as well
+	boost::filesystem::resize_file (path, boost::filesystem::file_size (path) - 1);
+	ASSERT_TRUE (nano::ledger_import (*system.nodes[1], 1).run (path, output));
+}
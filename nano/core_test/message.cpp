@@ -83,3 +83,67 @@ TEST (message, confirm_ack_serialization)
 	ASSERT_FALSE (error);
 	ASSERT_EQ (con1, con2);
 }
+
+TEST (message, confirm_req_hashes_payload_length)
+{
+	std::vector<std::pair<nano::block_hash, nano::block_hash>> roots_hashes;
+	for (auto i (0); i < nano::message_header::count_max; ++i)
+	{
+		roots_hashes.push_back (std::make_pair (nano::block_hash (i), nano::block_hash (i + 1)));
+	}
+	nano::confirm_req req (roots_hashes);
+	ASSERT_EQ (nano::message_header::count_max, req.header.count_get ());
+	auto bytes (req.to_bytes ());
+	ASSERT_EQ (bytes->size (), 8 + req.header.payload_length_bytes ());
+	ASSERT_LE (bytes->size (), nano::message_parser::max_tcp_realtime_message_size);
+	nano::bufferstream stream (bytes->data (), bytes->size ());
+	auto error (false);
+	nano::message_header header (error, stream);
+	ASSERT_FALSE (error);
+	ASSERT_EQ (nano::message_header::count_max, header.count_get ());
+	nano::confirm_req req2 (error, stream, header);
+	ASSERT_FALSE (error);
+	ASSERT_EQ (req, req2);
+}
+
+TEST (message, frontier_req_end)
+{
+	nano::frontier_req req;
+	req.start = 1;
+	req.age = 2;
+	req.count = 3;
+	auto bytes (req.to_bytes ());
+	ASSERT_EQ (bytes->size (), 8 + nano::frontier_req::size);
+	req.end = 4;
+	req.set_end_present (true);
+	bytes = req.to_bytes ();
+	ASSERT_EQ (bytes->size (), 8 + nano::frontier_req::size + nano::frontier_req::extended_parameters_size);
+	nano::bufferstream stream (bytes->data (), bytes->size ());
+	auto error (false);
+	nano::message_header header (error, stream);
+	ASSERT_FALSE (error);
+	ASSERT_EQ (bytes->size (), 8 + header.payload_length_bytes ());
+	nano::frontier_req req2 (error, stream, header);
+	ASSERT_FALSE (error);
+	ASSERT_EQ (req, req2);
+	ASSERT_EQ (nano::account (4), req2.end);
+}
+
+TEST (message, confirm_ack_hashes_payload_length)
+{
+	nano::keypair key1;
+	std::vector<nano::block_hash> hashes;
+	for (auto i (0); i < 12; ++i)
+	{
+		hashes.push_back (nano::block_hash (i));
+	}
+	auto vote (std::make_shared<nano::vote> (key1.pub, key1.prv, 0, hashes));
+	nano::confirm_ack con1 (vote);
+	ASSERT_EQ (12, con1.header.count_get ());
+	auto bytes (con1.to_bytes ());
+	ASSERT_EQ (bytes->size (), 8 + con1.header.payload_length_bytes ());
+	nano::send_block block (0, 1, 2, key1.prv, 4, 5);
+	nano::confirm_ack con2 (std::make_shared<nano::vote> (key1.pub, key1.prv, 0, std::make_shared<nano::send_block> (block)));
+	ASSERT_EQ (0, con2.header.count_get ());
+	ASSERT_EQ (con2.to_bytes ()->size (), 8 + con2.header.payload_length_bytes ());
+}
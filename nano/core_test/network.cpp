@@ -183,6 +183,46 @@ TEST (network, multi_keepalive)
 	node2->stop ();
 }
 
+TEST (network, tcp_realtime)
+{
+	nano::system system (24000, 1);
+	nano::node_init init1;
+	nano::node_config config1 (24001, system.logging);
+	config1.tcp_realtime = true;
+	auto node1 (std::make_shared<nano::node> (init1, system.io_ctx, nano::unique_path (), system.alarm, config1, system.work));
+	node1->start ();
+	system.nodes.push_back (node1);
+	nano::node_init init2;
+	nano::node_config config2 (24002, system.logging);
+	config2.tcp_realtime = true;
+	auto node2 (std::make_shared<nano::node> (init2, system.io_ctx, nano::unique_path (), system.alarm, config2, system.work));
+	node2->start ();
+	system.nodes.push_back (node2);
+	node2->network.send_keepalive (node1->network.endpoint ());
+	auto established ([](std::shared_ptr<nano::node> const & node_a, nano::endpoint const & endpoint_a) {
+		auto channel (node_a->peers.tcp_channel (endpoint_a));
+		return channel != nullptr && channel->established ();
+	});
+	system.deadline_set (10s);
+	while (!established (node1, node2->network.endpoint ()) || !established (node2, node1->network.endpoint ()))
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_NE (0, node1->stats.count (nano::stat::type::tcp, nano::stat::detail::handshake, nano::stat::dir::out));
+	ASSERT_NE (0, node2->stats.count (nano::stat::type::tcp, nano::stat::detail::handshake, nano::stat::dir::in));
+	nano::genesis genesis;
+	nano::keypair key1;
+	auto block (std::make_shared<nano::send_block> (genesis.hash (), key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (genesis.hash ())));
+	node1->process_active (block);
+	system.deadline_set (10s);
+	while (!node2->block (block->hash ()))
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_NE (0, node1->stats.count (nano::stat::type::tcp, nano::stat::dir::out));
+	ASSERT_NE (0, node2->stats.count (nano::stat::type::tcp, nano::stat::dir::in));
+}
+
 TEST (network, send_discarded_publish)
 {
 	nano::system system (24000, 2);
@@ -696,6 +736,68 @@ TEST (bootstrap_processor, process_new)
 	node1->stop ();
 }
 
+TEST (bootstrap_processor, frontier_incremental)
+{
+	nano::system system (24000, 1);
+	auto node0 (system.nodes[0]);
+	nano::keypair key;
+	nano::genesis genesis;
+	auto send1 (std::make_shared<nano::send_block> (genesis.hash (), key.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (genesis.hash ())));
+	ASSERT_EQ (nano::process_result::progress, node0->process (*send1).code);
+	nano::node_init init1;
+	auto node1 (std::make_shared<nano::node> (init1, system.io_ctx, 24001, nano::unique_path (), system.alarm, system.logging, system.work));
+	ASSERT_FALSE (init1.error ());
+	nano::tcp_endpoint endpoint (node0->network.endpoint ().address (), node0->network.endpoint ().port ());
+	ASSERT_EQ (std::numeric_limits<uint32_t>::max (), node1->bootstrap_initiator.frontier_syncs.age (endpoint, 0));
+	node1->bootstrap_initiator.bootstrap (node0->network.endpoint ());
+	system.deadline_set (10s);
+	while (node1->latest (nano::test_genesis_key.pub) != send1->hash () || node1->bootstrap_initiator.in_progress ())
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	// The first range was compared in full, the next request only asks for recently modified accounts
+	ASSERT_GT (nano::frontier_sync_cache::full_interval, node1->bootstrap_initiator.frontier_syncs.age (endpoint, 0));
+	ASSERT_EQ (0, node1->stats.count (nano::stat::type::bootstrap, nano::stat::detail::frontier_req_incremental, nano::stat::dir::out));
+	// Moves the sync point back so the one stored by the next round can be told apart
+	auto now (nano::seconds_since_epoch ());
+	node1->bootstrap_initiator.frontier_syncs.synced (endpoint, 0, now - 100, true);
+	ASSERT_LE (100, node1->bootstrap_initiator.frontier_syncs.age (endpoint, 0));
+	auto send2 (std::make_shared<nano::send_block> (send1->hash (), key.pub, nano::genesis_amount - 200, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (send1->hash ())));
+	ASSERT_EQ (nano::process_result::progress, node0->process (*send2).code);
+	node1->bootstrap_initiator.bootstrap (node0->network.endpoint ());
+	system.deadline_set (10s);
+	while (node1->latest (nano::test_genesis_key.pub) != send2->hash () || node1->bootstrap_initiator.in_progress ())
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_LT (0, node1->stats.count (nano::stat::type::bootstrap, nano::stat::detail::frontier_req_incremental, nano::stat::dir::out));
+	ASSERT_GT (100, node1->bootstrap_initiator.frontier_syncs.age (endpoint, 0));
+	node1->stop ();
+}
+
+TEST (frontier_req, sync_cache)
+{
+	nano::frontier_sync_cache cache;
+	nano::tcp_endpoint endpoint (boost::asio::ip::address_v6::loopback (), 24000);
+	nano::account start (1);
+	ASSERT_EQ (std::numeric_limits<uint32_t>::max (), cache.age (endpoint, start));
+	// Incremental results aren't recorded without an earlier full comparison
+	auto now (nano::seconds_since_epoch ());
+	cache.synced (endpoint, start, now - 100, false);
+	ASSERT_EQ (std::numeric_limits<uint32_t>::max (), cache.age (endpoint, start));
+	cache.synced (endpoint, start, now - 100, true);
+	auto age1 (cache.age (endpoint, start));
+	ASSERT_LE (100 + nano::frontier_sync_cache::margin, age1);
+	ASSERT_GT (110 + nano::frontier_sync_cache::margin, age1);
+	ASSERT_EQ (std::numeric_limits<uint32_t>::max (), cache.age (endpoint, 0));
+	cache.synced (endpoint, start, now, false);
+	ASSERT_GT (age1, cache.age (endpoint, start));
+	// A complete comparison is requested again once the full interval passed
+	cache.synced (endpoint, start, now - nano::frontier_sync_cache::full_interval, true);
+	ASSERT_EQ (std::numeric_limits<uint32_t>::max (), cache.age (endpoint, start));
+	ASSERT_EQ (1, cache.size ());
+}
+
 TEST (bootstrap_processor, pull_diamond)
 {
 	nano::system system (24000, 1);
@@ -922,6 +1024,31 @@ TEST (frontier_req_response, DISABLED_destruction)
 	ASSERT_TRUE (true);
 }
 
+TEST (bulk_pull, fill)
+{
+	nano::system system (24000, 1);
+	auto send1 (std::make_shared<nano::send_block> (system.nodes[0]->latest (nano::test_genesis_key.pub), nano::test_genesis_key.pub, 1, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (system.nodes[0]->latest (nano::test_genesis_key.pub))));
+	ASSERT_EQ (nano::process_result::progress, system.nodes[0]->process (*send1).code);
+	auto connection (std::make_shared<nano::bootstrap_server> (nullptr, system.nodes[0]));
+	std::unique_ptr<nano::bulk_pull> req (new nano::bulk_pull{});
+	req->start = nano::test_genesis_key.pub;
+	req->end.clear ();
+	connection->requests.push (std::unique_ptr<nano::message>{});
+	auto request (std::make_shared<nano::bulk_pull_server> (connection, std::move (req)));
+	std::vector<uint8_t> buffer;
+	request->fill (buffer);
+	ASSERT_TRUE (request->finished);
+	std::vector<uint8_t> expected;
+	{
+		nano::vectorstream stream (expected);
+		nano::serialize_block (stream, *send1);
+		nano::genesis genesis;
+		nano::serialize_block (stream, *genesis.open);
+	}
+	expected.push_back (static_cast<uint8_t> (nano::block_type::not_a_block));
+	ASSERT_EQ (expected, buffer);
+}
+
 TEST (frontier_req, begin)
 {
 	nano::system system (24000, 1);
@@ -937,6 +1064,45 @@ TEST (frontier_req, begin)
 	ASSERT_EQ (genesis.hash (), request->frontier);
 }
 
+TEST (frontier_req, fill)
+{
+	nano::system system (24000, 1);
+	auto connection (std::make_shared<nano::bootstrap_server> (nullptr, system.nodes[0]));
+	std::unique_ptr<nano::frontier_req> req (new nano::frontier_req);
+	req->start.clear ();
+	req->age = std::numeric_limits<decltype (req->age)>::max ();
+	req->count = std::numeric_limits<decltype (req->count)>::max ();
+	connection->requests.push (std::unique_ptr<nano::message>{});
+	auto request (std::make_shared<nano::frontier_req_server> (connection, std::move (req)));
+	std::vector<uint8_t> buffer;
+	request->fill (buffer);
+	ASSERT_TRUE (request->finished);
+	ASSERT_EQ (2 * nano::frontier_req_client::size_frontier, buffer.size ());
+	nano::genesis genesis;
+	auto hash (genesis.hash ());
+	ASSERT_TRUE (std::equal (nano::test_genesis_key.pub.bytes.begin (), nano::test_genesis_key.pub.bytes.end (), buffer.begin ()));
+	ASSERT_TRUE (std::equal (hash.bytes.begin (), hash.bytes.end (), buffer.begin () + 32));
+	ASSERT_TRUE (std::all_of (buffer.begin () + nano::frontier_req_client::size_frontier, buffer.end (), [](uint8_t byte_a) { return byte_a == 0; }));
+}
+
+TEST (frontier_req, partition)
+{
+	auto single (nano::bootstrap_attempt::frontier_partition (1));
+	ASSERT_EQ (1, single.size ());
+	ASSERT_TRUE (single[0].first.is_zero ());
+	ASSERT_TRUE (single[0].second.is_zero ());
+	auto ranges (nano::bootstrap_attempt::frontier_partition (4));
+	ASSERT_EQ (4, ranges.size ());
+	ASSERT_TRUE (ranges.front ().first.is_zero ());
+	ASSERT_TRUE (ranges.back ().second.is_zero ());
+	for (size_t i (1); i < ranges.size (); ++i)
+	{
+		// Ranges are contiguous and ascending so every account belongs to exactly one
+		ASSERT_EQ (ranges[i - 1].second, ranges[i].first);
+		ASSERT_LT (ranges[i - 1].first, ranges[i].first);
+	}
+}
+
 TEST (frontier_req, end)
 {
 	nano::system system (24000, 1);
@@ -950,6 +1116,26 @@ TEST (frontier_req, end)
 	ASSERT_TRUE (request->current.is_zero ());
 }
 
+TEST (frontier_req, range_end)
+{
+	nano::system system (24000, 1);
+	auto connection (std::make_shared<nano::bootstrap_server> (nullptr, system.nodes[0]));
+	std::unique_ptr<nano::frontier_req> req (new nano::frontier_req);
+	req->start.clear ();
+	req->age = std::numeric_limits<decltype (req->age)>::max ();
+	req->count = std::numeric_limits<decltype (req->count)>::max ();
+	// Genesis is the only account and lies past the end of the range
+	req->end = nano::test_genesis_key.pub;
+	req->set_end_present (true);
+	connection->requests.push (std::unique_ptr<nano::message>{});
+	auto request (std::make_shared<nano::frontier_req_server> (connection, std::move (req)));
+	ASSERT_TRUE (request->current.is_zero ());
+	std::vector<uint8_t> buffer;
+	request->fill (buffer);
+	ASSERT_TRUE (request->finished);
+	ASSERT_EQ (nano::frontier_req_client::size_frontier, buffer.size ());
+}
+
 TEST (frontier_req, count)
 {
 	nano::system system (24000, 1);
@@ -1420,3 +1606,136 @@ TEST (bootstrap, keepalive)
 		ASSERT_NO_ERROR (system.poll ());
 	}
 }
+
+TEST (network, traffic_capture_replay)
+{
+	nano::system system (24000, 1);
+	auto path (nano::unique_path ());
+	nano::genesis genesis;
+	nano::keypair key1;
+	auto block (std::make_shared<nano::send_block> (genesis.hash (), key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (genesis.hash ())));
+	nano::publish publish (block);
+	auto bytes (publish.to_bytes ());
+	nano::endpoint endpoint (boost::asio::ip::address_v6::loopback (), 24100);
+	{
+		nano::traffic_capture capture;
+		ASSERT_FALSE (capture.open (path));
+		capture.add (endpoint, bytes->data (), bytes->size ());
+		ASSERT_EQ (1, capture.count ());
+		capture.close ();
+	}
+	{
+		nano::traffic_capture_reader reader;
+		ASSERT_FALSE (reader.open (path));
+		nano::capture_record record;
+		ASSERT_FALSE (reader.read_next (record));
+		ASSERT_EQ (endpoint, record.endpoint);
+		ASSERT_EQ (*bytes, record.data);
+		ASSERT_TRUE (reader.read_next (record));
+	}
+	auto node (system.nodes[0]);
+	node->config.allow_local_peers = true;
+	node->flags.disable_udp_send = true;
+	nano::traffic_replay replay (*node, 0);
+	std::stringstream output;
+	ASSERT_FALSE (replay.run (path, output));
+	system.deadline_set (10s);
+	while (node->block (block->hash ()) == nullptr)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (1, node->stats.count (nano::stat::type::message, nano::stat::detail::publish, nano::stat::dir::in));
+	ASSERT_NE (std::string::npos, output.str ().find ("Replay complete"));
+}
+
+TEST (network_simulator, delivery)
+{
+	auto simulator (std::make_shared<nano::network_simulator> (1));
+	simulator->latency = std::chrono::milliseconds (100);
+	simulator->jitter = std::chrono::microseconds (0);
+	nano::system system (24000, 2, simulator);
+	nano::genesis genesis;
+	nano::keypair key1;
+	auto block (std::make_shared<nano::send_block> (genesis.hash (), key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (genesis.hash ())));
+	system.nodes[0]->process_active (block);
+	auto node1 (system.nodes[1]);
+	ASSERT_FALSE (simulator->run_until ([node1, block]() { return node1->block (block->hash ()) != nullptr; }, std::chrono::seconds (10)));
+	ASSERT_GE (simulator->now (), std::chrono::milliseconds (100));
+	ASSERT_LT (0, simulator->delivered);
+	ASSERT_EQ (0, simulator->dropped);
+}
+
+TEST (network_simulator, loss)
+{
+	auto simulator (std::make_shared<nano::network_simulator> (1));
+	simulator->loss = 1.0;
+	nano::system system (24000, 2, simulator);
+	nano::genesis genesis;
+	nano::keypair key1;
+	auto block (std::make_shared<nano::send_block> (genesis.hash (), key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (genesis.hash ())));
+	system.nodes[0]->process_active (block);
+	auto node1 (system.nodes[1]);
+	ASSERT_TRUE (simulator->run_until ([node1, block]() { return node1->block (block->hash ()) != nullptr; }, std::chrono::seconds (10), std::chrono::milliseconds (500)));
+	ASSERT_EQ (0, simulator->delivered);
+	ASSERT_LT (0, simulator->dropped);
+	ASSERT_EQ (nullptr, node1->block (block->hash ()));
+}
+
+TEST (network_simulator, virtual_alarm)
+{
+	auto simulator (std::make_shared<nano::network_simulator> (1));
+	nano::system system (24000, 1, simulator);
+	std::atomic<bool> fired (false);
+	system.alarm.add (system.alarm.now () + std::chrono::hours (1), [&fired]() { fired = true; });
+	auto begin (std::chrono::steady_clock::now ());
+	ASSERT_FALSE (simulator->run_until ([&fired]() { return fired.load (); }, std::chrono::hours (2)));
+	// An hour of virtual time passes without waiting for it
+	ASSERT_GE (simulator->now (), std::chrono::hours (1));
+	ASSERT_LT (std::chrono::steady_clock::now () - begin, std::chrono::minutes (1));
+}
+
+TEST (message_buffer_pool, reuse)
+{
+	auto pool (std::make_unique<nano::message_buffer_pool> (1));
+	auto allocated (false);
+	auto buffer1 (pool->allocate (allocated));
+	ASSERT_TRUE (allocated);
+	buffer1->resize (100);
+	auto data (buffer1->data ());
+	buffer1.reset ();
+	ASSERT_EQ (1, pool->size ());
+	auto buffer2 (pool->allocate (allocated));
+	ASSERT_FALSE (allocated);
+	ASSERT_TRUE (buffer2->empty ());
+	ASSERT_EQ (data, buffer2->data ());
+	auto buffer3 (pool->allocate (allocated));
+	ASSERT_TRUE (allocated);
+	buffer2.reset ();
+	// The pool keeps at most one free buffer
+	buffer3.reset ();
+	ASSERT_EQ (1, pool->size ());
+	auto buffer4 (pool->allocate (allocated));
+	pool.reset ();
+	buffer4.reset ();
+}
+
+TEST (network, shared_message_bytes)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	nano::genesis genesis;
+	nano::keypair key1;
+	auto block (std::make_shared<nano::send_block> (genesis.hash (), key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (genesis.hash ())));
+	auto bytes1 (node.network.publish_bytes (block));
+	auto bytes2 (node.network.publish_bytes (block));
+	ASSERT_EQ (bytes1, bytes2);
+	ASSERT_EQ (*nano::publish (block).to_bytes (), *bytes1);
+	auto copy (std::make_shared<nano::send_block> (*block));
+	ASSERT_EQ (nullptr, copy->publish_bytes);
+	auto vote (std::make_shared<nano::vote> (nano::test_genesis_key.pub, nano::test_genesis_key.prv, 1, block));
+	auto bytes3 (node.network.confirm_ack_bytes (vote));
+	ASSERT_EQ (bytes3, node.network.confirm_ack_bytes (vote));
+	ASSERT_EQ (*nano::confirm_ack (vote).to_bytes (), *bytes3);
+	ASSERT_EQ (2, node.stats.count (nano::stat::type::message_buffer, nano::stat::detail::serialize));
+	ASSERT_EQ (2, node.stats.count (nano::stat::type::message_buffer, nano::stat::detail::cached));
+}
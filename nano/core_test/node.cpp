@@ -4,6 +4,7 @@
 #include <nano/node/testing.hpp>
 #include <nano/node/working.hpp>
 
+#include <boost/beast.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/polymorphic_cast.hpp>
 
@@ -521,6 +522,7 @@ TEST (node_config, serialization)
 	config1.callback_address = "test";
 	config1.callback_port = 10;
 	config1.callback_target = "test";
+	config1.callback_batch_size = 16;
 	config1.lmdb_max_dbs = 256;
 	nano::jsonconfig tree;
 	config1.serialize_json (tree);
@@ -538,6 +540,7 @@ TEST (node_config, serialization)
 	ASSERT_NE (config2.callback_address, config1.callback_address);
 	ASSERT_NE (config2.callback_port, config1.callback_port);
 	ASSERT_NE (config2.callback_target, config1.callback_target);
+	ASSERT_NE (config2.callback_batch_size, config1.callback_batch_size);
 	ASSERT_NE (config2.lmdb_max_dbs, config1.lmdb_max_dbs);
 
 	ASSERT_FALSE (tree.get_optional<std::string> ("epoch_block_link"));
@@ -556,6 +559,7 @@ TEST (node_config, serialization)
 	ASSERT_EQ (config2.callback_address, config1.callback_address);
 	ASSERT_EQ (config2.callback_port, config1.callback_port);
 	ASSERT_EQ (config2.callback_target, config1.callback_target);
+	ASSERT_EQ (config2.callback_batch_size, config1.callback_batch_size);
 	ASSERT_EQ (config2.lmdb_max_dbs, config1.lmdb_max_dbs);
 }
 
@@ -1624,6 +1628,189 @@ TEST (node, send_callback)
 	ASSERT_EQ (std::numeric_limits<nano::uint128_t>::max () - system.nodes[0]->config.receive_minimum.number (), system.nodes[0]->balance (nano::test_genesis_key.pub));
 }
 
+namespace
+{
+// Callback receiver on the loopback which keeps connections alive and answers the first failures requests with 500
+class callback_server : public std::enable_shared_from_this<callback_server>
+{
+public:
+	callback_server (boost::asio::io_context & io_ctx_a, unsigned failures_a) :
+	io_ctx (io_ctx_a),
+	acceptor (io_ctx_a, boost::asio::ip::tcp::endpoint (boost::asio::ip::address_v6::loopback (), 0)),
+	connections (0),
+	requests (0),
+	failures (failures_a)
+	{
+	}
+	void accept ()
+	{
+		auto this_l (shared_from_this ());
+		auto socket (std::make_shared<boost::asio::ip::tcp::socket> (io_ctx));
+		acceptor.async_accept (*socket, [this_l, socket](boost::system::error_code const & ec) {
+			if (!ec)
+			{
+				++this_l->connections;
+				this_l->read (std::make_shared<session> (socket));
+				this_l->accept ();
+			}
+		});
+	}
+	uint16_t port ()
+	{
+		return acceptor.local_endpoint ().port ();
+	}
+	// Events received, a batch counts each of its elements
+	size_t events ()
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		return bodies.size ();
+	}
+	boost::asio::io_context & io_ctx;
+	boost::asio::ip::tcp::acceptor acceptor;
+	std::atomic<unsigned> connections;
+	std::atomic<unsigned> requests;
+	std::atomic<unsigned> failures;
+	std::mutex mutex;
+	std::vector<std::string> bodies;
+
+private:
+	class session
+	{
+	public:
+		session (std::shared_ptr<boost::asio::ip::tcp::socket> socket_a) :
+		socket (socket_a)
+		{
+		}
+		std::shared_ptr<boost::asio::ip::tcp::socket> socket;
+		boost::beast::flat_buffer buffer;
+		boost::beast::http::request<boost::beast::http::string_body> request;
+		boost::beast::http::response<boost::beast::http::string_body> response;
+	};
+	void read (std::shared_ptr<session> session_a)
+	{
+		auto this_l (shared_from_this ());
+		session_a->request = decltype (session_a->request) ();
+		boost::beast::http::async_read (*session_a->socket, session_a->buffer, session_a->request, [this_l, session_a](boost::system::error_code const & ec, size_t) {
+			if (!ec)
+			{
+				++this_l->requests;
+				auto status (boost::beast::http::status::ok);
+				if (this_l->failures > 0)
+				{
+					--this_l->failures;
+					status = boost::beast::http::status::internal_server_error;
+				}
+				else
+				{
+					std::stringstream istream (session_a->request.body ());
+					boost::property_tree::ptree tree;
+					boost::property_tree::read_json (istream, tree);
+					std::lock_guard<std::mutex> lock (this_l->mutex);
+					if (tree.count ("hash") > 0)
+					{
+						this_l->bodies.push_back (tree.get<std::string> ("hash"));
+					}
+					else
+					{
+						for (auto & event : tree)
+						{
+							this_l->bodies.push_back (event.second.get<std::string> ("hash"));
+						}
+					}
+				}
+				session_a->response = decltype (session_a->response) ();
+				session_a->response.result (status);
+				session_a->response.version (11);
+				session_a->response.keep_alive (true);
+				session_a->response.prepare_payload ();
+				boost::beast::http::async_write (*session_a->socket, session_a->response, [this_l, session_a](boost::system::error_code const & ec, size_t) {
+					if (!ec)
+					{
+						this_l->read (session_a);
+					}
+				});
+			}
+		});
+	}
+};
+}
+
+TEST (node, callback_batches)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	auto server (std::make_shared<callback_server> (system.io_ctx, 0));
+	server->accept ();
+	node.config.callback_address = "::1";
+	node.config.callback_port = server->port ();
+	node.config.callback_target = "/";
+	node.config.callback_connections = 2;
+	node.config.callback_batch_size = 8;
+	for (auto i (0); i < 100; ++i)
+	{
+		node.callbacks.add (boost::str (boost::format ("{\"hash\": \"%1%\"}") % i));
+	}
+	system.deadline_set (10s);
+	while (server->events () < 100)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (100, server->events ());
+	// Requests share the pooled connections and carry several events each
+	ASSERT_LE (server->connections.load (), 2);
+	ASSERT_LT (server->requests.load (), 100);
+	ASSERT_GT (node.stats.count (nano::stat::type::http_callback, nano::stat::detail::batch, nano::stat::dir::out), 0);
+	ASSERT_EQ (100, node.stats.count (nano::stat::type::http_callback, nano::stat::detail::initiate, nano::stat::dir::out));
+	boost::property_tree::ptree tree;
+	node.callbacks.serialize (tree);
+	ASSERT_EQ (100, tree.get<uint64_t> ("delivered"));
+	ASSERT_EQ (0, tree.get<uint64_t> ("dropped"));
+}
+
+TEST (node, callback_retry)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	auto server (std::make_shared<callback_server> (system.io_ctx, 1));
+	server->accept ();
+	node.config.callback_address = "::1";
+	node.config.callback_port = server->port ();
+	node.config.callback_target = "/";
+	node.callbacks.add ("{\"hash\": \"0\"}");
+	system.deadline_set (10s);
+	while (server->events () < 1)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (2, server->requests.load ());
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::http_callback, nano::stat::detail::retry, nano::stat::dir::out));
+	ASSERT_EQ (0, node.stats.count (nano::stat::type::http_callback, nano::stat::detail::drop, nano::stat::dir::out));
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::http_callback, nano::stat::detail::initiate, nano::stat::dir::out));
+}
+
+TEST (node, callback_timeout)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	// Accepts the connection but never answers the POST
+	boost::asio::ip::tcp::acceptor acceptor (system.io_ctx, boost::asio::ip::tcp::endpoint (boost::asio::ip::address_v6::loopback (), 0));
+	auto socket (std::make_shared<boost::asio::ip::tcp::socket> (system.io_ctx));
+	acceptor.async_accept (*socket, [socket](boost::system::error_code const &) {});
+	node.config.callback_address = "::1";
+	node.config.callback_port = acceptor.local_endpoint ().port ();
+	node.config.callback_target = "/";
+	node.config.callback_retries = 0;
+	node.config.callback_timeout = 1;
+	node.callbacks.add ("{\"hash\": \"0\"}");
+	system.deadline_set (10s);
+	while (node.stats.count (nano::stat::type::http_callback, nano::stat::detail::drop, nano::stat::dir::out) < 1)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::error, nano::stat::detail::http_callback, nano::stat::dir::out));
+	ASSERT_EQ (0, node.stats.count (nano::stat::type::http_callback, nano::stat::detail::initiate, nano::stat::dir::out));
+}
+
 // Check that votes get replayed back to nodes if they sent an old sequence number.
 // This helps representatives continue from their last sequence number if their node is reinitialized and the old sequence number is lost
 TEST (node, vote_replay)
@@ -2167,6 +2354,25 @@ TEST (node, block_processor_reject_state)
 	ASSERT_TRUE (node.ledger.block_exists (send2->hash ()));
 }
 
+TEST (node, block_processor_add_batch)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	nano::genesis genesis;
+	auto send1 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::gFLR_ratio, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	node.work_generate_blocking (*send1);
+	auto send2 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, send1->hash (), nano::test_genesis_key.pub, nano::genesis_amount - 2 * nano::gFLR_ratio, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	node.work_generate_blocking (*send2);
+	std::vector<nano::unchecked_info> batch;
+	batch.emplace_back (send1, nano::test_genesis_key.pub, 0, nano::signature_verification::unknown);
+	batch.emplace_back (send2, nano::test_genesis_key.pub, 0, nano::signature_verification::unknown);
+	batch.emplace_back (send2, nano::test_genesis_key.pub, 0, nano::signature_verification::unknown);
+	node.block_processor.add (batch);
+	node.block_processor.flush ();
+	ASSERT_TRUE (node.ledger.block_exists (send1->hash ()));
+	ASSERT_TRUE (node.ledger.block_exists (send2->hash ()));
+}
+
 TEST (node, block_processor_reject_rolled_back)
 {
 	nano::system system (24000, 1);
@@ -2287,25 +2493,116 @@ TEST (node, unchecked_cleanup)
 	node.config.unchecked_cutoff_time = std::chrono::seconds (2);
 	{
 		auto transaction (node.store.tx_begin ());
-		auto unchecked_count (node.store.unchecked_count (transaction));
+		auto unchecked_count (node.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 	}
 	std::this_thread::sleep_for (std::chrono::seconds (1));
 	node.unchecked_cleanup ();
 	{
 		auto transaction (node.store.tx_begin ());
-		auto unchecked_count (node.store.unchecked_count (transaction));
+		auto unchecked_count (node.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 	}
 	std::this_thread::sleep_for (std::chrono::seconds (2));
 	node.unchecked_cleanup ();
 	{
 		auto transaction (node.store.tx_begin ());
-		auto unchecked_count (node.store.unchecked_count (transaction));
+		auto unchecked_count (node.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 	}
 }
 
+TEST (node, unchecked_spill)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	nano::genesis genesis;
+	nano::unchecked_map unchecked (node.store, node.stats, 0);
+	std::vector<std::shared_ptr<nano::state_block>> blocks;
+	for (auto i (0); i < 3; ++i)
+	{
+		nano::keypair key;
+		blocks.push_back (std::make_shared<nano::state_block> (key.pub, genesis.hash (), key.pub, 0, 0, key.prv, key.pub, 0));
+	}
+	{
+		auto transaction (node.store.tx_begin_write ());
+		// With no memory budget every entry goes straight to the table
+		unchecked.put (transaction, nano::unchecked_key (genesis.hash (), blocks[0]->hash ()), nano::unchecked_info (blocks[0], 0, nano::seconds_since_epoch ()));
+		ASSERT_EQ (0, unchecked.memory_count ());
+		ASSERT_EQ (1, node.store.unchecked_count (transaction));
+		ASSERT_EQ (1, node.stats.count (nano::stat::type::unchecked, nano::stat::detail::spill, nano::stat::dir::in));
+	}
+	nano::unchecked_map unchecked2 (node.store, node.stats, 1024 * 1024);
+	{
+		auto transaction (node.store.tx_begin_write ());
+		unchecked2.put (transaction, nano::unchecked_key (genesis.hash (), blocks[1]->hash ()), nano::unchecked_info (blocks[1], 0, nano::seconds_since_epoch ()));
+		unchecked2.put (transaction, nano::unchecked_key (blocks[2]->hash (), blocks[2]->hash ()), nano::unchecked_info (blocks[2], 0, nano::seconds_since_epoch ()));
+		ASSERT_EQ (2, unchecked2.memory_count ());
+		ASSERT_EQ (3, unchecked2.count (transaction));
+		ASSERT_EQ (2, unchecked2.get (transaction, genesis.hash ()).size ());
+		auto list (unchecked2.list (transaction, nano::unchecked_key (0, 0), 10));
+		ASSERT_EQ (3, list.size ());
+		for (size_t i (1); i < list.size (); ++i)
+		{
+			ASSERT_TRUE (nano::unchecked_key_less () (list[i - 1].first, list[i].first));
+		}
+		nano::unchecked_info info;
+		ASSERT_FALSE (unchecked2.find (transaction, blocks[1]->hash (), info));
+		ASSERT_EQ (*blocks[1], *info.block);
+		// Dependents come from memory and the table, both are removed
+		auto taken (unchecked2.take (transaction, genesis.hash ()));
+		ASSERT_EQ (2, taken.size ());
+		ASSERT_EQ (1, node.stats.count (nano::stat::type::unchecked, nano::stat::detail::memory_hit, nano::stat::dir::in));
+		ASSERT_EQ (1, node.stats.count (nano::stat::type::unchecked, nano::stat::detail::table_hit, nano::stat::dir::in));
+		ASSERT_EQ (1, unchecked2.count (transaction));
+		ASSERT_EQ (0, node.store.unchecked_count (transaction));
+		ASSERT_EQ (0, unchecked2.cleanup (nano::seconds_since_epoch () - 60));
+		unchecked2.flush (transaction);
+		ASSERT_EQ (0, unchecked2.memory_count ());
+		ASSERT_EQ (1, node.store.unchecked_count (transaction));
+	}
+}
+
+TEST (node, unchecked_lru)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	std::vector<std::shared_ptr<nano::state_block>> blocks;
+	for (auto i (0); i < 3; ++i)
+	{
+		nano::keypair key;
+		blocks.push_back (std::make_shared<nano::state_block> (key.pub, key.pub, key.pub, 0, 0, key.prv, key.pub, 0));
+	}
+	auto key = [&blocks](size_t index_a) {
+		return nano::unchecked_key (blocks[index_a]->hashables.previous, blocks[index_a]->hash ());
+	};
+	size_t entry_size (0);
+	{
+		nano::unchecked_map sizing (node.store, node.stats, 1024 * 1024);
+		auto transaction (node.store.tx_begin_write ());
+		sizing.put (transaction, key (0), nano::unchecked_info (blocks[0], 0, nano::seconds_since_epoch ()));
+		entry_size = sizing.memory_size ();
+	}
+	// Room for two entries, reading the first one makes the second the least recently used
+	nano::unchecked_map unchecked (node.store, node.stats, 2 * entry_size);
+	auto transaction (node.store.tx_begin_write ());
+	unchecked.put (transaction, key (0), nano::unchecked_info (blocks[0], 0, nano::seconds_since_epoch ()));
+	unchecked.put (transaction, key (1), nano::unchecked_info (blocks[1], 0, nano::seconds_since_epoch ()));
+	ASSERT_EQ (1, unchecked.get (transaction, blocks[0]->hashables.previous).size ());
+	unchecked.put (transaction, key (2), nano::unchecked_info (blocks[2], 0, nano::seconds_since_epoch ()));
+	ASSERT_EQ (2, unchecked.memory_count ());
+	ASSERT_EQ (1, node.store.unchecked_count (transaction));
+	ASSERT_TRUE (node.store.unchecked_exists (transaction, key (1)));
+	// Fast bootstrap reads dependents without removing them, from memory as well as the table
+	ASSERT_EQ (1, unchecked.take (transaction, blocks[0]->hashables.previous, false).size ());
+	ASSERT_EQ (1, unchecked.take (transaction, blocks[1]->hashables.previous, false).size ());
+	ASSERT_EQ (3, unchecked.count (transaction));
+	ASSERT_EQ (1, unchecked.take (transaction, blocks[0]->hashables.previous).size ());
+	ASSERT_EQ (1, unchecked.take (transaction, blocks[1]->hashables.previous).size ());
+	ASSERT_EQ (1, unchecked.count (transaction));
+	ASSERT_EQ (0, node.store.unchecked_count (transaction));
+}
+
 namespace
 {
 void add_required_children_node_config_tree (nano::jsonconfig & tree)
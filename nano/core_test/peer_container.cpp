@@ -142,6 +142,61 @@ TEST (peer_container, rep_weight)
 	ASSERT_EQ (endpoint0, reps[0].endpoint);
 }
 
+TEST (peer_container, snapshot)
+{
+	nano::peer_container peers (nano::endpoint{});
+	auto snapshot0 (peers.snapshot ());
+	ASSERT_TRUE (snapshot0->peers.empty ());
+	nano::endpoint endpoint0 (boost::asio::ip::address_v6::loopback (), 24000);
+	nano::endpoint endpoint1 (boost::asio::ip::address_v6::loopback (), 24001);
+	peers.insert (endpoint0, nano::protocol_version);
+	peers.insert (endpoint1, nano::protocol_version);
+	auto snapshot1 (peers.snapshot ());
+	ASSERT_TRUE (snapshot0->peers.empty ());
+	ASSERT_EQ (2, snapshot1->peers.size ());
+	ASSERT_TRUE (snapshot1->representatives.empty ());
+	// Refreshing a known peer doesn't publish a new snapshot
+	peers.insert (endpoint0, nano::protocol_version);
+	ASSERT_EQ (snapshot1, peers.snapshot ());
+	nano::keypair key;
+	peers.rep_response (endpoint0, key.pub, nano::amount (100));
+	peers.rep_response (endpoint1, key.pub, nano::amount (50));
+	auto snapshot2 (peers.snapshot ());
+	ASSERT_EQ (2, snapshot2->representatives.size ());
+	ASSERT_EQ (endpoint0, snapshot2->representatives[0].endpoint);
+	ASSERT_EQ (1, snapshot2->probable_reps.size ());
+	ASSERT_EQ (100, snapshot2->total_weight);
+	ASSERT_EQ (100, peers.total_weight ());
+	size_t visited (0);
+	snapshot2->random_sample (1, [&visited](nano::peer_information const &) { ++visited; });
+	ASSERT_EQ (1, visited);
+	peers.purge_list (std::chrono::steady_clock::now () + std::chrono::seconds (1));
+	ASSERT_TRUE (peers.snapshot ()->peers.empty ());
+	ASSERT_EQ (2, snapshot2->peers.size ());
+}
+
+TEST (peer_container, random_sample)
+{
+	nano::peer_container peers (nano::endpoint{});
+	for (uint16_t i (0); i < 16; ++i)
+	{
+		peers.insert (nano::endpoint (boost::asio::ip::address_v6::loopback (), 24000 + i), nano::protocol_version);
+	}
+	auto snapshot (peers.snapshot ());
+	std::unordered_set<nano::endpoint> seen;
+	for (auto i (0); i < 64; ++i)
+	{
+		std::unordered_set<nano::endpoint> sample;
+		snapshot->random_sample (4, [&sample](nano::peer_information const & peer_a) { ASSERT_TRUE (sample.insert (peer_a.endpoint).second); });
+		ASSERT_EQ (4, sample.size ());
+		seen.insert (sample.begin (), sample.end ());
+	}
+	ASSERT_EQ (16, seen.size ());
+	size_t visited (0);
+	snapshot->random_sample (32, [&visited](nano::peer_information const &) { ++visited; });
+	ASSERT_EQ (16, visited);
+}
+
 // Test to make sure we don't repeatedly send keepalive messages to nodes that aren't responding
 TEST (peer_container, reachout)
 {
@@ -169,3 +224,23 @@ TEST (peer_container, depeer)
 	peers.contacted (endpoint0, nano::protocol_version_min - 1);
 	ASSERT_EQ (0, peers.size ());
 }
+
+TEST (peer_container, bootstrap_rate)
+{
+	nano::peer_container peers (nano::endpoint{});
+	nano::endpoint endpoint0 (boost::asio::ip::address_v6::loopback (), 24000);
+	nano::endpoint endpoint1 (boost::asio::ip::address_v6::loopback (), 24001);
+	peers.insert (endpoint0, nano::protocol_version);
+	peers.insert (endpoint1, nano::protocol_version);
+	ASSERT_EQ (0, peers.bootstrap_rate (endpoint1));
+	peers.bootstrap_rate_update (endpoint1, 100);
+	ASSERT_EQ (100, peers.bootstrap_rate (endpoint1));
+	peers.bootstrap_rate_update (endpoint1, 50);
+	ASSERT_EQ (75, peers.bootstrap_rate (endpoint1));
+	// The faster peer is picked first even though neither was attempted yet
+	ASSERT_EQ (endpoint1, peers.bootstrap_peer ());
+	ASSERT_EQ (endpoint0, peers.bootstrap_peer ());
+	// Once both were returned the next round starts with the faster peer again
+	ASSERT_EQ (endpoint1, peers.bootstrap_peer ());
+	ASSERT_EQ (endpoint0, peers.bootstrap_peer ());
+}
@@ -2,11 +2,13 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/beast.hpp>
+#include <boost/polymorphic_cast.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/thread.hpp>
 #include <nano/core_test/testutil.hpp>
 #include <nano/lib/jsonconfig.hpp>
+#include <nano/lib/jsonwriter.hpp>
 #include <nano/node/common.hpp>
 #include <nano/node/rpc.hpp>
 #include <nano/node/testing.hpp>
@@ -1151,6 +1153,70 @@ TEST (rpc, history_count)
 	ASSERT_EQ (1, history_node.size ());
 }
 
+TEST (rpc, account_history_offset)
+{
+	nano::system system (24000, 1);
+	system.wallet (0)->insert_adhoc (nano::test_genesis_key.prv);
+	auto change (system.wallet (0)->change_action (nano::test_genesis_key.pub, nano::test_genesis_key.pub));
+	ASSERT_NE (nullptr, change);
+	auto send (system.wallet (0)->send_action (nano::test_genesis_key.pub, nano::test_genesis_key.pub, system.nodes[0]->config.receive_minimum.number ()));
+	ASSERT_NE (nullptr, send);
+	auto receive (system.wallet (0)->receive_action (*send, nano::test_genesis_key.pub, system.nodes[0]->config.receive_minimum.number ()));
+	ASSERT_NE (nullptr, receive);
+	{
+		auto transaction (system.nodes[0]->store.tx_begin_read ());
+		ASSERT_EQ (send->hash (), system.nodes[0]->store.account_height_get (transaction, nano::test_genesis_key.pub, 3));
+	}
+	nano::rpc rpc (system.io_ctx, *system.nodes[0], nano::rpc_config (true));
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "account_history");
+	request.put ("account", nano::test_genesis_key.pub.to_account ());
+	request.put ("count", 2);
+	request.put ("offset", 1);
+	{
+		test_response response (request, rpc, system.io_ctx);
+		system.deadline_set (5s);
+		while (response.status == 0)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (200, response.status);
+		// The change block counts toward the offset but isn't listed
+		auto & history_node (response.json.get_child ("history"));
+		ASSERT_EQ (2, history_node.size ());
+		ASSERT_EQ (send->hash ().to_string (), history_node.begin ()->second.get<std::string> ("hash"));
+		ASSERT_EQ (system.nodes[0]->config.receive_minimum.to_string_dec (), history_node.begin ()->second.get<std::string> ("amount"));
+		ASSERT_FALSE (response.json.get_optional<std::string> ("previous").is_initialized ());
+	}
+	request.put ("count", 1);
+	request.put ("reverse", "true");
+	{
+		test_response response (request, rpc, system.io_ctx);
+		system.deadline_set (5s);
+		while (response.status == 0)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (200, response.status);
+		auto & history_node (response.json.get_child ("history"));
+		ASSERT_EQ (1, history_node.size ());
+		ASSERT_EQ (send->hash ().to_string (), history_node.begin ()->second.get<std::string> ("hash"));
+		ASSERT_EQ (receive->hash ().to_string (), response.json.get<std::string> ("next"));
+	}
+	request.put ("offset", 4);
+	{
+		test_response response (request, rpc, system.io_ctx);
+		system.deadline_set (5s);
+		while (response.status == 0)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (200, response.status);
+		ASSERT_EQ ("", response.json.get<std::string> ("history"));
+	}
+}
+
 TEST (rpc, process_block)
 {
 	nano::system system (24000, 1);
@@ -1822,6 +1888,44 @@ TEST (rpc, pending)
 	ASSERT_EQ (sources[block1->hash ()], nano::test_genesis_key.pub);
 }
 
+TEST (rpc, pending_threshold_unindexed)
+{
+	nano::system system (24000, 1);
+	nano::keypair key1;
+	system.wallet (0)->insert_adhoc (nano::test_genesis_key.prv);
+	auto block1 (system.wallet (0)->send_action (nano::test_genesis_key.pub, key1.pub, 100));
+	system.deadline_set (5s);
+	while (system.nodes[0]->active.active (*block1))
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	{
+		// The amount index is empty until the version 15 upgrade has run
+		auto & store (*boost::polymorphic_downcast<nano::mdb_store *> (system.nodes[0]->store_impl.get ()));
+		auto transaction (store.tx_begin_write ());
+		ASSERT_EQ (0, mdb_drop (store.env.tx (transaction), store.pending_amounts, 0));
+		store.version_put (transaction, 14);
+	}
+	nano::rpc rpc (system.io_ctx, *system.nodes[0], nano::rpc_config (true));
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "pending");
+	request.put ("account", key1.pub.to_account ());
+	request.put ("count", "100");
+	request.put ("threshold", "100");
+	test_response response (request, rpc, system.io_ctx);
+	system.deadline_set (5s);
+	while (response.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response.status);
+	auto & blocks_node (response.json.get_child ("blocks"));
+	ASSERT_EQ (1, blocks_node.size ());
+	ASSERT_EQ (block1->hash ().to_string (), blocks_node.begin ()->first);
+	ASSERT_EQ ("100", blocks_node.begin ()->second.get<std::string> (""));
+}
+
 TEST (rpc_config, serialization)
 {
 	nano::rpc_config config1;
@@ -2414,6 +2518,56 @@ TEST (rpc, representatives)
 	ASSERT_EQ (nano::genesis_account, representatives[0]);
 }
 
+TEST (rpc, representatives_sorting_unindexed)
+{
+	nano::system system (24000, 1);
+	nano::keypair key1;
+	system.wallet (0)->insert_adhoc (nano::test_genesis_key.prv);
+	system.wallet (0)->insert_adhoc (key1.prv);
+	ASSERT_NE (nullptr, system.wallet (0)->send_action (nano::test_genesis_key.pub, key1.pub, 100));
+	system.deadline_set (5s);
+	while (system.nodes[0]->balance (key1.pub) != 100)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_NE (nullptr, system.wallet (0)->change_action (key1.pub, key1.pub));
+	system.deadline_set (5s);
+	while (system.nodes[0]->weight (key1.pub) != 100)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	{
+		// The weight index is empty until the version 16 upgrade has run
+		auto & store (*boost::polymorphic_downcast<nano::mdb_store *> (system.nodes[0]->store_impl.get ()));
+		auto transaction (store.tx_begin_write ());
+		ASSERT_EQ (0, mdb_drop (store.env.tx (transaction), store.representative_weights, 0));
+		store.version_put (transaction, 15);
+	}
+	nano::rpc rpc (system.io_ctx, *system.nodes[0], nano::rpc_config (true));
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "representatives");
+	request.put ("sorting", "true");
+	test_response response (request, rpc, system.io_ctx);
+	system.deadline_set (5s);
+	while (response.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (200, response.status);
+	auto & representatives_node (response.json.get_child ("representatives"));
+	std::vector<nano::account> representatives;
+	for (auto i (representatives_node.begin ()), n (representatives_node.end ()); i != n; ++i)
+	{
+		nano::account account;
+		ASSERT_FALSE (account.decode_account (i->first));
+		representatives.push_back (account);
+	}
+	ASSERT_EQ (2, representatives.size ());
+	ASSERT_EQ (nano::genesis_account, representatives[0]);
+	ASSERT_EQ (key1.pub, representatives[1]);
+}
+
 TEST (rpc, wallet_change_seed)
 {
 	nano::system system0 (24000, 1);
@@ -2982,6 +3136,74 @@ TEST (rpc, pending_exists)
 	ASSERT_EQ ("1", exists_text1);
 }
 
+TEST (rpc, batch)
+{
+	nano::system system (24000, 1);
+	nano::genesis genesis;
+	nano::rpc rpc (system.io_ctx, *system.nodes[0], nano::rpc_config (true));
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "batch");
+	boost::property_tree::ptree requests;
+	boost::property_tree::ptree account_info;
+	account_info.put ("action", "account_info");
+	account_info.put ("account", nano::test_genesis_key.pub.to_account ());
+	requests.push_back (std::make_pair ("", account_info));
+	boost::property_tree::ptree block_info;
+	block_info.put ("action", "block_info");
+	block_info.put ("hash", genesis.hash ().to_string ());
+	requests.push_back (std::make_pair ("", block_info));
+	boost::property_tree::ptree bad_hash;
+	bad_hash.put ("action", "pending_exists");
+	bad_hash.put ("hash", "not a hash");
+	requests.push_back (std::make_pair ("", bad_hash));
+	boost::property_tree::ptree stop;
+	stop.put ("action", "stop");
+	requests.push_back (std::make_pair ("", stop));
+	request.add_child ("requests", requests);
+	for (auto parallel : { "false", "true" })
+	{
+		request.put ("parallel", parallel);
+		test_response response (request, rpc, system.io_ctx);
+		system.deadline_set (5s);
+		while (response.status == 0)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (200, response.status);
+		auto & responses (response.json.get_child ("responses"));
+		ASSERT_EQ (4, responses.size ());
+		auto i (responses.begin ());
+		ASSERT_EQ (genesis.hash ().to_string (), i->second.get<std::string> ("frontier"));
+		++i;
+		ASSERT_EQ (nano::test_genesis_key.pub.to_account (), i->second.get<std::string> ("block_account"));
+		++i;
+		ASSERT_EQ ("Bad hash number", i->second.get<std::string> ("error"));
+		++i;
+		ASSERT_EQ ("Action not allowed in batch", i->second.get<std::string> ("error"));
+	}
+	// A JSON array body runs as a batch of its elements
+	std::string result;
+	auto handler (std::make_shared<nano::rpc_handler> (*system.nodes[0], rpc, "[" + nano::json_string (account_info) + "]", "0", [&result](std::string const & body_a) {
+		result = body_a;
+	}));
+	handler->process_request ();
+	boost::property_tree::ptree tree;
+	std::stringstream stream (result);
+	boost::property_tree::read_json (stream, tree);
+	ASSERT_EQ (1, tree.get_child ("responses").size ());
+	ASSERT_EQ (genesis.hash ().to_string (), tree.get_child ("responses").front ().second.get<std::string> ("frontier"));
+	rpc.config.batch_request_limit = 3;
+	request.put ("parallel", "false");
+	test_response response (request, rpc, system.io_ctx);
+	system.deadline_set (5s);
+	while (response.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (std::error_code (nano::error_rpc::batch_too_large).message (), response.json.get<std::string> ("error"));
+}
+
 TEST (rpc, wallet_pending)
 {
 	nano::system system0 (24000, 1);
@@ -4339,6 +4561,268 @@ TEST (rpc, node_id_delete)
 	ASSERT_NE (node_id.pub.to_string (), system.nodes[0]->node_id.pub.to_string ());
 }
 
+TEST (rpc, worker_queues)
+{
+	nano::system system (24000, 1);
+	nano::rpc_config config (true);
+	config.heavy_queue_limit = 0;
+	nano::rpc rpc (system.io_ctx, *system.nodes[0], config);
+	rpc.start ();
+	// Heavy scans are rejected while their queue is full, cheap reads are still served
+	boost::property_tree::ptree request;
+	request.put ("action", "ledger");
+	test_response response (request, rpc, system.io_ctx);
+	system.deadline_set (5s);
+	while (response.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (boost::beast::http::status::service_unavailable, response.resp.result ());
+	ASSERT_EQ (std::error_code (nano::error_rpc::queue_full).message (), response.json.get<std::string> ("error"));
+	request.put ("action", "block_count");
+	test_response response1 (request, rpc, system.io_ctx);
+	system.deadline_set (5s);
+	while (response1.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ (boost::beast::http::status::ok, response1.resp.result ());
+	ASSERT_EQ ("1", response1.json.get<std::string> ("count"));
+	request.put ("action", "stats");
+	request.put ("type", "rpc");
+	test_response response2 (request, rpc, system.io_ctx);
+	system.deadline_set (5s);
+	while (response2.status == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_EQ ("1", response2.json.get<std::string> ("heavy.rejected"));
+	ASSERT_EQ ("4", response2.json.get<std::string> ("read.threads"));
+	// Both the block_count and the stats request waited in the read queue
+	uint64_t waited (0);
+	for (auto & bucket : response2.json.get_child ("read.wait"))
+	{
+		waited += bucket.second.get<uint64_t> ("");
+	}
+	ASSERT_LE (2, waited);
+}
+
+TEST (rpc, workers_stop)
+{
+	nano::rpc_config config (true);
+	config.read_threads = 1;
+	std::atomic<bool> ran (false);
+	std::atomic<bool> dropped (false);
+	{
+		nano::rpc_workers workers (config);
+		std::promise<void> release;
+		auto released (release.get_future ());
+		std::atomic<bool> started (false);
+		ASSERT_FALSE (workers.push (nano::rpc_request_class::read, [&started, &released]() {
+			started = true;
+			released.wait ();
+		}));
+		while (!started)
+		{
+			std::this_thread::sleep_for (1ms);
+		}
+		// Queued behind the running action, stopping answers it through its dropped callback instead of discarding it
+		ASSERT_FALSE (workers.push (nano::rpc_request_class::read, [&ran]() { ran = true; }, [&dropped]() { dropped = true; }));
+		workers.stop ();
+		ASSERT_TRUE (dropped);
+		ASSERT_TRUE (workers.push (nano::rpc_request_class::read, [&ran]() { ran = true; }));
+		release.set_value ();
+	}
+	ASSERT_FALSE (ran);
+}
+
+TEST (rpc, frontiers_cursor)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	nano::genesis genesis;
+	nano::keypair key1;
+	nano::send_block send (genesis.hash (), key1.pub, nano::genesis_amount - nano::gFLR_ratio, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0);
+	nano::open_block open (send.hash (), key1.pub, key1.pub, key1.prv, key1.pub, 0);
+	{
+		auto transaction (node.store.tx_begin_write ());
+		ASSERT_EQ (nano::process_result::progress, node.ledger.process (transaction, send).code);
+		ASSERT_EQ (nano::process_result::progress, node.ledger.process (transaction, open).code);
+	}
+	nano::rpc rpc (system.io_ctx, node, nano::rpc_config (true));
+	rpc.start ();
+	boost::property_tree::ptree request;
+	request.put ("action", "frontiers");
+	request.put ("account", nano::account (0).to_account ());
+	request.put ("count", 1);
+	request.put ("paged", "true");
+	std::unordered_map<std::string, std::string> frontiers;
+	std::string cursor;
+	{
+		test_response response (request, rpc, system.io_ctx);
+		system.deadline_set (5s);
+		while (response.status == 0)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (200, response.status);
+		for (auto & frontier : response.json.get_child ("frontiers"))
+		{
+			frontiers[frontier.first] = frontier.second.get<std::string> ("");
+		}
+		cursor = response.json.get<std::string> ("cursor");
+	}
+	ASSERT_EQ (1, frontiers.size ());
+	ASSERT_EQ (1, rpc.cursors->size ());
+	// Blocks added after the cursor was opened aren't in its snapshot
+	nano::send_block send2 (send.hash (), key1.pub, nano::genesis_amount - 2 * nano::gFLR_ratio, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0);
+	{
+		auto transaction (node.store.tx_begin_write ());
+		ASSERT_EQ (nano::process_result::progress, node.ledger.process (transaction, send2).code);
+	}
+	boost::property_tree::ptree next;
+	next.put ("action", "frontiers");
+	next.put ("cursor", cursor);
+	{
+		test_response response (next, rpc, system.io_ctx);
+		system.deadline_set (5s);
+		while (response.status == 0)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (200, response.status);
+		for (auto & frontier : response.json.get_child ("frontiers"))
+		{
+			frontiers[frontier.first] = frontier.second.get<std::string> ("");
+		}
+		ASSERT_FALSE (response.json.get_optional<std::string> ("cursor").is_initialized ());
+	}
+	ASSERT_EQ (2, frontiers.size ());
+	ASSERT_EQ (send.hash ().to_string (), frontiers[nano::test_genesis_key.pub.to_account ()]);
+	ASSERT_EQ (open.hash ().to_string (), frontiers[key1.pub.to_account ()]);
+	ASSERT_EQ (0, rpc.cursors->size ());
+	// The last page closed the cursor
+	{
+		test_response response (next, rpc, system.io_ctx);
+		system.deadline_set (5s);
+		while (response.status == 0)
+		{
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_EQ (200, response.status);
+		std::error_code ec (nano::error_rpc::cursor_not_found);
+		ASSERT_EQ (ec.message (), response.json.get<std::string> ("error"));
+	}
+}
+
+TEST (rpc, cursor_limit)
+{
+	nano::system system (24000, 1);
+	nano::rpc_config config (true);
+	config.cursor_limit = 1;
+	nano::rpc rpc (system.io_ctx, *system.nodes[0], config);
+	boost::property_tree::ptree request;
+	auto cursor (rpc.cursors->open (system.nodes[0]->store, "frontiers", request));
+	ASSERT_NE (nullptr, cursor);
+	rpc.cursors->put (cursor);
+	cursor = rpc.cursors->take (cursor->id, "frontiers");
+	ASSERT_NE (nullptr, cursor);
+	// A cursor reading its page still holds a snapshot and counts toward the limit
+	ASSERT_EQ (0, rpc.cursors->size ());
+	ASSERT_EQ (1, rpc.cursors->open_count ());
+	ASSERT_EQ (nullptr, rpc.cursors->open (system.nodes[0]->store, "frontiers", request));
+	cursor.reset ();
+	ASSERT_EQ (0, rpc.cursors->open_count ());
+	ASSERT_NE (nullptr, rpc.cursors->open (system.nodes[0]->store, "frontiers", request));
+	// Cursors and worker threads can't take more than half of LMDB's reader slots
+	nano::jsonconfig json;
+	config.cursor_limit = nano::mdb_env::max_readers;
+	config.serialize_json (json);
+	nano::rpc_config config2;
+	ASSERT_TRUE (!!config2.deserialize_json (json));
+}
+
+TEST (rpc, keep_alive)
+{
+	nano::system system (24000, 1);
+	nano::rpc_config config (true);
+	config.keep_alive_max_requests = 3;
+	nano::rpc rpc (system.io_ctx, *system.nodes[0], config);
+	rpc.start ();
+	auto port (rpc.config.port);
+	boost::asio::io_context io_ctx;
+	boost::asio::ip::tcp::socket socket (io_ctx);
+	std::atomic<bool> done{ false };
+	// The client thread records failures for the test thread to check, it can't return from the test itself
+	std::atomic<bool> failed{ false };
+	std::thread client ([&socket, &done, &failed, port]() {
+		try
+		{
+			failed = [&socket, port]() {
+				socket.connect (nano::tcp_endpoint (boost::asio::ip::address_v6::loopback (), port));
+				boost::beast::http::request<boost::beast::http::string_body> request (boost::beast::http::verb::post, "/", 11);
+				request.body () = R"({"action": "block_count"})";
+				request.prepare_payload ();
+				boost::beast::flat_buffer buffer;
+				boost::beast::http::response<boost::beast::http::string_body> response;
+				boost::beast::http::write (socket, request);
+				boost::beast::http::read (socket, buffer, response);
+				if (response.result () != boost::beast::http::status::ok || !response.keep_alive ())
+				{
+					return true;
+				}
+				// Pipelined requests are answered in order on the same connection
+				auto second (request);
+				second.body () = R"({"action": "account_count"})";
+				second.prepare_payload ();
+				boost::beast::http::write (socket, request);
+				boost::beast::http::write (socket, second);
+				response = {};
+				boost::beast::http::read (socket, buffer, response);
+				if (response.body ().find ("\"unchecked\"") == std::string::npos)
+				{
+					return true;
+				}
+				response = {};
+				boost::beast::http::read (socket, buffer, response);
+				if (response.body ().find ("\"count\"") == std::string::npos || response.body ().find ("\"unchecked\"") != std::string::npos)
+				{
+					return true;
+				}
+				// The third request reached keep_alive_max_requests
+				if (response.keep_alive ())
+				{
+					return true;
+				}
+				boost::system::error_code ec;
+				response = {};
+				boost::beast::http::read (socket, buffer, response, ec);
+				return ec != boost::beast::http::error::end_of_stream;
+			}();
+		}
+		catch (boost::system::system_error const &)
+		{
+			failed = true;
+		}
+		done = true;
+	});
+	system.deadline_set (10s);
+	std::error_code ec;
+	while (!done && !ec)
+	{
+		ec = system.poll ();
+	}
+	if (!done)
+	{
+		// Unblocks the client so it can be joined
+		boost::system::error_code ignored;
+		socket.shutdown (boost::asio::ip::tcp::socket::shutdown_both, ignored);
+	}
+	client.join ();
+	ASSERT_NO_ERROR (ec);
+	ASSERT_FALSE (failed);
+}
+
 TEST (rpc, stats_clear)
 {
 	nano::system system (24000, 1);
@@ -4537,3 +5021,69 @@ TEST (rpc, memory_stats)
 
 	ASSERT_EQ (response.json.get_child ("node").get_child ("vote_uniquer").get_child ("votes").get<std::string> ("count"), "1");
 }
+
+TEST (rpc, json_writer)
+{
+	boost::property_tree::ptree tree;
+	tree.put ("account", "a/b\"c\\d\ne\x01");
+	boost::property_tree::ptree history;
+	boost::property_tree::ptree value;
+	value.put ("", "1");
+	history.push_back (std::make_pair ("", value));
+	boost::property_tree::ptree entry;
+	entry.put ("type", "send");
+	entry.add_child ("empty", boost::property_tree::ptree ());
+	history.push_back (std::make_pair ("", entry));
+	tree.add_child ("history", history);
+	tree.add_child ("blocks", boost::property_tree::ptree ());
+	tree.put ("previous", "0");
+	std::string body;
+	nano::json_writer writer (body);
+	writer.begin ();
+	writer.put ("account", "a/b\"c\\d\ne\x01");
+	writer.begin_array ("history");
+	writer.push ("1");
+	writer.begin_object ();
+	writer.put ("type", "send");
+	writer.begin_object ("empty");
+	writer.end ();
+	writer.end ();
+	writer.end ();
+	writer.begin_object ("blocks");
+	writer.end ();
+	writer.put ("previous", "0");
+	writer.finish ();
+	ASSERT_EQ (nano::json_string (tree), body);
+	std::string empty;
+	nano::json_writer empty_writer (empty);
+	empty_writer.begin ();
+	empty_writer.finish ();
+	ASSERT_EQ (nano::json_string (boost::property_tree::ptree ()), empty);
+	// Bytes outside ASCII are escaped per byte like write_json, not copied as UTF-8
+	boost::property_tree::ptree alias_tree;
+	alias_tree.put ("alias", "caf\xc3\xa9\x7f");
+	std::string alias;
+	nano::json_writer alias_writer (alias);
+	alias_writer.begin ();
+	alias_writer.put ("alias", "caf\xc3\xa9\x7f");
+	alias_writer.finish ();
+	ASSERT_EQ (nano::json_string (alias_tree), alias);
+	ASSERT_NE (std::string::npos, alias.find ("caf\\u00C3\\u00A9\\u007F"));
+	// Serialized values are embedded as is, the result parses back to the same tree
+	boost::property_tree::ptree embedded;
+	boost::property_tree::ptree responses;
+	responses.push_back (std::make_pair ("", entry));
+	responses.push_back (std::make_pair ("", tree));
+	embedded.add_child ("responses", responses);
+	std::string embedded_body;
+	nano::json_writer embedded_writer (embedded_body);
+	embedded_writer.begin ();
+	embedded_writer.begin_array ("responses");
+	embedded_writer.push_json (nano::json_string (entry));
+	embedded_writer.push_json (body);
+	embedded_writer.finish ();
+	boost::property_tree::ptree parsed;
+	std::stringstream stream (embedded_body);
+	boost::property_tree::read_json (stream, parsed);
+	ASSERT_EQ (embedded, parsed);
+}
@@ -89,6 +89,16 @@ size_t nano::block::size (nano::block_type type_a)
 	return result;
 }
 
+nano::block::block (nano::block const &)
+{
+}
+
+nano::block & nano::block::operator= (nano::block const &)
+{
+	publish_bytes = nullptr;
+	return *this;
+}
+
 nano::block_hash nano::block::hash () const
 {
 	nano::uint256_union result;
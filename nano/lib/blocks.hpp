@@ -56,6 +56,10 @@ enum class block_type : uint8_t
 class block
 {
 public:
+	block () = default;
+	// Copies don't share the serialized message as they're usually made to be modified
+	block (nano::block const &);
+	nano::block & operator= (nano::block const &);
 	// Return a digest of the hashables in this block.
 	nano::block_hash hash () const;
 	// Return a digest of hashables and non-hashables in this block.
@@ -84,6 +88,9 @@ public:
 	virtual ~block () = default;
 	virtual bool valid_predecessor (nano::block const &) const = 0;
 	static size_t size (nano::block_type);
+	// Serialized publish message set by the node the first time the block is broadcast, blocks mustn't be modified afterwards.
+	// Accessed with std::atomic_load/std::atomic_store.
+	mutable std::shared_ptr<std::vector<uint8_t>> publish_bytes;
 };
 class send_hashables
 {
@@ -128,6 +128,8 @@ std::string nano::error_rpc_messages::message (int ev) const
 			return "Bad source";
 		case nano::error_rpc::bad_timeout:
 			return "Bad timeout number";
+		case nano::error_rpc::batch_too_large:
+			return "Too many requests in batch";
 		case nano::error_rpc::block_create_balance_mismatch:
 			return "Balance mismatch for previous block";
 		case nano::error_rpc::block_create_key_required:
@@ -146,8 +148,16 @@ std::string nano::error_rpc_messages::message (int ev) const
 			return "Destination account, previous hash, current balance and amount required";
 		case nano::error_rpc::confirmation_not_found:
 			return "Active confirmation not found";
+		case nano::error_rpc::cursor_limit:
+			return "Too many open cursors";
+		case nano::error_rpc::cursor_not_found:
+			return "Cursor not found or expired";
 		case nano::error_rpc::invalid_balance:
 			return "Invalid balance number";
+		case nano::error_rpc::invalid_batch:
+			return "Invalid batch requests";
+		case nano::error_rpc::invalid_cursor:
+			return "Cursor can't be used with these options";
 		case nano::error_rpc::invalid_destinations:
 			return "Invalid destinations number";
 		case nano::error_rpc::invalid_offset:
@@ -172,12 +182,16 @@ std::string nano::error_rpc_messages::message (int ev) const
 			return "Account has non-zero balance";
 		case nano::error_rpc::payment_unable_create_account:
 			return "Unable to create transaction account";
+		case nano::error_rpc::queue_full:
+			return "RPC queue full";
 		case nano::error_rpc::rpc_control_disabled:
 			return "RPC control is disabled";
 		case nano::error_rpc::sign_hash_disabled:
 			return "Signing by block hash is disabled";
 		case nano::error_rpc::source_not_found:
 			return "Source not found";
+		case nano::error_rpc::stopping:
+			return "RPC is stopping";
 	}
 
 	return "Invalid error code";
@@ -80,6 +80,7 @@ enum class error_rpc
 	bad_representative_number,
 	bad_source,
 	bad_timeout,
+	batch_too_large,
 	block_create_balance_mismatch,
 	block_create_key_required,
 	block_create_public_key_mismatch,
@@ -89,7 +90,11 @@ enum class error_rpc
 	block_create_requirements_change,
 	block_create_requirements_send,
 	confirmation_not_found,
+	cursor_limit,
+	cursor_not_found,
 	invalid_balance,
+	invalid_batch,
+	invalid_cursor,
 	invalid_destinations,
 	invalid_offset,
 	invalid_missing_type,
@@ -102,9 +107,11 @@ enum class error_rpc
 	invalid_timestamp,
 	payment_account_balance,
 	payment_unable_create_account,
+	queue_full,
 	rpc_control_disabled,
 	sign_hash_disabled,
-	source_not_found
+	source_not_found,
+	stopping
 };
 
 /** process_result related errors */
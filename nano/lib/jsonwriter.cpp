@@ -0,0 +1,179 @@
+#include <nano/lib/jsonwriter.hpp>
+
+#include <cassert>
+
+nano::json_writer::json_writer (std::string & output_a) :
+output (output_a)
+{
+}
+
+void nano::json_writer::begin ()
+{
+	assert (scopes.empty ());
+	scopes.push_back (scope{ false, true, 0, std::string () });
+	output += "{\n";
+}
+
+void nano::json_writer::finish ()
+{
+	while (!scopes.empty ())
+	{
+		end ();
+	}
+	output += '\n';
+}
+
+void nano::json_writer::begin_object (std::string const & key_a)
+{
+	begin_scope (false, key_a);
+}
+
+void nano::json_writer::begin_array (std::string const & key_a)
+{
+	begin_scope (true, key_a);
+}
+
+void nano::json_writer::begin_object ()
+{
+	assert (!scopes.empty () && scopes.back ().array);
+	begin_scope (false, std::string ());
+}
+
+void nano::json_writer::begin_scope (bool array_a, std::string const & key_a)
+{
+	assert (!scopes.empty ());
+	scopes.push_back (scope{ array_a, false, 0, key_a });
+}
+
+void nano::json_writer::end ()
+{
+	assert (!scopes.empty ());
+	auto & top (scopes.back ());
+	if (top.open)
+	{
+		auto level (scopes.size () - 1);
+		if (top.members > 0)
+		{
+			output += '\n';
+		}
+		output.append (4 * level, ' ');
+		output += top.array ? ']' : '}';
+		scopes.pop_back ();
+	}
+	else
+	{
+		// Nothing was written for an empty scope, it becomes an empty value of its parent
+		auto key (std::move (top.key));
+		scopes.pop_back ();
+		open_scopes ();
+		prefix (scopes.size () - 1, key);
+		output += "\"\"";
+	}
+}
+
+void nano::json_writer::put (std::string const & key_a, std::string const & value_a)
+{
+	assert (!scopes.empty () && !scopes.back ().array);
+	open_scopes ();
+	prefix (scopes.size () - 1, key_a);
+	output += '"';
+	escape (output, value_a);
+	output += '"';
+}
+
+void nano::json_writer::push (std::string const & value_a)
+{
+	assert (!scopes.empty () && scopes.back ().array);
+	open_scopes ();
+	prefix (scopes.size () - 1, std::string ());
+	output += '"';
+	escape (output, value_a);
+	output += '"';
+}
+
+void nano::json_writer::push_json (std::string const & value_a)
+{
+	assert (!scopes.empty () && scopes.back ().array);
+	open_scopes ();
+	prefix (scopes.size () - 1, std::string ());
+	auto end (value_a.find_last_not_of ('\n'));
+	output.append (value_a, 0, end == std::string::npos ? 0 : end + 1);
+}
+
+void nano::json_writer::prefix (size_t level_a, std::string const & key_a)
+{
+	auto & parent (scopes[level_a]);
+	if (parent.members > 0)
+	{
+		output += ",\n";
+	}
+	output.append (4 * (level_a + 1), ' ');
+	if (!parent.array)
+	{
+		output += '"';
+		escape (output, key_a);
+		output += "\": ";
+	}
+	++parent.members;
+}
+
+void nano::json_writer::open_scopes ()
+{
+	auto first (scopes.size ());
+	while (first > 0 && !scopes[first - 1].open)
+	{
+		--first;
+	}
+	for (auto i (first); i < scopes.size (); ++i)
+	{
+		prefix (i - 1, scopes[i].key);
+		output += scopes[i].array ? "[\n" : "{\n";
+		scopes[i].open = true;
+	}
+}
+
+void nano::json_writer::escape (std::string & output_a, std::string const & value_a)
+{
+	// Same rules as property_tree's create_escapes: control characters, quotes, backslashes and '/' are escaped, DEL and bytes outside ASCII become \u00XX
+	static char const * hexdigits ("0123456789ABCDEF");
+	for (auto c : value_a)
+	{
+		auto u (static_cast<unsigned char> (c));
+		if (u == 0x20 || u == 0x21 || (u >= 0x23 && u <= 0x2E) || (u >= 0x30 && u <= 0x5B) || (u >= 0x5D && u < 0x7F))
+		{
+			output_a += c;
+		}
+		else
+		{
+			output_a += '\\';
+			switch (c)
+			{
+				case '\b':
+					output_a += 'b';
+					break;
+				case '\f':
+					output_a += 'f';
+					break;
+				case '\n':
+					output_a += 'n';
+					break;
+				case '\r':
+					output_a += 'r';
+					break;
+				case '\t':
+					output_a += 't';
+					break;
+				case '/':
+				case '"':
+				case '\\':
+					output_a += c;
+					break;
+				default:
+					output_a += "u00";
+					output_a += hexdigits[u >> 4];
+					output_a += hexdigits[u & 0xf];
+					break;
+			}
+		}
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace nano
+{
+/**
+ * Writes JSON directly into a string using the layout of boost::property_tree::write_json, so a response streamed with it
+ * is byte-identical to the same response built as a ptree. As with ptree every value is a string, and an object or array
+ * without members is written as "" because ptree can't tell it apart from an empty value.
+ */
+class json_writer
+{
+public:
+	json_writer (std::string &);
+	// Opens the root object
+	void begin ();
+	// Closes every open scope and writes the trailing newline
+	void finish ();
+	void begin_object (std::string const &);
+	void begin_array (std::string const &);
+	// Opens an object as the next element of the enclosing array
+	void begin_object ();
+	// Closes the innermost object or array
+	void end ();
+	void put (std::string const &, std::string const &);
+	// Appends a value to the enclosing array
+	void push (std::string const &);
+	// Appends an already serialized JSON value to the enclosing array, it's copied without its trailing newline and keeps its own indentation
+	void push_json (std::string const &);
+	// Appends the value with the escaping of write_json
+	static void escape (std::string &, std::string const &);
+
+private:
+	class scope
+	{
+	public:
+		bool array;
+		// Whether the opening bracket was written, it's deferred until the first member
+		bool open;
+		size_t members;
+		std::string key;
+	};
+	// Writes the separator, indentation and key for a new member of the scope at the level
+	void prefix (size_t, std::string const &);
+	void open_scopes ();
+	void begin_scope (bool, std::string const &);
+	std::string & output;
+	std::vector<scope> scopes;
+};
+}
@@ -99,6 +99,9 @@ namespace thread_role
 			case nano::thread_role::name::slow_db_upgrade:
 				thread_role_name_string = "Slow db upgrade";
 				break;
+			case nano::thread_role::name::rpc_worker:
+				thread_role_name_string = "RPC worker";
+				break;
 		}
 
 		/*
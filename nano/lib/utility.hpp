@@ -86,6 +86,7 @@ namespace thread_role
 		voting,
 		signature_checking,
 		slow_db_upgrade,
+		rpc_worker,
 	};
 	/*
 	 * Get/Set the identifier for the current thread
@@ -32,6 +32,7 @@ int main (int argc, char * const * argv)
 		("disable_unchecked_drop", "Disables drop of unchecked table at startup")
 		("fast_bootstrap", "Increase bootstrap speed for high end nodes with higher limits")
 		("batch_size",boost::program_options::value<std::size_t> (), "Increase sideband batch size, default 512")
+		("capture", boost::program_options::value<std::string> (), "Record received UDP traffic to <capture> for use with debug_replay")
 		("debug_block_count", "Display the number of block")
 		("debug_bootstrap_generate", "Generate bootstrap sequence of blocks")
 		("debug_dump_online_weight", "Dump online_weights table")
@@ -51,6 +52,8 @@ int main (int argc, char * const * argv)
 		("debug_rpc", "Read an RPC command from stdin and invoke it. Network operations will have no effect.")
 		("debug_validate_blocks", "Check all blocks for correct hash, signature, work value")
 		("debug_peers", "Display peer IPv6:port connections")
+		("debug_replay", "Feed traffic recorded with --capture from <file> into a node and report throughput. Uses a temporary ledger unless --data_path is given, which is modified")
+		("speed", boost::program_options::value<double> (), "Defines the replay <speed> multiplier for debug_replay, 0 replays as fast as possible, default 1")
 		("platform", boost::program_options::value<std::string> (), "Defines the <platform> for OpenCL commands")
 		("device", boost::program_options::value<std::string> (), "Defines <device> for OpenCL command")
 		("threads", boost::program_options::value<std::string> (), "Defines <threads> count for OpenCL command");
@@ -102,6 +105,11 @@ int main (int argc, char * const * argv)
 			flags.disable_unchecked_cleanup = (vm.count ("disable_unchecked_cleanup") > 0);
 			flags.disable_unchecked_drop = (vm.count ("disable_unchecked_drop") > 0);
 			flags.fast_bootstrap = (vm.count ("fast_bootstrap") > 0);
+			auto capture_it = vm.find ("capture");
+			if (capture_it != vm.end ())
+			{
+				flags.capture_path = capture_it->second.as<std::string> ();
+			}
 			daemon.run (data_path, flags);
 		}
 		else if (vm.count ("debug_block_count"))
@@ -650,8 +658,8 @@ int main (int argc, char * const * argv)
 				command_l << rpc_input_l;
 			}
 
-			auto response_handler_l ([](boost::property_tree::ptree const & tree_a) {
-				boost::property_tree::write_json (std::cout, tree_a);
+			auto response_handler_l ([](std::string const & body_a) {
+				std::cout << body_a;
 				// Terminate as soon as we have the result, even if background threads (like work generation) are running.
 				std::exit (0);
 			});
@@ -866,7 +874,7 @@ int main (int argc, char * const * argv)
 				block_count_2 = node2.node->store.block_count (transaction_2).sum ();
 				if ((count % 60) == 0)
 				{
-					std::cout << boost::str (boost::format ("%1% (%2%) blocks processed") % block_count_2 % node2.node->store.unchecked_count (transaction_2)) << std::endl;
+					std::cout << boost::str (boost::format ("%1% (%2%) blocks processed") % block_count_2 % node2.node->unchecked.count (transaction_2)) << std::endl;
 				}
 				count++;
 			}
@@ -886,6 +894,36 @@ int main (int argc, char * const * argv)
 				std::cout << boost::str (boost::format ("%1%\n") % nano::endpoint (boost::asio::ip::address_v6 (i->first.address_bytes ()), i->first.port ()));
 			}
 		}
+		else if (vm.count ("debug_replay"))
+		{
+			if (vm.count ("file") == 1)
+			{
+				auto speed (vm.count ("speed") == 1 ? vm["speed"].as<double> () : 1.0);
+				nano::inactive_node node (data_path_it != vm.end () ? data_path : nano::unique_path (), 24001);
+				// Replies and bootstrap connections to the recorded peers would reach real nodes
+				node.node->flags.disable_udp_send = true;
+				node.node->flags.disable_legacy_bootstrap = true;
+				node.node->flags.disable_lazy_bootstrap = true;
+				node.node->flags.disable_wallet_bootstrap = true;
+				node.node->flags.disable_bootstrap_listener = true;
+				// Elections, vote processing and alarms need a running node to react to the replayed traffic
+				node.node->start ();
+				nano::thread_runner runner (*node.io_context, node.node->config.io_threads);
+				nano::traffic_replay replay (*node.node, speed);
+				if (replay.run (vm["file"].as<std::string> (), std::cout))
+				{
+					std::cerr << "Unable to read capture file\n";
+					result = -1;
+				}
+				node.node->stop ();
+				runner.join ();
+			}
+			else
+			{
+				std::cerr << "debug_replay requires one <file> option\n";
+				result = -1;
+			}
+		}
 		else if (vm.count ("version"))
 		{
 			if (NANO_VERSION_PATCH == 0)
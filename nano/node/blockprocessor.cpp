@@ -47,6 +47,12 @@ bool nano::block_processor::full ()
 	return (blocks.size () + state_blocks.size ()) > full_size;
 }
 
+size_t nano::block_processor::size ()
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	return blocks.size () + state_blocks.size ();
+}
+
 void nano::block_processor::add (std::shared_ptr<nano::block> block_a, uint64_t origination)
 {
 	nano::unchecked_info info (block_a, 0, origination, nano::signature_verification::unknown);
@@ -58,20 +64,8 @@ void nano::block_processor::add (nano::unchecked_info const & info_a)
 	if (!nano::work_validate (info_a.block->root (), info_a.block->block_work ()))
 	{
 		{
-			auto hash (info_a.block->hash ());
 			std::lock_guard<std::mutex> lock (mutex);
-			if (blocks_hashes.find (hash) == blocks_hashes.end () && rolled_back.get<1> ().find (hash) == rolled_back.get<1> ().end ())
-			{
-				if (info_a.verified == nano::signature_verification::unknown && (info_a.block->type () == nano::block_type::state || info_a.block->type () == nano::block_type::open || !info_a.account.is_zero ()))
-				{
-					state_blocks.push_back (info_a);
-				}
-				else
-				{
-					blocks.push_back (info_a);
-				}
-				blocks_hashes.insert (hash);
-			}
+			insert (info_a);
 		}
 		condition.notify_all ();
 	}
@@ -82,6 +76,52 @@ void nano::block_processor::add (nano::unchecked_info const & info_a)
 	}
 }
 
+void nano::block_processor::add (std::vector<nano::unchecked_info> const & infos_a)
+{
+	std::vector<nano::unchecked_info const *> valid;
+	valid.reserve (infos_a.size ());
+	for (auto & info : infos_a)
+	{
+		if (!nano::work_validate (info.block->root (), info.block->block_work ()))
+		{
+			valid.push_back (&info);
+		}
+		else
+		{
+			BOOST_LOG (node.log) << "nano::block_processor::add called for hash " << info.block->hash ().to_string () << " with invalid work " << nano::to_string_hex (info.block->block_work ());
+			assert (false && "nano::block_processor::add called with invalid work");
+		}
+	}
+	if (!valid.empty ())
+	{
+		{
+			std::lock_guard<std::mutex> lock (mutex);
+			for (auto info : valid)
+			{
+				insert (*info);
+			}
+		}
+		condition.notify_all ();
+	}
+}
+
+void nano::block_processor::insert (nano::unchecked_info const & info_a)
+{
+	auto hash (info_a.block->hash ());
+	if (blocks_hashes.find (hash) == blocks_hashes.end () && rolled_back.get<1> ().find (hash) == rolled_back.get<1> ().end ())
+	{
+		if (info_a.verified == nano::signature_verification::unknown && (info_a.block->type () == nano::block_type::state || info_a.block->type () == nano::block_type::open || !info_a.account.is_zero ()))
+		{
+			state_blocks.push_back (info_a);
+		}
+		else
+		{
+			blocks.push_back (info_a);
+		}
+		blocks_hashes.insert (hash);
+	}
+}
+
 void nano::block_processor::force (std::shared_ptr<nano::block> block_a)
 {
 	{
@@ -350,7 +390,7 @@ void nano::block_processor::process_live (nano::block_hash const & hash_a, std::
 	}
 	// Request confirmation for new block with delay
 	std::weak_ptr<nano::node> node_w (node.shared ());
-	node.alarm.add (std::chrono::steady_clock::now () + confirmation_request_delay, [node_w, block_a]() {
+	node.alarm.add (node.alarm.now () + confirmation_request_delay, [node_w, block_a]() {
 		if (auto node_l = node_w.lock ())
 		{
 			// Check if votes were already requested
@@ -406,7 +446,7 @@ nano::process_return nano::block_processor::process_one (nano::transaction const
 			{
 				info_a.modified = nano::seconds_since_epoch ();
 			}
-			node.store.unchecked_put (transaction_a, nano::unchecked_key (info_a.block->previous (), hash), info_a);
+			node.unchecked.put (transaction_a, nano::unchecked_key (info_a.block->previous (), hash), info_a);
 			node.gap_cache.add (transaction_a, hash);
 			break;
 		}
@@ -421,7 +461,7 @@ nano::process_return nano::block_processor::process_one (nano::transaction const
 			{
 				info_a.modified = nano::seconds_since_epoch ();
 			}
-			node.store.unchecked_put (transaction_a, nano::unchecked_key (node.ledger.block_source (transaction_a, *(info_a.block)), hash), info_a);
+			node.unchecked.put (transaction_a, nano::unchecked_key (node.ledger.block_source (transaction_a, *(info_a.block)), hash), info_a);
 			node.gap_cache.add (transaction_a, hash);
 			break;
 		}
@@ -518,13 +558,9 @@ nano::process_return nano::block_processor::process_one (nano::transaction const
 
 void nano::block_processor::queue_unchecked (nano::transaction const & transaction_a, nano::block_hash const & hash_a)
 {
-	auto unchecked_blocks (node.store.unchecked_get (transaction_a, hash_a));
+	auto unchecked_blocks (node.unchecked.take (transaction_a, hash_a, !node.flags.fast_bootstrap));
 	for (auto & info : unchecked_blocks)
 	{
-		if (!node.flags.fast_bootstrap)
-		{
-			node.store.unchecked_del (transaction_a, nano::unchecked_key (hash_a, info.block->hash ()));
-		}
 		add (info);
 	}
 	std::lock_guard<std::mutex> lock (node.gap_cache.mutex);
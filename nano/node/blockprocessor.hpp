@@ -35,7 +35,10 @@ public:
 	void stop ();
 	void flush ();
 	bool full ();
+	size_t size ();
 	void add (nano::unchecked_info const &);
+	// Queues blocks with a single lock and wakeup, used for batches received by bootstrap
+	void add (std::vector<nano::unchecked_info> const &);
 	void add (std::shared_ptr<nano::block>, uint64_t = 0);
 	void force (std::shared_ptr<nano::block>);
 	bool should_log (bool);
@@ -48,6 +51,8 @@ public:
 	static std::chrono::milliseconds constexpr confirmation_request_delay{ 1500 };
 
 private:
+	// Requires mutex to be held
+	void insert (nano::unchecked_info const &);
 	void queue_unchecked (nano::transaction const &, nano::block_hash const &);
 	void verify_state_blocks (nano::transaction const & transaction_a, std::unique_lock<std::mutex> &, size_t = std::numeric_limits<size_t>::max ());
 	void process_batch (std::unique_lock<std::mutex> &);
@@ -17,9 +17,13 @@ constexpr unsigned bootstrap_max_new_connections = 10;
 constexpr unsigned bulk_push_cost_limit = 200;
 
 size_t constexpr nano::frontier_req_client::size_frontier;
+uint64_t constexpr nano::frontier_sync_cache::full_interval;
+uint64_t constexpr nano::frontier_sync_cache::margin;
+size_t constexpr nano::frontier_sync_cache::max_entries;
 
 nano::socket::socket (std::shared_ptr<nano::node> node_a) :
 socket_m (node_a->io_ctx),
+io_timeout (5),
 cutoff (std::numeric_limits<uint64_t>::max ()),
 node (node_a)
 {
@@ -42,7 +46,7 @@ void nano::socket::async_read (std::shared_ptr<std::vector<uint8_t>> buffer_a, s
 	auto this_l (shared_from_this ());
 	if (socket_m.is_open ())
 	{
-		start ();
+		start (std::chrono::steady_clock::now () + io_timeout);
 		boost::asio::async_read (socket_m, boost::asio::buffer (buffer_a->data (), size_a), [this_l, callback_a](boost::system::error_code const & ec, size_t size_a) {
 			this_l->node->stats.add (nano::stat::type::traffic_bootstrap, nano::stat::dir::in, size_a);
 			this_l->stop ();
@@ -51,12 +55,27 @@ void nano::socket::async_read (std::shared_ptr<std::vector<uint8_t>> buffer_a, s
 	}
 }
 
+void nano::socket::async_read_some (std::shared_ptr<std::vector<uint8_t>> buffer_a, size_t offset_a, size_t size_a, std::function<void(boost::system::error_code const &, size_t)> callback_a)
+{
+	assert (offset_a + size_a <= buffer_a->size ());
+	auto this_l (shared_from_this ());
+	if (socket_m.is_open ())
+	{
+		start (std::chrono::steady_clock::now () + io_timeout);
+		socket_m.async_read_some (boost::asio::buffer (buffer_a->data () + offset_a, size_a), [this_l, buffer_a, callback_a](boost::system::error_code const & ec, size_t size_a) {
+			this_l->node->stats.add (nano::stat::type::traffic_bootstrap, nano::stat::dir::in, size_a);
+			this_l->stop ();
+			callback_a (ec, size_a);
+		});
+	}
+}
+
 void nano::socket::async_write (std::shared_ptr<std::vector<uint8_t>> buffer_a, std::function<void(boost::system::error_code const &, size_t)> callback_a)
 {
 	auto this_l (shared_from_this ());
 	if (socket_m.is_open ())
 	{
-		start ();
+		start (std::chrono::steady_clock::now () + io_timeout);
 		boost::asio::async_write (socket_m, boost::asio::buffer (buffer_a->data (), buffer_a->size ()), [this_l, callback_a, buffer_a](boost::system::error_code const & ec, size_t size_a) {
 			this_l->node->stats.add (nano::stat::type::traffic_bootstrap, nano::stat::dir::out, size_a);
 			this_l->stop ();
@@ -94,7 +113,7 @@ void nano::socket::close ()
 void nano::socket::checkup ()
 {
 	std::weak_ptr<nano::socket> this_w (shared_from_this ());
-	node->alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (10), [this_w]() {
+	node->alarm.add (node->alarm.now () + std::chrono::seconds (10), [this_w]() {
 		if (auto this_l = this_w.lock ())
 		{
 			if (this_l->cutoff != std::numeric_limits<uint64_t>::max () && this_l->cutoff < static_cast<uint64_t> (std::chrono::steady_clock::now ().time_since_epoch ().count ()))
@@ -135,6 +154,11 @@ receive_buffer (std::make_shared<std::vector<uint8_t>> ()),
 endpoint (endpoint_a),
 start_time (std::chrono::steady_clock::now ()),
 block_count (0),
+byte_count (0),
+pull_count (0),
+error_count (0),
+first_byte_us (0),
+prior_rate (node_a->peers.bootstrap_rate (nano::endpoint (endpoint_a.address (), endpoint_a.port ()))),
 pending_stop (false),
 hard_stop (false)
 {
@@ -145,6 +169,10 @@ hard_stop (false)
 nano::bootstrap_client::~bootstrap_client ()
 {
 	--attempt->connections;
+	if (block_count > 0)
+	{
+		node->peers.bootstrap_rate_update (nano::endpoint (endpoint.address (), endpoint.port ()), block_rate ());
+	}
 }
 
 double nano::bootstrap_client::block_rate () const
@@ -153,6 +181,29 @@ double nano::bootstrap_client::block_rate () const
 	return static_cast<double> (block_count.load () / elapsed);
 }
 
+double nano::bootstrap_client::byte_rate () const
+{
+	auto elapsed = std::max (elapsed_seconds (), bootstrap_minimum_elapsed_seconds_blockrate);
+	return static_cast<double> (byte_count.load ()) / elapsed;
+}
+
+double nano::bootstrap_client::score () const
+{
+	auto rate (block_count > 0 ? block_rate () : prior_rate);
+	auto pulls (pull_count.load ());
+	auto success (pulls > 0 ? 1.0 - static_cast<double> (std::min (error_count.load (), pulls)) / pulls : 1.0);
+	auto latency (first_byte_us.load () / 1e6);
+	return rate * success / (1.0 + latency);
+}
+
+void nano::bootstrap_client::first_byte (std::chrono::steady_clock::duration const & latency_a)
+{
+	uint64_t sample (std::chrono::duration_cast<std::chrono::microseconds> (latency_a).count ());
+	auto previous (first_byte_us.load ());
+	// Only one pull runs on a connection at a time so the read-modify-write doesn't race
+	first_byte_us = previous == 0 ? sample : (previous * 3 + sample) / 4;
+}
+
 double nano::bootstrap_client::elapsed_seconds () const
 {
 	return std::chrono::duration_cast<std::chrono::duration<double>> (std::chrono::steady_clock::now () - start_time).count ();
@@ -203,9 +254,20 @@ void nano::bootstrap_client::run ()
 void nano::frontier_req_client::run ()
 {
 	std::unique_ptr<nano::frontier_req> request (new nano::frontier_req);
-	request->start.clear ();
-	request->age = std::numeric_limits<decltype (request->age)>::max ();
+	request->start = range_start;
+	request->age = age;
 	request->count = std::numeric_limits<decltype (request->count)>::max ();
+	if (!range_end.is_zero () && connection->node->peers.version (nano::endpoint (connection->endpoint.address (), connection->endpoint.port ())) >= nano::frontier_req_end_version)
+	{
+		// Older peers stream to the end of their frontiers, the connection is dropped once they pass the range instead
+		request->end = range_end;
+		request->set_end_present (true);
+	}
+	request_time = nano::seconds_since_epoch ();
+	if (incremental ())
+	{
+		connection->node->stats.inc (nano::stat::type::bootstrap, nano::stat::detail::frontier_req_incremental, nano::stat::dir::out);
+	}
 	auto send_buffer (std::make_shared<std::vector<uint8_t>> ());
 	{
 		nano::vectorstream stream (*send_buffer);
@@ -232,18 +294,60 @@ std::shared_ptr<nano::bootstrap_client> nano::bootstrap_client::shared ()
 	return shared_from_this ();
 }
 
-nano::frontier_req_client::frontier_req_client (std::shared_ptr<nano::bootstrap_client> connection_a) :
+nano::frontier_req_client::frontier_req_client (std::shared_ptr<nano::bootstrap_client> connection_a, nano::account const & start_a, nano::account const & end_a, uint32_t age_a) :
 connection (connection_a),
-current (0),
+range_start (start_a),
+range_end (end_a),
+age (age_a),
+request_time (0),
+resume (start_a),
+finished (false),
+current (start_a.is_zero () ? nano::account (0) : nano::account (start_a.number () - 1)),
 count (0),
 bulk_push_cost (0)
 {
-	auto transaction (connection->node->store.tx_begin_read ());
-	next (transaction);
+	if (!incremental ())
+	{
+		auto transaction (connection->node->store.tx_begin_read ());
+		next (transaction);
+	}
+	else
+	{
+		// Received frontiers are looked up individually instead of walking local accounts alongside them
+		current.clear ();
+	}
 }
 
 nano::frontier_req_client::~frontier_req_client ()
 {
+	if (!finished)
+	{
+		// Connection failed before the whole range was received
+		connection->attempt->frontier_finished (resume, range_end, true);
+	}
+}
+
+void nano::frontier_req_client::finish (bool error_a)
+{
+	if (!finished)
+	{
+		finished = true;
+		if (!error_a)
+		{
+			connection->node->bootstrap_initiator.frontier_syncs.synced (connection->endpoint, range_start, request_time, !incremental ());
+		}
+		connection->attempt->frontier_finished (error_a ? resume : range_start, range_end, error_a);
+	}
+}
+
+bool nano::frontier_req_client::in_range (nano::account const & account_a) const
+{
+	return range_end.is_zero () || account_a < range_end;
+}
+
+bool nano::frontier_req_client::incremental () const
+{
+	return age != std::numeric_limits<uint32_t>::max ();
 }
 
 void nano::frontier_req_client::receive_frontier ()
@@ -304,10 +408,11 @@ void nano::frontier_req_client::received_frontier (boost::system::error_code con
 
 		double elapsed_sec = std::max (time_span.count (), bootstrap_minimum_elapsed_seconds_blockrate);
 		double blocks_per_sec = static_cast<double> (count) / elapsed_sec;
-		if (elapsed_sec > bootstrap_connection_warmup_time_sec && blocks_per_sec < bootstrap_minimum_frontier_blocks_per_sec)
+		// Age filtered replies are sparse by design, the peer is still scanning every account between them
+		if (!incremental () && elapsed_sec > bootstrap_connection_warmup_time_sec && blocks_per_sec < bootstrap_minimum_frontier_blocks_per_sec)
 		{
 			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Aborting frontier req because it was too slow"));
-			promise.set_value (true);
+			finish (true);
 			return;
 		}
 		if (connection->attempt->should_log ())
@@ -315,7 +420,21 @@ void nano::frontier_req_client::received_frontier (boost::system::error_code con
 			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Received %1% frontiers from %2%") % std::to_string (count) % connection->socket->remote_endpoint ());
 		}
 		auto transaction (connection->node->store.tx_begin_read ());
-		if (!account.is_zero ())
+		if (!account.is_zero () && in_range (account) && incremental ())
+		{
+			nano::account_info info;
+			if (!connection->node->store.account_get (transaction, account, info))
+			{
+				compare (transaction, account, latest, info.head);
+			}
+			else
+			{
+				connection->attempt->add_pull (nano::pull_info (account, latest, nano::block_hash (0)));
+			}
+			resume = account.number () + 1;
+			receive_frontier ();
+		}
+		else if (!account.is_zero () && in_range (account))
 		{
 			while (!current.is_zero () && current < account)
 			{
@@ -327,25 +446,7 @@ void nano::frontier_req_client::received_frontier (boost::system::error_code con
 			{
 				if (account == current)
 				{
-					if (latest == frontier)
-					{
-						// In sync
-					}
-					else
-					{
-						if (connection->node->store.block_exists (transaction, latest))
-						{
-							// We know about a block they don't.
-							unsynced (frontier, latest);
-						}
-						else
-						{
-							connection->attempt->add_pull (nano::pull_info (account, latest, frontier));
-							// Either we're behind or there's a fork we differ on
-							// Either way, bulk pushing will probably not be effective
-							bulk_push_cost += 5;
-						}
-					}
+					compare (transaction, account, latest, frontier);
 					next (transaction);
 				}
 				else
@@ -358,6 +459,7 @@ void nano::frontier_req_client::received_frontier (boost::system::error_code con
 			{
 				connection->attempt->add_pull (nano::pull_info (account, latest, nano::block_hash (0)));
 			}
+			resume = account.number () + 1;
 			receive_frontier ();
 		}
 		else
@@ -372,16 +474,16 @@ void nano::frontier_req_client::received_frontier (boost::system::error_code con
 			{
 				BOOST_LOG (connection->node->log) << "Bulk push cost: " << bulk_push_cost;
 			}
+			finish (false);
+			if (account.is_zero ())
 			{
-				try
-				{
-					promise.set_value (false);
-				}
-				catch (std::future_error &)
-				{
-				}
 				connection->attempt->pool_connection (connection);
 			}
+			else
+			{
+				// The peer is still sending frontiers past the end of the range
+				connection->stop (true);
+			}
 		}
 	}
 	else
@@ -393,13 +495,36 @@ void nano::frontier_req_client::received_frontier (boost::system::error_code con
 	}
 }
 
+void nano::frontier_req_client::compare (nano::transaction const & transaction_a, nano::account const & account_a, nano::block_hash const & latest_a, nano::block_hash const & local_a)
+{
+	if (latest_a == local_a)
+	{
+		// In sync
+	}
+	else
+	{
+		if (connection->node->store.block_exists (transaction_a, latest_a))
+		{
+			// We know about a block they don't.
+			unsynced (local_a, latest_a);
+		}
+		else
+		{
+			connection->attempt->add_pull (nano::pull_info (account_a, latest_a, local_a));
+			// Either we're behind or there's a fork we differ on
+			// Either way, bulk pushing will probably not be effective
+			bulk_push_cost += 5;
+		}
+	}
+}
+
 void nano::frontier_req_client::next (nano::transaction const & transaction_a)
 {
 	// Filling accounts deque to prevent often read transactions
 	if (accounts.empty ())
 	{
 		size_t max_size (128);
-		for (auto i (connection->node->store.latest_begin (transaction_a, current.number () + 1)), n (connection->node->store.latest_end ()); i != n && accounts.size () != max_size; ++i)
+		for (auto i (connection->node->store.latest_begin (transaction_a, current.number () + 1)), n (connection->node->store.latest_end ()); i != n && accounts.size () != max_size && in_range (nano::account (i->first)); ++i)
 		{
 			nano::account_info info (i->second);
 			accounts.push_back (std::make_pair (nano::account (i->first), info.head));
@@ -423,8 +548,14 @@ connection (connection_a),
 known_account (0),
 pull (pull_a),
 total_blocks (0),
-unexpected_count (0)
+unexpected_count (0),
+buffer_begin (0),
+buffer_end (0)
 {
+	if (connection->pull_buffer == nullptr)
+	{
+		connection->pull_buffer = std::make_shared<std::vector<uint8_t>> (nano::bootstrap_receive_buffer_size);
+	}
 	std::lock_guard<std::mutex> mutex (connection->attempt->mutex);
 	connection->attempt->condition.notify_all ();
 }
@@ -434,6 +565,7 @@ nano::bulk_pull_client::~bulk_pull_client ()
 	// If received end block is not expected end block
 	if (expected != pull.end)
 	{
+		++connection->error_count;
 		pull.head = expected;
 		if (connection->attempt->mode != nano::bootstrap_mode::legacy)
 		{
@@ -476,6 +608,8 @@ void nano::bulk_pull_client::request ()
 		std::unique_lock<std::mutex> lock (connection->attempt->mutex);
 		BOOST_LOG (connection->node->log) << boost::str (boost::format ("%1% accounts in pull queue") % connection->attempt->pulls.size ());
 	}
+	++connection->pull_count;
+	request_time = std::chrono::steady_clock::now ();
 	auto this_l (shared_from_this ());
 	connection->socket->async_write (buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
 		if (!ec)
@@ -494,155 +628,163 @@ void nano::bulk_pull_client::request ()
 
 void nano::bulk_pull_client::receive_block ()
 {
+	auto & buffer (*connection->pull_buffer);
+	// Move a partially received block to the front, leaving room for at least one complete block after it
+	if (buffer_begin > 0)
+	{
+		std::copy (buffer.begin () + buffer_begin, buffer.begin () + buffer_end, buffer.begin ());
+		buffer_end -= buffer_begin;
+		buffer_begin = 0;
+	}
 	auto this_l (shared_from_this ());
-	connection->socket->async_read (connection->receive_buffer, 1, [this_l](boost::system::error_code const & ec, size_t size_a) {
+	connection->socket->async_read_some (connection->pull_buffer, buffer_end, buffer.size () - buffer_end, [this_l](boost::system::error_code const & ec, size_t size_a) {
 		if (!ec)
 		{
-			this_l->received_type ();
+			if (this_l->request_time != std::chrono::steady_clock::time_point ())
+			{
+				this_l->connection->first_byte (std::chrono::steady_clock::now () - this_l->request_time);
+				this_l->request_time = std::chrono::steady_clock::time_point ();
+			}
+			this_l->connection->byte_count += size_a;
+			this_l->buffer_end += size_a;
+			this_l->received_data ();
 		}
 		else
 		{
 			if (this_l->connection->node->config.logging.bulk_pull_logging ())
 			{
-				BOOST_LOG (this_l->connection->node->log) << boost::str (boost::format ("Error receiving block type: %1%") % ec.message ());
+				BOOST_LOG (this_l->connection->node->log) << boost::str (boost::format ("Error bulk receiving block: %1%") % ec.message ());
 			}
 		}
 	});
 }
 
-void nano::bulk_pull_client::received_type ()
+void nano::bulk_pull_client::received_data ()
 {
-	auto this_l (shared_from_this ());
-	nano::block_type type (static_cast<nano::block_type> (connection->receive_buffer->data ()[0]));
-	switch (type)
+	auto & buffer (*connection->pull_buffer);
+	std::vector<nano::unchecked_info> batch;
+	auto receive (true);
+	auto incomplete (false);
+	auto pool (false);
+	while (receive && !incomplete && buffer_begin < buffer_end)
 	{
-		case nano::block_type::send:
+		nano::block_type type (static_cast<nano::block_type> (buffer[buffer_begin]));
+		switch (type)
 		{
-			connection->socket->async_read (connection->receive_buffer, nano::send_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-				this_l->received_block (ec, size_a, type);
-			});
-			break;
+			case nano::block_type::send:
+			case nano::block_type::receive:
+			case nano::block_type::open:
+			case nano::block_type::change:
+			case nano::block_type::state:
+			{
+				auto size (nano::block::size (type));
+				if (buffer_end - buffer_begin > size)
+				{
+					nano::bufferstream stream (buffer.data () + buffer_begin + 1, size);
+					std::shared_ptr<nano::block> block (nano::deserialize_block (stream, type));
+					buffer_begin += 1 + size;
+					receive = received_block (block, batch);
+				}
+				else
+				{
+					incomplete = true;
+				}
+				break;
+			}
+			case nano::block_type::not_a_block:
+			{
+				++buffer_begin;
+				receive = false;
+				// Avoid re-using slow peers, or peers that sent the wrong blocks.
+				pool = !connection->pending_stop && expected == pull.end;
+				break;
+			}
+			default:
+			{
+				if (connection->node->config.logging.network_packet_logging ())
+				{
+					BOOST_LOG (connection->node->log) << boost::str (boost::format ("Unknown type received as block type: %1%") % static_cast<int> (type));
+				}
+				receive = false;
+				break;
+			}
 		}
-		case nano::block_type::receive:
+	}
+	if (!batch.empty ())
+	{
+		connection->node->block_processor.add (batch);
+	}
+	if (receive)
+	{
+		receive_block ();
+	}
+	else if (pool)
+	{
+		connection->attempt->pool_connection (connection);
+	}
+}
+
+bool nano::bulk_pull_client::received_block (std::shared_ptr<nano::block> block_a, std::vector<nano::unchecked_info> & batch_a)
+{
+	auto result (false);
+	if (block_a != nullptr && !nano::work_validate (*block_a))
+	{
+		auto hash (block_a->hash ());
+		if (connection->node->config.logging.bulk_pull_logging ())
 		{
-			connection->socket->async_read (connection->receive_buffer, nano::receive_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-				this_l->received_block (ec, size_a, type);
-			});
-			break;
+			std::string block_l;
+			block_a->serialize_json (block_l);
+			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Pulled block %1% %2%") % hash.to_string () % block_l);
 		}
-		case nano::block_type::open:
+		// Is block expected?
+		bool block_expected (false);
+		if (hash == expected)
 		{
-			connection->socket->async_read (connection->receive_buffer, nano::open_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-				this_l->received_block (ec, size_a, type);
-			});
-			break;
+			expected = block_a->previous ();
+			block_expected = true;
 		}
-		case nano::block_type::change:
+		else
 		{
-			connection->socket->async_read (connection->receive_buffer, nano::change_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-				this_l->received_block (ec, size_a, type);
-			});
-			break;
+			unexpected_count++;
 		}
-		case nano::block_type::state:
+		if (total_blocks == 0 && block_expected)
 		{
-			connection->socket->async_read (connection->receive_buffer, nano::state_block::size, [this_l, type](boost::system::error_code const & ec, size_t size_a) {
-				this_l->received_block (ec, size_a, type);
-			});
-			break;
+			known_account = block_a->account ();
 		}
-		case nano::block_type::not_a_block:
+		if (connection->block_count++ == 0)
 		{
-			// Avoid re-using slow peers, or peers that sent the wrong blocks.
-			if (!connection->pending_stop && expected == pull.end)
-			{
-				connection->attempt->pool_connection (connection);
-			}
-			break;
+			connection->start_time = std::chrono::steady_clock::now ();
 		}
-		default:
+		connection->attempt->total_blocks++;
+		total_blocks++;
+		bool stop_pull (connection->attempt->process_block (block_a, known_account, total_blocks, block_expected, batch_a));
+		if (!stop_pull && !connection->hard_stop.load ())
 		{
-			if (connection->node->config.logging.network_packet_logging ())
-			{
-				BOOST_LOG (connection->node->log) << boost::str (boost::format ("Unknown type received as block type: %1%") % static_cast<int> (type));
-			}
-			break;
+			/* Process block in lazy pull if not stopped
+			Stop usual pull request with unexpected block & more than 16k blocks processed
+			to prevent spam */
+			result = connection->attempt->mode != nano::bootstrap_mode::legacy || unexpected_count < 16384;
 		}
-	}
-}
-
-void nano::bulk_pull_client::received_block (boost::system::error_code const & ec, size_t size_a, nano::block_type type_a)
-{
-	if (!ec)
-	{
-		nano::bufferstream stream (connection->receive_buffer->data (), size_a);
-		std::shared_ptr<nano::block> block (nano::deserialize_block (stream, type_a));
-		if (block != nullptr && !nano::work_validate (*block))
+		else if (stop_pull && block_expected)
 		{
-			auto hash (block->hash ());
-			if (connection->node->config.logging.bulk_pull_logging ())
-			{
-				std::string block_l;
-				block->serialize_json (block_l);
-				BOOST_LOG (connection->node->log) << boost::str (boost::format ("Pulled block %1% %2%") % hash.to_string () % block_l);
-			}
-			// Is block expected?
-			bool block_expected (false);
-			if (hash == expected)
-			{
-				expected = block->previous ();
-				block_expected = true;
-			}
-			else
-			{
-				unexpected_count++;
-			}
-			if (total_blocks == 0 && block_expected)
-			{
-				known_account = block->account ();
-			}
-			if (connection->block_count++ == 0)
-			{
-				connection->start_time = std::chrono::steady_clock::now ();
-			}
-			connection->attempt->total_blocks++;
-			total_blocks++;
-			bool stop_pull (connection->attempt->process_block (block, known_account, total_blocks, block_expected));
-			if (!stop_pull && !connection->hard_stop.load ())
-			{
-				/* Process block in lazy pull if not stopped
-				Stop usual pull request with unexpected block & more than 16k blocks processed
-				to prevent spam */
-				if (connection->attempt->mode != nano::bootstrap_mode::legacy || unexpected_count < 16384)
-				{
-					receive_block ();
-				}
-			}
-			else if (stop_pull && block_expected)
-			{
-				expected = pull.end;
-				connection->attempt->pool_connection (connection);
-			}
-			if (stop_pull)
-			{
-				connection->attempt->lazy_stopped++;
-			}
+			expected = pull.end;
+			connection->node->block_processor.add (batch_a);
+			batch_a.clear ();
+			connection->attempt->pool_connection (connection);
 		}
-		else
+		if (stop_pull)
 		{
-			if (connection->node->config.logging.bulk_pull_logging ())
-			{
-				BOOST_LOG (connection->node->log) << "Error deserializing block received from pull request";
-			}
+			connection->attempt->lazy_stopped++;
 		}
 	}
 	else
 	{
 		if (connection->node->config.logging.bulk_pull_logging ())
 		{
-			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Error bulk receiving block: %1%") % ec.message ());
+			BOOST_LOG (connection->node->log) << "Error deserializing block received from pull request";
 		}
 	}
+	return result;
 }
 
 nano::bulk_push_client::bulk_push_client (std::shared_ptr<nano::bootstrap_client> const & connection_a) :
@@ -911,6 +1053,7 @@ attempts (0)
 
 nano::bootstrap_attempt::bootstrap_attempt (std::shared_ptr<nano::node> node_a) :
 next_log (std::chrono::steady_clock::now ()),
+frontier_requests (0),
 connections (0),
 pulling (0),
 node (node_a),
@@ -919,6 +1062,10 @@ total_blocks (0),
 runs_count (0),
 stopped (false),
 mode (nano::bootstrap_mode::legacy),
+lazy_spill (node_a->application_path / boost::str (boost::format ("lazy_bootstrap_%1%.ldb") % nano::random_pool::generate_word32 (0, std::numeric_limits<CryptoPP::word32>::max ())), static_cast<size_t> (node_a->config.lazy_bootstrap_memory_mb) * 1024 * 1024, node_a->log),
+lazy_blocks (lazy_spill, "blocks"),
+lazy_state_unknown (lazy_spill, "state_unknown"),
+lazy_balances (lazy_spill, "balances"),
 lazy_stopped (0)
 {
 	BOOST_LOG (node->log) << "Starting bootstrap attempt";
@@ -944,39 +1091,81 @@ bool nano::bootstrap_attempt::should_log ()
 	return result;
 }
 
-bool nano::bootstrap_attempt::request_frontier (std::unique_lock<std::mutex> & lock_a)
+void nano::bootstrap_attempt::request_frontier (std::unique_lock<std::mutex> & lock_a)
 {
-	auto result (true);
 	auto connection_l (connection (lock_a));
-	connection_frontier_request = connection_l;
-	if (connection_l)
+	if (connection_l && !frontier_ranges.empty ())
 	{
-		std::future<bool> future;
-		{
-			auto client (std::make_shared<nano::frontier_req_client> (connection_l));
-			client->run ();
-			frontiers = client;
-			future = client->promise.get_future ();
-		}
-		lock_a.unlock ();
-		result = consume_future (future); // This is out of scope of `client' so when the last reference via boost::asio::io_context is lost and the client is destroyed, the future throws an exception.
-		lock_a.lock ();
-		if (result)
+		auto range (frontier_ranges.front ());
+		frontier_ranges.pop_front ();
+		++frontier_requests;
+		if (range.second.is_zero ())
 		{
-			pulls.clear ();
+			// Only the last range runs to the end of the peer's frontiers, leaving its connection usable for bulk push
+			connection_frontier_request = connection_l;
 		}
-		if (node->config.logging.network_logging ())
-		{
-			if (!result)
+		// The frontier_req_client destructor reports failed ranges which takes the attempt mutex, construct it outside the lock
+		auto node_l (node);
+		node->background ([node_l, connection_l, range]() {
+			auto age (node_l->bootstrap_initiator.frontier_syncs.age (connection_l->endpoint, range.first));
+			if (node_l->config.logging.network_logging ())
 			{
-				BOOST_LOG (node->log) << boost::str (boost::format ("Completed frontier request, %1% out of sync accounts according to %2%") % pulls.size () % connection_l->endpoint);
+				auto incremental (age != std::numeric_limits<uint32_t>::max ());
+				BOOST_LOG (node_l->log) << boost::str (boost::format ("Requesting %1%frontiers from %2% to %3% from %4%") % (incremental ? boost::str (boost::format ("last %1% seconds of ") % age) : std::string ("")) % range.first.to_account () % (range.second.is_zero () ? std::string ("end") : range.second.to_account ()) % connection_l->endpoint);
 			}
-			else
+			auto client (std::make_shared<nano::frontier_req_client> (connection_l, range.first, range.second, age));
+			client->run ();
+		});
+	}
+}
+
+void nano::bootstrap_attempt::frontier_finished (nano::account const & start_a, nano::account const & end_a, bool error_a)
+{
+	auto retry (false);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		assert (frontier_requests > 0);
+		--frontier_requests;
+		if (error_a && !stopped)
+		{
+			// Ranges keep their end when resumed, it identifies them across attempts
+			retry = ++frontier_range_failures[end_a] < bootstrap_frontier_retry_limit;
+			if (retry)
 			{
-				BOOST_LOG (node->log) << "frontier_req failed, reattempting";
+				frontier_ranges.emplace_back (start_a, end_a);
 			}
 		}
 	}
+	condition.notify_all ();
+	if (node->config.logging.network_logging ())
+	{
+		if (!error_a)
+		{
+			BOOST_LOG (node->log) << boost::str (boost::format ("Completed frontier range from %1%") % start_a.to_account ());
+		}
+		else if (retry)
+		{
+			BOOST_LOG (node->log) << boost::str (boost::format ("Frontier range from %1% failed, reattempting") % start_a.to_account ());
+		}
+		else
+		{
+			BOOST_LOG (node->log) << boost::str (boost::format ("Frontier range from %1% failed %2% times, giving up") % start_a.to_account () % bootstrap_frontier_retry_limit);
+		}
+	}
+}
+
+std::deque<std::pair<nano::account, nano::account>> nano::bootstrap_attempt::frontier_partition (unsigned count_a)
+{
+	assert (count_a > 0);
+	std::deque<std::pair<nano::account, nano::account>> result;
+	nano::uint256_t step (std::numeric_limits<nano::uint256_t>::max () / count_a);
+	nano::uint256_t start (0);
+	for (auto i (0u); i < count_a; ++i)
+	{
+		nano::uint256_t end (i + 1 < count_a ? start + step : nano::uint256_t (0));
+		result.emplace_back (nano::account (start), nano::account (end));
+		start = end;
+	}
 	return result;
 }
 
@@ -992,7 +1181,7 @@ void nano::bootstrap_attempt::request_pull (std::unique_lock<std::mutex> & lock_
 			// Check if pull is obsolete (head was processed)
 			std::unique_lock<std::mutex> lock (lazy_mutex);
 			auto transaction (node->store.tx_begin_read ());
-			while (!pulls.empty () && !pull.head.is_zero () && (lazy_blocks.find (pull.head) != lazy_blocks.end () || node->store.block_exists (transaction, pull.head)))
+			while (!pulls.empty () && !pull.head.is_zero () && (lazy_blocks.exists (pull.head) || node->store.block_exists (transaction, pull.head)))
 			{
 				pull = pulls.front ();
 				pulls.pop_front ();
@@ -1040,33 +1229,25 @@ bool nano::bootstrap_attempt::still_pulling ()
 	auto running (!stopped);
 	auto more_pulls (!pulls.empty ());
 	auto still_pulling (pulling > 0);
-	return running && (more_pulls || still_pulling);
+	auto more_frontiers (!frontier_ranges.empty () || frontier_requests > 0);
+	return running && (more_pulls || still_pulling || more_frontiers);
 }
 
 void nano::bootstrap_attempt::run ()
 {
 	populate_connections ();
 	std::unique_lock<std::mutex> lock (mutex);
-	auto frontier_failure (true);
-	while (!stopped && frontier_failure)
-	{
-		frontier_failure = request_frontier (lock);
-	}
-	// Shuffle pulls.
-	release_assert (std::numeric_limits<CryptoPP::word32>::max () > pulls.size ());
-	if (!pulls.empty ())
-	{
-		for (auto i = static_cast<CryptoPP::word32> (pulls.size () - 1); i > 0; --i)
-		{
-			auto k = nano::random_pool::generate_word32 (0, i);
-			std::swap (pulls[i], pulls[k]);
-		}
-	}
+	// Frontier ranges are compared in parallel, pulls start as soon as a range reports accounts we're behind on
+	frontier_ranges = frontier_partition (std::max (1U, node->config.bootstrap_connections));
 	while (still_pulling ())
 	{
 		while (still_pulling ())
 		{
-			if (!pulls.empty ())
+			if (!frontier_ranges.empty ())
+			{
+				request_frontier (lock);
+			}
+			else if (!pulls.empty ())
 			{
 				if (!node->block_processor.full ())
 				{
@@ -1129,8 +1310,12 @@ std::shared_ptr<nano::bootstrap_client> nano::bootstrap_attempt::connection (std
 	std::shared_ptr<nano::bootstrap_client> result;
 	if (!idle.empty ())
 	{
-		result = idle.back ();
-		idle.pop_back ();
+		// Hand out the best scoring idle connection so pulls, including requeued ones, go to the fastest peers first
+		auto best (std::max_element (idle.begin (), idle.end (), [](std::shared_ptr<nano::bootstrap_client> const & lhs, std::shared_ptr<nano::bootstrap_client> const & rhs) {
+			return lhs->score () < rhs->score ();
+		}));
+		result = *best;
+		idle.erase (best);
 	}
 	return result;
 }
@@ -1149,11 +1334,11 @@ bool nano::bootstrap_attempt::consume_future (std::future<bool> & future_a)
 	return result;
 }
 
-struct block_rate_cmp
+struct score_cmp
 {
 	bool operator() (const std::shared_ptr<nano::bootstrap_client> & lhs, const std::shared_ptr<nano::bootstrap_client> & rhs) const
 	{
-		return lhs->block_rate () > rhs->block_rate ();
+		return lhs->score () > rhs->score ();
 	}
 };
 
@@ -1174,7 +1359,7 @@ void nano::bootstrap_attempt::populate_connections ()
 {
 	double rate_sum = 0.0;
 	size_t num_pulls = 0;
-	std::priority_queue<std::shared_ptr<nano::bootstrap_client>, std::vector<std::shared_ptr<nano::bootstrap_client>>, block_rate_cmp> sorted_connections;
+	std::priority_queue<std::shared_ptr<nano::bootstrap_client>, std::vector<std::shared_ptr<nano::bootstrap_client>>, score_cmp> sorted_connections;
 	std::unordered_set<nano::tcp_endpoint> endpoints;
 	{
 		std::unique_lock<std::mutex> lock (mutex);
@@ -1230,7 +1415,7 @@ void nano::bootstrap_attempt::populate_connections ()
 
 			if (node->config.logging.bulk_pull_logging ())
 			{
-				BOOST_LOG (node->log) << boost::str (boost::format ("Dropping peer with block rate %1%, block count %2% (%3%) ") % client->block_rate () % client->block_count % client->endpoint.address ().to_string ());
+				BOOST_LOG (node->log) << boost::str (boost::format ("Dropping peer with score %1%, block rate %2%, block count %3%, failed pulls %4%/%5% (%6%) ") % client->score () % client->block_rate () % client->block_count % client->error_count % client->pull_count % client->endpoint.address ().to_string ());
 			}
 
 			client->stop (false);
@@ -1272,7 +1457,7 @@ void nano::bootstrap_attempt::populate_connections ()
 	if (!stopped)
 	{
 		std::weak_ptr<nano::bootstrap_attempt> this_w (shared_from_this ());
-		node->alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (1), [this_w]() {
+		node->alarm.add (node->alarm.now () + std::chrono::seconds (1), [this_w]() {
 			if (auto this_l = this_w.lock ())
 			{
 				this_l->populate_connections ();
@@ -1311,16 +1496,6 @@ void nano::bootstrap_attempt::stop ()
 			client->socket->close ();
 		}
 	}
-	if (auto i = frontiers.lock ())
-	{
-		try
-		{
-			i->promise.set_value (true);
-		}
-		catch (std::future_error &)
-		{
-		}
-	}
 	if (auto i = push.lock ())
 	{
 		try
@@ -1381,7 +1556,7 @@ void nano::bootstrap_attempt::lazy_start (nano::block_hash const & hash_a)
 	std::unique_lock<std::mutex> lock (lazy_mutex);
 	// Add start blocks, limit 1024 (32k with disabled legacy bootstrap)
 	size_t max_keys (node->flags.disable_legacy_bootstrap ? 32 * 1024 : 1024);
-	if (lazy_keys.size () < max_keys && lazy_keys.find (hash_a) == lazy_keys.end () && lazy_blocks.find (hash_a) == lazy_blocks.end ())
+	if (lazy_keys.size () < max_keys && lazy_keys.find (hash_a) == lazy_keys.end () && !lazy_blocks.exists (hash_a))
 	{
 		lazy_keys.insert (hash_a);
 		lazy_pulls.push_back (hash_a);
@@ -1392,7 +1567,7 @@ void nano::bootstrap_attempt::lazy_add (nano::block_hash const & hash_a)
 {
 	// Add only unknown blocks
 	assert (!lazy_mutex.try_lock ());
-	if (lazy_blocks.find (hash_a) == lazy_blocks.end ())
+	if (!lazy_blocks.exists (hash_a))
 	{
 		lazy_pulls.push_back (hash_a);
 	}
@@ -1406,7 +1581,7 @@ void nano::bootstrap_attempt::lazy_pull_flush ()
 	for (auto & pull_start : lazy_pulls)
 	{
 		// Recheck if block was already processed
-		if (lazy_blocks.find (pull_start) == lazy_blocks.end () && !node->store.block_exists (transaction, pull_start))
+		if (!lazy_blocks.exists (pull_start) && !node->store.block_exists (transaction, pull_start))
 		{
 			pulls.push_back (nano::pull_info (pull_start, pull_start, nano::block_hash (0), lazy_max_pull_blocks));
 		}
@@ -1448,6 +1623,7 @@ void nano::bootstrap_attempt::lazy_clear ()
 	lazy_pulls.clear ();
 	lazy_state_unknown.clear ();
 	lazy_balances.clear ();
+	lazy_spill.flush ();
 	lazy_stopped = 0;
 }
 
@@ -1524,7 +1700,7 @@ void nano::bootstrap_attempt::lazy_run ()
 	idle.clear ();
 }
 
-bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_a, nano::account const & known_account_a, uint64_t total_blocks, bool block_expected)
+bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_a, nano::account const & known_account_a, uint64_t total_blocks, bool block_expected, std::vector<nano::unchecked_info> & batch_a)
 {
 	bool stop_pull (false);
 	if (mode != nano::bootstrap_mode::legacy && block_expected)
@@ -1532,15 +1708,14 @@ bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_
 		auto hash (block_a->hash ());
 		std::unique_lock<std::mutex> lock (lazy_mutex);
 		// Processing new blocks
-		if (lazy_blocks.find (hash) == lazy_blocks.end ())
+		if (!lazy_blocks.exists (hash))
 		{
 			// Search block in ledger (old)
 			auto transaction (node->store.tx_begin_read ());
 			if (!node->store.block_exists (transaction, block_a->type (), hash))
 			{
 				nano::uint128_t balance (std::numeric_limits<nano::uint128_t>::max ());
-				nano::unchecked_info info (block_a, known_account_a, 0, nano::signature_verification::unknown);
-				node->block_processor.add (info);
+				batch_a.emplace_back (block_a, known_account_a, 0, nano::signature_verification::unknown);
 				// Search for new dependencies
 				if (!block_a->source ().is_zero () && !node->store.block_exists (transaction, block_a->source ()))
 				{
@@ -1563,7 +1738,7 @@ bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_
 						balance = block_l->hashables.balance.number ();
 						nano::block_hash link (block_l->hashables.link);
 						// If link is not epoch link or 0. And if block from link unknown
-						if (!link.is_zero () && link != node->ledger.epoch_link && lazy_blocks.find (link) == lazy_blocks.end () && !node->store.block_exists (transaction, link))
+						if (!link.is_zero () && link != node->ledger.epoch_link && !lazy_blocks.exists (link) && !node->store.block_exists (transaction, link))
 						{
 							nano::block_hash previous (block_l->hashables.previous);
 							// If state block previous is 0 then source block required
@@ -1581,22 +1756,25 @@ bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_
 								}
 							}
 							// Search balance of already processed previous blocks
-							else if (lazy_blocks.find (previous) != lazy_blocks.end ())
+							else if (lazy_blocks.exists (previous))
 							{
-								auto previous_balance (lazy_balances.find (previous));
-								if (previous_balance != lazy_balances.end ())
+								nano::amount previous_balance;
+								if (!lazy_balances.get (previous, previous_balance))
 								{
-									if (previous_balance->second <= balance)
+									if (previous_balance.number () <= balance)
 									{
 										lazy_add (link);
 									}
-									lazy_balances.erase (previous_balance);
+									lazy_balances.erase (previous);
 								}
 							}
 							// Insert in unknown state blocks if previous wasn't already processed
 							else
 							{
-								lazy_state_unknown.insert (std::make_pair (previous, std::make_pair (link, balance)));
+								if (!lazy_state_unknown.exists (previous))
+								{
+									lazy_state_unknown.put (previous, nano::lazy_state_dependency{ link, balance });
+								}
 							}
 						}
 					}
@@ -1605,10 +1783,10 @@ bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_
 				// Adding lazy balances
 				if (total_blocks == 0)
 				{
-					lazy_balances.insert (std::make_pair (hash, balance));
+					lazy_balances.put (hash, balance);
 				}
 				// Removing lazy balances
-				if (!block_a->previous ().is_zero () && lazy_balances.find (block_a->previous ()) != lazy_balances.end ())
+				if (!block_a->previous ().is_zero ())
 				{
 					lazy_balances.erase (block_a->previous ());
 				}
@@ -1625,27 +1803,26 @@ bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_
 				}
 			}
 			//Search unknown state blocks balances
-			auto find_state (lazy_state_unknown.find (hash));
-			if (find_state != lazy_state_unknown.end ())
+			nano::lazy_state_dependency next_block;
+			if (!lazy_state_unknown.get (hash, next_block))
 			{
-				auto next_block (find_state->second);
 				lazy_state_unknown.erase (hash);
 				// Retrieve balance for previous state blocks
 				if (block_a->type () == nano::block_type::state)
 				{
 					std::shared_ptr<nano::state_block> block_l (std::static_pointer_cast<nano::state_block> (block_a));
-					if (block_l->hashables.balance.number () <= next_block.second)
+					if (block_l->hashables.balance.number () <= next_block.balance.number ())
 					{
-						lazy_add (next_block.first);
+						lazy_add (next_block.link);
 					}
 				}
 				// Retrieve balance for previous legacy send blocks
 				else if (block_a->type () == nano::block_type::send)
 				{
 					std::shared_ptr<nano::send_block> block_l (std::static_pointer_cast<nano::send_block> (block_a));
-					if (block_l->hashables.balance.number () <= next_block.second)
+					if (block_l->hashables.balance.number () <= next_block.balance.number ())
 					{
-						lazy_add (next_block.first);
+						lazy_add (next_block.link);
 					}
 				}
 				// Weak assumption for other legacy block types
@@ -1666,6 +1843,8 @@ bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_
 				stop_pull = true;
 			}
 		}
+		// Commit this block's spilled writes in one transaction before releasing the lock
+		lazy_spill.flush ();
 	}
 	else if (mode != nano::bootstrap_mode::legacy)
 	{
@@ -1674,8 +1853,7 @@ bool nano::bootstrap_attempt::process_block (std::shared_ptr<nano::block> block_
 	}
 	else
 	{
-		nano::unchecked_info info (block_a, known_account_a, 0, nano::signature_verification::unknown);
-		node->block_processor.add (info);
+		batch_a.emplace_back (block_a, known_account_a, 0, nano::signature_verification::unknown);
 	}
 	return stop_pull;
 }
@@ -1756,6 +1934,55 @@ void nano::bootstrap_attempt::wallet_run ()
 	idle.clear ();
 }
 
+uint32_t nano::frontier_sync_cache::age (nano::tcp_endpoint const & endpoint_a, nano::account const & start_a)
+{
+	auto result (std::numeric_limits<uint32_t>::max ());
+	auto now (nano::seconds_since_epoch ());
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (entries.find (std::make_pair (endpoint_a, start_a)));
+	if (existing != entries.end () && now < existing->second.full + full_interval && existing->second.last <= now)
+	{
+		result = static_cast<uint32_t> (now - existing->second.last + margin);
+	}
+	return result;
+}
+
+void nano::frontier_sync_cache::synced (nano::tcp_endpoint const & endpoint_a, nano::account const & start_a, uint64_t time_a, bool full_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (entries.find (std::make_pair (endpoint_a, start_a)));
+	if (existing != entries.end ())
+	{
+		existing->second.last = time_a;
+		if (full_a)
+		{
+			existing->second.full = time_a;
+		}
+	}
+	else if (full_a)
+	{
+		if (entries.size () >= max_entries)
+		{
+			// Peers come and go, entries past their full interval would be compared in full anyway
+			auto now (nano::seconds_since_epoch ());
+			for (auto i (entries.begin ()), n (entries.end ()); i != n;)
+			{
+				i = now >= i->second.full + full_interval ? entries.erase (i) : std::next (i);
+			}
+		}
+		if (entries.size () < max_entries)
+		{
+			entries[std::make_pair (endpoint_a, start_a)] = { time_a, time_a };
+		}
+	}
+}
+
+size_t nano::frontier_sync_cache::size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return entries.size ();
+}
+
 nano::bootstrap_initiator::bootstrap_initiator (nano::node & node_a) :
 node (node_a),
 stopped (false),
@@ -1764,6 +1991,8 @@ thread ([this]() {
 	run_bootstrap ();
 })
 {
+	// Lazy attempts from a previous run that didn't shut down cleanly
+	nano::spill_store::remove_stale (node.application_path, "lazy_bootstrap_");
 }
 
 nano::bootstrap_initiator::~bootstrap_initiator ()
@@ -1916,14 +2145,30 @@ namespace nano
 std::unique_ptr<seq_con_info_component> collect_seq_con_info (bootstrap_initiator & bootstrap_initiator, const std::string & name)
 {
 	size_t count = 0;
+	std::shared_ptr<nano::bootstrap_attempt> attempt;
 	{
 		std::lock_guard<std::mutex> guard (bootstrap_initiator.mutex);
 		count = bootstrap_initiator.observers.size ();
+		attempt = bootstrap_initiator.attempt;
 	}
 
 	auto sizeof_element = sizeof (decltype (bootstrap_initiator.observers)::value_type);
 	auto composite = std::make_unique<seq_con_info_composite> (name);
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "observers", count, sizeof_element }));
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "frontier_syncs", bootstrap_initiator.frontier_syncs.size (), sizeof (std::pair<nano::tcp_endpoint, nano::account>) + 2 * sizeof (uint64_t) }));
+	if (attempt != nullptr)
+	{
+		std::lock_guard<std::mutex> lazy_guard (attempt->lazy_mutex);
+		// Spilled entries live in the temporary LMDB file, they're reported with the size of their in-memory slot for comparison
+		composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "lazy_blocks", attempt->lazy_blocks.memory_count (), sizeof (nano::spill_map<uint8_t>::entry) }));
+		composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "lazy_blocks_spilled", attempt->lazy_blocks.spilled (), sizeof (nano::spill_map<uint8_t>::entry) }));
+		composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "lazy_state_unknown", attempt->lazy_state_unknown.memory_count (), sizeof (decltype (attempt->lazy_state_unknown)::entry) }));
+		composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "lazy_state_unknown_spilled", attempt->lazy_state_unknown.spilled (), sizeof (decltype (attempt->lazy_state_unknown)::entry) }));
+		composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "lazy_balances", attempt->lazy_balances.memory_count (), sizeof (decltype (attempt->lazy_balances)::entry) }));
+		composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "lazy_balances_spilled", attempt->lazy_balances.spilled (), sizeof (decltype (attempt->lazy_balances)::entry) }));
+		composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "lazy_keys", attempt->lazy_keys.size (), sizeof (decltype (attempt->lazy_keys)::value_type) }));
+		composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "lazy_pulls", attempt->lazy_pulls.size (), sizeof (decltype (attempt->lazy_pulls)::value_type) }));
+	}
 	return composite;
 }
 }
@@ -1957,10 +2202,12 @@ void nano::bootstrap_listener::start ()
 void nano::bootstrap_listener::stop ()
 {
 	decltype (connections) connections_l;
+	decltype (realtime_connections) realtime_connections_l;
 	{
 		std::lock_guard<std::mutex> lock (mutex);
 		on = false;
 		connections_l.swap (connections);
+		realtime_connections_l.swap (realtime_connections);
 	}
 	acceptor.close ();
 	for (auto & i : connections_l)
@@ -1971,6 +2218,14 @@ void nano::bootstrap_listener::stop ()
 			connection->socket->close ();
 		}
 	}
+	for (auto & i : realtime_connections_l)
+	{
+		auto connection (i.second.lock ());
+		if (connection)
+		{
+			connection->socket->close ();
+		}
+	}
 }
 
 void nano::bootstrap_listener::accept_connection ()
@@ -2025,6 +2280,19 @@ void nano::bootstrap_listener::accept_action (boost::system::error_code const &
 	}
 }
 
+bool nano::bootstrap_listener::promote_realtime (nano::bootstrap_server * connection_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (connections.find (connection_a));
+	auto error (existing == connections.end () || realtime_connections.size () >= node.config.tcp_realtime_connections_max);
+	if (!error)
+	{
+		realtime_connections.insert (*existing);
+		connections.erase (existing);
+	}
+	return error;
+}
+
 boost::asio::ip::tcp::endpoint nano::bootstrap_listener::endpoint ()
 {
 	return boost::asio::ip::tcp::endpoint (boost::asio::ip::address_v6::loopback (), local.port ());
@@ -2035,14 +2303,17 @@ namespace nano
 std::unique_ptr<seq_con_info_component> collect_seq_con_info (bootstrap_listener & bootstrap_listener, const std::string & name)
 {
 	size_t count = 0;
+	size_t realtime_count = 0;
 	{
 		std::lock_guard<std::mutex> guard (bootstrap_listener.mutex);
 		count = bootstrap_listener.connections.size ();
+		realtime_count = bootstrap_listener.realtime_connections.size ();
 	}
 
 	auto sizeof_element = sizeof (decltype (bootstrap_listener.connections)::value_type);
 	auto composite = std::make_unique<seq_con_info_composite> (name);
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "connections", count, sizeof_element }));
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "realtime_connections", realtime_count, sizeof_element }));
 	return composite;
 }
 }
@@ -2055,12 +2326,14 @@ nano::bootstrap_server::~bootstrap_server ()
 	}
 	std::lock_guard<std::mutex> lock (node->bootstrap.mutex);
 	node->bootstrap.connections.erase (this);
+	node->bootstrap.realtime_connections.erase (this);
 }
 
 nano::bootstrap_server::bootstrap_server (std::shared_ptr<nano::socket> socket_a, std::shared_ptr<nano::node> node_a) :
 receive_buffer (std::make_shared<std::vector<uint8_t>> ()),
 socket (socket_a),
-node (node_a)
+node (node_a),
+realtime (false)
 {
 	receive_buffer->resize (512);
 }
@@ -2123,10 +2396,53 @@ void nano::bootstrap_server::receive_header_action (boost::system::error_code co
 				{
 					auto this_l (shared_from_this ());
 					socket->async_read (receive_buffer, header.payload_length_bytes (), [this_l, header](boost::system::error_code const & ec, size_t size_a) {
-						this_l->receive_keepalive_action (ec, size_a, header);
+						if (this_l->realtime)
+						{
+							this_l->receive_realtime_action (ec, size_a, header);
+						}
+						else
+						{
+							this_l->receive_keepalive_action (ec, size_a, header);
+						}
 					});
 					break;
 				}
+				case nano::message_type::node_id_handshake:
+				{
+					if (node->config.tcp_realtime && header.payload_length_bytes () > 0)
+					{
+						auto this_l (shared_from_this ());
+						socket->async_read (receive_buffer, header.payload_length_bytes (), [this_l, header](boost::system::error_code const & ec, size_t size_a) {
+							if (this_l->realtime)
+							{
+								this_l->receive_realtime_action (ec, size_a, header);
+							}
+							else
+							{
+								this_l->receive_node_id_handshake_action (ec, size_a, header);
+							}
+						});
+					}
+					break;
+				}
+				case nano::message_type::publish:
+				case nano::message_type::confirm_req:
+				case nano::message_type::confirm_ack:
+				{
+					auto size (header.payload_length_bytes ());
+					if (realtime && size > 0 && size <= receive_buffer->size ())
+					{
+						auto this_l (shared_from_this ());
+						socket->async_read (receive_buffer, size, [this_l, header](boost::system::error_code const & ec, size_t size_a) {
+							this_l->receive_realtime_action (ec, size_a, header);
+						});
+					}
+					else if (node->config.logging.network_logging ())
+					{
+						BOOST_LOG (node->log) << boost::str (boost::format ("Received unexpected realtime message type %1% from bootstrap connection") % static_cast<uint8_t> (header.type));
+					}
+					break;
+				}
 				default:
 				{
 					if (node->config.logging.network_logging ())
@@ -2208,6 +2524,97 @@ void nano::bootstrap_server::receive_keepalive_action (boost::system::error_code
 	}
 }
 
+void nano::bootstrap_server::receive_node_id_handshake_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a)
+{
+	if (!ec)
+	{
+		auto error (false);
+		nano::bufferstream stream (receive_buffer->data (), size_a);
+		nano::node_id_handshake request (error, stream, header_a);
+		if (!error)
+		{
+			node->stats.inc (nano::stat::type::message, nano::stat::detail::node_id_handshake, nano::stat::dir::in);
+			auto remote (socket->remote_endpoint ());
+			auto remote_l (nano::map_endpoint_to_v6 (nano::endpoint (remote.address (), remote.port ())));
+			if (request.query && !request.response && !realtime_cookie)
+			{
+				// Answer the query and challenge the remote node with our own cookie in the same message
+				realtime_cookie = node->peers.assign_syn_cookie (remote_l);
+				if (realtime_cookie)
+				{
+					auto response (std::make_pair (node->node_id.pub, nano::sign_message (node->node_id.prv, node->node_id.pub, *request.query)));
+					nano::node_id_handshake message (realtime_cookie, response);
+					auto bytes (message.to_bytes ());
+					node->stats.inc (nano::stat::type::message, nano::stat::detail::node_id_handshake, nano::stat::dir::out);
+					auto this_l (shared_from_this ());
+					socket->async_write (bytes, [this_l](boost::system::error_code const & ec, size_t size_a) {
+						if (!ec)
+						{
+							this_l->receive ();
+						}
+					});
+				}
+			}
+			else if (request.response && !request.query && realtime_cookie)
+			{
+				auto endpoint_l (node->peers.node_id_endpoint (request.response->first));
+				auto valid (!node->peers.validate_syn_cookie (remote_l, request.response->first, request.response->second) && endpoint_l);
+				if (valid && node->bootstrap.promote_realtime (this))
+				{
+					if (node->config.logging.network_node_id_handshake_logging ())
+					{
+						BOOST_LOG (node->log) << boost::str (boost::format ("Rejecting TCP realtime channel from %1%, limit of %2% reached") % remote_l % node->config.tcp_realtime_connections_max);
+					}
+				}
+				else if (valid)
+				{
+					realtime = true;
+					realtime_endpoint = *endpoint_l;
+					// Realtime connections are idle between messages, only time out if the peer went quiet
+					socket->io_timeout = nano::node::cutoff;
+					receive_buffer->resize (nano::message_parser::max_tcp_realtime_message_size);
+					node->stats.inc (nano::stat::type::tcp, nano::stat::detail::handshake, nano::stat::dir::in);
+					if (node->config.logging.network_node_id_handshake_logging ())
+					{
+						BOOST_LOG (node->log) << boost::str (boost::format ("TCP realtime channel accepted from %1% with node ID %2%") % realtime_endpoint % request.response->first.to_account ());
+					}
+					receive ();
+				}
+				else if (node->config.logging.network_node_id_handshake_logging ())
+				{
+					BOOST_LOG (node->log) << boost::str (boost::format ("Failed to validate TCP realtime handshake from %1%") % remote_l);
+				}
+			}
+		}
+	}
+}
+
+void nano::bootstrap_server::receive_realtime_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a)
+{
+	if (!ec)
+	{
+		std::vector<uint8_t> bytes;
+		{
+			nano::vectorstream stream (bytes);
+			header_a.serialize (stream);
+		}
+		bytes.insert (bytes.end (), receive_buffer->begin (), receive_buffer->begin () + size_a);
+		node->stats.inc (nano::stat::type::tcp, nano::stat::dir::in);
+		if (!node->network.receive_tcp_realtime (bytes.data (), bytes.size (), realtime_endpoint))
+		{
+			receive ();
+		}
+		else if (node->config.logging.network_logging ())
+		{
+			BOOST_LOG (node->log) << boost::str (boost::format ("Invalid realtime message from %1%, closing connection") % realtime_endpoint);
+		}
+	}
+	else if (node->config.logging.network_logging ())
+	{
+		BOOST_LOG (node->log) << boost::str (boost::format ("Error receiving realtime message from %1%: %2%") % realtime_endpoint % ec.message ());
+	}
+}
+
 void nano::bootstrap_server::receive_frontier_req_action (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a)
 {
 	if (!ec)
@@ -2219,7 +2626,7 @@ void nano::bootstrap_server::receive_frontier_req_action (boost::system::error_c
 		{
 			if (node->config.logging.bulk_pull_logging ())
 			{
-				BOOST_LOG (node->log) << boost::str (boost::format ("Received frontier request for %1% with age %2%") % request->start.to_string () % request->age);
+				BOOST_LOG (node->log) << boost::str (boost::format ("Received frontier request for %1% to %2% with age %3%") % request->start.to_string () % (request->end.is_zero () ? std::string ("end") : request->end.to_string ()) % request->age);
 			}
 			add_request (std::unique_ptr<nano::message> (request.release ()));
 			receive ();
@@ -2424,30 +2831,65 @@ void nano::bulk_pull_server::set_current_end ()
 
 void nano::bulk_pull_server::send_next ()
 {
-	auto block (get_next ());
-	if (block != nullptr)
+	if (next_buffer->empty ())
 	{
+		fill (*next_buffer);
+	}
+	std::swap (send_buffer, next_buffer);
+	auto this_l (shared_from_this ());
+	connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
+		this_l->sent_action (ec, size_a);
+	});
+	// Read ahead from the store while the socket is busy
+	next_buffer->clear ();
+	if (!finished)
+	{
+		fill (*next_buffer);
+	}
+}
+
+void nano::bulk_pull_server::fill (std::vector<uint8_t> & buffer_a)
+{
+	buffer_a.clear ();
+	{
+		nano::vectorstream stream (buffer_a);
+		size_t size (0);
+		auto transaction (connection->node->store.tx_begin_read ());
+		while (!finished && size < nano::bootstrap_send_buffer_size)
 		{
-			send_buffer->clear ();
-			nano::vectorstream stream (*send_buffer);
-			nano::serialize_block (stream, *block);
-		}
-		auto this_l (shared_from_this ());
-		if (connection->node->config.logging.bulk_pull_logging ())
-		{
-			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ());
+			auto block (get_next (transaction));
+			if (block != nullptr)
+			{
+				if (connection->node->config.logging.bulk_pull_logging ())
+				{
+					BOOST_LOG (connection->node->log) << boost::str (boost::format ("Sending block: %1%") % block->hash ().to_string ());
+				}
+				nano::serialize_block (stream, *block);
+				size += sizeof (nano::block_type) + nano::block::size (block->type ());
+			}
+			else
+			{
+				if (connection->node->config.logging.bulk_pull_logging ())
+				{
+					BOOST_LOG (connection->node->log) << "Bulk sending finished";
+				}
+				finished = true;
+			}
 		}
-		connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
-			this_l->sent_action (ec, size_a);
-		});
 	}
-	else
+	if (finished)
 	{
-		send_finished ();
+		buffer_a.push_back (static_cast<uint8_t> (nano::block_type::not_a_block));
 	}
 }
 
 std::shared_ptr<nano::block> nano::bulk_pull_server::get_next ()
+{
+	auto transaction (connection->node->store.tx_begin_read ());
+	return get_next (transaction);
+}
+
+std::shared_ptr<nano::block> nano::bulk_pull_server::get_next (nano::transaction const & transaction_a)
 {
 	std::shared_ptr<nano::block> result;
 	bool send_current = false, set_current_to_end = false;
@@ -2488,8 +2930,7 @@ std::shared_ptr<nano::block> nano::bulk_pull_server::get_next ()
 
 	if (send_current)
 	{
-		auto transaction (connection->node->store.tx_begin_read ());
-		result = connection->node->store.block_get (transaction, current);
+		result = connection->node->store.block_get (transaction_a, current);
 		if (result != nullptr && set_current_to_end == false)
 		{
 			auto previous (result->previous ());
@@ -2523,43 +2964,21 @@ void nano::bulk_pull_server::sent_action (boost::system::error_code const & ec,
 {
 	if (!ec)
 	{
-		send_next ();
-	}
-	else
-	{
-		if (connection->node->config.logging.bulk_pull_logging ())
+		if (!next_buffer->empty ())
 		{
-			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Unable to bulk send block: %1%") % ec.message ());
+			send_next ();
+		}
+		else
+		{
+			// The buffer just written ended with not_a_block
+			connection->finish_request ();
 		}
-	}
-}
-
-void nano::bulk_pull_server::send_finished ()
-{
-	send_buffer->clear ();
-	send_buffer->push_back (static_cast<uint8_t> (nano::block_type::not_a_block));
-	auto this_l (shared_from_this ());
-	if (connection->node->config.logging.bulk_pull_logging ())
-	{
-		BOOST_LOG (connection->node->log) << "Bulk sending finished";
-	}
-	connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
-		this_l->no_block_sent (ec, size_a);
-	});
-}
-
-void nano::bulk_pull_server::no_block_sent (boost::system::error_code const & ec, size_t size_a)
-{
-	if (!ec)
-	{
-		assert (size_a == 1);
-		connection->finish_request ();
 	}
 	else
 	{
 		if (connection->node->config.logging.bulk_pull_logging ())
 		{
-			BOOST_LOG (connection->node->log) << "Unable to send not-a-block";
+			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Unable to bulk send block: %1%") % ec.message ());
 		}
 	}
 }
@@ -2567,7 +2986,9 @@ void nano::bulk_pull_server::no_block_sent (boost::system::error_code const & ec
 nano::bulk_pull_server::bulk_pull_server (std::shared_ptr<nano::bootstrap_server> const & connection_a, std::unique_ptr<nano::bulk_pull> request_a) :
 connection (connection_a),
 request (std::move (request_a)),
-send_buffer (std::make_shared<std::vector<uint8_t>> ())
+send_buffer (std::make_shared<std::vector<uint8_t>> ()),
+next_buffer (std::make_shared<std::vector<uint8_t>> ()),
+finished (false)
 {
 	set_current_end ();
 }
@@ -2614,10 +3035,22 @@ void nano::bulk_pull_account_server::set_params ()
 	}
 
 	/*
-	 * Initialize the current item from the requested account
+	 * Entries are sent largest first from the amount index, which
+	 * lets the stream stop at the requested minimum.  Until the
+	 * store reaches version 15 the index may be incomplete, so the
+	 * pending table is scanned in hash order instead.
 	 */
-	current_key.account = request->account;
-	current_key.hash = 0;
+	{
+		auto transaction (connection->node->store.tx_begin_read ());
+		indexed = connection->node->store.version_get (transaction) >= 15;
+	}
+
+	/*
+	 * Initialize the current item from the requested account, the
+	 * amount index starts at its largest pending entry
+	 */
+	current_key = nano::pending_amount_key (request->account, std::numeric_limits<nano::uint128_t>::max (), 0);
+	current_pending_key = nano::pending_key (request->account, 0);
 }
 
 void nano::bulk_pull_account_server::send_frontier ()
@@ -2749,21 +3182,42 @@ std::pair<std::unique_ptr<nano::pending_key>, std::unique_ptr<nano::pending_info
 		 * database for a prolonged period.
 		 */
 		auto stream_transaction (connection->node->store.tx_begin_read ());
-		auto stream (connection->node->store.pending_begin (stream_transaction, current_key));
-
-		if (stream == nano::store_iterator<nano::pending_key, nano::pending_info> (nullptr))
+		nano::pending_key key;
+		nano::pending_info info;
+		if (indexed)
 		{
-			break;
+			auto stream (connection->node->store.pending_amount_begin (stream_transaction, current_key));
+
+			if (stream == connection->node->store.pending_amount_end ())
+			{
+				break;
+			}
+
+			nano::pending_amount_key amount_key (stream->first);
+			key = nano::pending_key (amount_key.account, amount_key.hash);
+			info = nano::pending_info (stream->second, amount_key.amount (), nano::epoch::unspecified);
+
+			/*
+			 * Get the key for the next value, to use in the next call or iteration
+			 */
+			current_key = amount_key;
+			current_key.hash = amount_key.hash.number () + 1;
 		}
+		else
+		{
+			auto stream (connection->node->store.pending_begin (stream_transaction, current_pending_key));
 
-		nano::pending_key key (stream->first);
-		nano::pending_info info (stream->second);
+			if (stream == connection->node->store.pending_end ())
+			{
+				break;
+			}
 
-		/*
-		 * Get the key for the next value, to use in the next call or iteration
-		 */
-		current_key.account = key.account;
-		current_key.hash = key.hash.number () + 1;
+			key = stream->first;
+			info = stream->second;
+
+			current_pending_key.account = key.account;
+			current_pending_key.hash = key.hash.number () + 1;
+		}
 
 		/*
 		 * Finish up if the response is for a different account
@@ -2775,10 +3229,15 @@ std::pair<std::unique_ptr<nano::pending_key>, std::unique_ptr<nano::pending_info
 
 		/*
 		 * Skip entries where the amount is less than the requested
-		 * minimum
+		 * minimum.  The amount index is ordered by descending amount
+		 * so every remaining entry is less too.
 		 */
-		if (info.amount < request->minimum_amount)
+		if (info.amount.number () < request->minimum_amount.number ())
 		{
+			if (indexed)
+			{
+				break;
+			}
 			continue;
 		}
 
@@ -2907,7 +3366,7 @@ nano::bulk_pull_account_server::bulk_pull_account_server (std::shared_ptr<nano::
 connection (connection_a),
 request (std::move (request_a)),
 send_buffer (std::make_shared<std::vector<uint8_t>> ()),
-current_key (0, 0)
+indexed (false)
 {
 	/*
 	 * Setup the streaming response for the first call to "send_frontier" and  "send_next_block"
@@ -3039,6 +3498,8 @@ current (request_a->start.number () - 1),
 frontier (0),
 request (std::move (request_a)),
 send_buffer (std::make_shared<std::vector<uint8_t>> ()),
+next_buffer (std::make_shared<std::vector<uint8_t>> ()),
+finished (false),
 count (0)
 {
 	next ();
@@ -3046,60 +3507,52 @@ count (0)
 
 void nano::frontier_req_server::send_next ()
 {
-	if (!current.is_zero () && count <= request->count)
+	if (next_buffer->empty ())
 	{
-		{
-			send_buffer->clear ();
-			nano::vectorstream stream (*send_buffer);
-			write (stream, current.bytes);
-			write (stream, frontier.bytes);
-		}
-		auto this_l (shared_from_this ());
-		if (connection->node->config.logging.bulk_pull_logging ())
-		{
-			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Sending frontier for %1% %2%") % current.to_account () % frontier.to_string ());
-		}
-		next ();
-		connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
-			this_l->sent_action (ec, size_a);
-		});
-	}
-	else
-	{
-		send_finished ();
-	}
-}
-
-void nano::frontier_req_server::send_finished ()
-{
-	{
-		send_buffer->clear ();
-		nano::vectorstream stream (*send_buffer);
-		nano::uint256_union zero (0);
-		write (stream, zero.bytes);
-		write (stream, zero.bytes);
+		fill (*next_buffer);
 	}
+	std::swap (send_buffer, next_buffer);
 	auto this_l (shared_from_this ());
-	if (connection->node->config.logging.network_logging ())
-	{
-		BOOST_LOG (connection->node->log) << "Frontier sending finished";
-	}
 	connection->socket->async_write (send_buffer, [this_l](boost::system::error_code const & ec, size_t size_a) {
-		this_l->no_block_sent (ec, size_a);
+		this_l->sent_action (ec, size_a);
 	});
+	// Read ahead from the store while the socket is busy
+	next_buffer->clear ();
+	if (!finished)
+	{
+		fill (*next_buffer);
+	}
 }
 
-void nano::frontier_req_server::no_block_sent (boost::system::error_code const & ec, size_t size_a)
+void nano::frontier_req_server::fill (std::vector<uint8_t> & buffer_a)
 {
-	if (!ec)
-	{
-		connection->finish_request ();
-	}
-	else
+	buffer_a.clear ();
+	nano::vectorstream stream (buffer_a);
+	size_t size (0);
+	while (!finished && size < nano::bootstrap_send_buffer_size)
 	{
-		if (connection->node->config.logging.network_logging ())
+		if (!current.is_zero () && count <= request->count)
 		{
-			BOOST_LOG (connection->node->log) << boost::str (boost::format ("Error sending frontier finish: %1%") % ec.message ());
+			if (connection->node->config.logging.bulk_pull_logging ())
+			{
+				BOOST_LOG (connection->node->log) << boost::str (boost::format ("Sending frontier for %1% %2%") % current.to_account () % frontier.to_string ());
+			}
+			write (stream, current.bytes);
+			write (stream, frontier.bytes);
+			size += nano::frontier_req_client::size_frontier;
+			++count;
+			next ();
+		}
+		else
+		{
+			if (connection->node->config.logging.network_logging ())
+			{
+				BOOST_LOG (connection->node->log) << "Frontier sending finished";
+			}
+			nano::uint256_union zero (0);
+			write (stream, zero.bytes);
+			write (stream, zero.bytes);
+			finished = true;
 		}
 	}
 }
@@ -3108,8 +3561,15 @@ void nano::frontier_req_server::sent_action (boost::system::error_code const & e
 {
 	if (!ec)
 	{
-		count++;
-		send_next ();
+		if (!next_buffer->empty ())
+		{
+			send_next ();
+		}
+		else
+		{
+			// The buffer just written ended with the zero pair
+			connection->finish_request ();
+		}
 	}
 	else
 	{
@@ -3127,19 +3587,26 @@ void nano::frontier_req_server::next ()
 	{
 		auto now (nano::seconds_since_epoch ());
 		bool skip_old (request->age != std::numeric_limits<decltype (request->age)>::max ());
-		size_t max_size (128);
+		// Enough accounts to fill a send buffer under one read transaction
+		size_t max_size (nano::bootstrap_send_buffer_size / nano::frontier_req_client::size_frontier);
+		auto past_end (false);
 		auto transaction (connection->node->store.tx_begin_read ());
-		for (auto i (connection->node->store.latest_begin (transaction, current.number () + 1)), n (connection->node->store.latest_end ()); i != n && accounts.size () != max_size; ++i)
+		for (auto i (connection->node->store.latest_begin (transaction, current.number () + 1)), n (connection->node->store.latest_end ()); i != n && accounts.size () != max_size && !past_end; ++i)
 		{
-			nano::account_info info (i->second);
-			if (!skip_old || (now - info.modified) <= request->age)
+			nano::account account (i->first);
+			past_end = !request->end.is_zero () && account.number () >= request->end.number ();
+			if (!past_end)
 			{
-				accounts.push_back (std::make_pair (nano::account (i->first), info.head));
+				nano::account_info info (i->second);
+				if (!skip_old || (now - info.modified) <= request->age)
+				{
+					accounts.push_back (std::make_pair (account, info.head));
+				}
 			}
 		}
-		/* If loop breaks before max_size, then latest_end () is reached
+		/* If loop breaks before max_size, then latest_end () or the end of the requested range is reached
 		Add empty record to finish frontier_req_server */
-		if (accounts.size () != max_size)
+		if (past_end || accounts.size () != max_size)
 		{
 			accounts.push_back (std::make_pair (nano::account (0), nano::block_hash (0)));
 		}
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <nano/node/common.hpp>
+#include <nano/node/spill.hpp>
 #include <nano/secure/blockstore.hpp>
 #include <nano/secure/ledger.hpp>
 
 #include <atomic>
 #include <future>
+#include <map>
 #include <queue>
 #include <stack>
 #include <unordered_set>
@@ -30,6 +32,8 @@ public:
 	socket (std::shared_ptr<nano::node>);
 	void async_connect (nano::tcp_endpoint const &, std::function<void(boost::system::error_code const &)>);
 	void async_read (std::shared_ptr<std::vector<uint8_t>>, size_t, std::function<void(boost::system::error_code const &, size_t)>);
+	// Reads whatever is available, up to size bytes, into the buffer starting at offset
+	void async_read_some (std::shared_ptr<std::vector<uint8_t>>, size_t offset, size_t size, std::function<void(boost::system::error_code const &, size_t)>);
 	void async_write (std::shared_ptr<std::vector<uint8_t>>, std::function<void(boost::system::error_code const &, size_t)>);
 	void start (std::chrono::steady_clock::time_point = std::chrono::steady_clock::now () + std::chrono::seconds (5));
 	void stop ();
@@ -37,6 +41,8 @@ public:
 	void checkup ();
 	nano::tcp_endpoint remote_endpoint ();
 	boost::asio::ip::tcp::socket socket_m;
+	// Maximum duration of a single read or write before the socket is closed
+	std::chrono::seconds io_timeout;
 
 private:
 	std::atomic<uint64_t> cutoff;
@@ -48,6 +54,10 @@ private:
  * The 2 here represents the size of a std::bitset<16>, which is 2 chars long normally
  */
 static const int bootstrap_message_header_size = sizeof (nano::message_header::magic_number) + sizeof (uint8_t) + sizeof (uint8_t) + sizeof (uint8_t) + sizeof (nano::message_type) + 2;
+// Bulk pull and frontier servers batch their responses into writes of about this size
+static const size_t bootstrap_send_buffer_size = 64 * 1024;
+// Bulk pull clients read responses in chunks of up to this size
+static const size_t bootstrap_receive_buffer_size = 64 * 1024;
 
 class bootstrap_client;
 class pull_info
@@ -71,6 +81,12 @@ enum class bootstrap_mode
 class frontier_req_client;
 class bulk_push_client;
 class bulk_pull_account_client;
+class lazy_state_dependency
+{
+public:
+	nano::block_hash link;
+	nano::amount balance;
+};
 class bootstrap_attempt : public std::enable_shared_from_this<bootstrap_attempt>
 {
 public:
@@ -80,7 +96,12 @@ public:
 	std::shared_ptr<nano::bootstrap_client> connection (std::unique_lock<std::mutex> &);
 	bool consume_future (std::future<bool> &);
 	void populate_connections ();
-	bool request_frontier (std::unique_lock<std::mutex> &);
+	// Requests the next pending frontier range from an idle connection
+	void request_frontier (std::unique_lock<std::mutex> &);
+	// Called once per frontier range request, a failed range is queued again from the first account not yet received until it reaches the retry limit
+	void frontier_finished (nano::account const &, nano::account const &, bool);
+	// Splits the account space into equal ranges [start, end), a zero end is the end of the account space
+	static std::deque<std::pair<nano::account, nano::account>> frontier_partition (unsigned);
 	void request_pull (std::unique_lock<std::mutex> &);
 	void request_push (std::unique_lock<std::mutex> &);
 	void add_connection (nano::endpoint const &);
@@ -92,7 +113,8 @@ public:
 	unsigned target_connections (size_t pulls_remaining);
 	bool should_log ();
 	void add_bulk_push_target (nano::block_hash const &, nano::block_hash const &);
-	bool process_block (std::shared_ptr<nano::block>, nano::account const &, uint64_t, bool);
+	// Blocks to process are appended to the batch, which the caller passes on to the block processor
+	bool process_block (std::shared_ptr<nano::block>, nano::account const &, uint64_t, bool, std::vector<nano::unchecked_info> &);
 	void lazy_run ();
 	void lazy_start (nano::block_hash const &);
 	void lazy_add (nano::block_hash const &);
@@ -106,8 +128,14 @@ public:
 	bool wallet_finished ();
 	std::chrono::steady_clock::time_point next_log;
 	std::deque<std::weak_ptr<nano::bootstrap_client>> clients;
+	// Connection that served the last frontier range, bulk push targets are sent to it
 	std::weak_ptr<nano::bootstrap_client> connection_frontier_request;
-	std::weak_ptr<nano::frontier_req_client> frontiers;
+	// Frontier ranges waiting for a connection
+	std::deque<std::pair<nano::account, nano::account>> frontier_ranges;
+	// Frontier range requests in progress
+	unsigned frontier_requests;
+	// Failed requests per range end, a range is dropped for this attempt after bootstrap_frontier_retry_limit
+	std::unordered_map<nano::account, unsigned> frontier_range_failures;
 	std::weak_ptr<nano::bulk_push_client> push;
 	std::deque<nano::pull_info> pulls;
 	std::deque<std::shared_ptr<nano::bootstrap_client>> idle;
@@ -123,9 +151,12 @@ public:
 	std::mutex mutex;
 	std::condition_variable condition;
 	// Lazy bootstrap
-	std::unordered_set<nano::block_hash> lazy_blocks;
-	std::unordered_map<nano::block_hash, std::pair<nano::block_hash, nano::uint128_t>> lazy_state_unknown;
-	std::unordered_map<nano::block_hash, nano::uint128_t> lazy_balances;
+	// Memory budget shared by lazy_blocks, lazy_state_unknown and lazy_balances. lazy_keys is capped by count and lazy_pulls is drained every loop
+	nano::spill_store lazy_spill;
+	nano::spill_set lazy_blocks;
+	// State blocks whose subtype is unknown until their previous block arrives, keyed by previous
+	nano::spill_map<nano::lazy_state_dependency> lazy_state_unknown;
+	nano::spill_map<nano::amount> lazy_balances;
 	std::unordered_set<nano::block_hash> lazy_keys;
 	std::deque<nano::block_hash> lazy_pulls;
 	std::atomic<uint64_t> lazy_stopped;
@@ -135,24 +166,42 @@ public:
 	// Wallet lazy bootstrap
 	std::deque<nano::account> wallet_accounts;
 };
+/**
+ * Compares the frontiers of accounts in [start, end) with a peer, queuing pulls for accounts the peer is ahead on as they're received.
+ * A zero end covers the rest of the account space. Several clients can scan disjoint ranges in parallel.
+ */
 class frontier_req_client : public std::enable_shared_from_this<nano::frontier_req_client>
 {
 public:
-	frontier_req_client (std::shared_ptr<nano::bootstrap_client>);
+	frontier_req_client (std::shared_ptr<nano::bootstrap_client>, nano::account const & = nano::account (0), nano::account const & = nano::account (0), uint32_t = std::numeric_limits<uint32_t>::max ());
 	~frontier_req_client ();
 	void run ();
 	void receive_frontier ();
 	void received_frontier (boost::system::error_code const &, size_t);
+	// Acts on a difference between a received frontier and the local one
+	void compare (nano::transaction const &, nano::account const &, nano::block_hash const &, nano::block_hash const &);
 	void unsynced (nano::block_hash const &, nano::block_hash const &);
 	void next (nano::transaction const &);
+	// Reports the range to the attempt, error is true if it wasn't completely compared
+	void finish (bool);
+	bool in_range (nano::account const &) const;
+	// Only accounts modified within age seconds are requested, local accounts missing from the reply aren't treated as unknown to the peer
+	bool incremental () const;
 	std::shared_ptr<nano::bootstrap_client> connection;
+	nano::account range_start;
+	nano::account range_end;
+	uint32_t age;
+	// Wall clock time the request was sent, in seconds since epoch
+	uint64_t request_time;
+	// First account of the range not yet compared, where a failed range is resumed from
+	nano::account resume;
+	bool finished;
 	nano::account current;
 	nano::block_hash frontier;
 	unsigned count;
 	nano::account landing;
 	nano::account faucet;
 	std::chrono::steady_clock::time_point start_time;
-	std::promise<bool> promise;
 	/** A very rough estimate of the cost of `bulk_push`ing missing blocks */
 	uint64_t bulk_push_cost;
 	std::deque<std::pair<nano::account, nano::block_hash>> accounts;
@@ -165,8 +214,10 @@ public:
 	~bulk_pull_client ();
 	void request ();
 	void receive_block ();
-	void received_type ();
-	void received_block (boost::system::error_code const &, size_t, nano::block_type);
+	// Parses every complete block in the buffer and queues them for the block processor together
+	void received_data ();
+	// Returns true if the pull should continue after this block
+	bool received_block (std::shared_ptr<nano::block>, std::vector<nano::unchecked_info> &);
 	nano::block_hash first ();
 	std::shared_ptr<nano::bootstrap_client> connection;
 	nano::block_hash expected;
@@ -174,6 +225,11 @@ public:
 	nano::pull_info pull;
 	uint64_t total_blocks;
 	uint64_t unexpected_count;
+	// Unparsed bytes in connection->pull_buffer are [buffer_begin, buffer_end)
+	size_t buffer_begin;
+	size_t buffer_end;
+	// Time the request was written, zeroed once the first response bytes arrive
+	std::chrono::steady_clock::time_point request_time;
 };
 class bootstrap_client : public std::enable_shared_from_this<bootstrap_client>
 {
@@ -184,14 +240,27 @@ public:
 	std::shared_ptr<nano::bootstrap_client> shared ();
 	void stop (bool force);
 	double block_rate () const;
+	double byte_rate () const;
 	double elapsed_seconds () const;
+	// Blocks per second discounted by the share of failed pulls and the time to first byte, higher is better
+	double score () const;
+	// Records the delay between sending a pull request and the first response bytes as a moving average
+	void first_byte (std::chrono::steady_clock::duration const &);
 	std::shared_ptr<nano::node> node;
 	std::shared_ptr<nano::bootstrap_attempt> attempt;
 	std::shared_ptr<nano::socket> socket;
 	std::shared_ptr<std::vector<uint8_t>> receive_buffer;
+	// Used by bulk_pull_client, allocated on the first pull
+	std::shared_ptr<std::vector<uint8_t>> pull_buffer;
 	nano::tcp_endpoint endpoint;
 	std::chrono::steady_clock::time_point start_time;
 	std::atomic<uint64_t> block_count;
+	std::atomic<uint64_t> byte_count;
+	std::atomic<unsigned> pull_count;
+	std::atomic<unsigned> error_count;
+	std::atomic<uint64_t> first_byte_us;
+	// Block rate this peer served in previous attempts, used to rank the connection until it has served blocks itself
+	double prior_rate;
 	std::atomic<bool> pending_stop;
 	std::atomic<bool> hard_stop;
 };
@@ -219,6 +288,34 @@ public:
 	nano::account account;
 	uint64_t total_blocks;
 };
+/**
+ * Remembers when each peer's frontier ranges were last completely compared, so later bootstraps only request frontiers of accounts
+ * the peer modified since. Every full_interval a range is compared in full again to find accounts the peer is missing. Thread-safe.
+ */
+class frontier_sync_cache
+{
+public:
+	// Age to request the range's frontiers from the peer with, the maximum requests all of them
+	uint32_t age (nano::tcp_endpoint const &, nano::account const &);
+	// Records a completed comparison of the range requested at the given time
+	void synced (nano::tcp_endpoint const &, nano::account const &, uint64_t, bool);
+	size_t size ();
+	static uint64_t constexpr full_interval = 60 * 60;
+	// Covers accounts modified while the previous request was in flight
+	static uint64_t constexpr margin = 60;
+	static size_t constexpr max_entries = 16 * 1024;
+
+private:
+	class entry
+	{
+	public:
+		uint64_t last;
+		uint64_t full;
+	};
+	std::mutex mutex;
+	std::map<std::pair<nano::tcp_endpoint, nano::account>, entry> entries;
+};
+
 class bootstrap_initiator
 {
 public:
@@ -234,6 +331,7 @@ public:
 	bool in_progress ();
 	std::shared_ptr<nano::bootstrap_attempt> current_attempt ();
 	void stop ();
+	nano::frontier_sync_cache frontier_syncs;
 
 private:
 	nano::node & node;
@@ -258,8 +356,11 @@ public:
 	void stop ();
 	void accept_connection ();
 	void accept_action (boost::system::error_code const &, std::shared_ptr<nano::socket>);
+	/** Moves a connection that completed the realtime handshake out of the bootstrap slots, returns true if the realtime limit is reached */
+	bool promote_realtime (nano::bootstrap_server *);
 	std::mutex mutex;
 	std::unordered_map<nano::bootstrap_server *, std::weak_ptr<nano::bootstrap_server>> connections;
+	std::unordered_map<nano::bootstrap_server *, std::weak_ptr<nano::bootstrap_server>> realtime_connections;
 	nano::tcp_endpoint endpoint ();
 	boost::asio::ip::tcp::acceptor acceptor;
 	nano::tcp_endpoint local;
@@ -285,6 +386,8 @@ public:
 	void receive_bulk_pull_account_action (boost::system::error_code const &, size_t, nano::message_header const &);
 	void receive_frontier_req_action (boost::system::error_code const &, size_t, nano::message_header const &);
 	void receive_keepalive_action (boost::system::error_code const &, size_t, nano::message_header const &);
+	void receive_node_id_handshake_action (boost::system::error_code const &, size_t, nano::message_header const &);
+	void receive_realtime_action (boost::system::error_code const &, size_t, nano::message_header const &);
 	void add_request (std::unique_ptr<nano::message>);
 	void finish_request ();
 	void run_next ();
@@ -293,6 +396,11 @@ public:
 	std::shared_ptr<nano::node> node;
 	std::mutex mutex;
 	std::queue<std::unique_ptr<nano::message>> requests;
+	// Set once the remote node authenticated through node_id_handshake, realtime messages are then accepted
+	bool realtime;
+	// UDP endpoint of the authenticated peer, realtime messages are processed as if they came from it
+	nano::endpoint realtime_endpoint;
+	boost::optional<nano::uint256_union> realtime_cookie;
 };
 class bulk_pull;
 class bulk_pull_server : public std::enable_shared_from_this<nano::bulk_pull_server>
@@ -301,13 +409,18 @@ public:
 	bulk_pull_server (std::shared_ptr<nano::bootstrap_server> const &, std::unique_ptr<nano::bulk_pull>);
 	void set_current_end ();
 	std::shared_ptr<nano::block> get_next ();
+	std::shared_ptr<nano::block> get_next (nano::transaction const &);
 	void send_next ();
 	void sent_action (boost::system::error_code const &, size_t);
-	void send_finished ();
-	void no_block_sent (boost::system::error_code const &, size_t);
+	// Serializes blocks until the buffer is full or the request is exhausted, the last buffer ends with not_a_block
+	void fill (std::vector<uint8_t> &);
 	std::shared_ptr<nano::bootstrap_server> connection;
 	std::unique_ptr<nano::bulk_pull> request;
+	// Buffer being written to the socket
 	std::shared_ptr<std::vector<uint8_t>> send_buffer;
+	// Buffer filled from the store while send_buffer is being written
+	std::shared_ptr<std::vector<uint8_t>> next_buffer;
+	bool finished;
 	nano::block_hash current;
 	bool include_start;
 	nano::bulk_pull::count_t max_count;
@@ -329,7 +442,10 @@ public:
 	std::unique_ptr<nano::bulk_pull_account> request;
 	std::shared_ptr<std::vector<uint8_t>> send_buffer;
 	std::unordered_set<nano::uint256_union> deduplication;
-	nano::pending_key current_key;
+	// Set when entries are streamed largest first from the amount index instead of in hash order from the pending table
+	bool indexed;
+	nano::pending_amount_key current_key;
+	nano::pending_key current_pending_key;
 	bool pending_address_only;
 	bool pending_include_address;
 	bool invalid_request;
@@ -351,14 +467,18 @@ public:
 	frontier_req_server (std::shared_ptr<nano::bootstrap_server> const &, std::unique_ptr<nano::frontier_req>);
 	void send_next ();
 	void sent_action (boost::system::error_code const &, size_t);
-	void send_finished ();
-	void no_block_sent (boost::system::error_code const &, size_t);
+	// Serializes frontiers until the buffer is full or the request is exhausted, the last buffer ends with a zero pair
+	void fill (std::vector<uint8_t> &);
 	void next ();
 	std::shared_ptr<nano::bootstrap_server> connection;
 	nano::account current;
 	nano::block_hash frontier;
 	std::unique_ptr<nano::frontier_req> request;
+	// Buffer being written to the socket
 	std::shared_ptr<std::vector<uint8_t>> send_buffer;
+	// Buffer filled from the store while send_buffer is being written
+	std::shared_ptr<std::vector<uint8_t>> next_buffer;
+	bool finished;
 	size_t count;
 	std::deque<std::pair<nano::account, nano::block_hash>> accounts;
 };
@@ -0,0 +1,225 @@
+#include <nano/node/capture.hpp>
+
+#include <nano/node/node.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <thread>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+std::array<char, 4> constexpr nano::traffic_capture::magic;
+uint8_t constexpr nano::traffic_capture::version;
+
+nano::traffic_capture::traffic_capture () :
+start (std::chrono::steady_clock::now ()),
+records (0)
+{
+}
+
+bool nano::traffic_capture::open (boost::filesystem::path const & path_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	file.open (path_a.string (), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	auto error (file.fail ());
+	if (!error)
+	{
+		file.write (magic.data (), magic.size ());
+		file.put (static_cast<char> (version));
+		start = std::chrono::steady_clock::now ();
+		records = 0;
+	}
+	return error;
+}
+
+void nano::traffic_capture::add (nano::endpoint const & endpoint_a, uint8_t const * data_a, size_t size_a)
+{
+	assert (size_a <= std::numeric_limits<uint16_t>::max ());
+	uint64_t time (std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count ());
+	auto address (nano::map_endpoint_to_v6 (endpoint_a).address ().to_v6 ().to_bytes ());
+	uint16_t port (endpoint_a.port ());
+	uint16_t size (static_cast<uint16_t> (size_a));
+	std::lock_guard<std::mutex> lock (mutex);
+	if (file.is_open ())
+	{
+		file.write (reinterpret_cast<char const *> (&time), sizeof (time));
+		file.write (reinterpret_cast<char const *> (address.data ()), address.size ());
+		file.write (reinterpret_cast<char const *> (&port), sizeof (port));
+		file.write (reinterpret_cast<char const *> (&size), sizeof (size));
+		file.write (reinterpret_cast<char const *> (data_a), size_a);
+		++records;
+	}
+}
+
+void nano::traffic_capture::close ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	if (file.is_open ())
+	{
+		file.close ();
+	}
+}
+
+uint64_t nano::traffic_capture::count ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return records;
+}
+
+bool nano::traffic_capture_reader::open (boost::filesystem::path const & path_a)
+{
+	file.open (path_a.string (), std::ios_base::in | std::ios_base::binary);
+	std::array<char, 4> magic;
+	file.read (magic.data (), magic.size ());
+	auto version (file.get ());
+	return file.fail () || magic != nano::traffic_capture::magic || version != nano::traffic_capture::version;
+}
+
+bool nano::traffic_capture_reader::read_next (nano::capture_record & record_a)
+{
+	uint64_t time;
+	boost::asio::ip::address_v6::bytes_type address;
+	uint16_t port;
+	uint16_t size;
+	file.read (reinterpret_cast<char *> (&time), sizeof (time));
+	file.read (reinterpret_cast<char *> (address.data ()), address.size ());
+	file.read (reinterpret_cast<char *> (&port), sizeof (port));
+	file.read (reinterpret_cast<char *> (&size), sizeof (size));
+	auto error (file.fail ());
+	if (!error)
+	{
+		record_a.time = std::chrono::microseconds (time);
+		record_a.endpoint = nano::endpoint (boost::asio::ip::address_v6 (address), port);
+		record_a.data.resize (size);
+		file.read (reinterpret_cast<char *> (record_a.data.data ()), size);
+		error = file.fail ();
+	}
+	return error;
+}
+
+nano::traffic_replay::traffic_replay (nano::node & node_a, double speed_a) :
+node (node_a),
+speed (speed_a)
+{
+}
+
+bool nano::traffic_replay::run (boost::filesystem::path const & path_a, std::ostream & stream_a)
+{
+	nano::traffic_capture_reader reader;
+	auto error (reader.open (path_a));
+	if (!error)
+	{
+		auto & buffers (node.network.buffer_container);
+		auto cpu_start (thread_cpu ());
+		auto begin (std::chrono::steady_clock::now ());
+		auto next_report (begin + std::chrono::seconds (1));
+		uint64_t packets (0);
+		uint64_t skipped (0);
+		nano::capture_record record;
+		while (!reader.read_next (record))
+		{
+			if (speed > 0)
+			{
+				std::this_thread::sleep_until (begin + std::chrono::duration_cast<std::chrono::steady_clock::duration> (record.time / speed));
+			}
+			else
+			{
+				// Unthrottled replays wait for the packet threads instead of overwriting unserviced buffers
+				while (buffers.size () >= buffers.capacity () / 2)
+				{
+					std::this_thread::sleep_for (std::chrono::microseconds (100));
+				}
+			}
+			if (record.data.size () <= nano::network::buffer_size)
+			{
+				auto data (buffers.allocate ());
+				if (data != nullptr)
+				{
+					std::copy (record.data.begin (), record.data.end (), data->buffer);
+					data->size = record.data.size ();
+					data->endpoint = record.endpoint;
+					buffers.enqueue (data);
+					++packets;
+				}
+			}
+			else
+			{
+				++skipped;
+			}
+			auto now (std::chrono::steady_clock::now ());
+			if (now >= next_report)
+			{
+				report (stream_a, now - begin, packets, cpu_start);
+				next_report = now + std::chrono::seconds (1);
+			}
+		}
+		while (buffers.size () > 0)
+		{
+			std::this_thread::sleep_for (std::chrono::milliseconds (1));
+		}
+		node.block_processor.flush ();
+		node.vote_processor.flush ();
+		stream_a << "Replay complete" << std::endl;
+		report (stream_a, std::chrono::steady_clock::now () - begin, packets, cpu_start);
+		if (skipped > 0)
+		{
+			stream_a << boost::str (boost::format ("%1% oversized records skipped") % skipped) << std::endl;
+		}
+	}
+	return error;
+}
+
+void nano::traffic_replay::report (std::ostream & stream_a, std::chrono::steady_clock::duration elapsed_a, uint64_t packets_a, std::map<std::string, double> const & cpu_start_a)
+{
+	auto seconds (std::chrono::duration<double> (elapsed_a).count ());
+	stream_a << boost::str (boost::format ("%1$.1fs: %2% packets (%3$.0f/s), queues: udp %4% blocks %5% votes %6% elections %7%") % seconds % packets_a % (seconds > 0 ? packets_a / seconds : 0) % node.network.buffer_container.size () % node.block_processor.size () % node.vote_processor.size () % node.active.size ()) << std::endl;
+	for (auto & entry : thread_cpu ())
+	{
+		auto existing (cpu_start_a.find (entry.first));
+		auto used (entry.second - (existing != cpu_start_a.end () ? existing->second : 0));
+		if (used > 0)
+		{
+			stream_a << boost::str (boost::format ("    %1%: %2$.2fs cpu") % entry.first % used) << std::endl;
+		}
+	}
+}
+
+std::map<std::string, double> nano::traffic_replay::thread_cpu ()
+{
+	std::map<std::string, double> result;
+#ifdef __linux__
+	auto ticks (static_cast<double> (sysconf (_SC_CLK_TCK)));
+	boost::system::error_code ec;
+	for (boost::filesystem::directory_iterator i ("/proc/self/task", ec), n; !ec && i != n; i.increment (ec))
+	{
+		std::ifstream comm ((i->path () / "comm").string ());
+		std::ifstream stat ((i->path () / "stat").string ());
+		std::string name;
+		std::string stat_line;
+		if (std::getline (comm, name) && std::getline (stat, stat_line))
+		{
+			// The thread name in field 2 may contain spaces, fields are counted after its closing parenthesis
+			auto fields_begin (stat_line.rfind (')'));
+			if (fields_begin != std::string::npos)
+			{
+				std::istringstream fields (stat_line.substr (fields_begin + 1));
+				std::string field;
+				// Fields 3 to 13 precede utime and stime
+				for (auto j (0); j < 11; ++j)
+				{
+					fields >> field;
+				}
+				uint64_t utime (0);
+				uint64_t stime (0);
+				if (fields >> utime >> stime)
+				{
+					result[name] += (utime + stime) / ticks;
+				}
+			}
+		}
+	}
+#endif
+	return result;
+}
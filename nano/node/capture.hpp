@@ -0,0 +1,82 @@
+#pragma once
+
+#include <nano/node/common.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+namespace nano
+{
+class node;
+/** One datagram as it was received, with the time since the start of the capture */
+class capture_record
+{
+public:
+	std::chrono::microseconds time;
+	nano::endpoint endpoint;
+	std::vector<uint8_t> data;
+};
+
+/**
+ * Appends received datagrams to a file for later replay with --debug_replay
+ * File layout: "FCAP" magic, 1 byte format version, then records of
+ * 8 byte time in microseconds, 16 byte IPv6 address, 2 byte port, 2 byte size, size bytes of data.
+ * All public methods are thread-safe
+ */
+class traffic_capture
+{
+public:
+	traffic_capture ();
+	// Returns true if the file couldn't be created
+	bool open (boost::filesystem::path const &);
+	void add (nano::endpoint const &, uint8_t const *, size_t);
+	void close ();
+	uint64_t count ();
+	static std::array<char, 4> constexpr magic = { { 'F', 'C', 'A', 'P' } };
+	static uint8_t constexpr version = 1;
+
+private:
+	std::mutex mutex;
+	std::ofstream file;
+	std::chrono::steady_clock::time_point start;
+	uint64_t records;
+};
+
+/** Reads a file written by traffic_capture */
+class traffic_capture_reader
+{
+public:
+	// Returns true if the file is missing or isn't a capture
+	bool open (boost::filesystem::path const &);
+	// Returns true at the end of the file or on a truncated record
+	bool read_next (nano::capture_record &);
+
+private:
+	std::ifstream file;
+};
+
+/**
+ * Feeds a capture into a node's UDP receive queue, either at the recorded pace scaled by a speed factor or as fast as possible,
+ * and reports packets per second, queue depths and CPU time spent by each thread role while the node processes them.
+ * The node should have flags.disable_udp_send set so replies aren't sent to the recorded peers.
+ */
+class traffic_replay
+{
+public:
+	// speed 0 replays without delays, otherwise recorded time is divided by speed
+	traffic_replay (nano::node &, double);
+	// Returns true if the capture couldn't be read
+	bool run (boost::filesystem::path const &, std::ostream &);
+	// CPU seconds used so far by the threads of this process, grouped by thread name. Empty where not supported.
+	static std::map<std::string, double> thread_cpu ();
+
+private:
+	void report (std::ostream &, std::chrono::steady_clock::duration, uint64_t, std::map<std::string, double> const &);
+	nano::node & node;
+	double speed;
+};
+}
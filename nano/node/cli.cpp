@@ -1,6 +1,7 @@
 #include <nano/lib/interface.h>
 #include <nano/node/cli.hpp>
 #include <nano/node/common.hpp>
+#include <nano/node/ledger_archive.hpp>
 #include <nano/node/node.hpp>
 
 std::string nano::error_cli_messages::message (int ev) const
@@ -29,6 +30,8 @@ void nano::add_node_options (boost::program_options::options_description & descr
 	("account_key", "Get the public key for <account>")
 	("vacuum", "Compact database. If data_path is missing, the database in data directory is compacted.")
 	("snapshot", "Compact database and create snapshot, functions similar to vacuum but does not replace the existing database")
+	("ledger_export", "Write all account chains to <file> in dependency order for ledger_import")
+	("ledger_import", "Insert blocks from a <file> written by ledger_export into the ledger, reporting insertion throughput")
 	("data_path", boost::program_options::value<std::string> (), "Use the supplied path as the data directory")
 	("clear_send_ids", "Remove all send IDs from the database (dangerous: not intended for production use)")
 	("delete_node_id", "Delete the node ID in the database")
@@ -264,6 +267,43 @@ std::error_code nano::handle_node_options (boost::program_options::variables_map
 			std::cerr << "Snapshot Failed (unknown reason)" << std::endl;
 		}
 	}
+	else if (vm.count ("ledger_export"))
+	{
+		if (vm.count ("file") == 1)
+		{
+			inactive_node node (data_path);
+			nano::ledger_export exporter (*node.node);
+			if (exporter.run (vm["file"].as<std::string> (), std::cout))
+			{
+				std::cerr << "Unable to write ledger export file" << std::endl;
+				ec = nano::error_cli::generic;
+			}
+		}
+		else
+		{
+			std::cerr << "ledger_export requires one <file> option" << std::endl;
+			ec = nano::error_cli::invalid_arguments;
+		}
+	}
+	else if (vm.count ("ledger_import"))
+	{
+		if (vm.count ("file") == 1)
+		{
+			inactive_node node (data_path);
+			node.node->flags.fast_bootstrap = true;
+			nano::ledger_import importer (*node.node, std::thread::hardware_concurrency ());
+			if (importer.run (vm["file"].as<std::string> (), std::cout))
+			{
+				std::cerr << "Ledger import file is missing, corrupt or truncated" << std::endl;
+				ec = nano::error_cli::generic;
+			}
+		}
+		else
+		{
+			std::cerr << "ledger_import requires one <file> option" << std::endl;
+			ec = nano::error_cli::invalid_arguments;
+		}
+	}
 	else if (vm.count ("unchecked_clear"))
 	{
 		boost::filesystem::path data_path = vm.count ("data_path") ? boost::filesystem::path (vm["data_path"].as<std::string> ()) : nano::working_path ();
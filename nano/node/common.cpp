@@ -8,6 +8,8 @@
 
 std::array<uint8_t, 2> constexpr nano::message_header::magic_number;
 std::bitset<16> constexpr nano::message_header::block_type_mask;
+std::bitset<16> constexpr nano::message_header::count_mask;
+uint8_t constexpr nano::message_header::count_max;
 
 nano::message_header::message_header (nano::message_type type_a) :
 version_max (nano::protocol_version),
@@ -84,6 +86,18 @@ void nano::message_header::block_type_set (nano::block_type type_a)
 	extensions |= std::bitset<16> (static_cast<unsigned long long> (type_a) << 8);
 }
 
+uint8_t nano::message_header::count_get () const
+{
+	return static_cast<uint8_t> (((extensions & count_mask) >> 12).to_ullong ());
+}
+
+void nano::message_header::count_set (uint8_t count_a)
+{
+	assert (count_a <= count_max);
+	extensions &= ~count_mask;
+	extensions |= std::bitset<16> (static_cast<unsigned long long> (count_a) << 12);
+}
+
 bool nano::message_header::bulk_pull_is_count_present () const
 {
 	auto result (false);
@@ -98,6 +112,11 @@ bool nano::message_header::bulk_pull_is_count_present () const
 	return result;
 }
 
+bool nano::message_header::frontier_req_is_end_present () const
+{
+	return type == nano::message_type::frontier_req && extensions.test (frontier_req_end_present_flag);
+}
+
 size_t nano::message_header::payload_length_bytes () const
 {
 	switch (type)
@@ -113,7 +132,7 @@ size_t nano::message_header::payload_length_bytes () const
 		}
 		case nano::message_type::frontier_req:
 		{
-			return nano::frontier_req::size;
+			return nano::frontier_req::size + (frontier_req_is_end_present () ? nano::frontier_req::extended_parameters_size : 0);
 		}
 		case nano::message_type::bulk_pull_account:
 		{
@@ -123,8 +142,41 @@ size_t nano::message_header::payload_length_bytes () const
 		{
 			return nano::keepalive::size;
 		}
-		// Add realtime network messages once they get framing support; currently the
-		// realtime messages all fit in a datagram from which they're deserialized.
+		case nano::message_type::publish:
+		{
+			return block_size (block_type ());
+		}
+		case nano::message_type::confirm_req:
+		{
+			if (block_type () == nano::block_type::not_a_block)
+			{
+				return sizeof (uint8_t) + count_get () * (sizeof (nano::block_hash) + sizeof (nano::block_hash));
+			}
+			return block_size (block_type ());
+		}
+		case nano::message_type::confirm_ack:
+		{
+			auto vote_size (sizeof (nano::account) + sizeof (nano::signature) + sizeof (uint64_t));
+			if (block_type () == nano::block_type::not_a_block)
+			{
+				return vote_size + count_get () * sizeof (nano::block_hash);
+			}
+			auto size (block_size (block_type ()));
+			return size != 0 ? vote_size + size : 0;
+		}
+		case nano::message_type::node_id_handshake:
+		{
+			size_t result (0);
+			if (extensions.test (nano::node_id_handshake::query_flag))
+			{
+				result += sizeof (nano::uint256_union);
+			}
+			if (extensions.test (nano::node_id_handshake::response_flag))
+			{
+				result += sizeof (nano::account) + sizeof (nano::signature);
+			}
+			return result;
+		}
 		default:
 		{
 			assert (false);
@@ -133,8 +185,29 @@ size_t nano::message_header::payload_length_bytes () const
 	}
 }
 
+size_t nano::message_header::block_size (nano::block_type type_a)
+{
+	size_t result (0);
+	switch (type_a)
+	{
+		case nano::block_type::send:
+		case nano::block_type::receive:
+		case nano::block_type::open:
+		case nano::block_type::change:
+		case nano::block_type::state:
+			result = nano::block::size (type_a);
+			break;
+		default:
+			// Malformed block type, there's no way to frame the payload
+			break;
+	}
+	return result;
+}
+
 // MTU - IP header - UDP header
 const size_t nano::message_parser::max_safe_udp_message_size = 508;
+// Header + confirm_req carrying count_max roots/hashes, the largest realtime message
+const size_t nano::message_parser::max_tcp_realtime_message_size = 8 + 1 + nano::message_header::count_max * 64;
 
 std::string nano::message_parser::status_string ()
 {
@@ -204,11 +277,11 @@ status (parse_status::success)
 {
 }
 
-void nano::message_parser::deserialize_buffer (uint8_t const * buffer_a, size_t size_a)
+void nano::message_parser::deserialize_buffer (uint8_t const * buffer_a, size_t size_a, size_t max_size_a)
 {
 	status = parse_status::success;
 	auto error (false);
-	if (size_a <= max_safe_udp_message_size)
+	if (size_a <= max_size_a)
 	{
 		// Guaranteed to be deliverable
 		nano::bufferstream stream (buffer_a, size_a);
@@ -504,6 +577,8 @@ roots_hashes (roots_hashes_a)
 {
 	// not_a_block (1) block type for hashes + roots request
 	header.block_type_set (nano::block_type::not_a_block);
+	assert (roots_hashes.size () <= nano::message_header::count_max);
+	header.count_set (static_cast<uint8_t> (roots_hashes.size ()));
 }
 
 nano::confirm_req::confirm_req (nano::block_hash const & hash_a, nano::block_hash const & root_a) :
@@ -513,6 +588,7 @@ roots_hashes (std::vector<std::pair<nano::block_hash, nano::block_hash>> (1, std
 	assert (!roots_hashes.empty ());
 	// not_a_block (1) block type for hashes + roots request
 	header.block_type_set (nano::block_type::not_a_block);
+	header.count_set (static_cast<uint8_t> (roots_hashes.size ()));
 }
 
 void nano::confirm_req::visit (nano::message_visitor & visitor_a) const
@@ -631,6 +707,8 @@ vote (vote_a)
 	if (first_vote_block.which ())
 	{
 		header.block_type_set (nano::block_type::not_a_block);
+		assert (vote_a->blocks.size () <= nano::message_header::count_max);
+		header.count_set (static_cast<uint8_t> (vote_a->blocks.size ()));
 	}
 	else
 	{
@@ -657,12 +735,14 @@ void nano::confirm_ack::visit (nano::message_visitor & visitor_a) const
 }
 
 nano::frontier_req::frontier_req () :
-message (nano::message_type::frontier_req)
+message (nano::message_type::frontier_req),
+end (0)
 {
 }
 
 nano::frontier_req::frontier_req (bool & error_a, nano::stream & stream_a, nano::message_header const & header_a) :
-message (header_a)
+message (header_a),
+end (0)
 {
 	if (!error_a)
 	{
@@ -676,6 +756,10 @@ void nano::frontier_req::serialize (nano::stream & stream_a) const
 	write (stream_a, start.bytes);
 	write (stream_a, age);
 	write (stream_a, count);
+	if (is_end_present ())
+	{
+		write (stream_a, end.bytes);
+	}
 }
 
 bool nano::frontier_req::deserialize (nano::stream & stream_a)
@@ -687,6 +771,14 @@ bool nano::frontier_req::deserialize (nano::stream & stream_a)
 		nano::read (stream_a, start.bytes);
 		nano::read (stream_a, age);
 		nano::read (stream_a, count);
+		if (is_end_present ())
+		{
+			nano::read (stream_a, end.bytes);
+		}
+		else
+		{
+			end.clear ();
+		}
 	}
 	catch (std::runtime_error const &)
 	{
@@ -703,7 +795,17 @@ void nano::frontier_req::visit (nano::message_visitor & visitor_a) const
 
 bool nano::frontier_req::operator== (nano::frontier_req const & other_a) const
 {
-	return start == other_a.start && age == other_a.age && count == other_a.count;
+	return start == other_a.start && age == other_a.age && count == other_a.count && end == other_a.end;
+}
+
+bool nano::frontier_req::is_end_present () const
+{
+	return header.extensions.test (end_present_flag);
+}
+
+void nano::frontier_req::set_end_present (bool value_a)
+{
+	header.extensions.set (end_present_flag, value_a);
 }
 
 nano::bulk_pull::bulk_pull () :
@@ -980,6 +1082,49 @@ nano::message_visitor::~message_visitor ()
 {
 }
 
+nano::message_buffer_pool::message_buffer_pool (size_t max_a) :
+free (std::make_shared<free_list> ())
+{
+	free->max = max_a;
+}
+
+std::shared_ptr<std::vector<uint8_t>> nano::message_buffer_pool::allocate (bool & allocated_a)
+{
+	std::unique_ptr<std::vector<uint8_t>> buffer;
+	{
+		std::lock_guard<std::mutex> lock (free->mutex);
+		if (!free->buffers.empty ())
+		{
+			buffer = std::move (free->buffers.back ());
+			free->buffers.pop_back ();
+		}
+	}
+	allocated_a = buffer == nullptr;
+	if (allocated_a)
+	{
+		buffer = std::make_unique<std::vector<uint8_t>> ();
+	}
+	std::weak_ptr<free_list> free_w (free);
+	return std::shared_ptr<std::vector<uint8_t>> (buffer.release (), [free_w](std::vector<uint8_t> * buffer_a) {
+		std::unique_ptr<std::vector<uint8_t>> buffer (buffer_a);
+		if (auto free_l = free_w.lock ())
+		{
+			buffer->clear ();
+			std::lock_guard<std::mutex> lock (free_l->mutex);
+			if (free_l->buffers.size () < free_l->max)
+			{
+				free_l->buffers.push_back (std::move (buffer));
+			}
+		}
+	});
+}
+
+size_t nano::message_buffer_pool::size ()
+{
+	std::lock_guard<std::mutex> lock (free->mutex);
+	return free->buffers.size ();
+}
+
 bool nano::parse_port (std::string const & string_a, uint16_t & port_a)
 {
 	bool result = false;
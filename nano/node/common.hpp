@@ -204,11 +204,20 @@ public:
 
 	static size_t constexpr bulk_pull_count_present_flag = 0;
 	bool bulk_pull_is_count_present () const;
+	static size_t constexpr frontier_req_end_present_flag = 0;
+	bool frontier_req_is_end_present () const;
 
 	/** Size of the payload in bytes. For some messages, the payload size is based on header flags. */
 	size_t payload_length_bytes () const;
+	/** Serialized size of a block of the given type, 0 if the type can't appear in a message */
+	static size_t block_size (nano::block_type);
 
 	static std::bitset<16> constexpr block_type_mask = std::bitset<16> (0x0f00);
+	/** Number of hashes carried by confirm_req and confirm_ack, required to frame them on a stream */
+	static std::bitset<16> constexpr count_mask = std::bitset<16> (0xf000);
+	static uint8_t constexpr count_max = 15;
+	uint8_t count_get () const;
+	void count_set (uint8_t);
 	bool valid_magic () const
 	{
 		return magic_number[0] == 'F' && magic_number[1] >= 'A' && magic_number[1] <= 'C';
@@ -255,7 +264,7 @@ public:
 		invalid_network
 	};
 	message_parser (nano::block_uniquer &, nano::vote_uniquer &, nano::message_visitor &, nano::work_pool &);
-	void deserialize_buffer (uint8_t const *, size_t);
+	void deserialize_buffer (uint8_t const *, size_t, size_t = max_safe_udp_message_size);
 	void deserialize_keepalive (nano::stream &, nano::message_header const &);
 	void deserialize_publish (nano::stream &, nano::message_header const &);
 	void deserialize_confirm_req (nano::stream &, nano::message_header const &);
@@ -269,6 +278,7 @@ public:
 	parse_status status;
 	std::string status_string ();
 	static const size_t max_safe_udp_message_size;
+	static const size_t max_tcp_realtime_message_size;
 };
 class keepalive : public message
 {
@@ -330,6 +340,12 @@ public:
 	nano::account start;
 	uint32_t age;
 	uint32_t count;
+	// First account past the requested range, only sent when end_present is set. Zero is the end of the account space.
+	nano::account end;
+	bool is_end_present () const;
+	void set_end_present (bool);
+	static size_t constexpr end_present_flag = nano::message_header::frontier_req_end_present_flag;
+	static size_t constexpr extended_parameters_size = sizeof (end);
 	static size_t constexpr size = sizeof (start) + sizeof (age) + sizeof (count);
 };
 class bulk_pull : public message
@@ -350,6 +366,10 @@ public:
 	static size_t constexpr extended_parameters_size = 8;
 	static size_t constexpr size = sizeof (start) + sizeof (end);
 };
+/**
+ * Requests an account's pending entries of at least minimum_amount. Servers at store version 15 or later send them
+ * largest first, older ones and those still upgrading send them in block hash order, clients must not rely on either.
+ */
 class bulk_pull_account : public message
 {
 public:
@@ -404,6 +424,30 @@ public:
 	virtual void node_id_handshake (nano::node_id_handshake const &) = 0;
 	virtual ~message_visitor ();
 };
+/**
+ * Recycles the vectors holding serialized messages so broadcasts stop allocating once the pool is warm.
+ * Buffers are handed out as shared pointers which return their vector to the pool when the last reference is released,
+ * references outliving the pool free their vector instead. Thread-safe.
+ */
+class message_buffer_pool
+{
+public:
+	message_buffer_pool (size_t = 1024);
+	// Returns an empty buffer, allocated_a is set to true if no free buffer could be reused
+	std::shared_ptr<std::vector<uint8_t>> allocate (bool & allocated_a);
+	// Number of free buffers
+	size_t size ();
+
+private:
+	class free_list
+	{
+	public:
+		std::mutex mutex;
+		std::vector<std::unique_ptr<std::vector<uint8_t>>> buffers;
+		size_t max;
+	};
+	std::shared_ptr<free_list> free;
+};
 
 /**
  * Returns seconds passed since unix epoch (posix time)
@@ -0,0 +1,360 @@
+#include <nano/node/http_callback.hpp>
+
+#include <nano/node/node.hpp>
+
+std::chrono::milliseconds constexpr nano::http_callbacks::retry_delay;
+
+nano::http_callbacks::connection::connection (boost::asio::io_context & io_ctx_a) :
+socket (io_ctx_a),
+resolver (io_ctx_a),
+deadline (io_ctx_a),
+attempt (0),
+reused (false)
+{
+}
+
+nano::http_callbacks::http_callbacks (nano::node & node_a) :
+node (node_a),
+stopped (false),
+delivered (0),
+dropped (0)
+{
+	latency.fill (0);
+}
+
+void nano::http_callbacks::add (std::string const & body_a)
+{
+	auto added (false);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		if (!stopped && queue.size () < node.config.callback_queue_limit)
+		{
+			queue.push_back (event{ body_a, std::chrono::steady_clock::now () });
+			added = true;
+		}
+		else
+		{
+			++dropped;
+		}
+	}
+	if (added)
+	{
+		dispatch ();
+	}
+	else
+	{
+		node.stats.inc (nano::stat::type::http_callback, nano::stat::detail::overflow, nano::stat::dir::out);
+	}
+}
+
+void nano::http_callbacks::dispatch ()
+{
+	std::vector<std::shared_ptr<nano::http_callbacks::connection>> ready;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		auto batch_size (std::max (1U, node.config.callback_batch_size));
+		while (!stopped && !queue.empty () && (!idle.empty () || connections.size () < node.config.callback_connections))
+		{
+			std::shared_ptr<nano::http_callbacks::connection> connection_l;
+			if (!idle.empty ())
+			{
+				connection_l = idle.back ();
+				idle.pop_back ();
+			}
+			else
+			{
+				connection_l = std::make_shared<nano::http_callbacks::connection> (node.io_ctx);
+				connections.push_back (connection_l);
+			}
+			connection_l->attempt = 0;
+			while (!queue.empty () && connection_l->events.size () < batch_size)
+			{
+				connection_l->events.push_back (std::move (queue.front ()));
+				queue.pop_front ();
+			}
+			ready.push_back (connection_l);
+		}
+	}
+	for (auto & connection_l : ready)
+	{
+		send (connection_l);
+	}
+}
+
+void nano::http_callbacks::connect (std::shared_ptr<nano::http_callbacks::connection> connection_a)
+{
+	auto node_l (node.shared ());
+	auto address (node.config.callback_address);
+	auto port (node.config.callback_port);
+	deadline_start (connection_a);
+	connection_a->resolver.async_resolve (address, std::to_string (port), [node_l, connection_a, address, port](boost::system::error_code const & ec, boost::asio::ip::tcp::resolver::results_type results_a) {
+		if (!ec)
+		{
+			boost::asio::async_connect (connection_a->socket, results_a, [node_l, connection_a, address, port](boost::system::error_code const & ec, boost::asio::ip::tcp::endpoint const &) {
+				if (!ec)
+				{
+					node_l->callbacks.deadline_cancel (connection_a);
+					node_l->callbacks.send (connection_a);
+				}
+				else
+				{
+					node_l->callbacks.failed (connection_a, boost::str (boost::format ("Unable to connect to callback address: %1%:%2%: %3%") % address % port % ec.message ()));
+				}
+			});
+		}
+		else
+		{
+			node_l->callbacks.failed (connection_a, boost::str (boost::format ("Error resolving callback: %1%:%2%: %3%") % address % port % ec.message ()));
+		}
+	});
+}
+
+void nano::http_callbacks::send (std::shared_ptr<nano::http_callbacks::connection> connection_a)
+{
+	auto stopped_l (false);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		stopped_l = stopped;
+	}
+	if (stopped_l)
+	{
+		connection_a->events.clear ();
+	}
+	else if (!connection_a->socket.is_open ())
+	{
+		connect (connection_a);
+	}
+	else
+	{
+		auto & request (connection_a->request);
+		request = decltype (connection_a->request) ();
+		request.method (boost::beast::http::verb::post);
+		request.target (node.config.callback_target);
+		request.version (11);
+		request.insert (boost::beast::http::field::host, node.config.callback_address);
+		request.insert (boost::beast::http::field::content_type, "application/json");
+		request.keep_alive (true);
+		auto & body (request.body ());
+		if (node.config.callback_batch_size > 1)
+		{
+			// Batches are a JSON array of the events, one per block like unbatched callbacks
+			body.push_back ('[');
+			for (auto & event : connection_a->events)
+			{
+				if (body.size () > 1)
+				{
+					body.push_back (',');
+				}
+				body.append (event.body);
+			}
+			body.push_back (']');
+		}
+		else
+		{
+			assert (connection_a->events.size () == 1);
+			body = connection_a->events.front ().body;
+		}
+		request.prepare_payload ();
+		auto node_l (node.shared ());
+		deadline_start (connection_a);
+		boost::beast::http::async_write (connection_a->socket, request, [node_l, connection_a](boost::system::error_code const & ec, size_t) {
+			auto address (node_l->config.callback_address);
+			auto port (node_l->config.callback_port);
+			if (!ec)
+			{
+				connection_a->response = decltype (connection_a->response) ();
+				boost::beast::http::async_read (connection_a->socket, connection_a->buffer, connection_a->response, [node_l, connection_a, address, port](boost::system::error_code const & ec, size_t) {
+					if (!ec)
+					{
+						if (connection_a->response.result () == boost::beast::http::status::ok)
+						{
+							node_l->callbacks.sent (connection_a);
+						}
+						else
+						{
+							// The callback server answered, reconnecting wouldn't help
+							connection_a->reused = false;
+							node_l->callbacks.failed (connection_a, boost::str (boost::format ("Callback to %1%:%2% failed with status: %3%") % address % port % connection_a->response.result ()));
+						}
+					}
+					else
+					{
+						node_l->callbacks.failed (connection_a, boost::str (boost::format ("Unable complete callback: %1%:%2%: %3%") % address % port % ec.message ()));
+					}
+				});
+			}
+			else
+			{
+				node_l->callbacks.failed (connection_a, boost::str (boost::format ("Unable to send callback: %1%:%2%: %3%") % address % port % ec.message ()));
+			}
+		});
+	}
+}
+
+void nano::http_callbacks::sent (std::shared_ptr<nano::http_callbacks::connection> connection_a)
+{
+	deadline_cancel (connection_a);
+	auto now (std::chrono::steady_clock::now ());
+	auto count (connection_a->events.size ());
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		for (auto & event : connection_a->events)
+		{
+			size_t bucket (0);
+			for (auto bound (std::chrono::milliseconds (1)); bucket < latency.size () - 1 && now - event.queued >= bound; bound *= 10)
+			{
+				++bucket;
+			}
+			++latency[bucket];
+		}
+		delivered += count;
+	}
+	node.stats.add (nano::stat::type::http_callback, nano::stat::detail::initiate, nano::stat::dir::out, count);
+	if (count > 1)
+	{
+		node.stats.inc (nano::stat::type::http_callback, nano::stat::detail::batch, nano::stat::dir::out);
+	}
+	connection_a->reused = connection_a->response.keep_alive ();
+	if (!connection_a->reused)
+	{
+		boost::system::error_code ignored;
+		connection_a->socket.close (ignored);
+	}
+	release (connection_a);
+}
+
+void nano::http_callbacks::failed (std::shared_ptr<nano::http_callbacks::connection> connection_a, std::string const & message_a)
+{
+	deadline_cancel (connection_a);
+	boost::system::error_code ignored;
+	connection_a->socket.close (ignored);
+	connection_a->buffer.consume (connection_a->buffer.size ());
+	auto stopped_l (false);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		stopped_l = stopped;
+	}
+	if (!stopped_l && connection_a->reused)
+	{
+		// The callback server may have closed the connection while it was idle, one reconnect isn't counted as a failure
+		connection_a->reused = false;
+		send (connection_a);
+	}
+	else if (!stopped_l)
+	{
+		if (node.config.logging.callback_logging ())
+		{
+			BOOST_LOG (node.log) << message_a;
+		}
+		node.stats.inc (nano::stat::type::error, nano::stat::detail::http_callback, nano::stat::dir::out);
+		if (connection_a->attempt < node.config.callback_retries)
+		{
+			node.stats.inc (nano::stat::type::http_callback, nano::stat::detail::retry, nano::stat::dir::out);
+			auto delay (retry_delay * (1 << std::min (connection_a->attempt, 16U)));
+			++connection_a->attempt;
+			std::weak_ptr<nano::node> node_w (node.shared ());
+			node.alarm.add (node.alarm.now () + delay, [node_w, connection_a]() {
+				if (auto node_l = node_w.lock ())
+				{
+					node_l->callbacks.send (connection_a);
+				}
+			});
+		}
+		else
+		{
+			auto count (connection_a->events.size ());
+			{
+				std::lock_guard<std::mutex> lock (mutex);
+				dropped += count;
+			}
+			node.stats.add (nano::stat::type::http_callback, nano::stat::detail::drop, nano::stat::dir::out, count);
+			release (connection_a);
+		}
+	}
+}
+
+void nano::http_callbacks::deadline_start (std::shared_ptr<nano::http_callbacks::connection> connection_a)
+{
+	connection_a->deadline.expires_after (std::chrono::seconds (node.config.callback_timeout));
+	connection_a->deadline.async_wait ([connection_a](boost::system::error_code const & ec) {
+		// The expiry is moved past now when the operation completes, a wait that was already queued then does nothing
+		if (!ec && connection_a->deadline.expiry () <= std::chrono::steady_clock::now ())
+		{
+			// The pending resolve, connect, write or read completes with operation_aborted and goes through failed ()
+			connection_a->resolver.cancel ();
+			boost::system::error_code ignored;
+			connection_a->socket.close (ignored);
+		}
+	});
+}
+
+void nano::http_callbacks::deadline_cancel (std::shared_ptr<nano::http_callbacks::connection> connection_a)
+{
+	connection_a->deadline.expires_at (std::chrono::steady_clock::time_point::max ());
+}
+
+void nano::http_callbacks::release (std::shared_ptr<nano::http_callbacks::connection> connection_a)
+{
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		connection_a->events.clear ();
+		if (!stopped)
+		{
+			idle.push_back (connection_a);
+		}
+	}
+	dispatch ();
+}
+
+void nano::http_callbacks::stop ()
+{
+	decltype (connections) connections_l;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		stopped = true;
+		queue.clear ();
+		idle.clear ();
+		connections.swap (connections_l);
+	}
+	for (auto & connection_l : connections_l)
+	{
+		connection_l->deadline.cancel ();
+		connection_l->resolver.cancel ();
+		boost::system::error_code ignored;
+		connection_l->socket.close (ignored);
+	}
+}
+
+void nano::http_callbacks::serialize (boost::property_tree::ptree & tree_a)
+{
+	static std::array<char const *, 6> names{ { "1ms", "10ms", "100ms", "1s", "10s", "inf" } };
+	std::lock_guard<std::mutex> lock (mutex);
+	tree_a.put ("queued", std::to_string (queue.size ()));
+	tree_a.put ("connections", std::to_string (connections.size ()));
+	tree_a.put ("idle", std::to_string (idle.size ()));
+	tree_a.put ("delivered", std::to_string (delivered));
+	tree_a.put ("dropped", std::to_string (dropped));
+	boost::property_tree::ptree latency_l;
+	for (size_t i (0); i < latency.size (); ++i)
+	{
+		latency_l.put (names[i], std::to_string (latency[i]));
+	}
+	tree_a.add_child ("latency", latency_l);
+}
+
+size_t nano::http_callbacks::size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return queue.size ();
+}
+
+namespace nano
+{
+std::unique_ptr<seq_con_info_component> collect_seq_con_info (http_callbacks & http_callbacks, const std::string & name)
+{
+	auto count (http_callbacks.size ());
+	auto composite = std::make_unique<seq_con_info_composite> (name);
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "queue", count, sizeof (std::string) + sizeof (std::chrono::steady_clock::time_point) }));
+	return composite;
+}
+}
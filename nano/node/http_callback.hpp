@@ -0,0 +1,81 @@
+#pragma once
+
+#include <nano/lib/utility.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace nano
+{
+class node;
+/**
+ * Delivers confirmed block events to the configured callback address over a pool of persistent HTTP connections.
+ * Events wait in a bounded queue and an idle connection takes up to callback_batch_size of them per POST, failed or
+ * timed out POSTs are retried on the same connection with exponential backoff. Thread-safe.
+ */
+class http_callbacks
+{
+public:
+	http_callbacks (nano::node &);
+	// Queues a JSON event, it's dropped if the queue is full
+	void add (std::string const &);
+	void stop ();
+	// Queue, connections and delivery latency histogram
+	void serialize (boost::property_tree::ptree &);
+	size_t size ();
+	static std::chrono::milliseconds constexpr retry_delay = std::chrono::milliseconds (500);
+
+private:
+	class event
+	{
+	public:
+		std::string body;
+		std::chrono::steady_clock::time_point queued;
+	};
+	class connection
+	{
+	public:
+		connection (boost::asio::io_context &);
+		boost::asio::ip::tcp::socket socket;
+		boost::asio::ip::tcp::resolver resolver;
+		// Closes the socket if connecting or a POST exchange takes longer than callback_timeout, failing the pending operation
+		boost::asio::steady_timer deadline;
+		boost::beast::flat_buffer buffer;
+		boost::beast::http::request<boost::beast::http::string_body> request;
+		boost::beast::http::response<boost::beast::http::string_body> response;
+		std::vector<nano::http_callbacks::event> events;
+		unsigned attempt;
+		// Set after a kept-alive response, the next request may find the socket closed by the callback server
+		bool reused;
+	};
+	// Hands queued events to idle connections, opening new ones up to callback_connections
+	void dispatch ();
+	void connect (std::shared_ptr<nano::http_callbacks::connection>);
+	void send (std::shared_ptr<nano::http_callbacks::connection>);
+	void sent (std::shared_ptr<nano::http_callbacks::connection>);
+	void failed (std::shared_ptr<nano::http_callbacks::connection>, std::string const &);
+	void deadline_start (std::shared_ptr<nano::http_callbacks::connection>);
+	void deadline_cancel (std::shared_ptr<nano::http_callbacks::connection>);
+	void release (std::shared_ptr<nano::http_callbacks::connection>);
+	nano::node & node;
+	std::mutex mutex;
+	bool stopped;
+	std::deque<nano::http_callbacks::event> queue;
+	std::vector<std::shared_ptr<nano::http_callbacks::connection>> connections;
+	std::vector<std::shared_ptr<nano::http_callbacks::connection>> idle;
+	// Time from queueing to the callback's response in decade buckets from 1 millisecond to 10 seconds
+	std::array<uint64_t, 6> latency;
+	uint64_t delivered;
+	uint64_t dropped;
+};
+
+std::unique_ptr<seq_con_info_component> collect_seq_con_info (http_callbacks & http_callbacks, const std::string & name);
+}
@@ -60,6 +60,7 @@ nano::error nano::ipc::ipc_config::serialize_json (nano::jsonconfig & json) cons
 	domain_l.put ("path", transport_domain.path);
 	domain_l.put ("io_timeout", transport_domain.io_timeout);
 	json.put_child ("local", domain_l);
+	json.put ("subscription_queue_limit", subscription_queue_limit);
 	return json.get_error ();
 }
 
@@ -83,6 +84,12 @@ nano::error nano::ipc::ipc_config::deserialize_json (nano::jsonconfig & json)
 		domain_l->get<size_t> ("io_timeout", transport_domain.io_timeout);
 	}
 
+	json.get_optional<size_t> ("subscription_queue_limit", subscription_queue_limit);
+	if (subscription_queue_limit == 0)
+	{
+		json.get_error ().set ("subscription_queue_limit must be non-zero");
+	}
+
 	return json.get_error ();
 }
 
@@ -138,7 +145,7 @@ private:
  * A session represents an inbound connection over which multiple requests/reponses are transmitted.
  */
 template <typename SOCKET_TYPE>
-class session : public socket_base, public std::enable_shared_from_this<session<SOCKET_TYPE>>
+class session : public socket_base, public nano::ipc::subscriber, public std::enable_shared_from_this<session<SOCKET_TYPE>>
 {
 public:
 	session (nano::ipc::ipc_server & server_a, boost::asio::io_context & io_ctx_a, nano::ipc::ipc_config_transport & config_transport_a) :
@@ -199,14 +206,11 @@ public:
 		session_timer.restart ();
 		auto request_id_l (std::to_string (server.id_dispenser.fetch_add (1)));
 
-		// This is called when nano::rpc_handler#process_request is done. We convert to
-		// json and write the response to the ipc socket with a length prefix.
+		// This is called when nano::rpc_handler#process_request is done. We write the
+		// json response to the ipc socket with a length prefix.
 		auto this_l (this->shared_from_this ());
-		auto response_handler_l ([this_l, request_id_l](boost::property_tree::ptree const & tree_a) {
-			std::stringstream ostream;
-			boost::property_tree::write_json (ostream, tree_a);
-			ostream.flush ();
-			this_l->response_body = ostream.str ();
+		auto response_handler_l ([this_l, request_id_l](std::string const & body_a) {
+			this_l->response_body = body_a;
 
 			uint32_t size_response = boost::endian::native_to_big (static_cast<uint32_t> (this_l->response_body.size ()));
 			std::vector<boost::asio::mutable_buffer> bufs = {
@@ -238,7 +242,262 @@ public:
 
 		// Note that if the rpc action is async, the shared_ptr<rpc_handler> lifetime will be extended by the action handler
 		auto handler (std::make_shared<nano::rpc_handler> (node, server.rpc, body, request_id_l, response_handler_l));
-		handler->process_request ();
+		handler->queue_request ();
+	}
+
+	/** Handler for payload_encoding::binary, the lookup runs on the RPC read workers like json queries */
+	void binary_handle_query ()
+	{
+		session_timer.restart ();
+		node.stats.inc (nano::stat::type::ipc, nano::stat::detail::invocations);
+		auto this_l (this->shared_from_this ());
+		auto busy ([this_l]() {
+			this_l->binary_response.resize (sizeof (uint32_t));
+			this_l->binary_response.push_back (static_cast<uint8_t> (nano::ipc::binary_status::busy));
+			this_l->binary_write ();
+		});
+		if (server.rpc.workers.push (nano::rpc_request_class::read, [this_l]() {
+			    // The length prefix is filled in once the payload is written so the response goes out as a single buffer
+			    this_l->binary_response.resize (sizeof (uint32_t));
+			    nano::ipc::binary_handler handler (this_l->node);
+			    handler.process (this_l->buffer, this_l->binary_response);
+			    this_l->binary_write ();
+		    },
+		    busy))
+		{
+			busy ();
+		}
+	}
+
+	/** Writes binary_response after its length prefix */
+	void binary_write ()
+	{
+		uint32_t size_response = boost::endian::native_to_big (static_cast<uint32_t> (binary_response.size () - sizeof (uint32_t)));
+		std::copy (reinterpret_cast<uint8_t *> (&size_response), reinterpret_cast<uint8_t *> (&size_response) + sizeof (size_response), binary_response.begin ());
+
+		auto this_l (this->shared_from_this ());
+		timer_start (std::chrono::seconds (config_transport.io_timeout));
+		boost::asio::async_write (socket, boost::asio::buffer (binary_response), [this_l](boost::system::error_code const & error_a, size_t size_a) {
+			this_l->timer_cancel ();
+			if (!error_a)
+			{
+				this_l->read_next_request ();
+			}
+			else if (this_l->node.config.logging.log_ipc ())
+			{
+				BOOST_LOG (this_l->node.log) << "IPC: Write failed: " << error_a.message ();
+			}
+		});
+
+		if (node.config.logging.log_ipc ())
+		{
+			BOOST_LOG (node.log) << boost::str (boost::format ("IPC binary request completed in: %1% %2%") % session_timer.stop ().count () % session_timer.unit ());
+		}
+	}
+
+	/** Handler for payload_encoding::subscription, the acknowledgement is queued ahead of any message for the new subscription */
+	void subscription_handle_query ()
+	{
+		node.stats.inc (nano::stat::type::ipc, nano::stat::detail::invocations);
+		boost::property_tree::ptree response_l;
+		std::string error_l;
+		try
+		{
+			std::stringstream istream (std::string (reinterpret_cast<char *> (buffer.data ()), buffer.size ()));
+			boost::property_tree::ptree request_l;
+			boost::property_tree::read_json (istream, request_l);
+			auto action_l (request_l.get<std::string> ("action", ""));
+			nano::ipc::topic topic_l;
+			if (nano::ipc::broker::parse_topic (request_l.get<std::string> ("topic", ""), topic_l))
+			{
+				error_l = "Invalid topic";
+			}
+			else if (action_l == "subscribe")
+			{
+				std::unordered_set<nano::account> accounts_l;
+				auto accounts_node (request_l.get_child_optional ("accounts"));
+				if (accounts_node)
+				{
+					for (auto & entry : *accounts_node)
+					{
+						nano::account account_l;
+						if (account_l.decode_account (entry.second.get<std::string> ("")))
+						{
+							error_l = "Bad account number";
+							break;
+						}
+						accounts_l.insert (account_l);
+					}
+				}
+				if (error_l.empty ())
+				{
+					subscribed = true;
+					response_l.put ("ack", action_l);
+					response_l.put ("topic", nano::ipc::broker::topic_to_string (topic_l));
+					push (nano::ipc::broker::json (response_l));
+					server.broker->subscribe (this->shared_from_this (), topic_l, accounts_l);
+					node.stats.inc (nano::stat::type::ipc, nano::stat::detail::subscribe);
+				}
+			}
+			else if (action_l == "unsubscribe")
+			{
+				server.broker->unsubscribe (*this, topic_l);
+				response_l.put ("ack", action_l);
+				response_l.put ("topic", nano::ipc::broker::topic_to_string (topic_l));
+				push (nano::ipc::broker::json (response_l));
+			}
+			else
+			{
+				error_l = "Unknown command";
+			}
+		}
+		catch (boost::property_tree::ptree_error const &)
+		{
+			error_l = "Unable to parse JSON";
+		}
+		if (!error_l.empty ())
+		{
+			response_l.clear ();
+			response_l.put ("error", error_l);
+			push (nano::ipc::broker::json (response_l));
+		}
+		read_next_request ();
+	}
+
+	/**
+	 * Queues a message for the client. A client that falls subscription_queue_limit messages behind is evicted, its
+	 * session is closed and the broker drops it once the pending operations release the session.
+	 */
+	void push (std::shared_ptr<std::string> const & message_a) override
+	{
+		auto write_l (false);
+		auto evict_l (false);
+		{
+			std::lock_guard<std::mutex> lock (outbound_mutex);
+			if (!evicted && !close_after_write)
+			{
+				if (outbound.size () < node.config.ipc_config.subscription_queue_limit)
+				{
+					outbound.push_back (message_a);
+					write_l = !writing;
+					writing = true;
+				}
+				else
+				{
+					evicted = true;
+					evict_l = true;
+				}
+			}
+		}
+		if (write_l)
+		{
+			auto this_l (this->shared_from_this ());
+			boost::asio::post (io_ctx, [this_l]() {
+				this_l->write_outbound ();
+			});
+		}
+		else if (evict_l)
+		{
+			node.stats.inc (nano::stat::type::ipc, nano::stat::detail::eviction);
+			if (node.config.logging.log_ipc ())
+			{
+				BOOST_LOG (node.log) << boost::str (boost::format ("IPC: evicting slow subscriber with session id: %1%") % session_id);
+			}
+			auto this_l (this->shared_from_this ());
+			boost::asio::post (io_ctx, [this_l]() {
+				boost::system::error_code ignored;
+				this_l->socket.close (ignored);
+			});
+		}
+	}
+
+	/** Queues a final message, the session is closed once it and everything queued before it have been written */
+	void push_and_close (std::shared_ptr<std::string> const & message_a)
+	{
+		auto write_l (false);
+		auto close_l (false);
+		{
+			std::lock_guard<std::mutex> lock (outbound_mutex);
+			if (!evicted)
+			{
+				outbound.push_back (message_a);
+				close_after_write = true;
+				write_l = !writing;
+				writing = true;
+			}
+			else
+			{
+				close_l = true;
+			}
+		}
+		auto this_l (this->shared_from_this ());
+		if (write_l)
+		{
+			boost::asio::post (io_ctx, [this_l]() {
+				this_l->write_outbound ();
+			});
+		}
+		else if (close_l)
+		{
+			boost::asio::post (io_ctx, [this_l]() {
+				boost::system::error_code ignored;
+				this_l->socket.close (ignored);
+			});
+		}
+	}
+
+	/** Writes queued messages one at a time with a length prefix */
+	void write_outbound ()
+	{
+		std::shared_ptr<std::string> message_l;
+		{
+			std::lock_guard<std::mutex> lock (outbound_mutex);
+			assert (writing && !outbound.empty ());
+			message_l = outbound.front ();
+		}
+		outbound_size = boost::endian::native_to_big (static_cast<uint32_t> (message_l->size ()));
+		std::vector<boost::asio::const_buffer> bufs = {
+			boost::asio::buffer (&outbound_size, sizeof (outbound_size)),
+			boost::asio::buffer (*message_l)
+		};
+		auto this_l (this->shared_from_this ());
+		boost::asio::async_write (socket, bufs, [this_l, message_l](boost::system::error_code const & error_a, size_t size_a) {
+			auto more_l (false);
+			auto close_l (false);
+			{
+				std::lock_guard<std::mutex> lock (this_l->outbound_mutex);
+				if (!error_a)
+				{
+					this_l->outbound.pop_front ();
+					more_l = !this_l->outbound.empty ();
+					close_l = !more_l && this_l->close_after_write;
+				}
+				else
+				{
+					// Nothing more can be written, later pushes are discarded
+					this_l->outbound.clear ();
+					this_l->evicted = true;
+				}
+				this_l->writing = more_l;
+			}
+			if (!error_a)
+			{
+				this_l->node.stats.inc (nano::stat::type::ipc, nano::stat::detail::push, nano::stat::dir::out);
+				if (more_l)
+				{
+					this_l->write_outbound ();
+				}
+				else if (close_l)
+				{
+					boost::system::error_code ignored;
+					this_l->socket.close (ignored);
+				}
+			}
+			else if (this_l->node.config.logging.log_ipc ())
+			{
+				BOOST_LOG (this_l->node.log) << "IPC: Write failed: " << error_a.message ();
+			}
+		});
 	}
 
 	/** Async request reader */
@@ -256,6 +515,18 @@ public:
 					BOOST_LOG (this_l->node.log) << "IPC: Invalid preamble";
 				}
 			}
+			else if (this_l->subscribed && this_l->buffer[preamble_offset::encoding] != static_cast<uint8_t> (nano::ipc::payload_encoding::subscription))
+			{
+				// Responses would interleave with pushed messages, the client is told why before the session is closed
+				std::string error_l ("Only subscription requests are accepted after subscribing");
+				if (this_l->node.config.logging.log_ipc ())
+				{
+					BOOST_LOG (this_l->node.log) << "IPC: " << error_l;
+				}
+				boost::property_tree::ptree response_l;
+				response_l.put ("error", error_l);
+				this_l->push_and_close (nano::ipc::broker::json (response_l));
+			}
 			else if (this_l->buffer[preamble_offset::encoding] == static_cast<uint8_t> (nano::ipc::payload_encoding::json_legacy))
 			{
 				// Length of payload
@@ -268,6 +539,26 @@ public:
 					});
 				});
 			}
+			else if (this_l->buffer[preamble_offset::encoding] == static_cast<uint8_t> (nano::ipc::payload_encoding::binary))
+			{
+				this_l->async_read_exactly (&this_l->buffer_size, sizeof (this_l->buffer_size), [this_l]() {
+					boost::endian::big_to_native_inplace (this_l->buffer_size);
+					this_l->buffer.resize (this_l->buffer_size);
+					this_l->async_read_exactly (this_l->buffer.data (), this_l->buffer_size, [this_l]() {
+						this_l->binary_handle_query ();
+					});
+				});
+			}
+			else if (this_l->buffer[preamble_offset::encoding] == static_cast<uint8_t> (nano::ipc::payload_encoding::subscription))
+			{
+				this_l->async_read_exactly (&this_l->buffer_size, sizeof (this_l->buffer_size), [this_l]() {
+					boost::endian::big_to_native_inplace (this_l->buffer_size);
+					this_l->buffer.resize (this_l->buffer_size);
+					this_l->async_read_exactly (this_l->buffer.data (), this_l->buffer_size, [this_l]() {
+						this_l->subscription_handle_query ();
+					});
+				});
+			}
 			else if (this_l->node.config.logging.log_ipc ())
 			{
 				BOOST_LOG (this_l->node.log) << "IPC: Unsupported payload encoding";
@@ -307,9 +598,26 @@ private:
 	/** RPC response */
 	std::string response_body;
 
+	/** Binary response including its length prefix */
+	std::vector<uint8_t> binary_response;
+
 	/** Buffer used to store data received from the client */
 	std::vector<uint8_t> buffer;
 
+	/** Set by the first subscription request */
+	bool subscribed{ false };
+
+	/** Pushed messages and acknowledgements waiting to be written */
+	std::mutex outbound_mutex;
+	std::deque<std::shared_ptr<std::string>> outbound;
+	bool writing{ false };
+	bool evicted{ false };
+	/** Set when the session closes after the queued messages are written */
+	bool close_after_write{ false };
+
+	/** Length prefix of the message being written */
+	uint32_t outbound_size{ 0 };
+
 	/** Transport configuration */
 	nano::ipc::ipc_config_transport & config_transport;
 };
@@ -413,8 +721,9 @@ public:
 };
 
 nano::ipc::ipc_server::ipc_server (nano::node & node_a, nano::rpc & rpc_a) :
-node (node_a), rpc (rpc_a)
+node (node_a), rpc (rpc_a), broker (std::make_shared<nano::ipc::broker> (node_a))
 {
+	broker->start ();
 	try
 	{
 		if (node_a.config.ipc_config.transport_domain.enabled)
@@ -456,6 +765,182 @@ void nano::ipc::ipc_server::stop ()
 	}
 }
 
+nano::ipc::broker::broker (nano::node & node_a) :
+node (node_a)
+{
+}
+
+void nano::ipc::broker::start ()
+{
+	std::weak_ptr<nano::ipc::broker> broker_w (shared_from_this ());
+	node.observers.blocks.add ([broker_w](std::shared_ptr<nano::block> block_a, nano::account const & account_a, nano::amount const & amount_a, bool is_state_send_a) {
+		if (auto broker_l = broker_w.lock ())
+		{
+			broker_l->broadcast (nano::ipc::topic::confirmation, account_a, [block_a, &account_a, &amount_a, is_state_send_a]() {
+				boost::property_tree::ptree message;
+				message.put ("topic", topic_to_string (nano::ipc::topic::confirmation));
+				message.put ("account", account_a.to_account ());
+				message.put ("hash", block_a->hash ().to_string ());
+				std::string block_text;
+				block_a->serialize_json (block_text);
+				message.put ("block", block_text);
+				message.put ("amount", amount_a.to_string_dec ());
+				if (is_state_send_a)
+				{
+					message.put ("is_send", is_state_send_a);
+				}
+				return message;
+			});
+		}
+	});
+	node.observers.account_balance.add ([broker_w](nano::account const & account_a, bool is_pending_a) {
+		if (auto broker_l = broker_w.lock ())
+		{
+			auto & node_l (broker_l->node);
+			broker_l->broadcast (nano::ipc::topic::account_balance, account_a, [&node_l, &account_a, is_pending_a]() {
+				boost::property_tree::ptree message;
+				message.put ("topic", topic_to_string (nano::ipc::topic::account_balance));
+				message.put ("account", account_a.to_account ());
+				auto transaction (node_l.store.tx_begin_read ());
+				message.put ("balance", node_l.ledger.account_balance (transaction, account_a).convert_to<std::string> ());
+				message.put ("pending", node_l.ledger.account_pending (transaction, account_a).convert_to<std::string> ());
+				message.put ("is_pending", is_pending_a);
+				return message;
+			});
+		}
+	});
+	node.observers.vote.add ([broker_w](nano::transaction const &, std::shared_ptr<nano::vote> vote_a, nano::endpoint const &) {
+		if (auto broker_l = broker_w.lock ())
+		{
+			broker_l->broadcast (nano::ipc::topic::vote, vote_a->account, [vote_a]() {
+				boost::property_tree::ptree message;
+				message.put ("topic", topic_to_string (nano::ipc::topic::vote));
+				message.put ("account", vote_a->account.to_account ());
+				message.put ("sequence", std::to_string (vote_a->sequence));
+				boost::property_tree::ptree blocks;
+				for (auto hash : *vote_a)
+				{
+					boost::property_tree::ptree entry;
+					entry.put ("", hash.to_string ());
+					blocks.push_back (std::make_pair ("", entry));
+				}
+				message.add_child ("blocks", blocks);
+				return message;
+			});
+		}
+	});
+}
+
+void nano::ipc::broker::subscribe (std::shared_ptr<nano::ipc::subscriber> const & subscriber_a, nano::ipc::topic topic_a, std::unordered_set<nano::account> const & accounts_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (std::find_if (subscriptions.begin (), subscriptions.end (), [&subscriber_a, topic_a](nano::ipc::broker::subscription const & subscription_a) {
+		return subscription_a.topic == topic_a && subscription_a.subscriber.lock () == subscriber_a;
+	}));
+	if (existing != subscriptions.end ())
+	{
+		existing->accounts = accounts_a;
+	}
+	else
+	{
+		subscriptions.push_back (subscription{ subscriber_a, topic_a, accounts_a });
+	}
+}
+
+void nano::ipc::broker::unsubscribe (nano::ipc::subscriber const & subscriber_a, nano::ipc::topic topic_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	subscriptions.erase (std::remove_if (subscriptions.begin (), subscriptions.end (), [&subscriber_a, topic_a](nano::ipc::broker::subscription const & subscription_a) {
+		return subscription_a.topic == topic_a && subscription_a.subscriber.lock ().get () == &subscriber_a;
+	}),
+	subscriptions.end ());
+}
+
+size_t nano::ipc::broker::size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return subscriptions.size ();
+}
+
+void nano::ipc::broker::broadcast (nano::ipc::topic topic_a, nano::account const & account_a, std::function<boost::property_tree::ptree ()> const & message_a)
+{
+	std::vector<std::shared_ptr<nano::ipc::subscriber>> matches;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		for (auto i (subscriptions.begin ()); i != subscriptions.end ();)
+		{
+			auto subscriber_l (i->subscriber.lock ());
+			if (subscriber_l == nullptr)
+			{
+				i = subscriptions.erase (i);
+			}
+			else
+			{
+				if (i->topic == topic_a && (i->accounts.empty () || i->accounts.count (account_a) > 0))
+				{
+					matches.push_back (subscriber_l);
+				}
+				++i;
+			}
+		}
+	}
+	if (!matches.empty ())
+	{
+		auto message_l (json (message_a ()));
+		for (auto & subscriber_l : matches)
+		{
+			subscriber_l->push (message_l);
+		}
+	}
+}
+
+std::shared_ptr<std::string> nano::ipc::broker::json (boost::property_tree::ptree const & tree_a)
+{
+	std::stringstream ostream;
+	boost::property_tree::write_json (ostream, tree_a);
+	return std::make_shared<std::string> (ostream.str ());
+}
+
+bool nano::ipc::broker::parse_topic (std::string const & text_a, nano::ipc::topic & topic_a)
+{
+	auto error (false);
+	if (text_a == "confirmation")
+	{
+		topic_a = nano::ipc::topic::confirmation;
+	}
+	else if (text_a == "account_balance")
+	{
+		topic_a = nano::ipc::topic::account_balance;
+	}
+	else if (text_a == "vote")
+	{
+		topic_a = nano::ipc::topic::vote;
+	}
+	else
+	{
+		error = true;
+	}
+	return error;
+}
+
+std::string nano::ipc::broker::topic_to_string (nano::ipc::topic topic_a)
+{
+	std::string result;
+	switch (topic_a)
+	{
+		case nano::ipc::topic::confirmation:
+			result = "confirmation";
+			break;
+		case nano::ipc::topic::account_balance:
+			result = "account_balance";
+			break;
+		case nano::ipc::topic::vote:
+			result = "vote";
+			break;
+	}
+	return result;
+}
+
 /** Socket agnostic IO interface */
 class channel
 {
@@ -638,7 +1123,7 @@ void nano::ipc::ipc_client::async_read (std::shared_ptr<std::vector<uint8_t>> bu
 std::shared_ptr<std::vector<uint8_t>> nano::ipc::ipc_client::prepare_request (nano::ipc::payload_encoding encoding_a, std::string const & payload_a)
 {
 	auto buffer_l (std::make_shared<std::vector<uint8_t>> ());
-	if (encoding_a == nano::ipc::payload_encoding::json_legacy)
+	if (encoding_a == nano::ipc::payload_encoding::json_legacy || encoding_a == nano::ipc::payload_encoding::binary || encoding_a == nano::ipc::payload_encoding::subscription)
 	{
 		buffer_l->push_back ('N');
 		buffer_l->push_back (static_cast<uint8_t> (encoding_a));
@@ -673,3 +1158,152 @@ std::string nano::ipc::rpc_ipc_client::request (std::string const & rpc_action_a
 
 	return result_l.get_future ().get ();
 }
+
+std::vector<uint8_t> nano::ipc::binary_ipc_client::request (std::vector<uint8_t> const & payload_a)
+{
+	auto req (prepare_request (nano::ipc::payload_encoding::binary, std::string (payload_a.begin (), payload_a.end ())));
+	auto res (std::make_shared<std::vector<uint8_t>> ());
+
+	std::promise<std::vector<uint8_t>> result_l;
+	async_write (req, [this, &res, &result_l](nano::error err_a, size_t size_a) {
+		// Read length
+		this->async_read (res, sizeof (uint32_t), [this, &res, &result_l](nano::error err_read_a, size_t size_read_a) {
+			uint32_t payload_size_l = boost::endian::big_to_native (*reinterpret_cast<uint32_t *> (res->data ()));
+			// Read binary payload
+			this->async_read (res, payload_size_l, [&res, &result_l](nano::error err_read_a, size_t size_read_a) {
+				result_l.set_value (*res);
+			});
+		});
+	});
+
+	return result_l.get_future ().get ();
+}
+
+void nano::ipc::subscription_ipc_client::send (std::string const & payload_a)
+{
+	auto req (prepare_request (nano::ipc::payload_encoding::subscription, payload_a));
+	std::promise<void> result_l;
+	async_write (req, [&result_l](nano::error err_a, size_t size_a) {
+		result_l.set_value ();
+	});
+	result_l.get_future ().get ();
+}
+
+std::string nano::ipc::subscription_ipc_client::receive ()
+{
+	auto res (std::make_shared<std::vector<uint8_t>> ());
+	std::promise<std::string> result_l;
+	// Read length
+	async_read (res, sizeof (uint32_t), [this, &res, &result_l](nano::error err_read_a, size_t size_read_a) {
+		uint32_t payload_size_l = boost::endian::big_to_native (*reinterpret_cast<uint32_t *> (res->data ()));
+		// Read json payload
+		this->async_read (res, payload_size_l, [&res, &result_l](nano::error err_read_a, size_t size_read_a) {
+			result_l.set_value (std::string (res->begin (), res->end ()));
+		});
+	});
+	return result_l.get_future ().get ();
+}
+
+nano::ipc::binary_handler::binary_handler (nano::node & node_a) :
+node (node_a)
+{
+}
+
+namespace
+{
+void write_big (nano::stream & stream_a, uint64_t value_a)
+{
+	boost::endian::native_to_big_inplace (value_a);
+	nano::write (stream_a, value_a);
+}
+}
+
+void nano::ipc::binary_handler::process (std::vector<uint8_t> const & request_a, std::vector<uint8_t> & response_a)
+{
+	nano::bufferstream request (request_a.data (), request_a.size ());
+	auto status (nano::ipc::binary_status::bad_request);
+	// Fields are written after the status byte, which is only known once the lookup is done
+	std::vector<uint8_t> fields;
+	{
+		nano::vectorstream output (fields);
+		uint8_t action;
+		nano::uint256_union key;
+		if (!nano::try_read (request, action) && !nano::try_read (request, key.bytes))
+		{
+			auto transaction (node.store.tx_begin_read ());
+			switch (static_cast<nano::ipc::binary_action> (action))
+			{
+				case nano::ipc::binary_action::account_info:
+				{
+					nano::account_info info;
+					status = node.store.account_get (transaction, key, info) ? nano::ipc::binary_status::not_found : nano::ipc::binary_status::success;
+					if (status == nano::ipc::binary_status::success)
+					{
+						nano::write (output, info.head.bytes);
+						nano::write (output, info.open_block.bytes);
+						nano::write (output, info.rep_block.bytes);
+						nano::write (output, info.balance.bytes);
+						write_big (output, info.modified);
+						write_big (output, info.block_count);
+						nano::write (output, static_cast<uint8_t> (info.epoch == nano::epoch::epoch_1 ? 1 : 0));
+					}
+					break;
+				}
+				case nano::ipc::binary_action::account_balance:
+				{
+					nano::amount balance (node.ledger.account_balance (transaction, key));
+					nano::amount pending (node.ledger.account_pending (transaction, key));
+					nano::write (output, balance.bytes);
+					nano::write (output, pending.bytes);
+					status = nano::ipc::binary_status::success;
+					break;
+				}
+				case nano::ipc::binary_action::block_info:
+				{
+					nano::block_sideband sideband;
+					auto block (node.store.block_get (transaction, key, &sideband));
+					status = block == nullptr ? nano::ipc::binary_status::not_found : nano::ipc::binary_status::success;
+					if (status == nano::ipc::binary_status::success)
+					{
+						nano::account account (block->account ().is_zero () ? sideband.account : block->account ());
+						nano::write (output, account.bytes);
+						nano::write (output, nano::amount (node.ledger.amount (transaction, key)).bytes);
+						nano::write (output, nano::amount (node.ledger.balance (transaction, key)).bytes);
+						write_big (output, sideband.height);
+						write_big (output, sideband.timestamp);
+						nano::serialize_block (output, *block);
+					}
+					break;
+				}
+				case nano::ipc::binary_action::pending_exists:
+				{
+					uint8_t include_active;
+					if (!nano::try_read (request, include_active))
+					{
+						auto block (node.store.block_get (transaction, key));
+						status = block == nullptr ? nano::ipc::binary_status::not_found : nano::ipc::binary_status::success;
+						if (status == nano::ipc::binary_status::success)
+						{
+							auto exists (false);
+							auto destination (node.ledger.block_destination (transaction, *block));
+							if (!destination.is_zero ())
+							{
+								exists = node.store.pending_exists (transaction, nano::pending_key (destination, key));
+							}
+							exists = exists && (include_active != 0 || !node.active.active (*block));
+							nano::write (output, static_cast<uint8_t> (exists ? 1 : 0));
+						}
+					}
+					break;
+				}
+				default:
+					break;
+			}
+		}
+	}
+	response_a.push_back (static_cast<uint8_t> (status));
+	if (status == nano::ipc::binary_status::success)
+	{
+		response_a.insert (response_a.end (), fields.begin (), fields.end ());
+	}
+}
@@ -5,7 +5,11 @@
 #include <boost/property_tree/ptree.hpp>
 #include <nano/lib/errors.hpp>
 #include <nano/lib/jsonconfig.hpp>
+#include <nano/lib/numbers.hpp>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace nano
@@ -27,7 +31,55 @@ namespace ipc
 		 * Request is preamble followed by 32-bit BE payload length and payload bytes.
 		 * Response is 32-bit BE payload length followed by payload bytes.
 		 */
-		json_legacy = 1
+		json_legacy = 1,
+		/**
+		 * Same framing as json_legacy with a binary_action request payload and a binary_status response payload.
+		 */
+		binary = 2,
+		/**
+		 * Same framing as json_legacy with JSON subscribe and unsubscribe requests. Each request is acknowledged and the
+		 * server then pushes length prefixed JSON messages for the subscribed topics. A session that subscribed can only
+		 * send further subscription requests.
+		 */
+		subscription = 3
+	};
+
+	/** Topics a subscription session can filter by account */
+	enum class topic : uint8_t
+	{
+		/** Confirmed blocks of the accounts */
+		confirmation,
+		/** Balance or pending changes of the accounts from confirmed blocks */
+		account_balance,
+		/** Votes from the representatives on active elections */
+		vote
+	};
+
+	/**
+	 * Binary requests are the action byte followed by its arguments. Responses are a binary_status byte followed by the
+	 * action's fields when successful. Fields have fixed sizes: hashes and accounts are 32 raw bytes, amounts 16 big endian
+	 * bytes, integers big endian. Only block_info ends with a variable sized field.
+	 */
+	enum class binary_action : uint8_t
+	{
+		/** account -> frontier, open block, representative block, balance, modified (8), block count (8), version (1) */
+		account_info = 1,
+		/** account -> balance, pending */
+		account_balance = 2,
+		/** block hash -> account, amount, balance, height (8), local timestamp (8), serialized block with its type byte */
+		block_info = 3,
+		/** block hash, include_active (1) -> exists (1) */
+		pending_exists = 4
+	};
+
+	enum class binary_status : uint8_t
+	{
+		success = 0,
+		not_found = 1,
+		/** Unknown action or arguments of the wrong size */
+		bad_request = 2,
+		/** The RPC read queue is full or stopping, the request can be retried */
+		busy = 3
 	};
 
 	/** Removes domain socket files on startup and shutdown */
@@ -78,6 +130,51 @@ namespace ipc
 		nano::error serialize_json (nano::jsonconfig & json) const;
 		ipc_config_domain_socket transport_domain;
 		ipc_config_tcp_socket transport_tcp;
+		/** Messages waiting to be written to a subscription session, a session falling further behind is closed */
+		size_t subscription_queue_limit{ 1024 };
+	};
+
+	/** Receives pushed messages from the broker */
+	class subscriber
+	{
+	public:
+		virtual ~subscriber () = default;
+		/** Queues a message, must not block */
+		virtual void push (std::shared_ptr<std::string> const &) = 0;
+	};
+
+	/**
+	 * Fans node observer events out to subscribers. Observers can't be removed from the node so they hold a weak pointer
+	 * to the broker, and subscribers are held weakly and pruned once their session ends. Messages are only built when a
+	 * subscription matches and shared between the matching subscribers. Thread-safe.
+	 */
+	class broker : public std::enable_shared_from_this<broker>
+	{
+	public:
+		broker (nano::node &);
+		/** Registers the node observers */
+		void start ();
+		/** Replaces the subscriber's filter for the topic, an empty account set matches every account */
+		void subscribe (std::shared_ptr<nano::ipc::subscriber> const &, nano::ipc::topic, std::unordered_set<nano::account> const &);
+		void unsubscribe (nano::ipc::subscriber const &, nano::ipc::topic);
+		size_t size ();
+		static bool parse_topic (std::string const &, nano::ipc::topic &);
+		static std::string topic_to_string (nano::ipc::topic);
+		/** Message text as written to subscribers */
+		static std::shared_ptr<std::string> json (boost::property_tree::ptree const &);
+
+	private:
+		class subscription
+		{
+		public:
+			std::weak_ptr<nano::ipc::subscriber> subscriber;
+			nano::ipc::topic topic;
+			std::unordered_set<nano::account> accounts;
+		};
+		void broadcast (nano::ipc::topic, nano::account const &, std::function<boost::property_tree::ptree ()> const &);
+		nano::node & node;
+		std::mutex mutex;
+		std::vector<subscription> subscriptions;
 	};
 
 	/** The IPC server accepts connections on one or more configured transports */
@@ -94,11 +191,26 @@ namespace ipc
 		/** Unique counter/id shared across sessions */
 		std::atomic<uint64_t> id_dispenser{ 0 };
 
+		/** Pushes node events to subscription sessions */
+		std::shared_ptr<nano::ipc::broker> broker;
+
 	private:
 		std::unique_ptr<dsock_file_remover> file_remover;
 		std::vector<std::shared_ptr<nano::ipc::transport>> transports;
 	};
 
+	/** Decodes binary requests into arguments and writes responses directly from store values */
+	class binary_handler
+	{
+	public:
+		binary_handler (nano::node &);
+		/** Appends the response payload for the request payload */
+		void process (std::vector<uint8_t> const &, std::vector<uint8_t> &);
+
+	private:
+		nano::node & node;
+	};
+
 	class ipc_client_impl
 	{
 	public:
@@ -151,5 +263,31 @@ namespace ipc
 		/** Calls the RPC server via IPC and waits for the result. The client must be connected. */
 		std::string request (std::string const & rpc_action_a);
 	};
+
+	/** Convenience wrapper for making synchronous binary requests via IPC */
+	class binary_ipc_client : public ipc_client
+	{
+	public:
+		binary_ipc_client (boost::asio::io_context & io_ctx_a) :
+		ipc_client (io_ctx_a)
+		{
+		}
+		/** Sends a binary request payload and waits for the response payload. The client must be connected. */
+		std::vector<uint8_t> request (std::vector<uint8_t> const & payload_a);
+	};
+
+	/** Convenience wrapper for synchronous subscription requests and pushed messages via IPC */
+	class subscription_ipc_client : public ipc_client
+	{
+	public:
+		subscription_ipc_client (boost::asio::io_context & io_ctx_a) :
+		ipc_client (io_ctx_a)
+		{
+		}
+		/** Sends a subscribe or unsubscribe request, its acknowledgement arrives through receive. The client must be connected. */
+		void send (std::string const & payload_a);
+		/** Waits for the next message from the server */
+		std::string receive ();
+	};
 }
 }
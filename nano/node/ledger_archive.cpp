@@ -0,0 +1,301 @@
+#include <nano/node/ledger_archive.hpp>
+
+#include <nano/node/node.hpp>
+
+#include <deque>
+#include <future>
+#include <limits>
+#include <thread>
+
+std::array<char, 4> constexpr nano::ledger_archive::magic;
+uint8_t constexpr nano::ledger_archive::version;
+size_t constexpr nano::ledger_archive::frame_blocks;
+size_t constexpr nano::ledger_archive::export_memory;
+
+uint64_t nano::ledger_archive::checksum (uint8_t const * data_a, size_t size_a)
+{
+	uint64_t result;
+	blake2b_state hash;
+	blake2b_init (&hash, sizeof (result));
+	blake2b_update (&hash, data_a, size_a);
+	blake2b_final (&hash, &result, sizeof (result));
+	return result;
+}
+
+nano::ledger_export::ledger_export (nano::node & node_a) :
+count (0),
+node (node_a),
+frame_count (0),
+current (0),
+spill (node_a.application_path / boost::str (boost::format ("ledger_export_%1%.ldb") % nano::random_pool::generate_word32 (0, std::numeric_limits<CryptoPP::word32>::max ())), nano::ledger_archive::export_memory, node_a.log),
+partial (spill, "partial")
+{
+	// Exports that didn't finish cleanly
+	nano::spill_store::remove_stale (node.application_path, "ledger_export_");
+}
+
+bool nano::ledger_export::run (boost::filesystem::path const & path_a, std::ostream & stream_a)
+{
+	file.open (path_a.string (), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	auto error (file.fail ());
+	if (!error)
+	{
+		file.write (nano::ledger_archive::magic.data (), nano::ledger_archive::magic.size ());
+		file.put (static_cast<char> (nano::ledger_archive::version));
+		auto begin (std::chrono::steady_clock::now ());
+		auto next_report (begin + std::chrono::seconds (1));
+		auto transaction (node.store.tx_begin_read ());
+		for (auto i (node.store.latest_begin (transaction)), n (node.store.latest_end ()); i != n && !file.fail (); ++i)
+		{
+			nano::account_info info (i->second);
+			current = nano::account (i->first);
+			write_chain (transaction, current, info.block_count);
+			partial.erase (current);
+			auto now (std::chrono::steady_clock::now ());
+			if (now >= next_report)
+			{
+				stream_a << boost::str (boost::format ("%1% blocks exported") % count) << std::endl;
+				next_report = now + std::chrono::seconds (1);
+			}
+		}
+		if (frame_count > 0)
+		{
+			write_frame ();
+		}
+		// Terminating frame carries the total so a truncated file can't pass as complete
+		frame.clear ();
+		{
+			nano::vectorstream stream (frame);
+			nano::write (stream, count);
+		}
+		write_frame ();
+		file.close ();
+		error = file.fail ();
+		stream_a << boost::str (boost::format ("%1% blocks exported in %2% seconds") % count % std::chrono::duration_cast<std::chrono::seconds> (std::chrono::steady_clock::now () - begin).count ()) << std::endl;
+	}
+	return error;
+}
+
+bool nano::ledger_export::written (nano::account const & account_a, uint64_t height_a)
+{
+	nano::ledger_export_position position;
+	return account_a.number () < current.number () || (!partial.get (account_a, position) && position.height >= height_a);
+}
+
+void nano::ledger_export::write_chain (nano::transaction const & transaction_a, nano::account const & account_a, uint64_t height_a)
+{
+	// Chains are written up to a height, writing the chains of unwritten sources first. An explicit stack avoids deep recursion on long receive dependencies
+	std::vector<std::pair<nano::account, uint64_t>> pending;
+	pending.emplace_back (account_a, height_a);
+	while (!pending.empty ())
+	{
+		auto account (pending.back ().first);
+		nano::ledger_export_position position;
+		if (partial.get (account, position))
+		{
+			nano::account_info info;
+			auto error (node.store.account_get (transaction_a, account, info));
+			assert (!error);
+			position.height = 0;
+			position.next = info.open_block;
+		}
+		if (position.height >= pending.back ().second)
+		{
+			pending.pop_back ();
+		}
+		else
+		{
+			nano::block_sideband sideband;
+			auto block (node.store.block_get (transaction_a, position.next, &sideband));
+			assert (block != nullptr);
+			auto dependency (false);
+			auto source (node.ledger.block_source (transaction_a, *block));
+			// Genesis and epoch blocks have a source that isn't a block
+			if (!source.is_zero () && node.store.block_exists (transaction_a, source))
+			{
+				nano::block_sideband source_sideband;
+				node.store.block_get (transaction_a, source, &source_sideband);
+				auto source_account (node.ledger.account (transaction_a, source));
+				if (!written (source_account, source_sideband.height))
+				{
+					pending.emplace_back (source_account, source_sideband.height);
+					dependency = true;
+				}
+			}
+			if (!dependency)
+			{
+				write_block (*block);
+				partial.put (account, nano::ledger_export_position{ sideband.height, sideband.successor });
+			}
+		}
+	}
+}
+
+void nano::ledger_export::write_block (nano::block const & block_a)
+{
+	{
+		nano::vectorstream stream (frame);
+		nano::serialize_block (stream, block_a);
+	}
+	++count;
+	if (++frame_count == nano::ledger_archive::frame_blocks)
+	{
+		write_frame ();
+	}
+}
+
+void nano::ledger_export::write_frame ()
+{
+	uint32_t size (static_cast<uint32_t> (frame.size ()));
+	auto checksum (nano::ledger_archive::checksum (frame.data (), frame.size ()));
+	file.write (reinterpret_cast<char const *> (&frame_count), sizeof (frame_count));
+	file.write (reinterpret_cast<char const *> (&size), sizeof (size));
+	file.write (reinterpret_cast<char const *> (&checksum), sizeof (checksum));
+	file.write (reinterpret_cast<char const *> (frame.data ()), frame.size ());
+	frame.clear ();
+	frame_count = 0;
+	// Positions spilled while filling the frame are committed together
+	spill.flush ();
+}
+
+nano::ledger_import::ledger_import (nano::node & node_a, unsigned threads_a) :
+count (0),
+node (node_a),
+threads (std::max (1U, threads_a))
+{
+}
+
+bool nano::ledger_import::run (boost::filesystem::path const & path_a, std::ostream & stream_a)
+{
+	std::ifstream file (path_a.string (), std::ios_base::in | std::ios_base::binary);
+	std::array<char, 4> magic;
+	file.read (magic.data (), magic.size ());
+	auto version (file.get ());
+	auto error (file.fail () || magic != nano::ledger_archive::magic || version != nano::ledger_archive::version);
+	if (!error)
+	{
+		auto begin (std::chrono::steady_clock::now ());
+		auto next_report (begin + std::chrono::seconds (1));
+		auto max_size (nano::ledger_archive::frame_blocks * (1 + nano::block::size (nano::block_type::state)));
+		using decoded = std::pair<bool, std::vector<nano::unchecked_info>>;
+		std::deque<std::future<decoded>> decoding;
+		auto done (false);
+		uint64_t total (0);
+		while (!error && (!done || !decoding.empty ()))
+		{
+			// Keep a frame decoding on each thread ahead of the one being queued
+			while (!error && !done && decoding.size () < threads)
+			{
+				uint32_t blocks;
+				uint32_t size;
+				uint64_t checksum;
+				file.read (reinterpret_cast<char *> (&blocks), sizeof (blocks));
+				file.read (reinterpret_cast<char *> (&size), sizeof (size));
+				file.read (reinterpret_cast<char *> (&checksum), sizeof (checksum));
+				error = file.fail () || blocks > nano::ledger_archive::frame_blocks || size > max_size;
+				if (!error)
+				{
+					auto payload (std::make_shared<std::vector<uint8_t>> (size));
+					file.read (reinterpret_cast<char *> (payload->data ()), size);
+					error = file.fail ();
+					if (!error)
+					{
+						if (blocks == 0)
+						{
+							nano::bufferstream stream (payload->data (), payload->size ());
+							error = nano::ledger_archive::checksum (payload->data (), payload->size ()) != checksum || nano::try_read (stream, total);
+							done = true;
+						}
+						else
+						{
+							auto & ledger (node.ledger);
+							decoding.push_back (std::async (std::launch::async, [&ledger, payload, blocks, checksum]() {
+								decoded result;
+								result.first = decode (ledger, *payload, blocks, checksum, result.second);
+								return result;
+							}));
+						}
+					}
+				}
+			}
+			if (!error && !decoding.empty ())
+			{
+				auto frame (decoding.front ().get ());
+				decoding.pop_front ();
+				error = frame.first;
+				if (!error)
+				{
+					while (node.block_processor.full ())
+					{
+						std::this_thread::sleep_for (std::chrono::milliseconds (10));
+					}
+					node.block_processor.add (frame.second);
+					count += frame.second.size ();
+				}
+			}
+			auto now (std::chrono::steady_clock::now ());
+			if (now >= next_report)
+			{
+				report (stream_a, now - begin);
+				next_report = now + std::chrono::seconds (1);
+			}
+		}
+		node.block_processor.flush ();
+		if (!error && total != count)
+		{
+			error = true;
+		}
+		stream_a << (error ? "Import stopped at a corrupt or truncated frame" : "Import complete") << std::endl;
+		report (stream_a, std::chrono::steady_clock::now () - begin);
+	}
+	return error;
+}
+
+bool nano::ledger_import::decode (nano::ledger & ledger_a, std::vector<uint8_t> const & payload_a, uint32_t blocks_a, uint64_t checksum_a, std::vector<nano::unchecked_info> & blocks_out_a)
+{
+	auto error (nano::ledger_archive::checksum (payload_a.data (), payload_a.size ()) != checksum_a);
+	if (!error)
+	{
+		nano::bufferstream stream (payload_a.data (), payload_a.size ());
+		blocks_out_a.reserve (blocks_a);
+		for (uint32_t i (0); !error && i < blocks_a; ++i)
+		{
+			auto block (nano::deserialize_block (stream));
+			error = block == nullptr;
+			if (!error)
+			{
+				// Verified blocks skip the block processor's state block queue and stay in file order with legacy blocks, whose signing account only the ledger knows
+				auto verified (nano::signature_verification::unknown);
+				if (block->type () == nano::block_type::state || block->type () == nano::block_type::open)
+				{
+					auto hash (block->hash ());
+					// State blocks with an epoch link are epoch blocks if the epoch signer signed them, otherwise sends
+					if (!block->link ().is_zero () && ledger_a.is_epoch_link (block->link ()) && !nano::validate_message (ledger_a.epoch_signer, hash, block->block_signature ()))
+					{
+						verified = nano::signature_verification::valid_epoch;
+					}
+					else
+					{
+						error = nano::validate_message (block->account (), hash, block->block_signature ());
+						verified = nano::signature_verification::valid;
+					}
+				}
+				blocks_out_a.emplace_back (block, 0, 0, verified);
+			}
+		}
+	}
+	return error;
+}
+
+void nano::ledger_import::report (std::ostream & stream_a, std::chrono::steady_clock::duration elapsed_a)
+{
+	auto seconds (std::chrono::duration<double> (elapsed_a).count ());
+	uint64_t ledger_count (0);
+	uint64_t unchecked_count (0);
+	{
+		auto transaction (node.store.tx_begin_read ());
+		ledger_count = node.store.block_count (transaction).sum ();
+		unchecked_count = node.unchecked.count (transaction);
+	}
+	stream_a << boost::str (boost::format ("%1$.1fs: %2% blocks read (%3$.0f/s), ledger %4% blocks (%5$.0f/s), unchecked %6%, queued %7%") % seconds % count % (seconds > 0 ? count / seconds : 0) % ledger_count % (seconds > 0 ? ledger_count / seconds : 0) % unchecked_count % node.block_processor.size ()) << std::endl;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <nano/lib/blocks.hpp>
+#include <nano/node/spill.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace nano
+{
+class ledger;
+class node;
+class transaction;
+class unchecked_info;
+/**
+ * Flat file of ledger blocks written by --ledger_export and read by --ledger_import
+ * Blocks are ordered so every block follows its previous block and the send it receives from, letting an import insert them without going through unchecked.
+ * File layout: "FLDG" magic, 1 byte format version, then frames of
+ * 4 byte block count, 4 byte payload size, 8 byte blake2b checksum of the payload, payload.
+ * The payload is each block's type byte followed by its serialization. A frame with a block count of 0 ends the file, its payload is the 8 byte total block count.
+ */
+class ledger_archive
+{
+public:
+	static uint64_t checksum (uint8_t const *, size_t);
+	static std::array<char, 4> constexpr magic = { { 'F', 'L', 'D', 'G' } };
+	static uint8_t constexpr version = 1;
+	static size_t constexpr frame_blocks = 4096;
+	// Memory for the export's partly written chains before they're moved to a temporary LMDB file
+	static size_t constexpr export_memory = 64 * 1024 * 1024;
+};
+
+/** Highest block written of a partly written chain and the block following it */
+class ledger_export_position
+{
+public:
+	uint64_t height;
+	nano::block_hash next;
+};
+
+/** Writes every account chain in the node's ledger to an archive */
+class ledger_export
+{
+public:
+	ledger_export (nano::node &);
+	// Returns true if the file couldn't be written
+	bool run (boost::filesystem::path const &, std::ostream &);
+	uint64_t count;
+
+private:
+	void write_chain (nano::transaction const &, nano::account const &, uint64_t);
+	void write_block (nano::block const &);
+	void write_frame ();
+	// Returns true if the chain is written up to the height
+	bool written (nano::account const &, uint64_t);
+	nano::node & node;
+	std::ofstream file;
+	std::vector<uint8_t> frame;
+	uint32_t frame_count;
+	// Accounts are exported in key order, so chains before current are complete and only the ones ahead of it that were written part way as a dependency are tracked
+	nano::account current;
+	nano::spill_store spill;
+	nano::spill_map<nano::ledger_export_position> partial;
+};
+
+/**
+ * Reads an archive, decoding, checksumming and verifying signatures of frames on several threads, and feeds the blocks to the block processor in file order.
+ * Signatures are verified before queueing so every block goes through the block processor's single in-order queue instead of the state block verification queue.
+ * Also usable as a reproducible ledger insertion benchmark, throughput is reported while importing.
+ */
+class ledger_import
+{
+public:
+	ledger_import (nano::node &, unsigned);
+	// Returns true if the file is missing, corrupt or truncated. Blocks from frames before the error are still imported
+	bool run (boost::filesystem::path const &, std::ostream &);
+	uint64_t count;
+
+private:
+	// Returns true on a checksum, decoding or signature error
+	static bool decode (nano::ledger &, std::vector<uint8_t> const &, uint32_t, uint64_t, std::vector<nano::unchecked_info> &);
+	void report (std::ostream &, std::chrono::steady_clock::duration);
+	nano::node & node;
+	unsigned threads;
+};
+}
@@ -9,6 +9,8 @@
 
 #include <queue>
 
+unsigned constexpr nano::mdb_env::max_readers;
+
 nano::mdb_env::mdb_env (bool & error_a, boost::filesystem::path const & path_a, int max_dbs, size_t map_size_a)
 {
 	boost::system::error_code error_mkdir, error_chmod;
@@ -28,8 +30,12 @@ nano::mdb_env::mdb_env (bool & error_a, boost::filesystem::path const & path_a,
 			// This can happen if something like 256 io_threads are specified in the node config
 			// MDB_NORDAHEAD will allow platforms that support it to load the DB in memory as needed.
 			auto status4 (mdb_env_open (environment, path_a.string ().c_str (), MDB_NOSUBDIR | MDB_NOTLS | MDB_NORDAHEAD, 00600));
-			release_assert (status4 == 0);
 			error_a = status4 != 0;
+			if (error_a)
+			{
+				mdb_env_close (environment);
+				environment = nullptr;
+			}
 		}
 		else
 		{
@@ -111,6 +117,26 @@ mdb_val (sizeof (val_a), const_cast<nano::pending_key *> (&val_a))
 {
 }
 
+nano::mdb_val::mdb_val (nano::pending_summary const & val_a) :
+mdb_val (sizeof (val_a), const_cast<nano::pending_summary *> (&val_a))
+{
+}
+
+nano::mdb_val::mdb_val (nano::pending_amount_key const & val_a) :
+mdb_val (sizeof (val_a), const_cast<nano::pending_amount_key *> (&val_a))
+{
+}
+
+nano::mdb_val::mdb_val (nano::delegator_key const & val_a) :
+mdb_val (sizeof (val_a), const_cast<nano::delegator_key *> (&val_a))
+{
+}
+
+nano::mdb_val::mdb_val (nano::representative_weight_key const & val_a) :
+mdb_val (sizeof (val_a), const_cast<nano::representative_weight_key *> (&val_a))
+{
+}
+
 nano::mdb_val::mdb_val (nano::unchecked_info const & val_a) :
 buffer (std::make_shared<std::vector<uint8_t>> ())
 {
@@ -197,6 +223,42 @@ nano::mdb_val::operator nano::pending_key () const
 	return result;
 }
 
+nano::mdb_val::operator nano::pending_summary () const
+{
+	nano::pending_summary result;
+	assert (value.mv_size == sizeof (result));
+	static_assert (sizeof (nano::pending_summary::count) + sizeof (nano::pending_summary::total) == sizeof (result), "Packed class");
+	std::copy (reinterpret_cast<uint8_t const *> (value.mv_data), reinterpret_cast<uint8_t const *> (value.mv_data) + sizeof (result), reinterpret_cast<uint8_t *> (&result));
+	return result;
+}
+
+nano::mdb_val::operator nano::pending_amount_key () const
+{
+	nano::pending_amount_key result;
+	assert (value.mv_size == sizeof (result));
+	static_assert (sizeof (nano::pending_amount_key::account) + sizeof (nano::pending_amount_key::inverted_amount) + sizeof (nano::pending_amount_key::hash) == sizeof (result), "Packed class");
+	std::copy (reinterpret_cast<uint8_t const *> (value.mv_data), reinterpret_cast<uint8_t const *> (value.mv_data) + sizeof (result), reinterpret_cast<uint8_t *> (&result));
+	return result;
+}
+
+nano::mdb_val::operator nano::delegator_key () const
+{
+	nano::delegator_key result;
+	assert (value.mv_size == sizeof (result));
+	static_assert (sizeof (nano::delegator_key::representative) + sizeof (nano::delegator_key::account) == sizeof (result), "Packed class");
+	std::copy (reinterpret_cast<uint8_t const *> (value.mv_data), reinterpret_cast<uint8_t const *> (value.mv_data) + sizeof (result), reinterpret_cast<uint8_t *> (&result));
+	return result;
+}
+
+nano::mdb_val::operator nano::representative_weight_key () const
+{
+	nano::representative_weight_key result;
+	assert (value.mv_size == sizeof (result));
+	static_assert (sizeof (nano::representative_weight_key::inverted_weight) + sizeof (nano::representative_weight_key::representative) == sizeof (result), "Packed class");
+	std::copy (reinterpret_cast<uint8_t const *> (value.mv_data), reinterpret_cast<uint8_t const *> (value.mv_data) + sizeof (result), reinterpret_cast<uint8_t *> (&result));
+	return result;
+}
+
 nano::mdb_val::operator nano::unchecked_info () const
 {
 	nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.mv_data), value.mv_size);
@@ -696,6 +758,9 @@ nano::mdb_val nano::wallet_value::val () const
 }
 
 template class nano::mdb_iterator<nano::pending_key, nano::pending_info>;
+template class nano::mdb_iterator<nano::pending_amount_key, nano::uint256_union>;
+template class nano::mdb_iterator<nano::delegator_key, nano::no_value>;
+template class nano::mdb_iterator<nano::representative_weight_key, nano::no_value>;
 template class nano::mdb_iterator<nano::uint256_union, nano::block_info>;
 template class nano::mdb_iterator<nano::uint256_union, nano::uint128_union>;
 template class nano::mdb_iterator<nano::uint256_union, nano::uint256_union>;
@@ -716,6 +781,43 @@ nano::store_iterator<nano::account, nano::uint128_union> nano::mdb_store::repres
 	return result;
 }
 
+nano::store_iterator<nano::representative_weight_key, nano::no_value> nano::mdb_store::representative_weights_begin (nano::transaction const & transaction_a)
+{
+	nano::store_iterator<nano::representative_weight_key, nano::no_value> result (std::make_unique<nano::mdb_iterator<nano::representative_weight_key, nano::no_value>> (transaction_a, representative_weights));
+	return result;
+}
+
+nano::store_iterator<nano::representative_weight_key, nano::no_value> nano::mdb_store::representative_weights_end ()
+{
+	nano::store_iterator<nano::representative_weight_key, nano::no_value> result (nullptr);
+	return result;
+}
+
+void nano::mdb_store::delegator_put (nano::transaction const & transaction_a, nano::delegator_key const & key_a)
+{
+	auto status (mdb_put (env.tx (transaction_a), delegators, nano::mdb_val (key_a), nano::mdb_val (0, nullptr), 0));
+	release_assert (status == 0);
+}
+
+void nano::mdb_store::delegator_del (nano::transaction const & transaction_a, nano::delegator_key const & key_a)
+{
+	// Accounts written before upgrade_v15_to_v16 builds the index aren't in it
+	auto status (mdb_del (env.tx (transaction_a), delegators, nano::mdb_val (key_a), nullptr));
+	release_assert (status == 0 || status == MDB_NOTFOUND);
+}
+
+nano::store_iterator<nano::delegator_key, nano::no_value> nano::mdb_store::delegators_begin (nano::transaction const & transaction_a, nano::account const & representative_a)
+{
+	nano::store_iterator<nano::delegator_key, nano::no_value> result (std::make_unique<nano::mdb_iterator<nano::delegator_key, nano::no_value>> (transaction_a, delegators, nano::mdb_val (nano::delegator_key (representative_a, 0))));
+	return result;
+}
+
+nano::store_iterator<nano::delegator_key, nano::no_value> nano::mdb_store::delegators_end ()
+{
+	nano::store_iterator<nano::delegator_key, nano::no_value> result (nullptr);
+	return result;
+}
+
 nano::store_iterator<nano::unchecked_key, nano::unchecked_info> nano::mdb_store::unchecked_begin (nano::transaction const & transaction_a)
 {
 	nano::store_iterator<nano::unchecked_key, nano::unchecked_info> result (std::make_unique<nano::mdb_iterator<nano::unchecked_key, nano::unchecked_info>> (transaction_a, unchecked));
@@ -763,8 +865,14 @@ env (error_a, path_a, lmdb_max_dbs)
 		error_a |= mdb_dbi_open (env.tx (transaction), "state_v1", MDB_CREATE, &state_blocks_v1) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "pending", MDB_CREATE, &pending_v0) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "pending_v1", MDB_CREATE, &pending_v1) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction), "pending_summary", MDB_CREATE, &pending_summaries) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction), "pending_amount", MDB_CREATE, &pending_amounts) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "representation", MDB_CREATE, &representation) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction), "representative_weights", MDB_CREATE, &representative_weights) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction), "delegators", MDB_CREATE, &delegators) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction), "account_heights", MDB_CREATE, &account_heights) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "unchecked", MDB_CREATE, &unchecked) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction), "unchecked_modified", MDB_CREATE, &unchecked_modified) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "vote", MDB_CREATE, &vote) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "online_weight", MDB_CREATE, &online_weight) != 0;
 		error_a |= mdb_dbi_open (env.tx (transaction), "meta", MDB_CREATE, &meta) != 0;
@@ -829,6 +937,8 @@ void nano::mdb_store::initialize (nano::transaction const & transaction_a, nano:
 	block_put (transaction_a, hash_l, *genesis_a.open, sideband);
 	account_put (transaction_a, genesis_account, { hash_l, genesis_a.open->hash (), genesis_a.open->hash (), std::numeric_limits<nano::uint128_t>::max (), nano::seconds_since_epoch (), 1, nano::epoch::epoch_0 });
 	representation_put (transaction_a, genesis_account, std::numeric_limits<nano::uint128_t>::max ());
+	delegator_put (transaction_a, nano::delegator_key (genesis_a.open->representative (), genesis_account));
+	account_height_put (transaction_a, genesis_account, 1, hash_l);
 	frontier_put (transaction_a, hash_l, genesis_account);
 }
 
@@ -973,6 +1083,16 @@ void nano::mdb_store::do_upgrades (nano::transaction const & transaction_a, bool
 			slow_upgrade = true;
 			break;
 		case 13:
+			upgrade_v13_to_v14 (transaction_a);
+		case 14:
+			upgrade_v14_to_v15 (transaction_a);
+		case 15:
+			upgrade_v15_to_v16 (transaction_a);
+		case 16:
+			// Account heights are rebuilt in the background
+			slow_upgrade = true;
+			break;
+		case 17:
 			break;
 		default:
 			assert (false);
@@ -1188,8 +1308,16 @@ void nano::mdb_store::do_slow_upgrades (size_t const batch_size)
 			break;
 		case 12:
 			upgrade_v12_to_v13 (batch_size);
+			upgrade_v16_to_v17 (batch_size);
 			break;
 		case 13:
+		case 14:
+		case 15:
+			break;
+		case 16:
+			upgrade_v16_to_v17 (batch_size);
+			break;
+		case 17:
 			break;
 		default:
 			assert (false);
@@ -1269,6 +1397,112 @@ void nano::mdb_store::upgrade_v12_to_v13 (size_t const batch_size)
 	{
 		BOOST_LOG (logging.log) << boost::str (boost::format ("Completed sideband upgrade"));
 		version_put (transaction, 13);
+		upgrade_v13_to_v14 (transaction);
+		upgrade_v14_to_v15 (transaction);
+		upgrade_v15_to_v16 (transaction);
+	}
+}
+
+void nano::mdb_store::upgrade_v13_to_v14 (nano::transaction const & transaction_a)
+{
+	version_put (transaction_a, 14);
+	// Index the unchecked entries kept by --disable_unchecked_drop, the table is usually empty
+	mdb_drop (env.tx (transaction_a), unchecked_modified, 0);
+	for (auto i (unchecked_begin (transaction_a)), n (unchecked_end ()); i != n; ++i)
+	{
+		nano::unchecked_info info (i->second);
+		auto status (mdb_put (env.tx (transaction_a), unchecked_modified, unchecked_modified_key (info.modified, i->first), nano::mdb_val (0, nullptr), 0));
+		release_assert (status == 0);
+	}
+}
+
+void nano::mdb_store::upgrade_v14_to_v15 (nano::transaction const & transaction_a)
+{
+	version_put (transaction_a, 15);
+	mdb_drop (env.tx (transaction_a), pending_summaries, 0);
+	mdb_drop (env.tx (transaction_a), pending_amounts, 0);
+	for (auto i (pending_begin (transaction_a)), n (pending_end ()); i != n; ++i)
+	{
+		pending_index (transaction_a, nano::pending_key (i->first), nano::pending_info (i->second), false);
+	}
+}
+
+void nano::mdb_store::upgrade_v15_to_v16 (nano::transaction const & transaction_a)
+{
+	version_put (transaction_a, 16);
+	mdb_drop (env.tx (transaction_a), representative_weights, 0);
+	mdb_drop (env.tx (transaction_a), delegators, 0);
+	for (auto i (representation_begin (transaction_a)), n (representation_end ()); i != n; ++i)
+	{
+		auto status (mdb_put (env.tx (transaction_a), representative_weights, nano::mdb_val (nano::representative_weight_key (i->second, i->first)), nano::mdb_val (0, nullptr), 0));
+		release_assert (status == 0);
+	}
+	for (auto i (latest_begin (transaction_a)), n (latest_end ()); i != n; ++i)
+	{
+		nano::account_info info (i->second);
+		auto block (block_get (transaction_a, info.rep_block));
+		if (block != nullptr)
+		{
+			delegator_put (transaction_a, nano::delegator_key (block->representative (), i->first));
+		}
+	}
+}
+
+void nano::mdb_store::upgrade_v16_to_v17 (size_t const batch_size)
+{
+	auto transaction (tx_begin_write ());
+	if (!stopped && version_get (transaction) == 16)
+	{
+		// Blocks processed while this runs index their own heights, each account is indexed from its chain at the time it's visited
+		mdb_drop (env.tx (transaction), account_heights, 0);
+		size_t cost (0);
+		nano::account account (0);
+		auto const & not_an_account (nano::not_an_account ());
+		while (!stopped && account != not_an_account)
+		{
+			// Batches are only committed between accounts so a rollback can't remove the block being walked
+			if (cost >= batch_size)
+			{
+				BOOST_LOG (logging.log) << boost::str (boost::format ("Upgrading account heights for account %1%...") % account.to_account ().substr (0, 24));
+				auto tx (boost::polymorphic_downcast<nano::mdb_txn *> (transaction.impl.get ()));
+				auto status0 (mdb_txn_commit (*tx));
+				release_assert (status0 == MDB_SUCCESS);
+				std::this_thread::yield ();
+				auto status1 (mdb_txn_begin (env, nullptr, 0, &tx->handle));
+				release_assert (status1 == MDB_SUCCESS);
+				cost = 0;
+			}
+			nano::account first (0);
+			nano::account_info info;
+			{
+				auto current (latest_begin (transaction, account));
+				if (current != latest_end ())
+				{
+					first = current->first;
+					info = current->second;
+				}
+			}
+			if (!first.is_zero ())
+			{
+				uint64_t height (1);
+				for (auto hash (info.open_block); !hash.is_zero (); hash = block_successor (transaction, hash))
+				{
+					account_height_put (transaction, first, height, hash);
+					++height;
+					++cost;
+				}
+				account = first.number () + 1;
+			}
+			else
+			{
+				account = not_an_account;
+			}
+		}
+		if (account == not_an_account)
+		{
+			BOOST_LOG (logging.log) << boost::str (boost::format ("Completed account height upgrade"));
+			version_put (transaction, 17);
+		}
 	}
 }
 
@@ -1902,6 +2136,41 @@ size_t nano::mdb_store::account_count (nano::transaction const & transaction_a)
 	return result;
 }
 
+nano::mdb_val nano::mdb_store::account_height_key (nano::account const & account_a, uint64_t height_a)
+{
+	// Big endian height after the account so each chain sorts from its open block
+	nano::mdb_val result (height_a);
+	result.buffer->insert (result.buffer->begin (), account_a.bytes.begin (), account_a.bytes.end ());
+	result.value = { result.buffer->size (), result.buffer->data () };
+	return result;
+}
+
+nano::block_hash nano::mdb_store::account_height_get (nano::transaction const & transaction_a, nano::account const & account_a, uint64_t height_a)
+{
+	nano::mdb_val value;
+	auto status (mdb_get (env.tx (transaction_a), account_heights, account_height_key (account_a, height_a), value));
+	release_assert (status == 0 || status == MDB_NOTFOUND);
+	nano::block_hash result (0);
+	if (status == 0)
+	{
+		result = nano::uint256_union (value);
+	}
+	return result;
+}
+
+void nano::mdb_store::account_height_put (nano::transaction const & transaction_a, nano::account const & account_a, uint64_t height_a, nano::block_hash const & hash_a)
+{
+	auto status (mdb_put (env.tx (transaction_a), account_heights, account_height_key (account_a, height_a), nano::mdb_val (hash_a), 0));
+	release_assert (status == 0);
+}
+
+void nano::mdb_store::account_height_del (nano::transaction const & transaction_a, nano::account const & account_a, uint64_t height_a)
+{
+	// Blocks written before a sideband upgrade completes aren't indexed until it rebuilds the table
+	auto status (mdb_del (env.tx (transaction_a), account_heights, account_height_key (account_a, height_a), nullptr));
+	release_assert (status == 0 || status == MDB_NOTFOUND);
+}
+
 void nano::mdb_store::account_put (nano::transaction const & transaction_a, nano::account const & account_a, nano::account_info const & info_a)
 {
 	MDB_dbi db;
@@ -1936,12 +2205,22 @@ void nano::mdb_store::pending_put (nano::transaction const & transaction_a, nano
 			db = pending_v1;
 			break;
 	}
+	nano::pending_info existing;
+	if (!pending_get (transaction_a, key_a, existing))
+	{
+		pending_index (transaction_a, key_a, existing, true);
+	}
 	auto status (mdb_put (env.tx (transaction_a), db, nano::mdb_val (key_a), nano::mdb_val (pending_a), 0));
 	release_assert (status == 0);
+	pending_index (transaction_a, key_a, pending_a, false);
 }
 
 void nano::mdb_store::pending_del (nano::transaction const & transaction_a, nano::pending_key const & key_a)
 {
+	nano::pending_info existing;
+	auto error (pending_get (transaction_a, key_a, existing));
+	release_assert (!error);
+	pending_index (transaction_a, key_a, existing, true);
 	auto status1 (mdb_del (env.tx (transaction_a), pending_v1, mdb_val (key_a), nullptr));
 	if (status1 != 0)
 	{
@@ -1951,6 +2230,68 @@ void nano::mdb_store::pending_del (nano::transaction const & transaction_a, nano
 	}
 }
 
+void nano::mdb_store::pending_index (nano::transaction const & transaction_a, nano::pending_key const & key_a, nano::pending_info const & pending_a, bool remove_a)
+{
+	auto summary (pending_summary_get (transaction_a, key_a.account));
+	nano::pending_amount_key amount_key (key_a.account, pending_a.amount, key_a.hash);
+	auto indexed (true);
+	if (remove_a)
+	{
+		// Entries written before the store reached version 15 aren't indexed until upgrade_v14_to_v15 rebuilds the tables
+		auto status (mdb_del (env.tx (transaction_a), pending_amounts, nano::mdb_val (amount_key), nullptr));
+		release_assert (status == 0 || status == MDB_NOTFOUND);
+		indexed = status == 0;
+		if (indexed)
+		{
+			assert (summary.count > 0);
+			--summary.count;
+			summary.total = summary.total.number () - pending_a.amount.number ();
+		}
+	}
+	else
+	{
+		++summary.count;
+		summary.total = summary.total.number () + pending_a.amount.number ();
+		auto status (mdb_put (env.tx (transaction_a), pending_amounts, nano::mdb_val (amount_key), nano::mdb_val (pending_a.source), 0));
+		release_assert (status == 0);
+	}
+	if (indexed && summary.count > 0)
+	{
+		auto status (mdb_put (env.tx (transaction_a), pending_summaries, nano::mdb_val (key_a.account), nano::mdb_val (summary), 0));
+		release_assert (status == 0);
+	}
+	else if (indexed)
+	{
+		auto status (mdb_del (env.tx (transaction_a), pending_summaries, nano::mdb_val (key_a.account), nullptr));
+		release_assert (status == 0);
+	}
+}
+
+nano::pending_summary nano::mdb_store::pending_summary_get (nano::transaction const & transaction_a, nano::account const & account_a)
+{
+	nano::pending_summary result;
+	nano::mdb_val value;
+	auto status (mdb_get (env.tx (transaction_a), pending_summaries, nano::mdb_val (account_a), value));
+	release_assert (status == 0 || status == MDB_NOTFOUND);
+	if (status == 0)
+	{
+		result = static_cast<nano::pending_summary> (value);
+	}
+	return result;
+}
+
+nano::store_iterator<nano::pending_amount_key, nano::account> nano::mdb_store::pending_amount_begin (nano::transaction const & transaction_a, nano::pending_amount_key const & key_a)
+{
+	nano::store_iterator<nano::pending_amount_key, nano::account> result (std::make_unique<nano::mdb_iterator<nano::pending_amount_key, nano::account>> (transaction_a, pending_amounts, mdb_val (key_a)));
+	return result;
+}
+
+nano::store_iterator<nano::pending_amount_key, nano::account> nano::mdb_store::pending_amount_end ()
+{
+	nano::store_iterator<nano::pending_amount_key, nano::account> result (nullptr);
+	return result;
+}
+
 bool nano::mdb_store::pending_exists (nano::transaction const & transaction_a, nano::pending_key const & key_a)
 {
 	auto iterator (pending_begin (transaction_a, key_a));
@@ -2083,21 +2424,67 @@ nano::uint128_t nano::mdb_store::representation_get (nano::transaction const & t
 
 void nano::mdb_store::representation_put (nano::transaction const & transaction_a, nano::account const & account_a, nano::uint128_t const & representation_a)
 {
+	nano::mdb_val existing;
+	auto status1 (mdb_get (env.tx (transaction_a), representation, nano::mdb_val (account_a), existing));
+	release_assert (status1 == 0 || status1 == MDB_NOTFOUND);
+	if (status1 == 0)
+	{
+		// Upgrades that rebuild the representation table leave the weight index stale until it's rebuilt, so the old key may be missing
+		auto status2 (mdb_del (env.tx (transaction_a), representative_weights, nano::mdb_val (nano::representative_weight_key (nano::uint128_union (existing), account_a)), nullptr));
+		release_assert (status2 == 0 || status2 == MDB_NOTFOUND);
+	}
 	nano::uint128_union rep (representation_a);
-	auto status (mdb_put (env.tx (transaction_a), representation, nano::mdb_val (account_a), nano::mdb_val (rep), 0));
-	release_assert (status == 0);
+	auto status3 (mdb_put (env.tx (transaction_a), representation, nano::mdb_val (account_a), nano::mdb_val (rep), 0));
+	release_assert (status3 == 0);
+	auto status4 (mdb_put (env.tx (transaction_a), representative_weights, nano::mdb_val (nano::representative_weight_key (rep, account_a)), nano::mdb_val (0, nullptr), 0));
+	release_assert (status4 == 0);
 }
 
 void nano::mdb_store::unchecked_clear (nano::transaction const & transaction_a)
 {
 	auto status (mdb_drop (env.tx (transaction_a), unchecked, 0));
 	release_assert (status == 0);
+	auto status2 (mdb_drop (env.tx (transaction_a), unchecked_modified, 0));
+	release_assert (status2 == 0);
+}
+
+nano::mdb_val nano::mdb_store::unchecked_modified_key (uint64_t modified_a, nano::unchecked_key const & key_a)
+{
+	// Big endian time first so entries sort oldest first
+	nano::mdb_val result (modified_a);
+	{
+		nano::vectorstream stream (*result.buffer);
+		nano::write (stream, key_a.account.bytes);
+		nano::write (stream, key_a.hash.bytes);
+	}
+	result.value = { result.buffer->size (), result.buffer->data () };
+	return result;
+}
+
+void nano::mdb_store::unchecked_modified_del (nano::transaction const & transaction_a, nano::unchecked_key const & key_a)
+{
+	nano::mdb_val existing;
+	auto status (mdb_get (env.tx (transaction_a), unchecked, nano::mdb_val (key_a), existing));
+	release_assert (status == 0 || status == MDB_NOTFOUND);
+	if (status == 0)
+	{
+		// The modified time precedes the trailing signature_verification byte, read it without deserializing the block
+		uint64_t modified;
+		assert (existing.size () >= sizeof (modified) + sizeof (nano::signature_verification));
+		auto data (reinterpret_cast<uint8_t const *> (existing.data ()) + existing.size () - sizeof (nano::signature_verification) - sizeof (modified));
+		std::copy (data, data + sizeof (modified), reinterpret_cast<uint8_t *> (&modified));
+		auto status2 (mdb_del (env.tx (transaction_a), unchecked_modified, unchecked_modified_key (modified, key_a), nullptr));
+		release_assert (status2 == 0 || status2 == MDB_NOTFOUND);
+	}
 }
 
 void nano::mdb_store::unchecked_put (nano::transaction const & transaction_a, nano::unchecked_key const & key_a, nano::unchecked_info const & info_a)
 {
+	unchecked_modified_del (transaction_a, key_a);
 	auto status (mdb_put (env.tx (transaction_a), unchecked, nano::mdb_val (key_a), nano::mdb_val (info_a), 0));
 	release_assert (status == 0);
+	auto status2 (mdb_put (env.tx (transaction_a), unchecked_modified, unchecked_modified_key (info_a.modified, key_a), nano::mdb_val (0, nullptr), 0));
+	release_assert (status2 == 0);
 }
 
 void nano::mdb_store::unchecked_put (nano::transaction const & transaction_a, nano::block_hash const & hash_a, std::shared_ptr<nano::block> const & block_a)
@@ -2140,10 +2527,49 @@ bool nano::mdb_store::unchecked_exists (nano::transaction const & transaction_a,
 
 void nano::mdb_store::unchecked_del (nano::transaction const & transaction_a, nano::unchecked_key const & key_a)
 {
+	unchecked_modified_del (transaction_a, key_a);
 	auto status (mdb_del (env.tx (transaction_a), unchecked, nano::mdb_val (key_a), nullptr));
 	release_assert (status == 0 || status == MDB_NOTFOUND);
 }
 
+size_t nano::mdb_store::unchecked_cleanup (nano::transaction const & transaction_a, uint64_t cutoff_a, size_t count_a)
+{
+	size_t result (0);
+	MDB_cursor * cursor;
+	auto status (mdb_cursor_open (env.tx (transaction_a), unchecked_modified, &cursor));
+	release_assert (status == 0);
+	auto done (false);
+	while (!done && result < count_a)
+	{
+		nano::mdb_val key;
+		nano::mdb_val value;
+		auto status2 (mdb_cursor_get (cursor, key, value, MDB_FIRST));
+		release_assert (status2 == 0 || status2 == MDB_NOTFOUND);
+		done = status2 == MDB_NOTFOUND;
+		if (!done)
+		{
+			assert (key.size () == sizeof (uint64_t) + sizeof (nano::unchecked_key));
+			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (key.data ()), key.size ());
+			uint64_t modified;
+			nano::unchecked_key unchecked_key;
+			auto error (nano::try_read (stream, modified) || nano::try_read (stream, unchecked_key.account.bytes) || nano::try_read (stream, unchecked_key.hash.bytes));
+			assert (!error);
+			boost::endian::big_to_native_inplace (modified);
+			done = modified >= cutoff_a;
+			if (!done)
+			{
+				auto status3 (mdb_del (env.tx (transaction_a), unchecked, nano::mdb_val (unchecked_key), nullptr));
+				release_assert (status3 == 0 || status3 == MDB_NOTFOUND);
+				auto status4 (mdb_cursor_del (cursor, 0));
+				release_assert (status4 == 0);
+				++result;
+			}
+		}
+	}
+	mdb_cursor_close (cursor);
+	return result;
+}
+
 size_t nano::mdb_store::unchecked_count (nano::transaction const & transaction_a)
 {
 	MDB_stat unchecked_stats;
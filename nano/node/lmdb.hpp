@@ -38,6 +38,8 @@ public:
 	nano::transaction tx_begin (bool = false) const;
 	MDB_txn * tx (nano::transaction const &) const;
 	MDB_env * environment;
+	// Size of LMDB's reader table, the default since mdb_env_set_maxreaders isn't called. Every open read transaction takes a slot
+	static unsigned constexpr max_readers = 126;
 };
 
 /**
@@ -52,6 +54,10 @@ public:
 	mdb_val (MDB_val const &, nano::epoch = nano::epoch::unspecified);
 	mdb_val (nano::pending_info const &);
 	mdb_val (nano::pending_key const &);
+	mdb_val (nano::pending_summary const &);
+	mdb_val (nano::pending_amount_key const &);
+	mdb_val (nano::delegator_key const &);
+	mdb_val (nano::representative_weight_key const &);
 	mdb_val (nano::unchecked_info const &);
 	mdb_val (size_t, void *);
 	mdb_val (nano::uint128_union const &);
@@ -66,6 +72,10 @@ public:
 	explicit operator nano::block_info () const;
 	explicit operator nano::pending_info () const;
 	explicit operator nano::pending_key () const;
+	explicit operator nano::pending_summary () const;
+	explicit operator nano::pending_amount_key () const;
+	explicit operator nano::delegator_key () const;
+	explicit operator nano::representative_weight_key () const;
 	explicit operator nano::unchecked_info () const;
 	explicit operator nano::uint128_union () const;
 	explicit operator nano::uint256_union () const;
@@ -181,6 +191,9 @@ public:
 	void account_del (nano::transaction const &, nano::account const &) override;
 	bool account_exists (nano::transaction const &, nano::account const &) override;
 	size_t account_count (nano::transaction const &) override;
+	nano::block_hash account_height_get (nano::transaction const &, nano::account const &, uint64_t) override;
+	void account_height_put (nano::transaction const &, nano::account const &, uint64_t, nano::block_hash const &) override;
+	void account_height_del (nano::transaction const &, nano::account const &, uint64_t) override;
 	nano::store_iterator<nano::account, nano::account_info> latest_v0_begin (nano::transaction const &, nano::account const &) override;
 	nano::store_iterator<nano::account, nano::account_info> latest_v0_begin (nano::transaction const &) override;
 	nano::store_iterator<nano::account, nano::account_info> latest_v0_end () override;
@@ -204,6 +217,9 @@ public:
 	nano::store_iterator<nano::pending_key, nano::pending_info> pending_begin (nano::transaction const &, nano::pending_key const &) override;
 	nano::store_iterator<nano::pending_key, nano::pending_info> pending_begin (nano::transaction const &) override;
 	nano::store_iterator<nano::pending_key, nano::pending_info> pending_end () override;
+	nano::pending_summary pending_summary_get (nano::transaction const &, nano::account const &) override;
+	nano::store_iterator<nano::pending_amount_key, nano::account> pending_amount_begin (nano::transaction const &, nano::pending_amount_key const &) override;
+	nano::store_iterator<nano::pending_amount_key, nano::account> pending_amount_end () override;
 
 	bool block_info_get (nano::transaction const &, nano::block_hash const &, nano::block_info &) override;
 	nano::uint128_t block_balance (nano::transaction const &, nano::block_hash const &) override;
@@ -214,6 +230,13 @@ public:
 	void representation_add (nano::transaction const &, nano::account const &, nano::uint128_t const &) override;
 	nano::store_iterator<nano::account, nano::uint128_union> representation_begin (nano::transaction const &) override;
 	nano::store_iterator<nano::account, nano::uint128_union> representation_end () override;
+	nano::store_iterator<nano::representative_weight_key, nano::no_value> representative_weights_begin (nano::transaction const &) override;
+	nano::store_iterator<nano::representative_weight_key, nano::no_value> representative_weights_end () override;
+
+	void delegator_put (nano::transaction const &, nano::delegator_key const &) override;
+	void delegator_del (nano::transaction const &, nano::delegator_key const &) override;
+	nano::store_iterator<nano::delegator_key, nano::no_value> delegators_begin (nano::transaction const &, nano::account const &) override;
+	nano::store_iterator<nano::delegator_key, nano::no_value> delegators_end () override;
 
 	void unchecked_clear (nano::transaction const &) override;
 	void unchecked_put (nano::transaction const &, nano::unchecked_key const &, nano::unchecked_info const &) override;
@@ -225,6 +248,7 @@ public:
 	nano::store_iterator<nano::unchecked_key, nano::unchecked_info> unchecked_begin (nano::transaction const &, nano::unchecked_key const &) override;
 	nano::store_iterator<nano::unchecked_key, nano::unchecked_info> unchecked_end () override;
 	size_t unchecked_count (nano::transaction const &) override;
+	size_t unchecked_cleanup (nano::transaction const &, uint64_t, size_t) override;
 
 	// Return latest vote for an account from store
 	std::shared_ptr<nano::vote> vote_get (nano::transaction const &, nano::account const &) override;
@@ -266,6 +290,18 @@ public:
 	void upgrade_v11_to_v12 (nano::transaction const &);
 	void do_slow_upgrades (size_t const);
 	void upgrade_v12_to_v13 (size_t const);
+	void upgrade_v13_to_v14 (nano::transaction const &);
+	void upgrade_v14_to_v15 (nano::transaction const &);
+	void upgrade_v15_to_v16 (nano::transaction const &);
+	void upgrade_v16_to_v17 (size_t const);
+	// Key of an entry in the unchecked_modified index
+	static nano::mdb_val unchecked_modified_key (uint64_t, nano::unchecked_key const &);
+	// Key of an entry in the account_heights index
+	static nano::mdb_val account_height_key (nano::account const &, uint64_t);
+	// Removes the index entry of an existing unchecked entry
+	void unchecked_modified_del (nano::transaction const &, nano::unchecked_key const &);
+	// Adds an entry to the pending summary and amount index, or removes it if the flag is set
+	void pending_index (nano::transaction const &, nano::pending_key const &, nano::pending_info const &, bool);
 	bool full_sideband (nano::transaction const &);
 
 	// Requires a write transaction
@@ -355,6 +391,18 @@ public:
 	 */
 	MDB_dbi pending_v1{ 0 };
 
+	/**
+	 * Number and sum of the pending entries of each destination account.
+	 * nano::account -> uint64_t, nano::amount
+	 */
+	MDB_dbi pending_summaries{ 0 };
+
+	/**
+	 * Pending entries of both versions ordered by descending amount within each destination account.
+	 * nano::account, nano::amount (inverted), nano::block_hash -> nano::account
+	 */
+	MDB_dbi pending_amounts{ 0 };
+
 	/**
 	 * Maps block hash to account and balance.
 	 * block_hash -> nano::account, nano::amount
@@ -367,12 +415,36 @@ public:
 	 */
 	MDB_dbi representation{ 0 };
 
+	/**
+	 * Representatives ordered by descending weight, mirroring the representation table.
+	 * nano::amount (inverted), nano::account -> no_value
+	 */
+	MDB_dbi representative_weights{ 0 };
+
+	/**
+	 * Accounts grouped by the representative of their rep_block.
+	 * nano::account (representative), nano::account -> no_value
+	 */
+	MDB_dbi delegators{ 0 };
+
+	/**
+	 * Blocks of each account chain by height, so history can start at any height without walking the chain.
+	 * (nano::account, uint64_t height big endian) -> nano::block_hash
+	 */
+	MDB_dbi account_heights{ 0 };
+
 	/**
 	 * Unchecked bootstrap blocks info.
 	 * nano::block_hash -> nano::unchecked_info
 	 */
 	MDB_dbi unchecked{ 0 };
 
+	/**
+	 * Unchecked entries ordered by age so expired ones are found without scanning the unchecked table.
+	 * (uint64_t modified big endian, nano::unchecked_key) -> empty
+	 */
+	MDB_dbi unchecked_modified{ 0 };
+
 	/**
 	 * Highest vote observed for account.
 	 * nano::account -> uint64_t
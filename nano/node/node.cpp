@@ -23,6 +23,7 @@ std::chrono::minutes constexpr nano::node::backup_interval;
 std::chrono::seconds constexpr nano::node::search_pending_interval;
 std::chrono::seconds constexpr nano::node::peer_interval;
 std::chrono::hours constexpr nano::node::unchecked_cleanup_interval;
+size_t constexpr nano::node::unchecked_cleanup_batch;
 std::chrono::milliseconds constexpr nano::node::process_confirmed_interval;
 
 int constexpr nano::port_mapping::mapping_timeout;
@@ -40,8 +41,9 @@ extern unsigned char nano_bootstrap_weights[];
 extern size_t nano_bootstrap_weights_size;
 }
 
-nano::network::network (nano::node & node_a, uint16_t port) :
+nano::network::network (nano::node & node_a, uint16_t port, std::shared_ptr<nano::datagram_transport> transport_a) :
 buffer_container (node_a.stats, nano::network::buffer_size, 4096), // 2Mb receive buffer
+transport (transport_a),
 socket (node_a.io_ctx, nano::endpoint (boost::asio::ip::address_v6::any (), port)),
 resolver (node_a.io_ctx),
 node (node_a),
@@ -128,7 +130,7 @@ void nano::network::receive ()
 			}
 			if (this->on)
 			{
-				this->node.alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [this]() { this->receive (); });
+				this->node.alarm.add (this->node.alarm.now () + std::chrono::seconds (5), [this]() { this->receive (); });
 			}
 		}
 	});
@@ -160,6 +162,11 @@ void nano::network::stop ()
 	}
 	resolver.cancel ();
 	buffer_container.stop ();
+	node.peers.tcp_channels_clear ();
+	if (capture != nullptr)
+	{
+		capture->close ();
+	}
 }
 
 void nano::network::send_keepalive (nano::endpoint const & endpoint_a)
@@ -246,7 +253,7 @@ void nano::network::republish (nano::block_hash const & hash_a, std::shared_ptr<
 		BOOST_LOG (node.log) << boost::str (boost::format ("Publishing %1% to %2%") % hash_a.to_string () % endpoint_a);
 	}
 	std::weak_ptr<nano::node> node_w (node.shared ());
-	send_buffer (buffer_a->data (), buffer_a->size (), endpoint_a, [node_w, endpoint_a](boost::system::error_code const & ec, size_t size) {
+	send_buffer (buffer_a->data (), buffer_a->size (), endpoint_a, [buffer_a, node_w, endpoint_a](boost::system::error_code const & ec, size_t size) {
 		if (auto node_l = node_w.lock ())
 		{
 			if (ec && node_l->config.logging.network_logging ())
@@ -277,7 +284,7 @@ bool confirm_block (nano::transaction const & transaction_a, nano::node & node_a
 				result = true;
 				auto vote (node_a.store.vote_generate (transaction_a, pub_a, prv_a, std::vector<nano::block_hash> (1, hash)));
 				nano::confirm_ack confirm (vote);
-				auto vote_bytes = confirm.to_bytes ();
+				auto vote_bytes (node_a.network.confirm_ack_bytes (vote));
 				for (auto j (list_a.begin ()), m (list_a.end ()); j != m; ++j)
 				{
 					node_a.network.confirm_send (confirm, vote_bytes, *j);
@@ -291,7 +298,7 @@ bool confirm_block (nano::transaction const & transaction_a, nano::node & node_a
 			for (auto & vote : votes)
 			{
 				nano::confirm_ack confirm (vote);
-				auto vote_bytes = confirm.to_bytes ();
+				auto vote_bytes (node_a.network.confirm_ack_bytes (vote));
 				for (auto j (list_a.begin ()), m (list_a.end ()); j != m; ++j)
 				{
 					node_a.network.confirm_send (confirm, vote_bytes, *j);
@@ -301,9 +308,7 @@ bool confirm_block (nano::transaction const & transaction_a, nano::node & node_a
 		// Republish if required
 		if (also_publish)
 		{
-			nano::publish publish (block_a);
-			std::shared_ptr<std::vector<uint8_t>> publish_bytes;
-			publish_bytes = publish.to_bytes ();
+			auto publish_bytes (node_a.network.publish_bytes (block_a));
 			for (auto j (list_a.begin ()), m (list_a.end ()); j != m; ++j)
 			{
 				node_a.network.republish (hash, publish_bytes, *j);
@@ -328,11 +333,7 @@ void nano::network::confirm_hashes (nano::transaction const & transaction_a, nan
 		node.wallets.foreach_representative (transaction_a, [this, &blocks_bundle_a, &peer_a, &transaction_a](nano::public_key const & pub_a, nano::raw_key const & prv_a) {
 			auto vote (this->node.store.vote_generate (transaction_a, pub_a, prv_a, blocks_bundle_a));
 			nano::confirm_ack confirm (vote);
-			std::shared_ptr<std::vector<uint8_t>> bytes (new std::vector<uint8_t>);
-			{
-				nano::vectorstream stream (*bytes);
-				confirm.serialize (stream);
-			}
+			auto bytes (this->node.network.confirm_ack_bytes (vote));
 			this->node.network.confirm_send (confirm, bytes, peer_a);
 			this->node.votes_cache.add (vote);
 		});
@@ -347,7 +348,7 @@ bool nano::network::send_votes_cache (nano::block_hash const & hash_a, nano::end
 	for (auto & vote : votes)
 	{
 		nano::confirm_ack confirm (vote);
-		auto vote_bytes = confirm.to_bytes ();
+		auto vote_bytes (confirm_ack_bytes (vote));
 		confirm_send (confirm, vote_bytes, peer_a);
 	}
 	// Returns true if votes were sent
@@ -358,13 +359,11 @@ bool nano::network::send_votes_cache (nano::block_hash const & hash_a, nano::end
 void nano::network::republish_block (std::shared_ptr<nano::block> block)
 {
 	auto hash (block->hash ());
-	auto list (node.peers.list_fanout ());
-	nano::publish message (block);
-	auto bytes = message.to_bytes ();
-	for (auto i (list.begin ()), n (list.end ()); i != n; ++i)
-	{
-		republish (hash, bytes, *i);
-	}
+	auto snapshot (node.peers.snapshot ());
+	auto bytes (publish_bytes (block));
+	snapshot->random_sample (snapshot->size_sqrt (), [this, &hash, &bytes](nano::peer_information const & peer_a) {
+		republish (hash, bytes, peer_a.endpoint);
+	});
 	if (node.config.logging.network_logging ())
 	{
 		BOOST_LOG (node.log) << boost::str (boost::format ("Block %1% was republished to peers") % hash.to_string ());
@@ -374,13 +373,7 @@ void nano::network::republish_block (std::shared_ptr<nano::block> block)
 void nano::network::republish_block (std::shared_ptr<nano::block> block, nano::endpoint const & peer_a)
 {
 	auto hash (block->hash ());
-	nano::publish message (block);
-	std::vector<uint8_t> bytes;
-	{
-		nano::vectorstream stream (bytes);
-		message.serialize (stream);
-	}
-	republish (hash, std::make_shared<std::vector<uint8_t>> (bytes), peer_a);
+	republish (hash, publish_bytes (block), peer_a);
 	if (node.config.logging.network_logging ())
 	{
 		BOOST_LOG (node.log) << boost::str (boost::format ("Block %1% was republished to peer") % hash.to_string ());
@@ -395,7 +388,7 @@ void nano::network::republish_block_batch (std::deque<std::shared_ptr<nano::bloc
 	if (!blocks_a.empty ())
 	{
 		std::weak_ptr<nano::node> node_w (node.shared ());
-		node.alarm.add (std::chrono::steady_clock::now () + std::chrono::milliseconds (delay_a + std::rand () % delay_a), [node_w, blocks_a, delay_a]() {
+		node.alarm.add (node.alarm.now () + std::chrono::milliseconds (delay_a + std::rand () % delay_a), [node_w, blocks_a, delay_a]() {
 			if (auto node_l = node_w.lock ())
 			{
 				node_l->network.republish_block_batch (blocks_a, delay_a);
@@ -414,12 +407,11 @@ void nano::network::republish_block_batch (std::deque<std::shared_ptr<nano::bloc
 void nano::network::republish_vote (std::shared_ptr<nano::vote> vote_a)
 {
 	nano::confirm_ack confirm (vote_a);
-	auto bytes = confirm.to_bytes ();
-	auto list (node.peers.list_fanout ());
-	for (auto j (list.begin ()), m (list.end ()); j != m; ++j)
-	{
-		node.network.confirm_send (confirm, bytes, *j);
-	}
+	auto bytes (confirm_ack_bytes (vote_a));
+	auto snapshot (node.peers.snapshot ());
+	snapshot->random_sample (snapshot->size_sqrt (), [this, &confirm, &bytes](nano::peer_information const & peer_a) {
+		confirm_send (confirm, bytes, peer_a.endpoint);
+	});
 }
 
 void nano::network::broadcast_confirm_req (std::shared_ptr<nano::block> block_a)
@@ -456,9 +448,14 @@ void nano::network::broadcast_confirm_req_base (std::shared_ptr<nano::block> blo
 		BOOST_LOG (node.log) << boost::str (boost::format ("Broadcasting confirm req for block %1% to %2% representatives") % block_a->hash ().to_string () % endpoints_a->size ());
 	}
 	auto count (0);
+	std::shared_ptr<std::vector<uint8_t>> bytes;
 	while (!endpoints_a->empty () && count < max_reps)
 	{
-		send_confirm_req (endpoints_a->back ().endpoint, block_a);
+		if (bytes == nullptr)
+		{
+			bytes = serialize (nano::confirm_req (block_a));
+		}
+		send_confirm_req (endpoints_a->back ().endpoint, bytes);
 		endpoints_a->pop_back ();
 		count++;
 	}
@@ -467,7 +464,7 @@ void nano::network::broadcast_confirm_req_base (std::shared_ptr<nano::block> blo
 		delay_a += std::rand () % broadcast_interval_ms;
 
 		std::weak_ptr<nano::node> node_w (node.shared ());
-		node.alarm.add (std::chrono::steady_clock::now () + std::chrono::milliseconds (delay_a), [node_w, block_a, endpoints_a, delay_a]() {
+		node.alarm.add (node.alarm.now () + std::chrono::milliseconds (delay_a), [node_w, block_a, endpoints_a, delay_a]() {
 			if (auto node_l = node_w.lock ())
 			{
 				node_l->network.broadcast_confirm_req_base (block_a, endpoints_a, delay_a, true);
@@ -489,8 +486,10 @@ void nano::network::broadcast_confirm_req_batch (std::unordered_map<nano::endpoi
 		auto j (request_bundle_a.begin ());
 		count++;
 		std::vector<std::pair<nano::block_hash, nano::block_hash>> roots_hashes;
-		// Limit max request size hash + root to 6 pairs
-		while (roots_hashes.size () <= confirm_req_hashes_max && !j->second.empty ())
+		// Limit max request size hash + root to 7 pairs over UDP, a TCP channel isn't bound by the datagram size
+		auto channel (node.config.tcp_realtime ? node.peers.tcp_channel (j->first) : nullptr);
+		size_t max_hashes ((channel != nullptr && channel->established ()) ? nano::message_header::count_max : confirm_req_hashes_max + 1);
+		while (roots_hashes.size () < max_hashes && !j->second.empty ())
 		{
 			roots_hashes.push_back (j->second.back ());
 			j->second.pop_back ();
@@ -504,7 +503,7 @@ void nano::network::broadcast_confirm_req_batch (std::unordered_map<nano::endpoi
 	if (!request_bundle_a.empty ())
 	{
 		std::weak_ptr<nano::node> node_w (node.shared ());
-		node.alarm.add (std::chrono::steady_clock::now () + std::chrono::milliseconds (delay_a), [node_w, request_bundle_a, delay_a]() {
+		node.alarm.add (node.alarm.now () + std::chrono::milliseconds (delay_a), [node_w, request_bundle_a, delay_a]() {
 			if (auto node_l = node_w.lock ())
 			{
 				node_l->network.broadcast_confirm_req_batch (request_bundle_a, delay_a + 50, true);
@@ -529,7 +528,7 @@ void nano::network::broadcast_confirm_req_batch (std::deque<std::pair<std::share
 	if (!deque_a.empty ())
 	{
 		std::weak_ptr<nano::node> node_w (node.shared ());
-		node.alarm.add (std::chrono::steady_clock::now () + std::chrono::milliseconds (delay_a + std::rand () % delay_a), [node_w, deque_a, delay_a]() {
+		node.alarm.add (node.alarm.now () + std::chrono::milliseconds (delay_a + std::rand () % delay_a), [node_w, deque_a, delay_a]() {
 			if (auto node_l = node_w.lock ())
 			{
 				node_l->network.broadcast_confirm_req_batch (deque_a, delay_a);
@@ -540,8 +539,11 @@ void nano::network::broadcast_confirm_req_batch (std::deque<std::pair<std::share
 
 void nano::network::send_confirm_req (nano::endpoint const & endpoint_a, std::shared_ptr<nano::block> block)
 {
-	nano::confirm_req message (block);
-	auto bytes = message.to_bytes ();
+	send_confirm_req (endpoint_a, serialize (nano::confirm_req (block)));
+}
+
+void nano::network::send_confirm_req (nano::endpoint const & endpoint_a, std::shared_ptr<std::vector<uint8_t>> bytes)
+{
 	if (node.config.logging.network_message_logging ())
 	{
 		BOOST_LOG (node.log) << boost::str (boost::format ("Sending confirm req to %1%") % endpoint_a);
@@ -561,19 +563,14 @@ void nano::network::send_confirm_req (nano::endpoint const & endpoint_a, std::sh
 
 void nano::network::send_confirm_req_hashes (nano::endpoint const & endpoint_a, std::vector<std::pair<nano::block_hash, nano::block_hash>> const & roots_hashes_a)
 {
-	nano::confirm_req message (roots_hashes_a);
-	std::vector<uint8_t> bytes;
-	{
-		nano::vectorstream stream (bytes);
-		message.serialize (stream);
-	}
+	auto bytes (serialize (nano::confirm_req (roots_hashes_a)));
 	if (node.config.logging.network_message_logging ())
 	{
 		BOOST_LOG (node.log) << boost::str (boost::format ("Sending confirm req hashes to %1%") % endpoint_a);
 	}
 	std::weak_ptr<nano::node> node_w (node.shared ());
 	node.stats.inc (nano::stat::type::message, nano::stat::detail::confirm_req, nano::stat::dir::out);
-	send_buffer (bytes.data (), bytes.size (), endpoint_a, [node_w](boost::system::error_code const & ec, size_t size) {
+	send_buffer (bytes->data (), bytes->size (), endpoint_a, [bytes, node_w](boost::system::error_code const & ec, size_t size) {
 		if (auto node_l = node_w.lock ())
 		{
 			if (ec && node_l->config.logging.network_logging ())
@@ -597,7 +594,7 @@ void rep_query (nano::node & node_a, T const & peers_a)
 		node_a.network.send_confirm_req (*i, block);
 	}
 	std::weak_ptr<nano::node> node_w (node_a.shared ());
-	node_a.alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [node_w, hash]() {
+	node_a.alarm.add (node_a.alarm.now () + std::chrono::seconds (5), [node_w, hash]() {
 		if (auto node_l = node_w.lock ())
 		{
 			node_l->rep_crawler.remove (hash);
@@ -789,6 +786,10 @@ public:
 				if (message_a.response->first != node.node_id.pub)
 				{
 					node.peers.insert (endpoint_l, message_a.header.version_using, false, message_a.response->first);
+					if (node.config.tcp_realtime && message_a.header.version_using >= nano::tcp_realtime_version)
+					{
+						node.network.tcp_realtime_connect (endpoint_l, message_a.response->first);
+					}
 				}
 			}
 			else if (node.config.logging.network_node_id_handshake_logging ())
@@ -811,8 +812,48 @@ public:
 };
 }
 
+void nano::network::tcp_realtime_connect (nano::endpoint const & endpoint_a, nano::account const & node_id_a)
+{
+	if (on && node.peers.tcp_channel (endpoint_a) == nullptr)
+	{
+		auto channel (std::make_shared<nano::tcp_channel> (node.shared (), endpoint_a, node_id_a));
+		if (!node.peers.tcp_channel_set (endpoint_a, channel))
+		{
+			channel->start ();
+		}
+	}
+}
+
+bool nano::network::receive_tcp_realtime (uint8_t const * data_a, size_t size_a, nano::endpoint const & endpoint_a)
+{
+	auto error (true);
+	if (on)
+	{
+		network_message_visitor visitor (node, endpoint_a);
+		nano::message_parser parser (node.block_uniquer, node.vote_uniquer, visitor, node.work);
+		parser.deserialize_buffer (data_a, size_a, nano::message_parser::max_tcp_realtime_message_size);
+		if (parser.status == nano::message_parser::parse_status::success)
+		{
+			error = false;
+		}
+		else
+		{
+			node.stats.inc (nano::stat::type::error);
+			if (node.config.logging.network_logging ())
+			{
+				BOOST_LOG (node.log) << boost::str (boost::format ("Invalid TCP realtime message from %1%: %2%") % endpoint_a % parser.status_string ());
+			}
+		}
+	}
+	return error;
+}
+
 void nano::network::receive_action (nano::udp_data * data_a, nano::endpoint const & local_endpoint_a)
 {
+	if (capture != nullptr)
+	{
+		capture->add (data_a->endpoint, data_a->buffer, data_a->size);
+	}
 	auto allowed_sender (true);
 	if (!on)
 	{
@@ -914,8 +955,24 @@ bool nano::operation::operator> (nano::operation const & other_a) const
 	return wakeup > other_a.wakeup;
 }
 
-nano::alarm::alarm (boost::asio::io_context & io_ctx_a) :
+std::chrono::steady_clock::time_point nano::real_clock::now ()
+{
+	return std::chrono::steady_clock::now ();
+}
+
+void nano::real_clock::wait_until (std::unique_lock<std::mutex> & lock_a, std::condition_variable & condition_a, std::chrono::steady_clock::time_point const & time_a)
+{
+	condition_a.wait_until (lock_a, time_a);
+}
+
+void nano::real_clock::wait (std::unique_lock<std::mutex> & lock_a, std::condition_variable & condition_a)
+{
+	condition_a.wait (lock_a);
+}
+
+nano::alarm::alarm (boost::asio::io_context & io_ctx_a, std::shared_ptr<nano::clock> clock_a) :
 io_ctx (io_ctx_a),
+clock (clock_a),
 thread ([this]() {
 	nano::thread_role::set (nano::thread_role::name::alarm);
 	run ();
@@ -925,7 +982,7 @@ thread ([this]() {
 
 nano::alarm::~alarm ()
 {
-	add (std::chrono::steady_clock::now (), nullptr);
+	add (clock->now (), nullptr);
 	thread.join ();
 }
 
@@ -940,7 +997,7 @@ void nano::alarm::run ()
 			auto & operation (operations.top ());
 			if (operation.function)
 			{
-				if (operation.wakeup <= std::chrono::steady_clock::now ())
+				if (operation.wakeup <= clock->now ())
 				{
 					io_ctx.post (operation.function);
 					operations.pop ();
@@ -948,7 +1005,7 @@ void nano::alarm::run ()
 				else
 				{
 					auto wakeup (operation.wakeup);
-					condition.wait_until (lock, wakeup);
+					clock->wait_until (lock, condition, wakeup);
 				}
 			}
 			else
@@ -958,7 +1015,7 @@ void nano::alarm::run ()
 		}
 		else
 		{
-			condition.wait (lock);
+			clock->wait (lock, condition);
 		}
 	}
 }
@@ -972,6 +1029,11 @@ void nano::alarm::add (std::chrono::steady_clock::time_point const & wakeup_a, s
 	condition.notify_all ();
 }
 
+std::chrono::steady_clock::time_point nano::alarm::now ()
+{
+	return clock->now ();
+}
+
 namespace nano
 {
 std::unique_ptr<seq_con_info_component> collect_seq_con_info (alarm & alarm, const std::string & name)
@@ -1218,7 +1280,7 @@ nano::vote_code nano::vote_processor::vote_blocking (nano::transaction const & t
 				if (max_vote->sequence > vote_a->sequence + 10000)
 				{
 					nano::confirm_ack confirm (max_vote);
-					node.network.confirm_send (confirm, confirm.to_bytes (), endpoint_a);
+					node.network.confirm_send (confirm, node.network.confirm_ack_bytes (max_vote), endpoint_a);
 				}
 				break;
 			case nano::vote_code::invalid:
@@ -1271,6 +1333,12 @@ void nano::vote_processor::flush ()
 	}
 }
 
+size_t nano::vote_processor::size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return votes.size ();
+}
+
 void nano::vote_processor::calculate_weights ()
 {
 	std::unique_lock<std::mutex> lock (mutex);
@@ -1409,7 +1477,7 @@ node (init_a, io_ctx_a, application_path_a, alarm_a, nano::node_config (peering_
 {
 }
 
-nano::node::node (nano::node_init & init_a, boost::asio::io_context & io_ctx_a, boost::filesystem::path const & application_path_a, nano::alarm & alarm_a, nano::node_config const & config_a, nano::work_pool & work_a, nano::node_flags flags_a) :
+nano::node::node (nano::node_init & init_a, boost::asio::io_context & io_ctx_a, boost::filesystem::path const & application_path_a, nano::alarm & alarm_a, nano::node_config const & config_a, nano::work_pool & work_a, nano::node_flags flags_a, std::shared_ptr<nano::datagram_transport> transport_a) :
 io_ctx (io_ctx_a),
 config (config_a),
 flags (flags_a),
@@ -1422,7 +1490,7 @@ wallets_store (*wallets_store_impl),
 gap_cache (*this),
 ledger (store, stats, config.epoch_block_link, config.epoch_block_signer),
 active (*this),
-network (*this, config.peering_port),
+network (*this, config.peering_port, transport_a),
 bootstrap_initiator (*this),
 bootstrap (io_ctx_a, config.peering_port, *this),
 peers (network.endpoint ()),
@@ -1432,6 +1500,7 @@ port_mapping (*this),
 checker (config.signature_checker_threads),
 vote_processor (*this),
 warmed_up (0),
+unchecked (store, stats, static_cast<size_t> (config.unchecked_memory_mb) * 1024 * 1024),
 block_processor (*this),
 block_processor_thread ([this]() {
 	nano::thread_role::set (nano::thread_role::name::block_processing);
@@ -1440,6 +1509,7 @@ block_processor_thread ([this]() {
 online_reps (ledger, config.online_weight_minimum.number ()),
 stats (config.stat_config),
 vote_uniquer (block_uniquer),
+callbacks (*this),
 startup_time (std::chrono::steady_clock::now ())
 {
 	wallets.observer = [this](bool active) {
@@ -1472,25 +1542,7 @@ startup_time (std::chrono::steady_clock::now ())
 					std::stringstream ostream;
 					boost::property_tree::write_json (ostream, event);
 					ostream.flush ();
-					auto body (std::make_shared<std::string> (ostream.str ()));
-					auto address (node_l->config.callback_address);
-					auto port (node_l->config.callback_port);
-					auto target (std::make_shared<std::string> (node_l->config.callback_target));
-					auto resolver (std::make_shared<boost::asio::ip::tcp::resolver> (node_l->io_ctx));
-					resolver->async_resolve (boost::asio::ip::tcp::resolver::query (address, std::to_string (port)), [node_l, address, port, target, body, resolver](boost::system::error_code const & ec, boost::asio::ip::tcp::resolver::iterator i_a) {
-						if (!ec)
-						{
-							node_l->do_rpc_callback (i_a, address, port, target, body, resolver);
-						}
-						else
-						{
-							if (node_l->config.logging.callback_logging ())
-							{
-								BOOST_LOG (node_l->log) << boost::str (boost::format ("Error resolving callback: %1%:%2%: %3%") % address % port % ec.message ());
-							}
-							node_l->stats.inc (nano::stat::type::error, nano::stat::detail::http_callback, nano::stat::dir::out);
-						}
-					});
+					node_l->callbacks.add (ostream.str ());
 				});
 			}
 		});
@@ -1549,6 +1601,19 @@ startup_time (std::chrono::steady_clock::now ())
 	}
 
 	BOOST_LOG (log) << boost::str (boost::format ("Work pool running %1% threads") % work.threads.size ());
+	if (!flags.capture_path.empty ())
+	{
+		network.capture = std::make_unique<nano::traffic_capture> ();
+		if (!network.capture->open (flags.capture_path))
+		{
+			BOOST_LOG (log) << boost::str (boost::format ("Capturing received traffic to %1%") % flags.capture_path);
+		}
+		else
+		{
+			BOOST_LOG (log) << boost::str (boost::format ("Unable to open traffic capture file %1%") % flags.capture_path);
+			network.capture.reset ();
+		}
+	}
 	if (!init_a.error ())
 	{
 		if (config.logging.node_lifetime_tracing ())
@@ -1612,78 +1677,6 @@ nano::node::~node ()
 	stop ();
 }
 
-void nano::node::do_rpc_callback (boost::asio::ip::tcp::resolver::iterator i_a, std::string const & address, uint16_t port, std::shared_ptr<std::string> target, std::shared_ptr<std::string> body, std::shared_ptr<boost::asio::ip::tcp::resolver> resolver)
-{
-	if (i_a != boost::asio::ip::tcp::resolver::iterator{})
-	{
-		auto node_l (shared_from_this ());
-		auto sock (std::make_shared<boost::asio::ip::tcp::socket> (node_l->io_ctx));
-		sock->async_connect (i_a->endpoint (), [node_l, target, body, sock, address, port, i_a, resolver](boost::system::error_code const & ec) mutable {
-			if (!ec)
-			{
-				auto req (std::make_shared<boost::beast::http::request<boost::beast::http::string_body>> ());
-				req->method (boost::beast::http::verb::post);
-				req->target (*target);
-				req->version (11);
-				req->insert (boost::beast::http::field::host, address);
-				req->insert (boost::beast::http::field::content_type, "application/json");
-				req->body () = *body;
-				req->prepare_payload ();
-				boost::beast::http::async_write (*sock, *req, [node_l, sock, address, port, req, i_a, target, body, resolver](boost::system::error_code const & ec, size_t bytes_transferred) mutable {
-					if (!ec)
-					{
-						auto sb (std::make_shared<boost::beast::flat_buffer> ());
-						auto resp (std::make_shared<boost::beast::http::response<boost::beast::http::string_body>> ());
-						boost::beast::http::async_read (*sock, *sb, *resp, [node_l, sb, resp, sock, address, port, i_a, target, body, resolver](boost::system::error_code const & ec, size_t bytes_transferred) mutable {
-							if (!ec)
-							{
-								if (resp->result () == boost::beast::http::status::ok)
-								{
-									node_l->stats.inc (nano::stat::type::http_callback, nano::stat::detail::initiate, nano::stat::dir::out);
-								}
-								else
-								{
-									if (node_l->config.logging.callback_logging ())
-									{
-										BOOST_LOG (node_l->log) << boost::str (boost::format ("Callback to %1%:%2% failed with status: %3%") % address % port % resp->result ());
-									}
-									node_l->stats.inc (nano::stat::type::error, nano::stat::detail::http_callback, nano::stat::dir::out);
-								}
-							}
-							else
-							{
-								if (node_l->config.logging.callback_logging ())
-								{
-									BOOST_LOG (node_l->log) << boost::str (boost::format ("Unable complete callback: %1%:%2%: %3%") % address % port % ec.message ());
-								}
-								node_l->stats.inc (nano::stat::type::error, nano::stat::detail::http_callback, nano::stat::dir::out);
-							};
-						});
-					}
-					else
-					{
-						if (node_l->config.logging.callback_logging ())
-						{
-							BOOST_LOG (node_l->log) << boost::str (boost::format ("Unable to send callback: %1%:%2%: %3%") % address % port % ec.message ());
-						}
-						node_l->stats.inc (nano::stat::type::error, nano::stat::detail::http_callback, nano::stat::dir::out);
-					}
-				});
-			}
-			else
-			{
-				if (node_l->config.logging.callback_logging ())
-				{
-					BOOST_LOG (node_l->log) << boost::str (boost::format ("Unable to connect to callback address: %1%:%2%: %3%") % address % port % ec.message ());
-				}
-				node_l->stats.inc (nano::stat::type::error, nano::stat::detail::http_callback, nano::stat::dir::out);
-				++i_a;
-				node_l->do_rpc_callback (i_a, address, port, target, body, resolver);
-			}
-		});
-	}
-}
-
 bool nano::node::copy_with_compaction (boost::filesystem::path const & destination_file)
 {
 	return !mdb_env_copy2 (boost::polymorphic_downcast<nano::mdb_store *> (store_impl.get ())->env.environment, destination_file.string ().c_str (), MDB_CP_COMPACT);
@@ -1748,11 +1741,13 @@ std::unique_ptr<seq_con_info_component> collect_seq_con_info (node & node, const
 	composite->add_component (collect_seq_con_info (node.vote_processor, "vote_processor"));
 	composite->add_component (collect_seq_con_info (node.rep_crawler, "rep_crawler"));
 	composite->add_component (collect_seq_con_info (node.block_processor, "block_processor"));
+	composite->add_component (collect_seq_con_info (node.unchecked, "unchecked"));
 	composite->add_component (collect_seq_con_info (node.block_arrival, "block_arrival"));
 	composite->add_component (collect_seq_con_info (node.online_reps, "online_reps"));
 	composite->add_component (collect_seq_con_info (node.votes_cache, "votes_cache"));
 	composite->add_component (collect_seq_con_info (node.block_uniquer, "block_uniquer"));
 	composite->add_component (collect_seq_con_info (node.vote_uniquer, "vote_uniquer"));
+	composite->add_component (collect_seq_con_info (node.callbacks, "http_callbacks"));
 	return composite;
 }
 }
@@ -1815,7 +1810,7 @@ void nano::gap_cache::vote (std::shared_ptr<nano::vote> vote_a)
 				if (start_bootstrap)
 				{
 					auto node_l (node.shared ());
-					auto now (std::chrono::steady_clock::now ());
+					auto now (node.alarm.now ());
 					node.alarm.add (nano::is_test_network ? now + std::chrono::milliseconds (5) : now + std::chrono::seconds (5), [node_l, hash]() {
 						auto transaction (node_l->store.tx_begin_read ());
 						if (!node_l->store.block_exists (transaction, hash))
@@ -1931,7 +1926,7 @@ void nano::node::start ()
 	{
 		// Delay to start wallet lazy bootstrap
 		auto this_l (shared ());
-		alarm.add (std::chrono::steady_clock::now () + std::chrono::minutes (1), [this_l]() {
+		alarm.add (alarm.now () + std::chrono::minutes (1), [this_l]() {
 			this_l->bootstrap_wallet ();
 		});
 	}
@@ -1946,6 +1941,12 @@ void nano::node::stop ()
 	{
 		block_processor_thread.join ();
 	}
+	if (flags.disable_unchecked_drop)
+	{
+		// Blocks waiting in memory would be lost otherwise, the table is dropped on startup by default
+		auto transaction (store.tx_begin_write ());
+		unchecked.flush (transaction);
+	}
 	vote_processor.stop ();
 	active.stop ();
 	network.stop ();
@@ -1954,6 +1955,7 @@ void nano::node::stop ()
 	port_mapping.stop ();
 	checker.stop ();
 	wallets.stop ();
+	callbacks.stop ();
 }
 
 void nano::node::keepalive_preconfigured (std::vector<std::string> const & peers_a)
@@ -2017,8 +2019,19 @@ void nano::node::ongoing_keepalive ()
 	{
 		network.send_keepalive (i->endpoint);
 	}
+	if (config.tcp_realtime)
+	{
+		// Retry realtime channels which failed or were never opened
+		for (auto & peer : peers_l)
+		{
+			if (peer.tcp_channel == nullptr && peer.node_id && peer.network_version >= nano::tcp_realtime_version)
+			{
+				network.tcp_realtime_connect (peer.endpoint, *peer.node_id);
+			}
+		}
+	}
 	std::weak_ptr<nano::node> node_w (shared_from_this ());
-	alarm.add (std::chrono::steady_clock::now () + period, [node_w]() {
+	alarm.add (alarm.now () + period, [node_w]() {
 		if (auto node_l = node_w.lock ())
 		{
 			node_l->ongoing_keepalive ();
@@ -2030,7 +2043,7 @@ void nano::node::ongoing_syn_cookie_cleanup ()
 {
 	peers.purge_syn_cookies (std::chrono::steady_clock::now () - syn_cookie_cutoff);
 	std::weak_ptr<nano::node> node_w (shared_from_this ());
-	alarm.add (std::chrono::steady_clock::now () + (syn_cookie_cutoff * 2), [node_w]() {
+	alarm.add (alarm.now () + (syn_cookie_cutoff * 2), [node_w]() {
 		if (auto node_l = node_w.lock ())
 		{
 			node_l->ongoing_syn_cookie_cleanup ();
@@ -2040,7 +2053,7 @@ void nano::node::ongoing_syn_cookie_cleanup ()
 
 void nano::node::ongoing_rep_crawl ()
 {
-	auto now (std::chrono::steady_clock::now ());
+	auto now (alarm.now ());
 	auto peers_l (peers.rep_crawl ());
 	rep_query (*this, peers_l);
 	if (network.on)
@@ -2057,7 +2070,7 @@ void nano::node::ongoing_rep_crawl ()
 
 void nano::node::ongoing_rep_calculation ()
 {
-	auto now (std::chrono::steady_clock::now ());
+	auto now (alarm.now ());
 	vote_processor.calculate_weights ();
 	std::weak_ptr<nano::node> node_w (shared_from_this ());
 	alarm.add (now + std::chrono::minutes (10), [node_w]() {
@@ -2082,7 +2095,7 @@ void nano::node::ongoing_bootstrap ()
 	}
 	bootstrap_initiator.bootstrap ();
 	std::weak_ptr<nano::node> node_w (shared_from_this ());
-	alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (next_wakeup), [node_w]() {
+	alarm.add (alarm.now () + std::chrono::seconds (next_wakeup), [node_w]() {
 		if (auto node_l = node_w.lock ())
 		{
 			node_l->ongoing_bootstrap ();
@@ -2097,7 +2110,7 @@ void nano::node::ongoing_store_flush ()
 		store.flush (transaction);
 	}
 	std::weak_ptr<nano::node> node_w (shared_from_this ());
-	alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [node_w]() {
+	alarm.add (alarm.now () + std::chrono::seconds (5), [node_w]() {
 		if (auto node_l = node_w.lock ())
 		{
 			node_l->ongoing_store_flush ();
@@ -2121,7 +2134,7 @@ void nano::node::ongoing_peer_store ()
 	}
 
 	std::weak_ptr<nano::node> node_w (shared_from_this ());
-	alarm.add (std::chrono::steady_clock::now () + peer_interval, [node_w]() {
+	alarm.add (alarm.now () + peer_interval, [node_w]() {
 		if (auto node_l = node_w.lock ())
 		{
 			node_l->ongoing_peer_store ();
@@ -2142,7 +2155,7 @@ void nano::node::backup_wallet ()
 		i->second->store.write_backup (transaction, backup_path / (i->first.to_string () + ".json"));
 	}
 	auto this_l (shared ());
-	alarm.add (std::chrono::steady_clock::now () + backup_interval, [this_l]() {
+	alarm.add (alarm.now () + backup_interval, [this_l]() {
 		this_l->backup_wallet ();
 	});
 }
@@ -2154,7 +2167,7 @@ void nano::node::search_pending ()
 	// Search pending
 	wallets.search_pending_all ();
 	auto this_l (shared ());
-	alarm.add (std::chrono::steady_clock::now () + search_pending_interval, [this_l]() {
+	alarm.add (alarm.now () + search_pending_interval, [this_l]() {
 		this_l->search_pending ();
 	});
 }
@@ -2181,33 +2194,14 @@ void nano::node::bootstrap_wallet ()
 
 void nano::node::unchecked_cleanup ()
 {
-	std::deque<nano::unchecked_key> cleaning_list;
-	// Collect old unchecked keys
+	auto cutoff (nano::seconds_since_epoch () - config.unchecked_cutoff_time.count ());
+	unchecked.cleanup (cutoff);
+	// Expired entries are found through the unchecked_modified index and deleted in short write transactions so block processing can interleave
+	size_t deleted (unchecked_cleanup_batch);
+	while (deleted == unchecked_cleanup_batch)
 	{
-		auto now (nano::seconds_since_epoch ());
-		auto transaction (store.tx_begin_read ());
-		// Max 128k records to clean, max 2 minutes reading to prevent slow i/o systems start issues
-		for (auto i (store.unchecked_begin (transaction)), n (store.unchecked_end ()); i != n && cleaning_list.size () < 128 * 1024 && nano::seconds_since_epoch () - now < 120; ++i)
-		{
-			nano::unchecked_key key (i->first);
-			nano::unchecked_info info (i->second);
-			if ((now - info.modified) > config.unchecked_cutoff_time.count ())
-			{
-				cleaning_list.push_back (key);
-			}
-		}
-	}
-	// Delete old unchecked keys in batches
-	while (!cleaning_list.empty ())
-	{
-		size_t deleted_count (0);
 		auto transaction (store.tx_begin_write ());
-		while (deleted_count++ < 2 * 1024 && !cleaning_list.empty ())
-		{
-			auto key (cleaning_list.front ());
-			cleaning_list.pop_front ();
-			store.unchecked_del (transaction, key);
-		}
+		deleted = store.unchecked_cleanup (transaction, cutoff, unchecked_cleanup_batch);
 	}
 }
 
@@ -2218,7 +2212,7 @@ void nano::node::ongoing_unchecked_cleanup ()
 		unchecked_cleanup ();
 	}
 	auto this_l (shared ());
-	alarm.add (std::chrono::steady_clock::now () + unchecked_cleanup_interval, [this_l]() {
+	alarm.add (alarm.now () + unchecked_cleanup_interval, [this_l]() {
 		this_l->ongoing_unchecked_cleanup ();
 	});
 }
@@ -2486,7 +2480,7 @@ public:
 					{
 						BOOST_LOG (node->log) << "Work peer(s) failed to generate work for root " << root.to_string () << ", retrying...";
 					}
-					auto now (std::chrono::steady_clock::now ());
+					auto now (node->alarm.now ());
 					auto root_l (root);
 					auto callback_l (callback);
 					std::weak_ptr<nano::node> node_w (node);
@@ -2579,7 +2573,7 @@ nano::uint128_t nano::node::delta ()
 void nano::node::ongoing_online_weight_calculation_queue ()
 {
 	std::weak_ptr<nano::node> node_w (shared_from_this ());
-	alarm.add (std::chrono::steady_clock::now () + (std::chrono::seconds (nano::online_reps::weight_period)), [node_w]() {
+	alarm.add (alarm.now () + (std::chrono::seconds (nano::online_reps::weight_period)), [node_w]() {
 		if (auto node_l = node_w.lock ())
 		{
 			node_l->ongoing_online_weight_calculation ();
@@ -2699,7 +2693,7 @@ void nano::node::process_confirmed (std::shared_ptr<nano::block> block_a, uint8_
 	{
 		iteration++;
 		std::weak_ptr<nano::node> node_w (shared ());
-		alarm.add (std::chrono::steady_clock::now () + process_confirmed_interval, [node_w, block_a, iteration]() {
+		alarm.add (alarm.now () + process_confirmed_interval, [node_w, block_a, iteration]() {
 			if (auto node_l = node_w.lock ())
 			{
 				node_l->process_confirmed (block_a, iteration);
@@ -2714,6 +2708,52 @@ void nano::node::process_message (nano::message & message_a, nano::endpoint cons
 	message_a.visit (visitor);
 }
 
+std::shared_ptr<std::vector<uint8_t>> nano::network::serialize (nano::message const & message_a)
+{
+	auto allocated (false);
+	auto result (buffer_pool.allocate (allocated));
+	{
+		nano::vectorstream stream (*result);
+		message_a.serialize (stream);
+	}
+	node.stats.inc (nano::stat::type::message_buffer, nano::stat::detail::serialize);
+	if (allocated)
+	{
+		node.stats.inc (nano::stat::type::message_buffer, nano::stat::detail::allocate);
+	}
+	return result;
+}
+
+std::shared_ptr<std::vector<uint8_t>> nano::network::publish_bytes (std::shared_ptr<nano::block> block_a)
+{
+	auto result (std::atomic_load (&block_a->publish_bytes));
+	if (result == nullptr)
+	{
+		result = serialize (nano::publish (block_a));
+		std::atomic_store (&block_a->publish_bytes, result);
+	}
+	else
+	{
+		node.stats.inc (nano::stat::type::message_buffer, nano::stat::detail::cached);
+	}
+	return result;
+}
+
+std::shared_ptr<std::vector<uint8_t>> nano::network::confirm_ack_bytes (std::shared_ptr<nano::vote> vote_a)
+{
+	auto result (std::atomic_load (&vote_a->confirm_ack_bytes));
+	if (result == nullptr)
+	{
+		result = serialize (nano::confirm_ack (vote_a));
+		std::atomic_store (&vote_a->confirm_ack_bytes, result);
+	}
+	else
+	{
+		node.stats.inc (nano::stat::type::message_buffer, nano::stat::detail::cached);
+	}
+	return result;
+}
+
 nano::endpoint nano::network::endpoint ()
 {
 	boost::system::error_code ec;
@@ -2972,13 +3012,41 @@ bool nano::reserved_address (nano::endpoint const & endpoint_a, bool blacklist_l
 }
 
 void nano::network::send_buffer (uint8_t const * data_a, size_t size_a, nano::endpoint const & endpoint_a, std::function<void(boost::system::error_code const &, size_t)> callback_a)
+{
+	std::shared_ptr<nano::tcp_channel> channel;
+	if (node.config.tcp_realtime)
+	{
+		channel = node.peers.tcp_channel (endpoint_a);
+	}
+	if (channel != nullptr && channel->established ())
+	{
+		node.stats.inc (nano::stat::type::tcp, nano::stat::dir::out);
+		channel->send_buffer (data_a, size_a, [this, callback_a](boost::system::error_code const & ec, size_t size_a) {
+			callback_a (ec, size_a);
+			this->node.stats.add (nano::stat::type::traffic, nano::stat::dir::out, size_a);
+		});
+	}
+	else
+	{
+		send_buffer_udp (data_a, size_a, endpoint_a, callback_a);
+	}
+}
+
+void nano::network::send_buffer_udp (uint8_t const * data_a, size_t size_a, nano::endpoint const & endpoint_a, std::function<void(boost::system::error_code const &, size_t)> callback_a)
 {
 	std::unique_lock<std::mutex> lock (socket_mutex);
 	if (node.config.logging.network_packet_logging ())
 	{
 		BOOST_LOG (node.log) << "Sending packet";
 	}
-	if (on.load ())
+	if (transport != nullptr)
+	{
+		transport->send (node, endpoint_a, data_a, size_a);
+		lock.unlock ();
+		callback_a (boost::system::error_code (), size_a);
+		node.stats.add (nano::stat::type::traffic, nano::stat::dir::out, size_a);
+	}
+	else if (on.load () && !node.flags.disable_udp_send)
 	{
 		socket.async_send_to (boost::asio::buffer (data_a, size_a), endpoint_a, [this, callback_a](boost::system::error_code const & ec, size_t size_a) {
 			callback_a (ec, size_a);
@@ -3015,13 +3083,13 @@ nano::election_vote_result::election_vote_result (bool replay_a, bool processed_
 nano::election::election (nano::node & node_a, std::shared_ptr<nano::block> block_a, std::function<void(std::shared_ptr<nano::block>)> const & confirmation_action_a) :
 confirmation_action (confirmation_action_a),
 node (node_a),
-election_start (std::chrono::steady_clock::now ()),
+election_start (node_a.alarm.now ()),
 status ({ block_a, 0 }),
 confirmed (false),
 stopped (false),
 announcements (0)
 {
-	last_votes.insert (std::make_pair (nano::not_an_account (), nano::vote_info{ std::chrono::steady_clock::now (), 0, block_a->hash () }));
+	last_votes.insert (std::make_pair (nano::not_an_account (), nano::vote_info{ node.alarm.now (), 0, block_a->hash () }));
 	blocks.insert (std::make_pair (block_a->hash (), block_a));
 }
 
@@ -3041,7 +3109,7 @@ void nano::election::confirm_once (nano::transaction const & transaction_a, bool
 	if (!confirmed.exchange (true))
 	{
 		status.election_end = std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::system_clock::now ().time_since_epoch ());
-		status.election_duration = std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - election_start);
+		status.election_duration = std::chrono::duration_cast<std::chrono::milliseconds> (node.alarm.now () - election_start);
 		auto winner_l (status.winner);
 		auto node_l (node.shared ());
 		auto confirmation_action_l (confirmation_action);
@@ -3194,7 +3262,7 @@ nano::election_vote_result nano::election::vote (nano::account rep, uint64_t seq
 			auto last_vote (last_vote_it->second);
 			if (last_vote.sequence < sequence || (last_vote.sequence == sequence && last_vote.hash < block_hash))
 			{
-				if (last_vote.time <= std::chrono::steady_clock::now () - std::chrono::seconds (cooldown))
+				if (last_vote.time <= node.alarm.now () - std::chrono::seconds (cooldown))
 				{
 					should_process = true;
 				}
@@ -3206,7 +3274,7 @@ nano::election_vote_result nano::election::vote (nano::account rep, uint64_t seq
 		}
 		if (should_process)
 		{
-			last_votes[rep] = { std::chrono::steady_clock::now (), sequence, block_hash };
+			last_votes[rep] = { node.alarm.now (), sequence, block_hash };
 			if (!confirmed)
 			{
 				confirm_if_quorum (transaction);
@@ -3531,7 +3599,7 @@ void nano::active_transactions::request_loop ()
 	{
 		request_confirm (lock);
 		const auto extra_delay (std::min (roots.size (), max_broadcast_queue) * node.network.broadcast_interval_ms * 2);
-		condition.wait_for (lock, std::chrono::milliseconds (request_interval_ms + extra_delay));
+		node.alarm.clock->wait_until (lock, condition, node.alarm.now () + std::chrono::milliseconds (request_interval_ms + extra_delay));
 	}
 }
 
@@ -3885,6 +3953,15 @@ nano::udp_data * nano::udp_buffer::dequeue ()
 	}
 	return result;
 }
+size_t nano::udp_buffer::size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return full.size ();
+}
+size_t nano::udp_buffer::capacity () const
+{
+	return entries.size ();
+}
 void nano::udp_buffer::release (nano::udp_data * data_a)
 {
 	assert (data_a != nullptr);
@@ -3,12 +3,16 @@
 #include <nano/lib/work.hpp>
 #include <nano/node/blockprocessor.hpp>
 #include <nano/node/bootstrap.hpp>
+#include <nano/node/capture.hpp>
+#include <nano/node/http_callback.hpp>
 #include <nano/node/logging.hpp>
 #include <nano/node/nodeconfig.hpp>
 #include <nano/node/peers.hpp>
 #include <nano/node/portmapping.hpp>
 #include <nano/node/signatures.hpp>
 #include <nano/node/stats.hpp>
+#include <nano/node/tcp.hpp>
+#include <nano/node/unchecked.hpp>
 #include <nano/node/wallet.hpp>
 #include <nano/secure/ledger.hpp>
 
@@ -38,6 +42,15 @@ static const char * NANO_MAJOR_MINOR_RC_VERSION = xstr (NANO_VERSION_MAJOR) "."
 namespace nano
 {
 class node;
+/**
+ * Delivers UDP datagrams in-process instead of over the socket, implemented by the test network simulator
+ */
+class datagram_transport
+{
+public:
+	virtual ~datagram_transport () = default;
+	virtual void send (nano::node &, nano::endpoint const &, uint8_t const *, size_t) = 0;
+};
 class election_status
 {
 public:
@@ -168,14 +181,37 @@ public:
 	std::chrono::steady_clock::time_point wakeup;
 	std::function<void()> function;
 };
+/**
+ * Source of time for the alarm and the election and vote timers, a simulated network replaces it with a virtual clock
+ */
+class clock
+{
+public:
+	virtual ~clock () = default;
+	virtual std::chrono::steady_clock::time_point now () = 0;
+	// Waits on the condition until the time point or a notification, callers re-check their state as wakeups may be spurious
+	virtual void wait_until (std::unique_lock<std::mutex> &, std::condition_variable &, std::chrono::steady_clock::time_point const &) = 0;
+	// Waits on the condition with no deadline
+	virtual void wait (std::unique_lock<std::mutex> &, std::condition_variable &) = 0;
+};
+class real_clock : public nano::clock
+{
+public:
+	std::chrono::steady_clock::time_point now () override;
+	void wait_until (std::unique_lock<std::mutex> &, std::condition_variable &, std::chrono::steady_clock::time_point const &) override;
+	void wait (std::unique_lock<std::mutex> &, std::condition_variable &) override;
+};
 class alarm
 {
 public:
-	alarm (boost::asio::io_context &);
+	alarm (boost::asio::io_context &, std::shared_ptr<nano::clock> = std::make_shared<nano::real_clock> ());
 	~alarm ();
 	void add (std::chrono::steady_clock::time_point const &, std::function<void()> const &);
 	void run ();
+	// Current time of the clock operations are scheduled against
+	std::chrono::steady_clock::time_point now ();
 	boost::asio::io_context & io_ctx;
+	std::shared_ptr<nano::clock> clock;
 	std::mutex mutex;
 	std::condition_variable condition;
 	std::priority_queue<operation, std::vector<operation>, std::greater<operation>> operations;
@@ -309,6 +345,10 @@ public:
 	void release (nano::udp_data *);
 	// Stop container and notify waiting threads
 	void stop ();
+	// Number of buffers filled and waiting to be serviced
+	size_t size ();
+	// Total number of buffers
+	size_t capacity () const;
 
 private:
 	nano::stat & stats;
@@ -323,7 +363,7 @@ private:
 class network
 {
 public:
-	network (nano::node &, uint16_t);
+	network (nano::node &, uint16_t, std::shared_ptr<nano::datagram_transport> = nullptr);
 	~network ();
 	void receive ();
 	void process_packets ();
@@ -346,12 +386,28 @@ public:
 	void broadcast_confirm_req_batch (std::unordered_map<nano::endpoint, std::vector<std::pair<nano::block_hash, nano::block_hash>>>, unsigned = broadcast_interval_ms, bool = false);
 	void broadcast_confirm_req_batch (std::deque<std::pair<std::shared_ptr<nano::block>, std::shared_ptr<std::vector<nano::peer_information>>>>, unsigned = broadcast_interval_ms);
 	void send_confirm_req (nano::endpoint const &, std::shared_ptr<nano::block>);
+	void send_confirm_req (nano::endpoint const &, std::shared_ptr<std::vector<uint8_t>>);
 	void send_confirm_req_hashes (nano::endpoint const &, std::vector<std::pair<nano::block_hash, nano::block_hash>> const &);
 	void confirm_hashes (nano::transaction const &, nano::endpoint const &, std::vector<nano::block_hash>);
 	bool send_votes_cache (nano::block_hash const &, nano::endpoint const &);
 	void send_buffer (uint8_t const *, size_t, nano::endpoint const &, std::function<void(boost::system::error_code const &, size_t)>);
+	void send_buffer_udp (uint8_t const *, size_t, nano::endpoint const &, std::function<void(boost::system::error_code const &, size_t)>);
+	// Open a realtime TCP channel to a peer which completed the node ID handshake
+	void tcp_realtime_connect (nano::endpoint const &, nano::account const &);
+	// Process a realtime message received over TCP, returns true if it couldn't be parsed
+	bool receive_tcp_realtime (uint8_t const *, size_t, nano::endpoint const &);
 	nano::endpoint endpoint ();
+	// Serializes into a pooled buffer which can be shared by every destination
+	std::shared_ptr<std::vector<uint8_t>> serialize (nano::message const &);
+	// Serialized messages cached on the block or vote, so every republish of it shares one buffer
+	std::shared_ptr<std::vector<uint8_t>> publish_bytes (std::shared_ptr<nano::block>);
+	std::shared_ptr<std::vector<uint8_t>> confirm_ack_bytes (std::shared_ptr<nano::vote>);
+	nano::message_buffer_pool buffer_pool;
 	nano::udp_buffer buffer_container;
+	// Set when received traffic is being recorded
+	std::unique_ptr<nano::traffic_capture> capture;
+	// Set when UDP traffic is delivered in-process by a test network simulator instead of the socket
+	std::shared_ptr<nano::datagram_transport> const transport;
 	boost::asio::ip::udp::socket socket;
 	std::mutex socket_mutex;
 	boost::asio::ip::udp::resolver resolver;
@@ -394,6 +450,7 @@ public:
 	nano::vote_code vote_blocking (nano::transaction const &, std::shared_ptr<nano::vote>, nano::endpoint, bool = false);
 	void verify_votes (std::deque<std::pair<std::shared_ptr<nano::vote>, nano::endpoint>> &);
 	void flush ();
+	size_t size ();
 	void calculate_weights ();
 	nano::node & node;
 	void stop ();
@@ -435,7 +492,7 @@ class node : public std::enable_shared_from_this<nano::node>
 {
 public:
 	node (nano::node_init &, boost::asio::io_context &, uint16_t, boost::filesystem::path const &, nano::alarm &, nano::logging const &, nano::work_pool &);
-	node (nano::node_init &, boost::asio::io_context &, boost::filesystem::path const &, nano::alarm &, nano::node_config const &, nano::work_pool &, nano::node_flags = nano::node_flags ());
+	node (nano::node_init &, boost::asio::io_context &, boost::filesystem::path const &, nano::alarm &, nano::node_config const &, nano::work_pool &, nano::node_flags = nano::node_flags (), std::shared_ptr<nano::datagram_transport> = nullptr);
 	~node ();
 	template <typename T>
 	void background (T action_a)
@@ -480,7 +537,6 @@ public:
 	void block_confirm (std::shared_ptr<nano::block>);
 	void process_fork (nano::transaction const &, std::shared_ptr<nano::block>);
 	bool validate_block_by_previous (nano::transaction const &, std::shared_ptr<nano::block>);
-	void do_rpc_callback (boost::asio::ip::tcp::resolver::iterator i_a, std::string const &, uint16_t, std::shared_ptr<std::string>, std::shared_ptr<std::string>, std::shared_ptr<boost::asio::ip::tcp::resolver>);
 	nano::uint128_t delta ();
 	void ongoing_online_weight_calculation ();
 	void ongoing_online_weight_calculation_queue ();
@@ -509,6 +565,7 @@ public:
 	nano::vote_processor vote_processor;
 	nano::rep_crawler rep_crawler;
 	unsigned warmed_up;
+	nano::unchecked_map unchecked;
 	nano::block_processor block_processor;
 	boost::thread block_processor_thread;
 	nano::block_arrival block_arrival;
@@ -518,6 +575,7 @@ public:
 	nano::keypair node_id;
 	nano::block_uniquer block_uniquer;
 	nano::vote_uniquer vote_uniquer;
+	nano::http_callbacks callbacks;
 	const std::chrono::steady_clock::time_point startup_time;
 	static double constexpr price_max = 16.0;
 	static double constexpr free_cutoff = 1024.0;
@@ -528,6 +586,7 @@ public:
 	static std::chrono::seconds constexpr search_pending_interval = nano::is_test_network ? std::chrono::seconds (1) : std::chrono::seconds (5 * 60);
 	static std::chrono::seconds constexpr peer_interval = search_pending_interval;
 	static std::chrono::hours constexpr unchecked_cleanup_interval = std::chrono::hours (1);
+	static size_t constexpr unchecked_cleanup_batch = 2 * 1024;
 	static std::chrono::milliseconds constexpr process_confirmed_interval = nano::is_test_network ? std::chrono::milliseconds (50) : std::chrono::milliseconds (500);
 };
 
@@ -34,8 +34,17 @@ enable_voting (false),
 bootstrap_connections (4),
 bootstrap_connections_max (64),
 callback_port (0),
+callback_connections (4),
+callback_queue_limit (4096),
+callback_batch_size (1),
+callback_retries (3),
+callback_timeout (10),
 lmdb_max_dbs (128),
 allow_local_peers (false),
+tcp_realtime (false),
+tcp_realtime_connections_max (64),
+lazy_bootstrap_memory_mb (256),
+unchecked_memory_mb (64),
 block_processor_batch_max_time (std::chrono::milliseconds (5000)),
 unchecked_cutoff_time (std::chrono::seconds (4 * 60 * 60)) // 4 hours
 {
@@ -113,9 +122,18 @@ nano::error nano::node_config::serialize_json (nano::jsonconfig & json) const
 	json.put ("callback_address", callback_address);
 	json.put ("callback_port", callback_port);
 	json.put ("callback_target", callback_target);
+	json.put ("callback_connections", callback_connections);
+	json.put ("callback_queue_limit", callback_queue_limit);
+	json.put ("callback_batch_size", callback_batch_size);
+	json.put ("callback_retries", callback_retries);
+	json.put ("callback_timeout", callback_timeout);
 	json.put ("lmdb_max_dbs", lmdb_max_dbs);
 	json.put ("block_processor_batch_max_time", block_processor_batch_max_time.count ());
 	json.put ("allow_local_peers", allow_local_peers);
+	json.put ("tcp_realtime", tcp_realtime);
+	json.put ("tcp_realtime_connections_max", tcp_realtime_connections_max);
+	json.put ("lazy_bootstrap_memory_mb", lazy_bootstrap_memory_mb);
+	json.put ("unchecked_memory_mb", unchecked_memory_mb);
 	json.put ("vote_minimum", vote_minimum.to_string_dec ());
 	json.put ("unchecked_cutoff_time", unchecked_cutoff_time.count ());
 
@@ -242,6 +260,17 @@ bool nano::node_config::upgrade_json (unsigned version_a, nano::jsonconfig & jso
 			upgraded = true;
 		}
 		case 16:
+			json.put ("tcp_realtime", tcp_realtime);
+			json.put ("tcp_realtime_connections_max", tcp_realtime_connections_max);
+			json.put ("lazy_bootstrap_memory_mb", lazy_bootstrap_memory_mb);
+			json.put ("unchecked_memory_mb", unchecked_memory_mb);
+			json.put ("callback_connections", callback_connections);
+			json.put ("callback_queue_limit", callback_queue_limit);
+			json.put ("callback_batch_size", callback_batch_size);
+			json.put ("callback_retries", callback_retries);
+			json.put ("callback_timeout", callback_timeout);
+			upgraded = true;
+		case 17:
 			break;
 		default:
 			throw std::runtime_error ("Unknown node_config version");
@@ -359,9 +388,18 @@ nano::error nano::node_config::deserialize_json (bool & upgraded_a, nano::jsonco
 		json.get<std::string> ("callback_address", callback_address);
 		json.get<uint16_t> ("callback_port", callback_port);
 		json.get<std::string> ("callback_target", callback_target);
+		json.get<unsigned> ("callback_connections", callback_connections);
+		json.get<unsigned> ("callback_queue_limit", callback_queue_limit);
+		json.get<unsigned> ("callback_batch_size", callback_batch_size);
+		json.get<unsigned> ("callback_retries", callback_retries);
+		json.get<unsigned> ("callback_timeout", callback_timeout);
 		json.get<int> ("lmdb_max_dbs", lmdb_max_dbs);
 		json.get<bool> ("enable_voting", enable_voting);
 		json.get<bool> ("allow_local_peers", allow_local_peers);
+		json.get<bool> ("tcp_realtime", tcp_realtime);
+		json.get<unsigned> ("tcp_realtime_connections_max", tcp_realtime_connections_max);
+		json.get<unsigned> ("lazy_bootstrap_memory_mb", lazy_bootstrap_memory_mb);
+		json.get<unsigned> ("unchecked_memory_mb", unchecked_memory_mb);
 		json.get<unsigned> (signature_checker_threads_key, signature_checker_threads);
 
 		// Validate ranges
@@ -378,6 +416,10 @@ nano::error nano::node_config::deserialize_json (bool & upgraded_a, nano::jsonco
 		{
 			json.get_error ().set ("io_threads must be non-zero");
 		}
+		if (callback_connections == 0)
+		{
+			json.get_error ().set ("callback_connections must be non-zero");
+		}
 	}
 	catch (std::runtime_error const & ex)
 	{
@@ -403,6 +445,7 @@ disable_bootstrap_listener (false),
 disable_unchecked_cleanup (false),
 disable_unchecked_drop (true),
 fast_bootstrap (false),
+disable_udp_send (false),
 sideband_batch_size (512)
 {
 }
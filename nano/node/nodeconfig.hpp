@@ -44,8 +44,26 @@ public:
 	std::string callback_address;
 	uint16_t callback_port;
 	std::string callback_target;
+	/** Persistent connections used to deliver callbacks */
+	unsigned callback_connections;
+	/** Callbacks waiting for a connection, past it new ones are dropped */
+	unsigned callback_queue_limit;
+	/** Callbacks sent in one POST as a JSON array, 1 posts each block as its own object */
+	unsigned callback_batch_size;
+	/** Retries of a failed POST with exponential backoff before its callbacks are dropped */
+	unsigned callback_retries;
+	/** Seconds to connect, or to send a POST and read its response, before the attempt counts as failed */
+	unsigned callback_timeout;
 	int lmdb_max_dbs;
 	bool allow_local_peers;
+	/** Open a persistent TCP channel to peers supporting it and send realtime messages over it instead of UDP */
+	bool tcp_realtime;
+	/** Inbound TCP realtime channels, counted apart from bootstrap_connections_max so they can't starve bootstrap serving */
+	unsigned tcp_realtime_connections_max;
+	/** Memory for lazy bootstrap block hashes and balances, past it they're moved to a temporary LMDB file */
+	unsigned lazy_bootstrap_memory_mb;
+	/** Memory for blocks waiting on a missing dependency, past it the oldest are written to the unchecked table */
+	unsigned unchecked_memory_mb;
 	nano::stat_config stat_config;
 	nano::ipc::ipc_config ipc_config;
 	nano::uint256_union epoch_block_link;
@@ -57,7 +75,7 @@ public:
 	static std::chrono::minutes constexpr wallet_backup_interval = std::chrono::minutes (5);
 	static int json_version ()
 	{
-		return 16;
+		return 17;
 	}
 };
 
@@ -73,6 +91,9 @@ public:
 	bool disable_unchecked_cleanup;
 	bool disable_unchecked_drop;
 	bool fast_bootstrap;
+	bool disable_udp_send;
 	size_t sideband_batch_size;
+	// Received datagrams are written to this file when it isn't empty
+	std::string capture_path;
 };
 }
@@ -1,5 +1,10 @@
 #include <nano/node/peers.hpp>
 
+#include <nano/node/tcp.hpp>
+#include <nano/node/xorshift.hpp>
+
+#include <numeric>
+
 nano::endpoint nano::map_endpoint_to_v6 (nano::endpoint const & endpoint_a)
 {
 	auto endpoint_l (endpoint_a);
@@ -33,11 +38,74 @@ bool nano::peer_information::operator< (nano::peer_information const & peer_info
 	return endpoint < peer_information_a.endpoint;
 }
 
+namespace
+{
+// Snapshot sampling doesn't need the locked cryptographic pool, each thread seeds its own generator from it once
+thread_local nano::xorshift1024star sample_generator;
+thread_local bool sample_generator_seeded (false);
+}
+
+std::vector<size_t> nano::peer_snapshot::random_indices (size_t count_a) const
+{
+	if (!sample_generator_seeded)
+	{
+		nano::random_pool::generate_block (reinterpret_cast<uint8_t *> (sample_generator.s.data ()), sample_generator.s.size () * sizeof (uint64_t));
+		sample_generator_seeded = true;
+	}
+	std::vector<size_t> result (peers.size ());
+	std::iota (result.begin (), result.end (), 0);
+	// Partial Fisher-Yates, only the first count_a positions are shuffled
+	auto count (std::min (count_a, result.size ()));
+	for (size_t i (0); i < count; ++i)
+	{
+		auto j (i + static_cast<size_t> (sample_generator.next () % (result.size () - i)));
+		std::swap (result[i], result[j]);
+	}
+	result.resize (count);
+	return result;
+}
+
+size_t nano::peer_snapshot::size_sqrt () const
+{
+	return static_cast<size_t> (std::ceil (std::sqrt (peers.size ())));
+}
+
 nano::peer_container::peer_container (nano::endpoint const & self_a) :
 self (self_a),
 peer_observer ([](nano::endpoint const &) {}),
-disconnect_observer ([]() {})
+disconnect_observer ([]() {}),
+snapshot_m (std::make_shared<nano::peer_snapshot> ())
+{
+}
+
+std::shared_ptr<nano::peer_snapshot const> nano::peer_container::snapshot () const
+{
+	return std::atomic_load (&snapshot_m);
+}
+
+void nano::peer_container::snapshot_update ()
 {
+	auto snapshot_l (std::make_shared<nano::peer_snapshot> ());
+	snapshot_l->peers.reserve (peers.size ());
+	for (auto & peer : peers)
+	{
+		snapshot_l->peers.push_back (peer);
+		// Channels hold the node, the snapshot mustn't extend their lifetime
+		snapshot_l->peers.back ().tcp_channel.reset ();
+	}
+	std::unordered_set<nano::account> probable_reps;
+	for (auto i (peers.get<6> ().begin ()), n (peers.get<6> ().end ()); i != n && !i->rep_weight.is_zero (); ++i)
+	{
+		snapshot_l->representatives.push_back (*i);
+		snapshot_l->representatives.back ().tcp_channel.reset ();
+		// Calculate if representative isn't recorded for several IP addresses
+		if (probable_reps.insert (i->probable_rep_account).second)
+		{
+			snapshot_l->probable_reps.push_back (snapshot_l->representatives.back ());
+			snapshot_l->total_weight += i->rep_weight.number ();
+		}
+	}
+	std::atomic_store (&snapshot_m, std::shared_ptr<nano::peer_snapshot const> (std::move (snapshot_l)));
 }
 
 bool nano::peer_container::contacted (nano::endpoint const & endpoint_a, unsigned version_a)
@@ -81,22 +149,21 @@ bool nano::peer_container::known_peer (nano::endpoint const & endpoint_a)
 // Simulating with sqrt_broadcast_simulate shows we only need to broadcast to sqrt(total_peers) random peers in order to successfully publish to everyone with high probability
 std::deque<nano::endpoint> nano::peer_container::list_fanout ()
 {
-	auto peers (random_set (size_sqrt ()));
+	auto snapshot_l (snapshot ());
 	std::deque<nano::endpoint> result;
-	for (auto i (peers.begin ()), n (peers.end ()); i != n; ++i)
-	{
-		result.push_back (*i);
-	}
+	snapshot_l->random_sample (snapshot_l->size_sqrt (), [&result](nano::peer_information const & peer_a) {
+		result.push_back (peer_a.endpoint);
+	});
 	return result;
 }
 
 std::deque<nano::endpoint> nano::peer_container::list ()
 {
+	auto snapshot_l (snapshot ());
 	std::deque<nano::endpoint> result;
-	std::lock_guard<std::mutex> lock (mutex);
-	for (auto i (peers.begin ()), j (peers.end ()); i != j; ++i)
+	for (auto & peer : snapshot_l->peers)
 	{
-		result.push_back (i->endpoint);
+		result.push_back (peer.endpoint);
 	}
 	nano::random_pool::shuffle (result.begin (), result.end ());
 	return result;
@@ -104,11 +171,15 @@ std::deque<nano::endpoint> nano::peer_container::list ()
 
 std::vector<nano::peer_information> nano::peer_container::list_vector (size_t count_a)
 {
+	// Contact times aren't published to the snapshot, callers of this want them current
 	std::vector<peer_information> result;
-	std::lock_guard<std::mutex> lock (mutex);
-	for (auto i (peers.begin ()), j (peers.end ()); i != j; ++i)
 	{
-		result.push_back (*i);
+		std::lock_guard<std::mutex> lock (mutex);
+		result.reserve (peers.size ());
+		for (auto i (peers.begin ()), j (peers.end ()); i != j; ++i)
+		{
+			result.push_back (*i);
+		}
 	}
 	random_pool::shuffle (result.begin (), result.end ());
 	if (result.size () > count_a)
@@ -122,22 +193,71 @@ nano::endpoint nano::peer_container::bootstrap_peer ()
 {
 	nano::endpoint result (boost::asio::ip::address_v6::any (), 0);
 	std::lock_guard<std::mutex> lock (mutex);
-	;
-	for (auto i (peers.get<4> ().begin ()), n (peers.get<4> ().end ()); i != n;)
+	auto best (peers.get<4> ().end ());
+	for (auto round (0); round < 2 && best == peers.get<4> ().end (); ++round)
 	{
-		if (i->network_version >= protocol_version_reasonable_min)
+		if (round > 0)
 		{
-			result = i->endpoint;
-			peers.get<4> ().modify (i, [](nano::peer_information & peer_a) {
-				peer_a.last_bootstrap_attempt = std::chrono::steady_clock::now ();
-			});
-			i = n;
+			// Every peer was returned this round, start the next one
+			bootstrap_round_start = std::chrono::steady_clock::now ();
 		}
-		else
+		size_t candidates (0);
+		// Ordered by last attempt, so the peers not attempted this round come first
+		for (auto i (peers.get<4> ().begin ()), n (peers.get<4> ().end ()); i != n && i->last_bootstrap_attempt < bootstrap_round_start && candidates < bootstrap_peer_candidates; ++i)
 		{
-			++i;
+			if (i->network_version >= protocol_version_reasonable_min)
+			{
+				++candidates;
+				if (best == n || i->bootstrap_rate > best->bootstrap_rate)
+				{
+					best = i;
+				}
+			}
 		}
 	}
+	if (best != peers.get<4> ().end ())
+	{
+		result = best->endpoint;
+		peers.get<4> ().modify (best, [](nano::peer_information & peer_a) {
+			peer_a.last_bootstrap_attempt = std::chrono::steady_clock::now ();
+		});
+	}
+	return result;
+}
+
+void nano::peer_container::bootstrap_rate_update (nano::endpoint const & endpoint_a, double rate_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (peers.find (endpoint_a));
+	if (existing != peers.end ())
+	{
+		peers.modify (existing, [rate_a](nano::peer_information & peer_a) {
+			peer_a.bootstrap_rate = peer_a.bootstrap_rate == 0 ? rate_a : (peer_a.bootstrap_rate + rate_a) / 2;
+		});
+	}
+}
+
+double nano::peer_container::bootstrap_rate (nano::endpoint const & endpoint_a)
+{
+	double result (0);
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (peers.find (endpoint_a));
+	if (existing != peers.end ())
+	{
+		result = existing->bootstrap_rate;
+	}
+	return result;
+}
+
+unsigned nano::peer_container::version (nano::endpoint const & endpoint_a)
+{
+	unsigned result (0);
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (peers.find (endpoint_a));
+	if (existing != peers.end ())
+	{
+		result = existing->network_version;
+	}
 	return result;
 }
 
@@ -187,29 +307,88 @@ bool nano::peer_container::validate_syn_cookie (nano::endpoint const & endpoint,
 	return result;
 }
 
-std::unordered_set<nano::endpoint> nano::peer_container::random_set (size_t count_a)
+boost::optional<nano::endpoint> nano::peer_container::node_id_endpoint (nano::account const & node_id_a)
 {
-	std::unordered_set<nano::endpoint> result;
-	result.reserve (count_a);
+	boost::optional<nano::endpoint> result;
 	std::lock_guard<std::mutex> lock (mutex);
-	// Stop trying to fill result with random samples after this many attempts
-	auto random_cutoff (count_a * 2);
-	auto peers_size (peers.size ());
-	// Usually count_a will be much smaller than peers.size()
-	// Otherwise make sure we have a cutoff on attempting to randomly fill
-	if (!peers.empty ())
-	{
-		for (auto i (0); i < random_cutoff && result.size () < count_a; ++i)
+	for (auto i (peers.begin ()), n (peers.end ()); i != n && !result; ++i)
+	{
+		if (i->node_id && *i->node_id == node_id_a)
 		{
-			auto index (nano::random_pool::generate_word32 (0, static_cast<CryptoPP::word32> (peers_size - 1)));
-			result.insert (peers.get<3> ()[index].endpoint);
+			result = i->endpoint;
+		}
+	}
+	return result;
+}
+
+std::shared_ptr<nano::tcp_channel> nano::peer_container::tcp_channel (nano::endpoint const & endpoint_a)
+{
+	std::shared_ptr<nano::tcp_channel> result;
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (peers.find (endpoint_a));
+	if (existing != peers.end ())
+	{
+		result = existing->tcp_channel;
+	}
+	return result;
+}
+
+bool nano::peer_container::tcp_channel_set (nano::endpoint const & endpoint_a, std::shared_ptr<nano::tcp_channel> channel_a)
+{
+	auto error (true);
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (peers.find (endpoint_a));
+	if (existing != peers.end () && existing->tcp_channel == nullptr)
+	{
+		peers.modify (existing, [channel_a](nano::peer_information & info) {
+			info.tcp_channel = channel_a;
+		});
+		error = false;
+	}
+	return error;
+}
+
+void nano::peer_container::tcp_channel_erase (nano::endpoint const & endpoint_a, nano::tcp_channel const * channel_a)
+{
+	std::shared_ptr<nano::tcp_channel> erased;
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (peers.find (endpoint_a));
+	if (existing != peers.end () && existing->tcp_channel.get () == channel_a)
+	{
+		peers.modify (existing, [&erased](nano::peer_information & info) {
+			erased = std::move (info.tcp_channel);
+		});
+	}
+}
+
+void nano::peer_container::tcp_channels_clear ()
+{
+	std::vector<std::shared_ptr<nano::tcp_channel>> channels;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		for (auto i (peers.begin ()), n (peers.end ()); i != n; ++i)
+		{
+			if (i->tcp_channel != nullptr)
+			{
+				peers.modify (i, [&channels](nano::peer_information & info) {
+					channels.push_back (std::move (info.tcp_channel));
+				});
+			}
 		}
 	}
-	// Fill the remainder with most recent contact
-	for (auto i (peers.get<1> ().begin ()), n (peers.get<1> ().end ()); i != n && result.size () < count_a; ++i)
+	for (auto & channel : channels)
 	{
-		result.insert (i->endpoint);
+		channel->close ();
 	}
+}
+
+std::unordered_set<nano::endpoint> nano::peer_container::random_set (size_t count_a)
+{
+	std::unordered_set<nano::endpoint> result;
+	result.reserve (count_a);
+	snapshot ()->random_sample (count_a, [&result](nano::peer_information const & peer_a) {
+		result.insert (peer_a.endpoint);
+	});
 	return result;
 }
 
@@ -232,17 +411,9 @@ void nano::peer_container::random_fill (std::array<nano::endpoint, 8> & target_a
 // Request a list of the top known representatives
 std::vector<nano::peer_information> nano::peer_container::representatives (size_t count_a)
 {
-	std::vector<peer_information> result;
-	result.reserve (std::min (count_a, size_t (16)));
-	std::lock_guard<std::mutex> lock (mutex);
-	for (auto i (peers.get<6> ().begin ()), n (peers.get<6> ().end ()); i != n && result.size () < count_a; ++i)
-	{
-		if (!i->rep_weight.is_zero ())
-		{
-			result.push_back (*i);
-		}
-	}
-	return result;
+	auto snapshot_l (snapshot ());
+	auto & representatives_l (snapshot_l->representatives);
+	return std::vector<peer_information> (representatives_l.begin (), representatives_l.begin () + std::min (count_a, representatives_l.size ()));
 }
 
 void nano::peer_container::purge_syn_cookies (std::chrono::steady_clock::time_point const & cutoff)
@@ -280,7 +451,11 @@ std::vector<nano::peer_information> nano::peer_container::purge_list (std::chron
 		auto pivot (peers.get<1> ().lower_bound (cutoff));
 		result.assign (pivot, peers.get<1> ().end ());
 		// Remove peers that haven't been heard from past the cutoff
-		peers.get<1> ().erase (peers.get<1> ().begin (), pivot);
+		if (pivot != peers.get<1> ().begin ())
+		{
+			peers.get<1> ().erase (peers.get<1> ().begin (), pivot);
+			snapshot_update ();
+		}
 		for (auto i (peers.begin ()), n (peers.end ()); i != n; ++i)
 		{
 			peers.modify (i, [](nano::peer_information & info) { info.last_attempt = std::chrono::steady_clock::now (); });
@@ -314,43 +489,22 @@ std::vector<nano::endpoint> nano::peer_container::rep_crawl ()
 
 size_t nano::peer_container::size ()
 {
-	std::lock_guard<std::mutex> lock (mutex);
-	return peers.size ();
+	return snapshot ()->peers.size ();
 }
 
 size_t nano::peer_container::size_sqrt ()
 {
-	return (static_cast<size_t> (std::ceil (std::sqrt (size ()))));
+	return snapshot ()->size_sqrt ();
 }
 
 std::vector<nano::peer_information> nano::peer_container::list_probable_rep_weights ()
 {
-	std::vector<nano::peer_information> result;
-	std::unordered_set<nano::account> probable_reps;
-	std::lock_guard<std::mutex> lock (mutex);
-	for (auto i (peers.get<6> ().begin ()), n (peers.get<6> ().end ()); i != n; ++i)
-	{
-		// Calculate if representative isn't recorded for several IP addresses
-		if (probable_reps.find (i->probable_rep_account) == probable_reps.end ())
-		{
-			if (!i->rep_weight.number ().is_zero ())
-			{
-				result.push_back (*i);
-			}
-			probable_reps.insert (i->probable_rep_account);
-		}
-	}
-	return result;
+	return snapshot ()->probable_reps;
 }
 
 nano::uint128_t nano::peer_container::total_weight ()
 {
-	nano::uint128_t result (0);
-	for (auto & entry : list_probable_rep_weights ())
-	{
-		result = result + entry.rep_weight.number ();
-	}
-	return result;
+	return snapshot ()->total_weight;
 }
 
 bool nano::peer_container::empty ()
@@ -393,6 +547,10 @@ bool nano::peer_container::rep_response (nano::endpoint const & endpoint_a, nano
 				info.probable_rep_account = rep_account_a;
 			}
 		});
+		if (updated)
+		{
+			snapshot_update ();
+		}
 	}
 	return updated;
 }
@@ -439,6 +597,7 @@ bool nano::peer_container::insert (nano::endpoint const & endpoint_a, unsigned v
 			auto existing (peers.find (endpoint_a));
 			if (existing != peers.end ())
 			{
+				auto node_id_changed (node_id_a.is_initialized () && existing->node_id != node_id_a);
 				peers.modify (existing, [node_id_a](nano::peer_information & info) {
 					info.last_contact = std::chrono::steady_clock::now ();
 					if (node_id_a.is_initialized ())
@@ -446,6 +605,10 @@ bool nano::peer_container::insert (nano::endpoint const & endpoint_a, unsigned v
 						info.node_id = node_id_a;
 					}
 				});
+				if (node_id_changed)
+				{
+					snapshot_update ();
+				}
 				result = true;
 			}
 			else
@@ -462,6 +625,7 @@ bool nano::peer_container::insert (nano::endpoint const & endpoint_a, unsigned v
 				if (!result)
 				{
 					peers.insert (nano::peer_information (endpoint_a, version_a, node_id_a));
+					snapshot_update ();
 				}
 			}
 		}
@@ -479,15 +643,21 @@ std::unique_ptr<seq_con_info_component> collect_seq_con_info (peer_container & p
 {
 	size_t peers_count = 0;
 	size_t attemps_count = 0;
+	size_t tcp_channels_count = 0;
 	{
 		std::lock_guard<std::mutex> guard (peer_container.mutex);
 		peers_count = peer_container.peers.size ();
 		attemps_count = peer_container.attempts.size ();
+		for (auto & peer : peer_container.peers)
+		{
+			tcp_channels_count += peer.tcp_channel != nullptr;
+		}
 	}
 
 	auto composite = std::make_unique<seq_con_info_composite> (name);
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "peers", peers_count, sizeof (decltype (peer_container.peers)::value_type) }));
 	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "attempts", attemps_count, sizeof (decltype (peer_container.attempts)::value_type) }));
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "tcp_channels", tcp_channels_count, sizeof (nano::tcp_channel) }));
 
 	size_t syn_cookies_count = 0;
 	size_t syn_cookies_per_ip_count = 0;
@@ -18,6 +18,7 @@
 namespace nano
 {
 nano::endpoint map_endpoint_to_v6 (nano::endpoint const &);
+class tcp_channel;
 
 /** Multi-index helper */
 class peer_by_ip_addr
@@ -54,12 +55,45 @@ public:
 	std::chrono::steady_clock::time_point last_rep_request{ std::chrono::steady_clock::time_point () };
 	std::chrono::steady_clock::time_point last_rep_response{ std::chrono::steady_clock::time_point () };
 	nano::amount rep_weight{ 0 };
+	// Blocks per second this peer served to our bootstrap pulls, averaged over attempts. Zero if never measured
+	double bootstrap_rate{ 0 };
 	nano::account probable_rep_account{ 0 };
 	unsigned network_version{ nano::protocol_version };
 	boost::optional<nano::account> node_id;
+	// Realtime TCP channel, used instead of UDP for outgoing messages once established
+	std::shared_ptr<nano::tcp_channel> tcp_channel;
 	bool operator< (nano::peer_information const &) const;
 };
 
+/**
+ * Immutable copy of the peer set, republished whenever peers are added or removed or a representative weight changes.
+ * Readers hold on to the shared_ptr for as long as they need it, without taking the peer_container mutex.
+ */
+class peer_snapshot
+{
+public:
+	// All peers
+	std::vector<nano::peer_information> peers;
+	// Peers with a non-zero representative weight, heaviest first
+	std::vector<nano::peer_information> representatives;
+	// Representatives counted once per probable representative account
+	std::vector<nano::peer_information> probable_reps;
+	nano::uint128_t total_weight{ 0 };
+	// Calls action_a on up to count_a distinct peers chosen at random on each call
+	template <typename T>
+	void random_sample (size_t count_a, T const & action_a) const
+	{
+		for (auto i : random_indices (count_a))
+		{
+			action_a (peers[i]);
+		}
+	}
+	size_t size_sqrt () const;
+
+private:
+	std::vector<size_t> random_indices (size_t) const;
+};
+
 /** Manages a set of disovered peers */
 class peer_container
 {
@@ -85,8 +119,14 @@ public:
 	std::deque<nano::endpoint> list_fanout ();
 	// Returns a list of probable reps and their weight
 	std::vector<peer_information> list_probable_rep_weights ();
-	// Get the next peer for attempting bootstrap
+	// Get the next peer for attempting bootstrap, the fastest known among the least recently attempted
 	nano::endpoint bootstrap_peer ();
+	// Folds an observed bootstrap block rate into the peer's average
+	void bootstrap_rate_update (nano::endpoint const &, double);
+	// Returns 0 for unknown peers
+	double bootstrap_rate (nano::endpoint const &);
+	// Protocol version the peer last reported, 0 for unknown peers
+	unsigned version (nano::endpoint const &);
 	// Purge any peer where last_contact < time_point and return what was left
 	std::vector<nano::peer_information> purge_list (std::chrono::steady_clock::time_point const &);
 	void purge_syn_cookies (std::chrono::steady_clock::time_point const &);
@@ -101,11 +141,25 @@ public:
 	// Returns false if valid, true if invalid (true on error convention)
 	// Also removes the syn cookie from the store if valid
 	bool validate_syn_cookie (nano::endpoint const &, nano::account, nano::signature);
+	// Returns the UDP endpoint of the peer with this node ID
+	boost::optional<nano::endpoint> node_id_endpoint (nano::account const &);
+	// Returns nullptr if the peer has no realtime TCP channel
+	std::shared_ptr<nano::tcp_channel> tcp_channel (nano::endpoint const &);
+	// Returns true if the peer is unknown or already has a channel
+	bool tcp_channel_set (nano::endpoint const &, std::shared_ptr<nano::tcp_channel>);
+	// Detaches the channel if it's still the one attached to the peer
+	void tcp_channel_erase (nano::endpoint const &, nano::tcp_channel const *);
+	// Detaches and closes all channels, they hold a reference to the node
+	void tcp_channels_clear ();
+	// Lock-free view of the peers for hot readers, never null. Rebuilt when peers, node IDs or representatives change, not on every contact
+	std::shared_ptr<nano::peer_snapshot const> snapshot () const;
 	size_t size ();
 	size_t size_sqrt ();
 	nano::uint128_t total_weight ();
 	nano::uint128_t online_weight_minimum;
 	bool empty ();
+	// Rebuilds and publishes the snapshot, mutex must be held
+	void snapshot_update ();
 	std::mutex mutex;
 	nano::endpoint self;
 	boost::multi_index_container<
@@ -132,10 +186,16 @@ public:
 	// Called when a new peer is observed
 	std::function<void(nano::endpoint const &)> peer_observer;
 	std::function<void()> disconnect_observer;
+	// Accessed with std::atomic_load/std::atomic_store
+	std::shared_ptr<nano::peer_snapshot const> snapshot_m;
+	// bootstrap_peer returns each peer at most once per round, a round ends when every peer was attempted since it started
+	std::chrono::steady_clock::time_point bootstrap_round_start;
 	// Number of peers to crawl for being a rep every period
 	static size_t constexpr peers_per_crawl = 8;
 	// Maximum number of peers per IP
 	static size_t constexpr max_peers_per_ip = 10;
+	// Number of least recently attempted peers not yet returned this round that bootstrap_peer picks the fastest from
+	static size_t constexpr bootstrap_peer_candidates = 8;
 };
 
 std::unique_ptr<seq_con_info_component> collect_seq_con_info (peer_container & peer_container, const std::string & name);
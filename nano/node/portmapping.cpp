@@ -147,7 +147,7 @@ void nano::port_mapping::check_mapping_loop ()
 	if (on)
 	{
 		auto node_l (node.shared ());
-		node.alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (wait_duration), [node_l]() {
+		node.alarm.add (node.alarm.now () + std::chrono::seconds (wait_duration), [node_l]() {
 			node_l->port_mapping.check_mapping_loop ();
 		});
 	}
@@ -1,5 +1,6 @@
 #include <boost/algorithm/string.hpp>
 #include <nano/lib/interface.h>
+#include <nano/lib/jsonwriter.hpp>
 #include <nano/node/node.hpp>
 #include <nano/node/rpc.hpp>
 
@@ -51,7 +52,20 @@ enable_control (enable_control_a),
 frontier_request_limit (16384),
 chain_request_limit (16384),
 max_json_depth (20),
-enable_sign_hash (false)
+enable_sign_hash (false),
+batch_request_limit (1024),
+read_threads (4),
+read_queue_limit (1024),
+heavy_threads (1),
+heavy_queue_limit (64),
+mutation_threads (2),
+mutation_queue_limit (256),
+keep_alive_timeout (15),
+keep_alive_max_requests (1000),
+cursor_limit (32),
+cursor_page_limit (4096),
+cursor_timeout (30),
+cursor_lifetime (60)
 {
 }
 
@@ -64,6 +78,19 @@ nano::error nano::rpc_config::serialize_json (nano::jsonconfig & json) const
 	json.put ("chain_request_limit", chain_request_limit);
 	json.put ("max_json_depth", max_json_depth);
 	json.put ("enable_sign_hash", enable_sign_hash);
+	json.put ("batch_request_limit", batch_request_limit);
+	json.put ("read_threads", read_threads);
+	json.put ("read_queue_limit", read_queue_limit);
+	json.put ("heavy_threads", heavy_threads);
+	json.put ("heavy_queue_limit", heavy_queue_limit);
+	json.put ("mutation_threads", mutation_threads);
+	json.put ("mutation_queue_limit", mutation_queue_limit);
+	json.put ("keep_alive_timeout", keep_alive_timeout);
+	json.put ("keep_alive_max_requests", keep_alive_max_requests);
+	json.put ("cursor_limit", cursor_limit);
+	json.put ("cursor_page_limit", cursor_page_limit);
+	json.put ("cursor_timeout", cursor_timeout);
+	json.put ("cursor_lifetime", cursor_lifetime);
 	return json.get_error ();
 }
 
@@ -82,14 +109,336 @@ nano::error nano::rpc_config::deserialize_json (nano::jsonconfig & json)
 	json.get_optional<uint64_t> ("chain_request_limit", chain_request_limit);
 	json.get_optional<uint8_t> ("max_json_depth", max_json_depth);
 	json.get_optional<bool> ("enable_sign_hash", enable_sign_hash);
+	json.get_optional<uint64_t> ("batch_request_limit", batch_request_limit);
+	json.get_optional<unsigned> ("read_threads", read_threads);
+	json.get_optional<uint64_t> ("read_queue_limit", read_queue_limit);
+	json.get_optional<unsigned> ("heavy_threads", heavy_threads);
+	json.get_optional<uint64_t> ("heavy_queue_limit", heavy_queue_limit);
+	json.get_optional<unsigned> ("mutation_threads", mutation_threads);
+	json.get_optional<uint64_t> ("mutation_queue_limit", mutation_queue_limit);
+	json.get_optional<uint64_t> ("keep_alive_timeout", keep_alive_timeout);
+	json.get_optional<uint64_t> ("keep_alive_max_requests", keep_alive_max_requests);
+	json.get_optional<uint64_t> ("cursor_limit", cursor_limit);
+	json.get_optional<uint64_t> ("cursor_page_limit", cursor_page_limit);
+	json.get_optional<uint64_t> ("cursor_timeout", cursor_timeout);
+	json.get_optional<uint64_t> ("cursor_lifetime", cursor_lifetime);
+	// The node's io, network and processing threads need the other half
+	if (cursor_limit + read_threads + heavy_threads + mutation_threads > nano::mdb_env::max_readers / 2)
+	{
+		json.get_error ().set (boost::str (boost::format ("cursor_limit and the RPC worker threads must add up to at most %1%") % (nano::mdb_env::max_readers / 2)));
+	}
 	return json.get_error ();
 }
 
 nano::rpc::rpc (boost::asio::io_context & io_ctx_a, nano::node & node_a, nano::rpc_config const & config_a) :
 acceptor (io_ctx_a),
 config (config_a),
-node (node_a)
+node (node_a),
+cursors (std::make_shared<nano::rpc_cursors> (config_a)),
+workers (config_a)
+{
+}
+
+nano::rpc_cursor::rpc_cursor (nano::block_store & store_a, std::string const & action_a, boost::property_tree::ptree const & request_a, std::chrono::seconds const & lifetime_a, std::shared_ptr<std::atomic<uint64_t>> const & open_a) :
+action (action_a),
+request (request_a),
+snapshot (store_a.tx_begin_read ()),
+next (0, 0),
+pages (0),
+expiry (std::chrono::steady_clock::now ()),
+end_of_life (std::chrono::steady_clock::now () + lifetime_a),
+open (open_a)
+{
+	nano::uint128_union id_l;
+	nano::random_pool::generate_block (id_l.bytes.data (), id_l.bytes.size ());
+	id = id_l.to_string ();
+	++*open;
+}
+
+nano::rpc_cursor::~rpc_cursor ()
+{
+	--*open;
+}
+
+nano::rpc_cursors::rpc_cursors (nano::rpc_config const & config_a) :
+open_cursors (std::make_shared<std::atomic<uint64_t>> (0)),
+limit (config_a.cursor_limit),
+timeout (config_a.cursor_timeout),
+lifetime (config_a.cursor_lifetime)
+{
+}
+
+std::shared_ptr<nano::rpc_cursor> nano::rpc_cursors::open (nano::block_store & store_a, std::string const & action_a, boost::property_tree::ptree const & request_a)
+{
+	std::shared_ptr<nano::rpc_cursor> result;
+	cleanup ();
+	std::lock_guard<std::mutex> lock (mutex);
+	// Cursors taken out to read a page hold their snapshot too, so they're counted even though they aren't in the map
+	if (*open_cursors < limit)
+	{
+		result = std::make_shared<nano::rpc_cursor> (store_a, action_a, request_a, lifetime, open_cursors);
+	}
+	return result;
+}
+
+std::shared_ptr<nano::rpc_cursor> nano::rpc_cursors::take (std::string const & id_a, std::string const & action_a)
+{
+	std::shared_ptr<nano::rpc_cursor> result;
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (cursors.find (id_a));
+	if (existing != cursors.end ())
+	{
+		auto cursor (existing->second);
+		cursors.erase (existing);
+		auto now (std::chrono::steady_clock::now ());
+		if (cursor->action == action_a && cursor->expiry > now && cursor->end_of_life > now)
+		{
+			result = cursor;
+		}
+	}
+	return result;
+}
+
+void nano::rpc_cursors::put (std::shared_ptr<nano::rpc_cursor> const & cursor_a)
+{
+	auto now (std::chrono::steady_clock::now ());
+	if (cursor_a->end_of_life > now)
+	{
+		cursor_a->expiry = now + timeout;
+		std::lock_guard<std::mutex> lock (mutex);
+		cursors[cursor_a->id] = cursor_a;
+	}
+}
+
+void nano::rpc_cursors::cleanup ()
+{
+	// Snapshots are released outside the lock
+	std::vector<std::shared_ptr<nano::rpc_cursor>> expired;
+	{
+		auto now (std::chrono::steady_clock::now ());
+		std::lock_guard<std::mutex> lock (mutex);
+		for (auto i (cursors.begin ()); i != cursors.end ();)
+		{
+			if (i->second->expiry <= now || i->second->end_of_life <= now)
+			{
+				expired.push_back (i->second);
+				i = cursors.erase (i);
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+}
+
+void nano::rpc_cursors::ongoing_cleanup (nano::alarm & alarm_a)
+{
+	cleanup ();
+	std::weak_ptr<nano::rpc_cursors> this_w (shared_from_this ());
+	alarm_a.add (std::chrono::steady_clock::now () + std::max (timeout / 2, std::chrono::seconds (1)), [this_w, &alarm_a]() {
+		if (auto this_l = this_w.lock ())
+		{
+			this_l->ongoing_cleanup (alarm_a);
+		}
+	});
+}
+
+void nano::rpc_cursors::stop ()
+{
+	decltype (cursors) cursors_l;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		cursors.swap (cursors_l);
+	}
+}
+
+size_t nano::rpc_cursors::size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return cursors.size ();
+}
+
+uint64_t nano::rpc_cursors::open_count () const
+{
+	return *open_cursors;
+}
+
+nano::rpc_workers::histogram::histogram ()
+{
+	buckets.fill (0);
+}
+
+void nano::rpc_workers::histogram::add (std::chrono::steady_clock::duration const & duration_a)
+{
+	size_t bucket (0);
+	for (auto bound (std::chrono::microseconds (100)); bucket < bucket_count - 1 && duration_a >= bound; bound *= 10)
+	{
+		++bucket;
+	}
+	++buckets[bucket];
+}
+
+void nano::rpc_workers::histogram::serialize (boost::property_tree::ptree & tree_a) const
+{
+	static std::array<char const *, bucket_count> names{ { "100us", "1ms", "10ms", "100ms", "1s", "10s", "inf" } };
+	for (size_t i (0); i < bucket_count; ++i)
+	{
+		tree_a.put (names[i], std::to_string (buckets[i]));
+	}
+}
+
+nano::rpc_workers::rpc_workers (nano::rpc_config const & config_a) :
+stopped (false)
+{
+	queues[static_cast<size_t> (nano::rpc_request_class::read)].limit = config_a.read_queue_limit;
+	queues[static_cast<size_t> (nano::rpc_request_class::heavy)].limit = config_a.heavy_queue_limit;
+	queues[static_cast<size_t> (nano::rpc_request_class::mutation)].limit = config_a.mutation_queue_limit;
+	std::array<unsigned, 3> threads{ { config_a.read_threads, config_a.heavy_threads, config_a.mutation_threads } };
+	boost::thread::attributes attrs;
+	nano::thread_attributes::set (attrs);
+	for (size_t i (0); i < queues.size (); ++i)
+	{
+		auto & queue (queues[i]);
+		queue.rejected = 0;
+		for (unsigned j (0); j < threads[i]; ++j)
+		{
+			queue.threads.push_back (boost::thread (attrs, [this, &queue]() {
+				nano::thread_role::set (nano::thread_role::name::rpc_worker);
+				run (queue);
+			}));
+		}
+	}
+}
+
+nano::rpc_workers::~rpc_workers ()
+{
+	stop ();
+	for (auto & queue : queues)
+	{
+		for (auto & thread : queue.threads)
+		{
+			thread.join ();
+		}
+	}
+}
+
+bool nano::rpc_workers::push (nano::rpc_request_class class_a, std::function<void()> const & action_a, std::function<void()> const & dropped_a)
+{
+	auto & queue (queues[static_cast<size_t> (class_a)]);
+	auto error (false);
+	if (!queue.threads.empty ())
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		error = stopped || queue.items.size () >= queue.limit;
+		if (!error)
+		{
+			queue.items.push_back (item{ std::chrono::steady_clock::now (), action_a, dropped_a });
+			queue.condition.notify_one ();
+		}
+		else
+		{
+			++queue.rejected;
+		}
+	}
+	else
+	{
+		action_a ();
+	}
+	return error;
+}
+
+void nano::rpc_workers::run (nano::rpc_workers::queue & queue_a)
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	while (!stopped)
+	{
+		if (!queue_a.items.empty ())
+		{
+			auto item (std::move (queue_a.items.front ()));
+			queue_a.items.pop_front ();
+			auto start (std::chrono::steady_clock::now ());
+			queue_a.wait.add (start - item.queued);
+			lock.unlock ();
+			item.action ();
+			auto elapsed (std::chrono::steady_clock::now () - start);
+			lock.lock ();
+			queue_a.execution.add (elapsed);
+		}
+		else
+		{
+			queue_a.condition.wait (lock);
+		}
+	}
+}
+
+void nano::rpc_workers::stop ()
+{
+	std::vector<std::function<void()>> dropped;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		stopped = true;
+		for (auto & queue : queues)
+		{
+			for (auto & item : queue.items)
+			{
+				if (item.dropped)
+				{
+					dropped.push_back (std::move (item.dropped));
+				}
+			}
+			queue.items.clear ();
+			queue.condition.notify_all ();
+		}
+	}
+	// Called without the lock, they may write a response
+	for (auto & action : dropped)
+	{
+		action ();
+	}
+}
+
+size_t nano::rpc_workers::threads (nano::rpc_request_class class_a) const
+{
+	return queues[static_cast<size_t> (class_a)].threads.size ();
+}
+
+void nano::rpc_workers::serialize (boost::property_tree::ptree & tree_a)
+{
+	static std::array<char const *, 3> names{ { "read", "heavy", "mutation" } };
+	std::lock_guard<std::mutex> lock (mutex);
+	for (size_t i (0); i < queues.size (); ++i)
+	{
+		auto & queue (queues[i]);
+		boost::property_tree::ptree entry;
+		entry.put ("threads", std::to_string (queue.threads.size ()));
+		entry.put ("queued", std::to_string (queue.items.size ()));
+		entry.put ("queue_limit", std::to_string (queue.limit));
+		entry.put ("rejected", std::to_string (queue.rejected));
+		boost::property_tree::ptree wait;
+		queue.wait.serialize (wait);
+		entry.add_child ("wait", wait);
+		boost::property_tree::ptree execution;
+		queue.execution.serialize (execution);
+		entry.add_child ("execution", execution);
+		tree_a.add_child (names[i], entry);
+	}
+}
+
+nano::rpc_request_class nano::rpc_workers::classify (std::string const & action_a)
 {
+	static std::unordered_set<std::string> heavy{ "account_history", "accounts_pending", "batch", "blocks_info", "bootstrap_status", "chain", "confirmation_history", "delegators", "delegators_count", "frontiers", "history", "ledger", "pending", "representatives", "representatives_online", "successors", "unchecked", "unchecked_keys", "wallet_balances", "wallet_export", "wallet_frontiers", "wallet_history", "wallet_info", "wallet_ledger", "wallet_pending" };
+	static std::unordered_set<std::string> mutation{ "account_create", "account_move", "account_remove", "account_representative_set", "accounts_create", "block_confirm", "block_create", "bootstrap", "bootstrap_any", "bootstrap_lazy", "keepalive", "node_id_delete", "password_change", "password_enter", "payment_begin", "payment_end", "payment_init", "payment_wait", "process", "receive", "receive_minimum_set", "republish", "search_pending", "search_pending_all", "send", "sign", "stats_clear", "stop", "unchecked_clear", "wallet_add", "wallet_add_watch", "wallet_change_seed", "wallet_create", "wallet_destroy", "wallet_lock", "wallet_representative_set", "wallet_republish", "work_cancel", "work_generate", "work_peer_add", "work_peers_clear", "work_set" };
+	auto result (nano::rpc_request_class::read);
+	if (heavy.find (action_a) != heavy.end ())
+	{
+		result = nano::rpc_request_class::heavy;
+	}
+	else if (mutation.find (action_a) != mutation.end ())
+	{
+		result = nano::rpc_request_class::mutation;
+	}
+	return result;
 }
 
 void nano::rpc::add_block_observer ()
@@ -119,6 +468,7 @@ void nano::rpc::start (bool rpc_enabled_a)
 	}
 
 	add_block_observer ();
+	cursors->ongoing_cleanup (node.alarm);
 
 	if (rpc_enabled_a)
 	{
@@ -148,17 +498,39 @@ void nano::rpc::accept ()
 void nano::rpc::stop ()
 {
 	acceptor.close ();
+	workers.stop ();
+	cursors->stop ();
 }
 
-nano::rpc_handler::rpc_handler (nano::node & node_a, nano::rpc & rpc_a, std::string const & body_a, std::string const & request_id_a, std::function<void(boost::property_tree::ptree const &)> const & response_a) :
+nano::rpc_handler::rpc_handler (nano::node & node_a, nano::rpc & rpc_a, std::string const & body_a, std::string const & request_id_a, std::function<void(std::string const &)> const & response_a) :
 body (body_a),
 request_id (request_id_a),
 node (node_a),
 rpc (rpc_a),
-response (response_a)
+response (response_a),
+snapshot (nullptr)
 {
 }
 
+nano::rpc_read_transaction::rpc_read_transaction (nano::block_store & store_a, nano::transaction const * shared_a) :
+shared (shared_a)
+{
+	if (shared == nullptr)
+	{
+		owned = store_a.tx_begin_read ();
+	}
+}
+
+nano::rpc_read_transaction::operator nano::transaction const & () const
+{
+	return shared != nullptr ? *shared : owned;
+}
+
+nano::rpc_read_transaction nano::rpc_handler::tx_begin_read ()
+{
+	return nano::rpc_read_transaction (node.store, snapshot);
+}
+
 void nano::rpc::observer_action (nano::account const & account_a)
 {
 	std::shared_ptr<nano::payment_observer> observer;
@@ -176,24 +548,42 @@ void nano::rpc::observer_action (nano::account const & account_a)
 	}
 }
 
-void nano::error_response (std::function<void(boost::property_tree::ptree const &)> response_a, std::string const & message_a)
+std::string nano::json_string (boost::property_tree::ptree const & tree_a)
+{
+	std::stringstream ostream;
+	boost::property_tree::write_json (ostream, tree_a);
+	ostream.flush ();
+	return ostream.str ();
+}
+
+void nano::error_response (std::function<void(std::string const &)> response_a, std::string const & message_a)
 {
 	boost::property_tree::ptree response_l;
 	response_l.put ("error", message_a);
-	response_a (response_l);
+	response_a (nano::json_string (response_l));
 }
 
 void nano::rpc_handler::response_errors ()
 {
 	if (ec || response_l.empty ())
 	{
-		boost::property_tree::ptree response_error;
-		response_error.put ("error", ec ? ec.message () : "Empty response");
-		response (response_error);
+		error_response (response, ec ? ec.message () : "Empty response");
+	}
+	else
+	{
+		response (nano::json_string (response_l));
+	}
+}
+
+void nano::rpc_handler::response_stream (std::string const & body_a)
+{
+	if (ec)
+	{
+		error_response (response, ec.message ());
 	}
 	else
 	{
-		response (response_l);
+		response (body_a);
 	}
 }
 
@@ -431,6 +821,75 @@ bool nano::rpc_handler::rpc_control_impl ()
 	return result;
 }
 
+std::shared_ptr<nano::rpc_cursor> nano::rpc_handler::cursor_impl ()
+{
+	std::shared_ptr<nano::rpc_cursor> result;
+	if (!ec)
+	{
+		auto action (request.get<std::string> ("action"));
+		auto id (request.get_optional<std::string> ("cursor"));
+		auto paged (request.get<bool> ("paged", false));
+		if ((id.is_initialized () || paged) && snapshot != nullptr)
+		{
+			// Sub-requests of a batch already read from the batch's snapshot
+			ec = nano::error_rpc::invalid_cursor;
+		}
+		else if (id.is_initialized ())
+		{
+			result = rpc.cursors->take (id.get (), action);
+			if (result != nullptr)
+			{
+				// Later pages may change the page size, every other option comes from the request that opened the cursor
+				auto count_text (request.get_optional<std::string> ("count"));
+				request = result->request;
+				if (count_text.is_initialized ())
+				{
+					request.put ("count", count_text.get ());
+				}
+			}
+			else
+			{
+				ec = nano::error_rpc::cursor_not_found;
+			}
+		}
+		else if (paged)
+		{
+			result = rpc.cursors->open (node.store, action, request);
+			if (result == nullptr)
+			{
+				ec = nano::error_rpc::cursor_limit;
+			}
+		}
+		if (result != nullptr)
+		{
+			snapshot = &result->snapshot;
+		}
+	}
+	return result;
+}
+
+uint64_t nano::rpc_handler::cursor_count (std::shared_ptr<nano::rpc_cursor> const & cursor_a, uint64_t count_a)
+{
+	return cursor_a != nullptr ? std::min (count_a, rpc.config.cursor_page_limit) : count_a;
+}
+
+std::string nano::rpc_handler::cursor_finish (std::shared_ptr<nano::rpc_cursor> const & cursor_a, bool more_a, nano::unchecked_key const & next_a)
+{
+	std::string result;
+	if (cursor_a != nullptr)
+	{
+		snapshot = nullptr;
+		if (more_a)
+		{
+			cursor_a->next = next_a;
+			++cursor_a->pages;
+			rpc.cursors->put (cursor_a);
+			result = cursor_a->id;
+		}
+	}
+	return result;
+}
+
 void nano::rpc_handler::account_balance ()
 {
 	auto account (account_impl ());
@@ -448,7 +907,7 @@ void nano::rpc_handler::account_block_count ()
 	auto account (account_impl ());
 	if (!ec)
 	{
-		auto transaction (node.store.tx_begin_read ());
+		auto transaction (tx_begin_read ());
 		nano::account_info info;
 		if (!node.store.account_get (transaction, account, info))
 		{
@@ -526,7 +985,7 @@ void nano::rpc_handler::account_info ()
 		const bool representative = request.get<bool> ("representative", false);
 		const bool weight = request.get<bool> ("weight", false);
 		const bool pending = request.get<bool> ("pending", false);
-		auto transaction (node.store.tx_begin_read ());
+		auto transaction (tx_begin_read ());
 		nano::account_info info;
 		if (!node.store.account_get (transaction, account, info))
 		{
@@ -655,7 +1114,7 @@ void nano::rpc_handler::account_representative ()
 	auto account (account_impl ());
 	if (!ec)
 	{
-		auto transaction (node.store.tx_begin_read ());
+		auto transaction (tx_begin_read ());
 		nano::account_info info;
 		if (!node.store.account_get (transaction, account, info))
 		{
@@ -690,7 +1149,7 @@ void nano::rpc_handler::account_representative_set ()
 				if (!ec)
 				{
 					nano::account_info info;
-					auto block_transaction (node.store.tx_begin_read ());
+					auto block_transaction (tx_begin_read ());
 					if (!node.store.account_get (block_transaction, account, info))
 					{
 						if (nano::work_validate (info.head, work))
@@ -717,7 +1176,7 @@ void nano::rpc_handler::account_representative_set ()
 					}
 					boost::property_tree::ptree response_l;
 					response_l.put ("block", hash.to_string ());
-					response_a (response_l);
+					response_a (nano::json_string (response_l));
 				},
 				work, generate_work);
 				// clang-format on
@@ -792,7 +1251,7 @@ void nano::rpc_handler::accounts_create ()
 void nano::rpc_handler::accounts_frontiers ()
 {
 	boost::property_tree::ptree frontiers;
-	auto transaction (node.store.tx_begin_read ());
+	auto transaction (tx_begin_read ());
 	for (auto & accounts : request.get_child ("accounts"))
 	{
 		auto account (account_impl (accounts.second.data ()));
@@ -816,40 +1275,71 @@ void nano::rpc_handler::accounts_pending ()
 	const bool source = request.get<bool> ("source", false);
 	const bool include_active = request.get<bool> ("include_active", false);
 	boost::property_tree::ptree pending;
-	auto transaction (node.store.tx_begin_read ());
+	auto transaction (tx_begin_read ());
 	for (auto & accounts : request.get_child ("accounts"))
 	{
 		auto account (account_impl (accounts.second.data ()));
 		if (!ec)
 		{
 			boost::property_tree::ptree peers_l;
-			for (auto i (node.store.pending_begin (transaction, nano::pending_key (account, 0))); nano::pending_key (i->first).account == account && peers_l.size () < count; ++i)
+			if (!threshold.is_zero () && node.store.version_get (transaction) >= 15)
 			{
-				nano::pending_key key (i->first);
-				std::shared_ptr<nano::block> block (include_active ? nullptr : node.store.block_get (transaction, key.hash));
-				if (include_active || (block && !node.active.active (*block)))
+				// Entries are ordered by descending amount so blocks are listed largest first, stop at the first one under the threshold
+				for (auto i (node.store.pending_amount_begin (transaction, nano::pending_amount_key (account, std::numeric_limits<nano::uint128_t>::max (), 0))), n (node.store.pending_amount_end ()); i != n && peers_l.size () < count; ++i)
 				{
-					if (threshold.is_zero () && !source)
+					nano::pending_amount_key key (i->first);
+					if (key.account != account || key.amount ().number () < threshold.number ())
 					{
-						boost::property_tree::ptree entry;
-						entry.put ("", key.hash.to_string ());
-						peers_l.push_back (std::make_pair ("", entry));
+						break;
 					}
-					else
+					std::shared_ptr<nano::block> block (include_active ? nullptr : node.store.block_get (transaction, key.hash));
+					if (include_active || (block && !node.active.active (*block)))
 					{
-						nano::pending_info info (i->second);
-						if (info.amount.number () >= threshold.number ())
+						if (source)
 						{
-							if (source)
-							{
-								boost::property_tree::ptree pending_tree;
-								pending_tree.put ("amount", info.amount.number ().convert_to<std::string> ());
-								pending_tree.put ("source", info.source.to_account ());
-								peers_l.add_child (key.hash.to_string (), pending_tree);
-							}
-							else
+							boost::property_tree::ptree pending_tree;
+							pending_tree.put ("amount", key.amount ().number ().convert_to<std::string> ());
+							pending_tree.put ("source", nano::account (i->second).to_account ());
+							peers_l.add_child (key.hash.to_string (), pending_tree);
+						}
+						else
+						{
+							peers_l.put (key.hash.to_string (), key.amount ().number ().convert_to<std::string> ());
+						}
+					}
+				}
+			}
+			else
+			{
+				// Blocks are listed in hash order, the amount index is only complete once the store reaches version 15
+				for (auto i (node.store.pending_begin (transaction, nano::pending_key (account, 0))); nano::pending_key (i->first).account == account && peers_l.size () < count; ++i)
+				{
+					nano::pending_key key (i->first);
+					std::shared_ptr<nano::block> block (include_active ? nullptr : node.store.block_get (transaction, key.hash));
+					if (include_active || (block && !node.active.active (*block)))
+					{
+						if (threshold.is_zero () && !source)
+						{
+							boost::property_tree::ptree entry;
+							entry.put ("", key.hash.to_string ());
+							peers_l.push_back (std::make_pair ("", entry));
+						}
+						else
+						{
+							nano::pending_info info (i->second);
+							if (info.amount.number () >= threshold.number ())
 							{
-								peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
+								if (source)
+								{
+									boost::property_tree::ptree pending_tree;
+									pending_tree.put ("amount", info.amount.number ().convert_to<std::string> ());
+									pending_tree.put ("source", info.source.to_account ());
+									peers_l.add_child (key.hash.to_string (), pending_tree);
+								}
+								else
+								{
+									peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
+								}
 							}
 						}
 					}
@@ -873,14 +1363,122 @@ void nano::rpc_handler::available_supply ()
 	response_errors ();
 }
 
-void nano::rpc_handler::block_info ()
+namespace
 {
-	auto hash (hash_impl ());
-	if (!ec)
+/** Actions that only read the ledger and respond before returning, so they can share a snapshot and run on any thread */
+bool batchable (std::string const & action_a)
+{
+	static std::unordered_set<std::string> actions{ "account_balance", "account_block_count", "account_info", "account_key", "account_representative", "account_weight", "accounts_balances", "accounts_frontiers", "accounts_pending", "block_account", "block_count", "block_info", "blocks", "blocks_info", "chain", "delegators_count", "frontiers", "pending", "pending_exists", "successors", "validate_account_number" };
+	return actions.find (action_a) != actions.end ();
+}
+}
+
+void nano::rpc_handler::batch ()
+{
+	auto requests_l (request.get_child_optional ("requests"));
+	if (!requests_l)
 	{
-		nano::block_sideband sideband;
-		auto transaction (node.store.tx_begin_read ());
-		auto block (node.store.block_get (transaction, hash, &sideband));
+		ec = nano::error_rpc::invalid_batch;
+	}
+	else if (requests_l->size () > rpc.config.batch_request_limit)
+	{
+		ec = nano::error_rpc::batch_too_large;
+	}
+	if (!ec)
+	{
+		std::vector<boost::property_tree::ptree const *> items;
+		for (auto & item : *requests_l)
+		{
+			items.push_back (&item.second);
+		}
+		std::vector<std::string> results (items.size ());
+		// Runs a range of sub-requests in order under one read transaction
+		auto run = [this, &items, &results](size_t begin_a, size_t end_a) {
+			auto transaction (node.store.tx_begin_read ());
+			for (auto i (begin_a); i < end_a; ++i)
+			{
+				auto & result (results[i]);
+				auto action (items[i]->get<std::string> ("action", ""));
+				if (batchable (action))
+				{
+					auto handler (std::make_shared<nano::rpc_handler> (node, rpc, std::string (), request_id, [&result](std::string const & body_a) {
+						result = body_a;
+					}));
+					handler->request = *items[i];
+					handler->snapshot = &transaction;
+					handler->process_action ();
+				}
+				else
+				{
+					error_response ([&result](std::string const & body_a) { result = body_a; }, "Action not allowed in batch");
+				}
+			}
+		};
+		// By default every sub-request sees the same snapshot. Parallel batches split the sub-requests into one contiguous range per read worker, each range reading from its own snapshot
+		auto parallel (request.get<bool> ("parallel", false));
+		size_t ranges (parallel ? std::min (rpc.workers.threads (nano::rpc_request_class::read), items.size ()) : 1);
+		if (ranges <= 1)
+		{
+			run (0, items.size ());
+		}
+		else
+		{
+			std::mutex mutex;
+			std::condition_variable condition;
+			auto per_range ((items.size () + ranges - 1) / ranges);
+			auto remaining ((items.size () + per_range - 1) / per_range);
+			auto done ([&mutex, &condition, &remaining]() {
+				std::lock_guard<std::mutex> lock (mutex);
+				--remaining;
+				condition.notify_all ();
+			});
+			for (size_t begin (0); begin < items.size (); begin += per_range)
+			{
+				auto end (std::min (begin + per_range, items.size ()));
+				auto dropped ([&results, &done, begin, end]() {
+					for (auto i (begin); i < end; ++i)
+					{
+						auto & result (results[i]);
+						error_response ([&result](std::string const & body_a) { result = body_a; }, std::error_code (nano::error_rpc::stopping).message ());
+					}
+					done ();
+				});
+				// Ranges the read queue can't take run on this thread
+				if (rpc.workers.push (nano::rpc_request_class::read, [&run, &done, begin, end]() { run (begin, end); done (); }, dropped))
+				{
+					run (begin, end);
+					done ();
+				}
+			}
+			std::unique_lock<std::mutex> lock (mutex);
+			condition.wait (lock, [&remaining]() { return remaining == 0; });
+		}
+		// Sub-responses are already serialized, they're copied into the body instead of being parsed back into a tree
+		std::string body;
+		nano::json_writer writer (body);
+		writer.begin ();
+		writer.begin_array ("responses");
+		for (auto & result : results)
+		{
+			writer.push_json (result);
+		}
+		writer.finish ();
+		response_stream (body);
+	}
+	else
+	{
+		response_errors ();
+	}
+}
+
+void nano::rpc_handler::block_info ()
+{
+	auto hash (hash_impl ());
+	if (!ec)
+	{
+		nano::block_sideband sideband;
+		auto transaction (tx_begin_read ());
+		auto block (node.store.block_get (transaction, hash, &sideband));
 		if (block != nullptr)
 		{
 			nano::account account (block->account ().is_zero () ? sideband.account : block->account ());
@@ -908,7 +1506,7 @@ void nano::rpc_handler::block_confirm ()
 	auto hash (hash_impl ());
 	if (!ec)
 	{
-		auto transaction (node.store.tx_begin_read ());
+		auto transaction (tx_begin_read ());
 		auto block_l (node.store.block_get (transaction, hash));
 		if (block_l != nullptr)
 		{
@@ -927,7 +1525,7 @@ void nano::rpc_handler::blocks ()
 {
 	std::vector<std::string> hashes;
 	boost::property_tree::ptree blocks;
-	auto transaction (node.store.tx_begin_read ());
+	auto transaction (tx_begin_read ());
 	for (boost::property_tree::ptree::value_type & hashes : request.get_child ("hashes"))
 	{
 		if (!ec)
@@ -962,9 +1560,11 @@ void nano::rpc_handler::blocks_info ()
 {
 	const bool pending = request.get<bool> ("pending", false);
 	const bool source = request.get<bool> ("source", false);
-	std::vector<std::string> hashes;
-	boost::property_tree::ptree blocks;
-	auto transaction (node.store.tx_begin_read ());
+	std::string body;
+	nano::json_writer writer (body);
+	writer.begin ();
+	writer.begin_object ("blocks");
+	auto transaction (tx_begin_read ());
 	for (boost::property_tree::ptree::value_type & hashes : request.get_child ("hashes"))
 	{
 		if (!ec)
@@ -977,18 +1577,18 @@ void nano::rpc_handler::blocks_info ()
 				auto block (node.store.block_get (transaction, hash, &sideband));
 				if (block != nullptr)
 				{
-					boost::property_tree::ptree entry;
+					writer.begin_object (hash_text);
 					nano::account account (block->account ().is_zero () ? sideband.account : block->account ());
-					entry.put ("block_account", account.to_account ());
+					writer.put ("block_account", account.to_account ());
 					auto amount (node.ledger.amount (transaction, hash));
-					entry.put ("amount", amount.convert_to<std::string> ());
+					writer.put ("amount", amount.convert_to<std::string> ());
 					auto balance (node.ledger.balance (transaction, hash));
-					entry.put ("balance", balance.convert_to<std::string> ());
-					entry.put ("height", std::to_string (sideband.height));
-					entry.put ("local_timestamp", std::to_string (sideband.timestamp));
+					writer.put ("balance", balance.convert_to<std::string> ());
+					writer.put ("height", std::to_string (sideband.height));
+					writer.put ("local_timestamp", std::to_string (sideband.timestamp));
 					std::string contents;
 					block->serialize_json (contents);
-					entry.put ("contents", contents);
+					writer.put ("contents", contents);
 					if (pending)
 					{
 						bool exists (false);
@@ -997,7 +1597,7 @@ void nano::rpc_handler::blocks_info ()
 						{
 							exists = node.store.pending_exists (transaction, nano::pending_key (destination, hash));
 						}
-						entry.put ("pending", exists ? "1" : "0");
+						writer.put ("pending", exists ? "1" : "0");
 					}
 					if (source)
 					{
@@ -1006,14 +1606,14 @@ void nano::rpc_handler::blocks_info ()
 						if (block_a != nullptr)
 						{
 							auto source_account (node.ledger.account (transaction, source_hash));
-							entry.put ("source_account", source_account.to_account ());
+							writer.put ("source_account", source_account.to_account ());
 						}
 						else
 						{
-							entry.put ("source_account", "0");
+							writer.put ("source_account", "0");
 						}
 					}
-					blocks.push_back (std::make_pair (hash_text, entry));
+					writer.end ();
 				}
 				else
 				{
@@ -1026,8 +1626,8 @@ void nano::rpc_handler::blocks_info ()
 			}
 		}
 	}
-	response_l.add_child ("blocks", blocks);
-	response_errors ();
+	writer.finish ();
+	response_stream (body);
 }
 
 void nano::rpc_handler::block_account ()
@@ -1035,7 +1635,7 @@ void nano::rpc_handler::block_account ()
 	auto hash (hash_impl ());
 	if (!ec)
 	{
-		auto transaction (node.store.tx_begin_read ());
+		auto transaction (tx_begin_read ());
 		if (node.store.block_exists (transaction, hash))
 		{
 			auto account (node.ledger.account (transaction, hash));
@@ -1051,15 +1651,15 @@ void nano::rpc_handler::block_account ()
 
 void nano::rpc_handler::block_count ()
 {
-	auto transaction (node.store.tx_begin_read ());
+	auto transaction (tx_begin_read ());
 	response_l.put ("count", std::to_string (node.store.block_count (transaction).sum ()));
-	response_l.put ("unchecked", std::to_string (node.store.unchecked_count (transaction)));
+	response_l.put ("unchecked", std::to_string (node.unchecked.count (transaction)));
 	response_errors ();
 }
 
 void nano::rpc_handler::block_count_type ()
 {
-	auto transaction (node.store.tx_begin_read ());
+	auto transaction (tx_begin_read ());
 	nano::block_counts count (node.store.block_count (transaction));
 	response_l.put ("send", std::to_string (count.send));
 	response_l.put ("receive", std::to_string (count.receive));
@@ -1142,7 +1742,7 @@ void nano::rpc_handler::block_create ()
 			if (existing != node.wallets.items.end ())
 			{
 				auto transaction (node.wallets.tx_begin_read ());
-				auto block_transaction (node.store.tx_begin_read ());
+				auto block_transaction (tx_begin_read ());
 				wallet_locked_impl (transaction, existing->second);
 				wallet_account_impl (transaction, existing->second, account);
 				if (!ec)
@@ -1204,14 +1804,14 @@ void nano::rpc_handler::block_create ()
 			// Fetching account balance & previous for send blocks (if aren't given directly)
 			if (!previous_text.is_initialized () && !balance_text.is_initialized ())
 			{
-				auto transaction (node.store.tx_begin_read ());
+				auto transaction (tx_begin_read ());
 				previous = node.ledger.latest (transaction, pub);
 				balance = node.ledger.account_balance (transaction, pub);
 			}
 			// Double check current balance if previous block is specified
 			else if (previous_text.is_initialized () && balance_text.is_initialized () && type == "send")
 			{
-				auto transaction (node.store.tx_begin_read ());
+				auto transaction (tx_begin_read ());
 				if (node.store.block_exists (transaction, previous) && node.store.block_balance (transaction, previous) != balance.number ())
 				{
 					ec = nano::error_rpc::block_create_balance_mismatch;
@@ -1436,6 +2036,28 @@ void nano::rpc_handler::bootstrap_status ()
 		{
 			response_l.put ("lazy_key_1", (*(attempt->lazy_keys.begin ())).to_string ());
 		}
+		boost::property_tree::ptree connections;
+		{
+			std::lock_guard<std::mutex> lock (attempt->mutex);
+			for (auto & client_w : attempt->clients)
+			{
+				if (auto client = client_w.lock ())
+				{
+					boost::property_tree::ptree entry;
+					entry.put ("endpoint", boost::str (boost::format ("%1%") % client->endpoint));
+					entry.put ("blocks", std::to_string (client->block_count));
+					entry.put ("elapsed_seconds", std::to_string (client->elapsed_seconds ()));
+					entry.put ("blocks_per_second", std::to_string (client->block_rate ()));
+					entry.put ("bytes_per_second", std::to_string (client->byte_rate ()));
+					entry.put ("pulls", std::to_string (client->pull_count));
+					entry.put ("failed_pulls", std::to_string (client->error_count));
+					entry.put ("first_byte_milliseconds", std::to_string (client->first_byte_us / 1000));
+					entry.put ("score", std::to_string (client->score ()));
+					connections.push_back (std::make_pair ("", entry));
+				}
+			}
+		}
+		response_l.add_child ("connections_throughput", connections);
 	}
 	else
 	{
@@ -1453,7 +2075,7 @@ void nano::rpc_handler::chain (bool successors)
 	if (!ec)
 	{
 		boost::property_tree::ptree blocks;
-		auto transaction (node.store.tx_begin_read ());
+		auto transaction (tx_begin_read ());
 		while (!hash.is_zero () && blocks.size () < count)
 		{
 			auto block_l (node.store.block_get (transaction, hash));
@@ -1560,7 +2182,7 @@ void nano::rpc_handler::confirmation_info ()
 			auto election (conflict_info->election);
 			nano::uint128_t total (0);
 			response_l.put ("last_winner", election->status.winner->hash ().to_string ());
-			auto transaction (node.store.tx_begin_read ());
+			auto transaction (tx_begin_read ());
 			auto tally_l (election->tally (transaction));
 			boost::property_tree::ptree blocks;
 			for (auto i (tally_l.begin ()), n (tally_l.end ()); i != n; ++i)
@@ -1640,20 +2262,45 @@ void nano::rpc_handler::delegators ()
 	if (!ec)
 	{
 		boost::property_tree::ptree delegators;
-		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.latest_begin (transaction)), n (node.store.latest_end ()); i != n; ++i)
+		auto transaction (tx_begin_read ());
+		if (node.store.version_get (transaction) >= 16)
 		{
-			nano::account_info info (i->second);
-			auto block (node.store.block_get (transaction, info.rep_block));
-			assert (block != nullptr);
-			if (block->representative () == account)
+			for (auto i (node.store.delegators_begin (transaction, account)), n (node.store.delegators_end ()); i != n && nano::delegator_key (i->first).representative == account && !ec; ++i)
+			{
+				nano::delegator_key key (i->first);
+				nano::account_info info;
+				if (!node.store.account_get (transaction, key.account, info))
+				{
+					std::string balance;
+					nano::uint128_union (info.balance).encode_dec (balance);
+					delegators.put (key.account.to_account (), balance);
+				}
+				else
+				{
+					ec = nano::error_common::account_not_found;
+				}
+			}
+		}
+		else
+		{
+			// The delegators index is built by the version 16 upgrade, which waits for the background sideband upgrade on older ledgers
+			for (auto i (node.store.latest_begin (transaction)), n (node.store.latest_end ()); i != n; ++i)
 			{
-				std::string balance;
-				nano::uint128_union (info.balance).encode_dec (balance);
-				delegators.put (nano::account (i->first).to_account (), balance);
+				nano::account_info info (i->second);
+				auto block (node.store.block_get (transaction, info.rep_block));
+				assert (block != nullptr);
+				if (block->representative () == account)
+				{
+					std::string balance;
+					nano::uint128_union (info.balance).encode_dec (balance);
+					delegators.put (nano::account (i->first).to_account (), balance);
+				}
 			}
 		}
-		response_l.add_child ("delegators", delegators);
+		if (!ec)
+		{
+			response_l.add_child ("delegators", delegators);
+		}
 	}
 	response_errors ();
 }
@@ -1664,17 +2311,27 @@ void nano::rpc_handler::delegators_count ()
 	if (!ec)
 	{
 		uint64_t count (0);
-		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.latest_begin (transaction)), n (node.store.latest_end ()); i != n; ++i)
+		auto transaction (tx_begin_read ());
+		if (node.store.version_get (transaction) >= 16)
 		{
-			nano::account_info info (i->second);
-			auto block (node.store.block_get (transaction, info.rep_block));
-			assert (block != nullptr);
-			if (block->representative () == account)
+			for (auto i (node.store.delegators_begin (transaction, account)), n (node.store.delegators_end ()); i != n && nano::delegator_key (i->first).representative == account; ++i)
 			{
 				++count;
 			}
 		}
+		else
+		{
+			for (auto i (node.store.latest_begin (transaction)), n (node.store.latest_end ()); i != n; ++i)
+			{
+				nano::account_info info (i->second);
+				auto block (node.store.block_get (transaction, info.rep_block));
+				assert (block != nullptr);
+				if (block->representative () == account)
+				{
+					++count;
+				}
+			}
+		}
 		response_l.put ("count", std::to_string (count));
 	}
 	response_errors ();
@@ -1711,24 +2368,36 @@ void nano::rpc_handler::deterministic_key ()
 
 void nano::rpc_handler::frontiers ()
 {
+	auto cursor (cursor_impl ());
 	auto start (account_impl ());
-	auto count (count_impl ());
+	auto count (cursor_count (cursor, count_impl ()));
 	if (!ec)
 	{
+		if (cursor != nullptr && cursor->pages > 0)
+		{
+			start = cursor->next.account;
+		}
 		boost::property_tree::ptree frontiers;
-		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.latest_begin (transaction, start)), n (node.store.latest_end ()); i != n && frontiers.size () < count; ++i)
+		auto transaction (tx_begin_read ());
+		auto i (node.store.latest_begin (transaction, start));
+		auto n (node.store.latest_end ());
+		for (; i != n && frontiers.size () < count; ++i)
 		{
 			frontiers.put (nano::account (i->first).to_account (), nano::account_info (i->second).head.to_string ());
 		}
 		response_l.add_child ("frontiers", frontiers);
+		auto id (i != n ? cursor_finish (cursor, true, nano::unchecked_key (i->first, 0)) : cursor_finish (cursor, false));
+		if (!id.empty ())
+		{
+			response_l.put ("cursor", id);
+		}
 	}
 	response_errors ();
 }
 
 void nano::rpc_handler::account_count ()
 {
-	auto transaction (node.store.tx_begin_read ());
+	auto transaction (tx_begin_read ());
 	auto size (node.store.account_count (transaction));
 	response_l.put ("count", std::to_string (size));
 	response_errors ();
@@ -1736,88 +2405,91 @@ void nano::rpc_handler::account_count ()
 
 namespace
 {
+// Entry fields in output order, kept flat so an entry can be skipped or streamed without building a tree
+using history_fields = std::vector<std::pair<char const *, std::string>>;
 class history_visitor : public nano::block_visitor
 {
 public:
-	history_visitor (nano::rpc_handler & handler_a, bool raw_a, nano::transaction & transaction_a, boost::property_tree::ptree & tree_a, nano::block_hash const & hash_a) :
+	history_visitor (nano::rpc_handler & handler_a, bool raw_a, nano::transaction const & transaction_a, history_fields & fields_a, nano::block_hash const & hash_a, nano::block_sideband const & sideband_a) :
 	handler (handler_a),
 	raw (raw_a),
 	transaction (transaction_a),
-	tree (tree_a),
-	hash (hash_a)
+	fields (fields_a),
+	hash (hash_a),
+	sideband (sideband_a)
 	{
 	}
 	virtual ~history_visitor () = default;
 	void send_block (nano::send_block const & block_a)
 	{
-		tree.put ("type", "send");
+		put ("type", "send");
 		auto account (block_a.hashables.destination.to_account ());
-		tree.put ("account", account);
-		auto amount (handler.node.ledger.amount (transaction, hash).convert_to<std::string> ());
-		tree.put ("amount", amount);
+		put ("account", account);
+		auto amount ((handler.node.ledger.balance (transaction, block_a.hashables.previous) - block_a.hashables.balance.number ()).convert_to<std::string> ());
+		put ("amount", amount);
 		if (raw)
 		{
-			tree.put ("destination", account);
-			tree.put ("balance", block_a.hashables.balance.to_string_dec ());
-			tree.put ("previous", block_a.hashables.previous.to_string ());
+			put ("destination", account);
+			put ("balance", block_a.hashables.balance.to_string_dec ());
+			put ("previous", block_a.hashables.previous.to_string ());
 		}
 	}
 	void receive_block (nano::receive_block const & block_a)
 	{
-		tree.put ("type", "receive");
+		put ("type", "receive");
 		auto account (handler.node.ledger.account (transaction, block_a.hashables.source).to_account ());
-		tree.put ("account", account);
-		auto amount (handler.node.ledger.amount (transaction, hash).convert_to<std::string> ());
-		tree.put ("amount", amount);
+		put ("account", account);
+		auto amount ((sideband.balance.number () - handler.node.ledger.balance (transaction, block_a.hashables.previous)).convert_to<std::string> ());
+		put ("amount", amount);
 		if (raw)
 		{
-			tree.put ("source", block_a.hashables.source.to_string ());
-			tree.put ("previous", block_a.hashables.previous.to_string ());
+			put ("source", block_a.hashables.source.to_string ());
+			put ("previous", block_a.hashables.previous.to_string ());
 		}
 	}
 	void open_block (nano::open_block const & block_a)
 	{
 		if (raw)
 		{
-			tree.put ("type", "open");
-			tree.put ("representative", block_a.hashables.representative.to_account ());
-			tree.put ("source", block_a.hashables.source.to_string ());
-			tree.put ("opened", block_a.hashables.account.to_account ());
+			put ("type", "open");
+			put ("representative", block_a.hashables.representative.to_account ());
+			put ("source", block_a.hashables.source.to_string ());
+			put ("opened", block_a.hashables.account.to_account ());
 		}
 		else
 		{
 			// Report opens as a receive
-			tree.put ("type", "receive");
+			put ("type", "receive");
 		}
 		if (block_a.hashables.source != nano::genesis_account)
 		{
-			tree.put ("account", handler.node.ledger.account (transaction, block_a.hashables.source).to_account ());
-			tree.put ("amount", handler.node.ledger.amount (transaction, hash).convert_to<std::string> ());
+			put ("account", handler.node.ledger.account (transaction, block_a.hashables.source).to_account ());
+			put ("amount", sideband.balance.number ().convert_to<std::string> ());
 		}
 		else
 		{
-			tree.put ("account", nano::genesis_account.to_account ());
-			tree.put ("amount", nano::genesis_amount.convert_to<std::string> ());
+			put ("account", nano::genesis_account.to_account ());
+			put ("amount", nano::genesis_amount.convert_to<std::string> ());
 		}
 	}
 	void change_block (nano::change_block const & block_a)
 	{
 		if (raw)
 		{
-			tree.put ("type", "change");
-			tree.put ("representative", block_a.hashables.representative.to_account ());
-			tree.put ("previous", block_a.hashables.previous.to_string ());
+			put ("type", "change");
+			put ("representative", block_a.hashables.representative.to_account ());
+			put ("previous", block_a.hashables.previous.to_string ());
 		}
 	}
 	void state_block (nano::state_block const & block_a)
 	{
 		if (raw)
 		{
-			tree.put ("type", "state");
-			tree.put ("representative", block_a.hashables.representative.to_account ());
-			tree.put ("link", block_a.hashables.link.to_string ());
-			tree.put ("balance", block_a.hashables.balance.to_string_dec ());
-			tree.put ("previous", block_a.hashables.previous.to_string ());
+			put ("type", "state");
+			put ("representative", block_a.hashables.representative.to_account ());
+			put ("link", block_a.hashables.link.to_string ());
+			put ("balance", block_a.hashables.balance.to_string_dec ());
+			put ("previous", block_a.hashables.previous.to_string ());
 		}
 		auto balance (block_a.hashables.balance.number ());
 		auto previous_balance (handler.node.ledger.balance (transaction, block_a.hashables.previous));
@@ -1825,14 +2497,14 @@ public:
 		{
 			if (raw)
 			{
-				tree.put ("subtype", "send");
+				put ("subtype", "send");
 			}
 			else
 			{
-				tree.put ("type", "send");
+				put ("type", "send");
 			}
-			tree.put ("account", block_a.hashables.link.to_account ());
-			tree.put ("amount", (previous_balance - balance).convert_to<std::string> ());
+			put ("account", block_a.hashables.link.to_account ());
+			put ("amount", (previous_balance - balance).convert_to<std::string> ());
 		}
 		else
 		{
@@ -1840,37 +2512,43 @@ public:
 			{
 				if (raw)
 				{
-					tree.put ("subtype", "change");
+					put ("subtype", "change");
 				}
 			}
 			else if (balance == previous_balance && !handler.node.ledger.epoch_link.is_zero () && handler.node.ledger.is_epoch_link (block_a.hashables.link))
 			{
 				if (raw)
 				{
-					tree.put ("subtype", "epoch");
-					tree.put ("account", handler.node.ledger.epoch_signer.to_account ());
+					put ("subtype", "epoch");
+					put ("account", handler.node.ledger.epoch_signer.to_account ());
 				}
 			}
 			else
 			{
 				if (raw)
 				{
-					tree.put ("subtype", "receive");
+					put ("subtype", "receive");
 				}
 				else
 				{
-					tree.put ("type", "receive");
+					put ("type", "receive");
 				}
-				tree.put ("account", handler.node.ledger.account (transaction, block_a.hashables.link).to_account ());
-				tree.put ("amount", (balance - previous_balance).convert_to<std::string> ());
+				put ("account", handler.node.ledger.account (transaction, block_a.hashables.link).to_account ());
+				put ("amount", (balance - previous_balance).convert_to<std::string> ());
 			}
 		}
 	}
+	void put (char const * key_a, std::string const & value_a)
+	{
+		fields.emplace_back (key_a, value_a);
+	}
 	nano::rpc_handler & handler;
 	bool raw;
-	nano::transaction & transaction;
-	boost::property_tree::ptree & tree;
+	nano::transaction const & transaction;
+	history_fields & fields;
 	nano::block_hash const & hash;
+	// Balances of legacy blocks come from the sideband so amounts never walk the chain
+	nano::block_sideband const & sideband;
 };
 }
 
@@ -1880,7 +2558,8 @@ void nano::rpc_handler::account_history ()
 	bool output_raw (request.get_optional<bool> ("raw") == true);
 	nano::block_hash hash;
 	auto head_str (request.get_optional<std::string> ("head"));
-	auto transaction (node.store.tx_begin_read ());
+	auto reverse (request.get_optional<bool> ("reverse") == true);
+	auto transaction (tx_begin_read ());
 	if (head_str)
 	{
 		if (!hash.decode_hex (*head_str))
@@ -1904,17 +2583,53 @@ void nano::rpc_handler::account_history ()
 		account = account_impl ();
 		if (!ec)
 		{
-			hash = node.ledger.latest (transaction, account);
+			nano::account_info info;
+			if (!node.store.account_get (transaction, account, info))
+			{
+				hash = reverse ? info.open_block : info.head;
+			}
+			else
+			{
+				hash.clear ();
+			}
 		}
 	}
 	auto count (count_impl ());
 	auto offset (offset_optional_impl (0));
+	std::string body;
 	if (!ec)
 	{
-		boost::property_tree::ptree history;
-		response_l.put ("account", account.to_account ());
+		nano::json_writer writer (body);
+		writer.begin ();
+		writer.put ("account", account.to_account ());
+		writer.begin_array ("history");
+		history_fields entry;
 		nano::block_sideband sideband;
 		auto block (node.store.block_get (transaction, hash, &sideband));
+		if (block != nullptr && offset > 0 && sideband.height > 0)
+		{
+			// Seek to the first block of the page, heights are only missing while a store upgrade is rebuilding them and the offset is walked instead
+			nano::account_info info;
+			auto error (node.store.account_get (transaction, account, info));
+			assert (!error);
+			auto height (reverse ? sideband.height + offset : (offset < sideband.height ? sideband.height - offset : 0));
+			if (height == 0 || height > info.block_count)
+			{
+				hash.clear ();
+				block = nullptr;
+				offset = 0;
+			}
+			else
+			{
+				auto start (node.store.account_height_get (transaction, account, height));
+				if (!start.is_zero ())
+				{
+					hash = start;
+					block = node.store.block_get (transaction, hash, &sideband);
+					offset = 0;
+				}
+			}
+		}
 		while (block != nullptr && count > 0)
 		{
 			if (offset > 0)
@@ -1923,32 +2638,38 @@ void nano::rpc_handler::account_history ()
 			}
 			else
 			{
-				boost::property_tree::ptree entry;
-				history_visitor visitor (*this, output_raw, transaction, entry, hash);
+				entry.clear ();
+				history_visitor visitor (*this, output_raw, transaction, entry, hash, sideband);
 				block->visit (visitor);
 				if (!entry.empty ())
 				{
-					entry.put ("local_timestamp", std::to_string (sideband.timestamp));
-					entry.put ("hash", hash.to_string ());
+					writer.begin_object ();
+					for (auto & field : entry)
+					{
+						writer.put (field.first, field.second);
+					}
+					writer.put ("local_timestamp", std::to_string (sideband.timestamp));
+					writer.put ("hash", hash.to_string ());
 					if (output_raw)
 					{
-						entry.put ("work", nano::to_string_hex (block->block_work ()));
-						entry.put ("signature", block->block_signature ().to_string ());
+						writer.put ("work", nano::to_string_hex (block->block_work ()));
+						writer.put ("signature", block->block_signature ().to_string ());
 					}
-					history.push_back (std::make_pair ("", entry));
+					writer.end ();
 					--count;
 				}
 			}
-			hash = block->previous ();
+			hash = reverse ? sideband.successor : block->previous ();
 			block = node.store.block_get (transaction, hash, &sideband);
 		}
-		response_l.add_child ("history", history);
+		writer.end ();
 		if (!hash.is_zero ())
 		{
-			response_l.put ("previous", hash.to_string ());
+			writer.put (reverse ? "next" : "previous", hash.to_string ());
 		}
+		writer.finish ();
 	}
-	response_errors ();
+	response_stream (body);
 }
 
 void nano::rpc_handler::keepalive ()
@@ -2002,7 +2723,8 @@ void nano::rpc_handler::key_expand ()
 void nano::rpc_handler::ledger ()
 {
 	rpc_control_impl ();
-	auto count (count_optional_impl ());
+	auto cursor (cursor_impl ());
+	auto count (cursor_count (cursor, count_optional_impl ()));
 	if (!ec)
 	{
 		nano::account start (0);
@@ -2027,44 +2749,71 @@ void nano::rpc_handler::ledger ()
 		const bool representative = request.get<bool> ("representative", false);
 		const bool weight = request.get<bool> ("weight", false);
 		const bool pending = request.get<bool> ("pending", false);
-		boost::property_tree::ptree accounts;
-		auto transaction (node.store.tx_begin_read ());
+		if (cursor != nullptr)
+		{
+			if (sorting)
+			{
+				// Sorting reads every account before the first one can be written
+				ec = nano::error_rpc::invalid_cursor;
+			}
+			else if (cursor->pages > 0)
+			{
+				start = cursor->next.account;
+			}
+		}
+		std::string body;
+		nano::json_writer writer (body);
+		writer.begin ();
+		writer.begin_object ("accounts");
+		uint64_t written (0);
+		auto transaction (tx_begin_read ());
+		auto write_account = [&](nano::account const & account, nano::account_info const & info) {
+			writer.begin_object (account.to_account ());
+			writer.put ("frontier", info.head.to_string ());
+			writer.put ("open_block", info.open_block.to_string ());
+			writer.put ("representative_block", info.rep_block.to_string ());
+			std::string balance;
+			nano::uint128_union (info.balance).encode_dec (balance);
+			writer.put ("balance", balance);
+			writer.put ("modified_timestamp", std::to_string (info.modified));
+			writer.put ("block_count", std::to_string (info.block_count));
+			if (representative)
+			{
+				auto block (node.store.block_get (transaction, info.rep_block));
+				assert (block != nullptr);
+				writer.put ("representative", block->representative ().to_account ());
+			}
+			if (weight)
+			{
+				auto account_weight (node.ledger.weight (transaction, account));
+				writer.put ("weight", account_weight.convert_to<std::string> ());
+			}
+			if (pending)
+			{
+				auto account_pending (node.ledger.account_pending (transaction, account));
+				writer.put ("pending", account_pending.convert_to<std::string> ());
+			}
+			writer.end ();
+			++written;
+		};
 		if (!ec && !sorting) // Simple
 		{
-			for (auto i (node.store.latest_begin (transaction, start)), n (node.store.latest_end ()); i != n && accounts.size () < count; ++i)
+			auto i (node.store.latest_begin (transaction, start));
+			auto n (node.store.latest_end ());
+			for (; i != n && written < count; ++i)
 			{
 				nano::account_info info (i->second);
 				if (info.modified >= modified_since)
 				{
-					nano::account account (i->first);
-					boost::property_tree::ptree response_a;
-					response_a.put ("frontier", info.head.to_string ());
-					response_a.put ("open_block", info.open_block.to_string ());
-					response_a.put ("representative_block", info.rep_block.to_string ());
-					std::string balance;
-					nano::uint128_union (info.balance).encode_dec (balance);
-					response_a.put ("balance", balance);
-					response_a.put ("modified_timestamp", std::to_string (info.modified));
-					response_a.put ("block_count", std::to_string (info.block_count));
-					if (representative)
-					{
-						auto block (node.store.block_get (transaction, info.rep_block));
-						assert (block != nullptr);
-						response_a.put ("representative", block->representative ().to_account ());
-					}
-					if (weight)
-					{
-						auto account_weight (node.ledger.weight (transaction, account));
-						response_a.put ("weight", account_weight.convert_to<std::string> ());
-					}
-					if (pending)
-					{
-						auto account_pending (node.ledger.account_pending (transaction, account));
-						response_a.put ("pending", account_pending.convert_to<std::string> ());
-					}
-					accounts.push_back (std::make_pair (account.to_account (), response_a));
+					write_account (nano::account (i->first), info);
 				}
 			}
+			writer.end ();
+			auto id (i != n ? cursor_finish (cursor, true, nano::unchecked_key (i->first, 0)) : cursor_finish (cursor, false));
+			if (!id.empty ())
+			{
+				writer.put ("cursor", id);
+			}
 		}
 		else if (!ec) // Sorting
 		{
@@ -2081,41 +2830,19 @@ void nano::rpc_handler::ledger ()
 			std::sort (ledger_l.begin (), ledger_l.end ());
 			std::reverse (ledger_l.begin (), ledger_l.end ());
 			nano::account_info info;
-			for (auto i (ledger_l.begin ()), n (ledger_l.end ()); i != n && accounts.size () < count; ++i)
+			for (auto i (ledger_l.begin ()), n (ledger_l.end ()); i != n && written < count; ++i)
 			{
 				node.store.account_get (transaction, i->second, info);
-				nano::account account (i->second);
-				boost::property_tree::ptree response_a;
-				response_a.put ("frontier", info.head.to_string ());
-				response_a.put ("open_block", info.open_block.to_string ());
-				response_a.put ("representative_block", info.rep_block.to_string ());
-				std::string balance;
-				(i->first).encode_dec (balance);
-				response_a.put ("balance", balance);
-				response_a.put ("modified_timestamp", std::to_string (info.modified));
-				response_a.put ("block_count", std::to_string (info.block_count));
-				if (representative)
-				{
-					auto block (node.store.block_get (transaction, info.rep_block));
-					assert (block != nullptr);
-					response_a.put ("representative", block->representative ().to_account ());
-				}
-				if (weight)
-				{
-					auto account_weight (node.ledger.weight (transaction, account));
-					response_a.put ("weight", account_weight.convert_to<std::string> ());
-				}
-				if (pending)
-				{
-					auto account_pending (node.ledger.account_pending (transaction, account));
-					response_a.put ("pending", account_pending.convert_to<std::string> ());
-				}
-				accounts.push_back (std::make_pair (account.to_account (), response_a));
+				write_account (i->second, info);
 			}
 		}
-		response_l.add_child ("accounts", accounts);
+		writer.finish ();
+		response_stream (body);
+	}
+	else
+	{
+		response_errors ();
 	}
-	response_errors ();
 }
 
 void nano::rpc_handler::mFLR_from_raw (nano::uint128_t ratio)
@@ -2267,41 +2994,82 @@ void nano::rpc_handler::pending ()
 	if (!ec)
 	{
 		boost::property_tree::ptree peers_l;
-		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.pending_begin (transaction, nano::pending_key (account, 0))); nano::pending_key (i->first).account == account && peers_l.size () < count; ++i)
+		auto transaction (tx_begin_read ());
+		if (!threshold.is_zero () && node.store.version_get (transaction) >= 15)
 		{
-			nano::pending_key key (i->first);
-			std::shared_ptr<nano::block> block (include_active ? nullptr : node.store.block_get (transaction, key.hash));
-			if (include_active || (block && !node.active.active (*block)))
+			// Entries are ordered by descending amount so blocks are listed largest first, stop at the first one under the threshold
+			for (auto i (node.store.pending_amount_begin (transaction, nano::pending_amount_key (account, std::numeric_limits<nano::uint128_t>::max (), 0))), n (node.store.pending_amount_end ()); i != n && peers_l.size () < count; ++i)
 			{
-				if (threshold.is_zero () && !source && !min_version)
+				nano::pending_amount_key key (i->first);
+				if (key.account != account || key.amount ().number () < threshold.number ())
 				{
-					boost::property_tree::ptree entry;
-					entry.put ("", key.hash.to_string ());
-					peers_l.push_back (std::make_pair ("", entry));
+					break;
 				}
-				else
+				std::shared_ptr<nano::block> block (include_active ? nullptr : node.store.block_get (transaction, key.hash));
+				if (include_active || (block && !node.active.active (*block)))
 				{
-					nano::pending_info info (i->second);
-					if (info.amount.number () >= threshold.number ())
+					if (source || min_version)
 					{
-						if (source || min_version)
+						boost::property_tree::ptree pending_tree;
+						pending_tree.put ("amount", key.amount ().number ().convert_to<std::string> ());
+						if (source)
 						{
-							boost::property_tree::ptree pending_tree;
-							pending_tree.put ("amount", info.amount.number ().convert_to<std::string> ());
-							if (source)
+							pending_tree.put ("source", nano::account (i->second).to_account ());
+						}
+						if (min_version)
+						{
+							// The index doesn't carry the epoch
+							nano::pending_info info;
+							node.store.pending_get (transaction, nano::pending_key (account, key.hash), info);
+							pending_tree.put ("min_version", info.epoch == nano::epoch::epoch_1 ? "1" : "0");
+						}
+						peers_l.add_child (key.hash.to_string (), pending_tree);
+					}
+					else
+					{
+						peers_l.put (key.hash.to_string (), key.amount ().number ().convert_to<std::string> ());
+					}
+				}
+			}
+		}
+		else
+		{
+			// Blocks are listed in hash order, the amount index is only complete once the store reaches version 15
+			for (auto i (node.store.pending_begin (transaction, nano::pending_key (account, 0))); nano::pending_key (i->first).account == account && peers_l.size () < count; ++i)
+			{
+				nano::pending_key key (i->first);
+				std::shared_ptr<nano::block> block (include_active ? nullptr : node.store.block_get (transaction, key.hash));
+				if (include_active || (block && !node.active.active (*block)))
+				{
+					if (threshold.is_zero () && !source && !min_version)
+					{
+						boost::property_tree::ptree entry;
+						entry.put ("", key.hash.to_string ());
+						peers_l.push_back (std::make_pair ("", entry));
+					}
+					else
+					{
+						nano::pending_info info (i->second);
+						if (info.amount.number () >= threshold.number ())
+						{
+							if (source || min_version)
 							{
-								pending_tree.put ("source", info.source.to_account ());
+								boost::property_tree::ptree pending_tree;
+								pending_tree.put ("amount", info.amount.number ().convert_to<std::string> ());
+								if (source)
+								{
+									pending_tree.put ("source", info.source.to_account ());
+								}
+								if (min_version)
+								{
+									pending_tree.put ("min_version", info.epoch == nano::epoch::epoch_1 ? "1" : "0");
+								}
+								peers_l.add_child (key.hash.to_string (), pending_tree);
 							}
-							if (min_version)
+							else
 							{
-								pending_tree.put ("min_version", info.epoch == nano::epoch::epoch_1 ? "1" : "0");
+								peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
 							}
-							peers_l.add_child (key.hash.to_string (), pending_tree);
-						}
-						else
-						{
-							peers_l.put (key.hash.to_string (), info.amount.number ().convert_to<std::string> ());
 						}
 					}
 				}
@@ -2318,7 +3086,7 @@ void nano::rpc_handler::pending_exists ()
 	const bool include_active = request.get<bool> ("include_active", false);
 	if (!ec)
 	{
-		auto transaction (node.store.tx_begin_read ());
+		auto transaction (tx_begin_read ());
 		auto block (node.store.block_get (transaction, hash));
 		if (block != nullptr)
 		{
@@ -2367,7 +3135,7 @@ void nano::rpc_handler::payment_begin ()
 						}
 						else
 						{
-							auto block_transaction (node.store.tx_begin_read ());
+							auto block_transaction (tx_begin_read ());
 							if (!node.ledger.account_balance (block_transaction, account).is_zero ())
 							{
 								BOOST_LOG (node.log) << boost::str (boost::format ("Skipping account %1% for use as a transaction account: non-zero balance") % account.to_account ());
@@ -2433,7 +3201,7 @@ void nano::rpc_handler::payment_end ()
 	if (!ec)
 	{
 		auto transaction (node.wallets.tx_begin_read ());
-		auto block_transaction (node.store.tx_begin_read ());
+		auto block_transaction (tx_begin_read ());
 		wallet_account_impl (transaction, wallet, account);
 		if (!ec)
 		{
@@ -2491,7 +3259,7 @@ void nano::rpc_handler::process ()
 		if (!subtype_text.empty ())
 		{
 			std::shared_ptr<nano::state_block> block_state (std::static_pointer_cast<nano::state_block> (block));
-			auto transaction (node.store.tx_begin_read ());
+			auto transaction (tx_begin_read ());
 			if (!block_state->hashables.previous.is_zero () && !node.store.block_exists (transaction, block_state->hashables.previous))
 			{
 				ec = nano::error_process::gap_previous;
@@ -2655,7 +3423,7 @@ void nano::rpc_handler::receive ()
 		wallet_account_impl (transaction, wallet, account);
 		if (!ec)
 		{
-			auto block_transaction (node.store.tx_begin_read ());
+			auto block_transaction (tx_begin_read ());
 			auto block (node.store.block_get (block_transaction, hash));
 			if (block != nullptr)
 			{
@@ -2692,7 +3460,7 @@ void nano::rpc_handler::receive ()
 							}
 							boost::property_tree::ptree response_l;
 							response_l.put ("block", hash_a.to_string ());
-							response_a (response_l);
+							response_a (nano::json_string (response_l));
 						},
 						work, generate_work);
 						// clang-format on
@@ -2745,7 +3513,7 @@ void nano::rpc_handler::representatives ()
 	{
 		const bool sorting = request.get<bool> ("sorting", false);
 		boost::property_tree::ptree representatives;
-		auto transaction (node.store.tx_begin_read ());
+		auto transaction (tx_begin_read ());
 		if (!sorting) // Simple
 		{
 			for (auto i (node.store.representation_begin (transaction)), n (node.store.representation_end ()); i != n && representatives.size () < count; ++i)
@@ -2755,7 +3523,15 @@ void nano::rpc_handler::representatives ()
 				representatives.put (account.to_account (), amount.convert_to<std::string> ());
 			}
 		}
-		else // Sorting
+		else if (node.store.version_get (transaction) >= 16) // Sorting
+		{
+			for (auto i (node.store.representative_weights_begin (transaction)), n (node.store.representative_weights_end ()); i != n && representatives.size () < count; ++i)
+			{
+				nano::representative_weight_key key (i->first);
+				representatives.put (key.representative.to_account (), key.weight ().number ().convert_to<std::string> ());
+			}
+		}
+		else // Sorting, the weight index is built by the version 16 upgrade
 		{
 			std::vector<std::pair<nano::uint128_union, std::string>> representation;
 			for (auto i (node.store.representation_begin (transaction)), n (node.store.representation_end ()); i != n; ++i)
@@ -2801,7 +3577,7 @@ void nano::rpc_handler::representatives_online ()
 	if (!ec)
 	{
 		boost::property_tree::ptree representatives;
-		auto transaction (node.store.tx_begin_read ());
+		auto transaction (tx_begin_read ());
 		auto reps (node.online_reps.list ());
 		for (auto & i : reps)
 		{
@@ -2865,7 +3641,7 @@ void nano::rpc_handler::republish ()
 	if (!ec)
 	{
 		boost::property_tree::ptree blocks;
-		auto transaction (node.store.tx_begin_read ());
+		auto transaction (tx_begin_read ());
 		auto block (node.store.block_get (transaction, hash));
 		if (block != nullptr)
 		{
@@ -2995,7 +3771,7 @@ void nano::rpc_handler::send ()
 				if (!ec)
 				{
 					auto transaction (node.wallets.tx_begin_read ());
-					auto block_transaction (node.store.tx_begin_read ());
+					auto block_transaction (tx_begin_read ());
 					if (wallet->store.valid_password (transaction))
 					{
 						if (wallet->store.find (transaction, source) != wallet->store.end ())
@@ -3040,7 +3816,7 @@ void nano::rpc_handler::send ()
 							nano::uint256_union hash (block_a->hash ());
 							boost::property_tree::ptree response_l;
 							response_l.put ("block", hash.to_string ());
-							response_a (response_l);
+							response_a (nano::json_string (response_l));
 						}
 						else
 						{
@@ -3185,6 +3961,14 @@ void nano::rpc_handler::stats ()
 		node.stats.log_samples (*sink);
 		use_sink = true;
 	}
+	else if (type == "rpc")
+	{
+		rpc.workers.serialize (response_l);
+	}
+	else if (type == "callback")
+	{
+		node.callbacks.serialize (response_l);
+	}
 	else
 	{
 		ec = nano::error_rpc::invalid_missing_type;
@@ -3193,7 +3977,7 @@ void nano::rpc_handler::stats ()
 	{
 		auto stat_tree_l (*static_cast<boost::property_tree::ptree *> (sink->to_object ()));
 		stat_tree_l.put ("stat_duration_seconds", node.stats.last_reset ().count ());
-		response (stat_tree_l);
+		response (nano::json_string (stat_tree_l));
 	}
 	else
 	{
@@ -3205,7 +3989,7 @@ void nano::rpc_handler::stats_clear ()
 {
 	node.stats.clear ();
 	response_l.put ("success", "");
-	response (response_l);
+	response (nano::json_string (response_l));
 }
 
 void nano::rpc_handler::stop ()
@@ -3225,19 +4009,32 @@ void nano::rpc_handler::stop ()
 
 void nano::rpc_handler::unchecked ()
 {
-	auto count (count_optional_impl ());
+	auto cursor (cursor_impl ());
+	auto count (cursor_count (cursor, count_optional_impl ()));
 	if (!ec)
 	{
 		boost::property_tree::ptree unchecked;
-		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
+		auto transaction (tx_begin_read ());
+		// Paged requests read one more entry, it starts the next page
+		auto items (node.unchecked.list (transaction, cursor != nullptr ? cursor->next : nano::unchecked_key (0, 0), cursor != nullptr ? count + 1 : count));
+		auto more (cursor != nullptr && items.size () > count);
+		nano::unchecked_key next (more ? items.back ().first : nano::unchecked_key (0, 0));
+		if (more)
+		{
+			items.pop_back ();
+		}
+		for (auto & item : items)
 		{
-			nano::unchecked_info info (i->second);
 			std::string contents;
-			info.block->serialize_json (contents);
-			unchecked.put (info.block->hash ().to_string (), contents);
+			item.second.block->serialize_json (contents);
+			unchecked.put (item.second.block->hash ().to_string (), contents);
 		}
 		response_l.add_child ("blocks", unchecked);
+		auto id (cursor_finish (cursor, more, next));
+		if (!id.empty ())
+		{
+			response_l.put ("cursor", id);
+		}
 	}
 	response_errors ();
 }
@@ -3248,7 +4045,7 @@ void nano::rpc_handler::unchecked_clear ()
 	if (!ec)
 	{
 		auto transaction (node.store.tx_begin_write ());
-		node.store.unchecked_clear (transaction);
+		node.unchecked.clear (transaction);
 		response_l.put ("success", "");
 	}
 	response_errors ();
@@ -3259,19 +4056,14 @@ void nano::rpc_handler::unchecked_get ()
 	auto hash (hash_impl ());
 	if (!ec)
 	{
-		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n; ++i)
+		auto transaction (tx_begin_read ());
+		nano::unchecked_info info;
+		if (!node.unchecked.find (transaction, hash, info))
 		{
-			nano::unchecked_key key (i->first);
-			if (key.hash == hash)
-			{
-				nano::unchecked_info info (i->second);
-				response_l.put ("modified_timestamp", std::to_string (info.modified));
-				std::string contents;
-				info.block->serialize_json (contents);
-				response_l.put ("contents", contents);
-				break;
-			}
+			response_l.put ("modified_timestamp", std::to_string (info.modified));
+			std::string contents;
+			info.block->serialize_json (contents);
+			response_l.put ("contents", contents);
 		}
 		if (response_l.empty ())
 		{
@@ -3283,7 +4075,8 @@ void nano::rpc_handler::unchecked_get ()
 
 void nano::rpc_handler::unchecked_keys ()
 {
-	auto count (count_optional_impl ());
+	auto cursor (cursor_impl ());
+	auto count (cursor_count (cursor, count_optional_impl ()));
 	nano::uint256_union key (0);
 	boost::optional<std::string> hash_text (request.get_optional<std::string> ("key"));
 	if (!ec && hash_text.is_initialized ())
@@ -3296,20 +4089,32 @@ void nano::rpc_handler::unchecked_keys ()
 	if (!ec)
 	{
 		boost::property_tree::ptree unchecked;
-		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction, nano::unchecked_key (key, 0))), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
+		auto transaction (tx_begin_read ());
+		auto items (node.unchecked.list (transaction, cursor != nullptr && cursor->pages > 0 ? cursor->next : nano::unchecked_key (key, 0), cursor != nullptr ? count + 1 : count));
+		auto more (cursor != nullptr && items.size () > count);
+		nano::unchecked_key next (more ? items.back ().first : nano::unchecked_key (0, 0));
+		if (more)
+		{
+			items.pop_back ();
+		}
+		for (auto & item : items)
 		{
 			boost::property_tree::ptree entry;
-			nano::unchecked_info info (i->second);
+			auto & info (item.second);
 			std::string contents;
 			info.block->serialize_json (contents);
-			entry.put ("key", nano::block_hash (i->first.key ()).to_string ());
+			entry.put ("key", item.first.key ().to_string ());
 			entry.put ("hash", info.block->hash ().to_string ());
 			entry.put ("modified_timestamp", std::to_string (info.modified));
 			entry.put ("contents", contents);
 			unchecked.push_back (std::make_pair ("", entry));
 		}
 		response_l.add_child ("unchecked", unchecked);
+		auto id (cursor_finish (cursor, more, next));
+		if (!id.empty ())
+		{
+			response_l.put ("cursor", id);
+		}
 	}
 	response_errors ();
 }
@@ -3412,7 +4217,7 @@ void nano::rpc_handler::wallet_info ()
 		uint64_t deterministic_count (0);
 		uint64_t adhoc_count (0);
 		auto transaction (node.wallets.tx_begin_read ());
-		auto block_transaction (node.store.tx_begin_read ());
+		auto block_transaction (tx_begin_read ());
 		for (auto i (wallet->store.begin (transaction)), n (wallet->store.end ()); i != n; ++i)
 		{
 			nano::account account (i->first);
@@ -3448,7 +4253,7 @@ void nano::rpc_handler::wallet_balances ()
 	{
 		boost::property_tree::ptree balances;
 		auto transaction (node.wallets.tx_begin_read ());
-		auto block_transaction (node.store.tx_begin_read ());
+		auto block_transaction (tx_begin_read ());
 		for (auto i (wallet->store.begin (transaction)), n (wallet->store.end ()); i != n; ++i)
 		{
 			nano::account account (i->first);
@@ -3594,7 +4399,7 @@ void nano::rpc_handler::wallet_frontiers ()
 	{
 		boost::property_tree::ptree frontiers;
 		auto transaction (node.wallets.tx_begin_read ());
-		auto block_transaction (node.store.tx_begin_read ());
+		auto block_transaction (tx_begin_read ());
 		for (auto i (wallet->store.begin (transaction)), n (wallet->store.end ()); i != n; ++i)
 		{
 			nano::account account (i->first);
@@ -3623,9 +4428,9 @@ void nano::rpc_handler::wallet_history ()
 	auto wallet (wallet_impl ());
 	if (!ec)
 	{
-		std::multimap<uint64_t, boost::property_tree::ptree, std::greater<uint64_t>> entries;
+		std::multimap<uint64_t, history_fields, std::greater<uint64_t>> entries;
 		auto transaction (node.wallets.tx_begin_read ());
-		auto block_transaction (node.store.tx_begin_read ());
+		auto block_transaction (tx_begin_read ());
 		for (auto i (wallet->store.begin (transaction)), n (wallet->store.end ()); i != n; ++i)
 		{
 			nano::account account (i->first);
@@ -3641,15 +4446,15 @@ void nano::rpc_handler::wallet_history ()
 					timestamp = sideband.timestamp;
 					if (block != nullptr && timestamp >= modified_since)
 					{
-						boost::property_tree::ptree entry;
-						history_visitor visitor (*this, false, block_transaction, entry, hash);
+						history_fields entry;
+						history_visitor visitor (*this, false, block_transaction, entry, hash, sideband);
 						block->visit (visitor);
 						if (!entry.empty ())
 						{
-							entry.put ("block_account", account.to_account ());
-							entry.put ("hash", hash.to_string ());
-							entry.put ("local_timestamp", std::to_string (timestamp));
-							entries.insert (std::make_pair (timestamp, entry));
+							entry.emplace_back ("block_account", account.to_account ());
+							entry.emplace_back ("hash", hash.to_string ());
+							entry.emplace_back ("local_timestamp", std::to_string (timestamp));
+							entries.insert (std::make_pair (timestamp, std::move (entry)));
 						}
 						hash = block->previous ();
 					}
@@ -3660,14 +4465,26 @@ void nano::rpc_handler::wallet_history ()
 				}
 			}
 		}
-		boost::property_tree::ptree history;
+		std::string body;
+		nano::json_writer writer (body);
+		writer.begin ();
+		writer.begin_array ("history");
 		for (auto i (entries.begin ()), n (entries.end ()); i != n; ++i)
 		{
-			history.push_back (std::make_pair ("", i->second));
-		}
-		response_l.add_child ("history", history);
+			writer.begin_object ();
+			for (auto & field : i->second)
+			{
+				writer.put (field.first, field.second);
+			}
+			writer.end ();
+		}
+		writer.finish ();
+		response_stream (body);
+	}
+	else
+	{
+		response_errors ();
 	}
-	response_errors ();
 }
 
 void nano::rpc_handler::wallet_key_valid ()
@@ -3684,6 +4501,8 @@ void nano::rpc_handler::wallet_key_valid ()
 
 void nano::rpc_handler::wallet_ledger ()
 {
+	auto cursor (cursor_impl ());
+	auto count (cursor_count (cursor, count_optional_impl ()));
 	const bool representative = request.get<bool> ("representative", false);
 	const bool weight = request.get<bool> ("weight", false);
 	const bool pending = request.get<bool> ("pending", false);
@@ -3697,9 +4516,12 @@ void nano::rpc_handler::wallet_ledger ()
 	if (!ec)
 	{
 		boost::property_tree::ptree accounts;
+		// Only the ledger is read from the cursor's snapshot, wallets are in their own environment
 		auto transaction (node.wallets.tx_begin_read ());
-		auto block_transaction (node.store.tx_begin_read ());
-		for (auto i (wallet->store.begin (transaction)), n (wallet->store.end ()); i != n; ++i)
+		auto block_transaction (tx_begin_read ());
+		auto i (cursor != nullptr && cursor->pages > 0 ? wallet->store.begin (transaction, cursor->next.account) : wallet->store.begin (transaction));
+		auto n (wallet->store.end ());
+		for (; i != n && accounts.size () < count; ++i)
 		{
 			nano::account account (i->first);
 			nano::account_info info;
@@ -3737,6 +4559,11 @@ void nano::rpc_handler::wallet_ledger ()
 			}
 		}
 		response_l.add_child ("accounts", accounts);
+		auto id (i != n ? cursor_finish (cursor, true, nano::unchecked_key (i->first, 0)) : cursor_finish (cursor, false));
+		if (!id.empty ())
+		{
+			response_l.put ("cursor", id);
+		}
 	}
 	response_errors ();
 }
@@ -3767,7 +4594,7 @@ void nano::rpc_handler::wallet_pending ()
 	{
 		boost::property_tree::ptree pending;
 		auto transaction (node.wallets.tx_begin_read ());
-		auto block_transaction (node.store.tx_begin_read ());
+		auto block_transaction (tx_begin_read ());
 		for (auto i (wallet->store.begin (transaction)), n (wallet->store.end ()); i != n; ++i)
 		{
 			nano::account account (i->first);
@@ -3861,7 +4688,7 @@ void nano::rpc_handler::wallet_representative_set ()
 				std::vector<nano::account> accounts;
 				{
 					auto transaction (node.wallets.tx_begin_read ());
-					auto block_transaction (node.store.tx_begin_read ());
+					auto block_transaction (tx_begin_read ());
 					for (auto i (wallet->store.begin (transaction)), n (wallet->store.end ()); i != n; ++i)
 					{
 						nano::account account (i->first);
@@ -3903,7 +4730,7 @@ void nano::rpc_handler::wallet_republish ()
 		boost::property_tree::ptree blocks;
 		std::deque<std::shared_ptr<nano::block>> republish_bundle;
 		auto transaction (node.wallets.tx_begin_read ());
-		auto block_transaction (node.store.tx_begin_read ());
+		auto block_transaction (tx_begin_read ());
 		for (auto i (wallet->store.begin (transaction)), n (wallet->store.end ()); i != n; ++i)
 		{
 			nano::account account (i->first);
@@ -3966,7 +4793,7 @@ void nano::rpc_handler::work_generate ()
 			{
 				boost::property_tree::ptree response_l;
 				response_l.put ("work", nano::to_string_hex (work_a.value ()));
-				rpc_l->response (response_l);
+				rpc_l->response (nano::json_string (response_l));
 			}
 			else
 			{
@@ -4103,7 +4930,10 @@ void nano::rpc_handler::work_peers_clear ()
 nano::rpc_connection::rpc_connection (nano::node & node_a, nano::rpc & rpc_a) :
 node (node_a.shared ()),
 rpc (rpc_a),
-socket (node_a.io_ctx)
+socket (node_a.io_ctx),
+timer (node_a.io_ctx),
+requests (0),
+keep_alive (false)
 {
 	responded.clear ();
 }
@@ -4122,7 +4952,32 @@ void nano::rpc_connection::prepare_head (unsigned version, boost::beast::http::s
 	res.set (boost::beast::http::field::access_control_allow_origin, "*");
 	res.set (boost::beast::http::field::access_control_allow_methods, "POST, OPTIONS");
 	res.set (boost::beast::http::field::access_control_allow_headers, "Accept, Accept-Language, Content-Language, Content-Type");
-	res.set (boost::beast::http::field::connection, "close");
+	res.keep_alive (keep_alive);
+}
+
+void nano::rpc_connection::idle_timeout ()
+{
+	auto this_l (shared_from_this ());
+	timer.expires_after (std::chrono::seconds (rpc.config.keep_alive_timeout));
+	timer.async_wait ([this_l](boost::system::error_code const & ec) {
+		if (!ec)
+		{
+			boost::system::error_code ignored;
+			this_l->socket.close (ignored);
+		}
+	});
+}
+
+void nano::rpc_connection::update_keep_alive ()
+{
+	keep_alive = request.keep_alive () && ++requests < rpc.config.keep_alive_max_requests;
+}
+
+void nano::rpc_connection::reset ()
+{
+	request = {};
+	res = {};
+	responded.clear ();
 }
 
 void nano::rpc_connection::write_result (std::string body, unsigned version, boost::beast::http::status status)
@@ -4143,20 +4998,24 @@ void nano::rpc_connection::write_result (std::string body, unsigned version, boo
 void nano::rpc_connection::read ()
 {
 	auto this_l (shared_from_this ());
+	idle_timeout ();
 	boost::beast::http::async_read (socket, buffer, request, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
+		this_l->timer.cancel ();
 		if (!ec)
 		{
+			this_l->update_keep_alive ();
 			this_l->node->background ([this_l]() {
 				auto start (std::chrono::steady_clock::now ());
 				auto version (this_l->request.version ());
 				std::string request_id (boost::str (boost::format ("%1%") % boost::io::group (std::hex, std::showbase, reinterpret_cast<uintptr_t> (this_l.get ()))));
-				auto response_handler ([this_l, version, start, request_id](boost::property_tree::ptree const & tree_a) {
-					std::stringstream ostream;
-					boost::property_tree::write_json (ostream, tree_a);
-					ostream.flush ();
-					auto body (ostream.str ());
-					this_l->write_result (body, version);
+				auto write_response ([this_l, version, start, request_id](std::string const & body_a, boost::beast::http::status status_a) {
+					this_l->write_result (body_a, version, status_a);
 					boost::beast::http::async_write (this_l->socket, this_l->res, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
+						if (!ec && this_l->keep_alive)
+						{
+							this_l->reset ();
+							this_l->read ();
+						}
 					});
 
 					if (this_l->node->config.logging.log_rpc ())
@@ -4164,13 +5023,18 @@ void nano::rpc_connection::read ()
 						BOOST_LOG (this_l->node->log) << boost::str (boost::format ("RPC request %2% completed in: %1% microseconds") % std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count () % request_id);
 					}
 				});
+				auto response_handler ([write_response](std::string const & body_a) {
+					write_response (body_a, boost::beast::http::status::ok);
+				});
 				auto method = this_l->request.method ();
 				switch (method)
 				{
 					case boost::beast::http::verb::post:
 					{
 						auto handler (std::make_shared<nano::rpc_handler> (*this_l->node, this_l->rpc, this_l->request.body (), request_id, response_handler));
-						handler->process_request ();
+						handler->queue_request ([write_response](std::string const & body_a) {
+							write_response (body_a, boost::beast::http::status::service_unavailable);
+						});
 						break;
 					}
 					case boost::beast::http::verb::options:
@@ -4178,6 +5042,11 @@ void nano::rpc_connection::read ()
 						this_l->prepare_head (version);
 						this_l->res.prepare_payload ();
 						boost::beast::http::async_write (this_l->socket, this_l->res, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
+							if (!ec && this_l->keep_alive)
+							{
+								this_l->reset ();
+								this_l->read ();
+							}
 						});
 						break;
 					}
@@ -4189,8 +5058,9 @@ void nano::rpc_connection::read ()
 				}
 			});
 		}
-		else
+		else if (ec != boost::beast::http::error::end_of_stream && ec != boost::asio::error::operation_aborted)
 		{
+			// A persistent connection ends with the client closing it or the idle timeout closing the socket
 			BOOST_LOG (this_l->node->log) << "RPC read error: " << ec.message ();
 		}
 	});
@@ -4235,8 +5105,9 @@ std::string filter_request (boost::property_tree::ptree tree_a)
 }
 }
 
-void nano::rpc_handler::process_request ()
+bool nano::rpc_handler::parse_request ()
 {
+	auto error (true);
 	try
 	{
 		auto max_depth_exceeded (false);
@@ -4252,6 +5123,10 @@ void nano::rpc_handler::process_request ()
 				}
 				++max_depth_possible;
 			}
+			else if ((ch == ']' || ch == '}') && max_depth_possible > 0)
+			{
+				--max_depth_possible;
+			}
 		}
 		if (max_depth_exceeded)
 		{
@@ -4261,489 +5136,540 @@ void nano::rpc_handler::process_request ()
 		{
 			std::stringstream istream (body);
 			boost::property_tree::read_json (istream, request);
-			std::string action (request.get<std::string> ("action"));
-			if (node.config.logging.log_rpc ())
-			{
-				BOOST_LOG (node.log) << boost::str (boost::format ("%1% ") % request_id) << filter_request (request);
-			}
-			if (action == "account_balance")
-			{
-				account_balance ();
-			}
-			else if (action == "account_block_count")
-			{
-				account_block_count ();
-			}
-			else if (action == "account_count")
-			{
-				account_count ();
-			}
-			else if (action == "account_create")
-			{
-				account_create ();
-			}
-			else if (action == "account_get")
-			{
-				account_get ();
-			}
-			else if (action == "account_history")
-			{
-				account_history ();
-			}
-			else if (action == "account_info")
-			{
-				account_info ();
-			}
-			else if (action == "account_key")
-			{
-				account_key ();
-			}
-			else if (action == "account_list")
-			{
-				account_list ();
-			}
-			else if (action == "account_move")
-			{
-				account_move ();
-			}
-			else if (action == "account_remove")
-			{
-				account_remove ();
-			}
-			else if (action == "account_representative")
-			{
-				account_representative ();
-			}
-			else if (action == "account_representative_set")
-			{
-				account_representative_set ();
-			}
-			else if (action == "account_weight")
-			{
-				account_weight ();
-			}
-			else if (action == "accounts_balances")
-			{
-				accounts_balances ();
-			}
-			else if (action == "accounts_create")
-			{
-				accounts_create ();
-			}
-			else if (action == "accounts_frontiers")
-			{
-				accounts_frontiers ();
-			}
-			else if (action == "accounts_pending")
-			{
-				accounts_pending ();
-			}
-			else if (action == "available_supply")
-			{
-				available_supply ();
-			}
-			else if (action == "block")
-			{
-				block_info ();
-			}
-			else if (action == "block_info")
-			{
-				block_info ();
-			}
-			else if (action == "block_confirm")
-			{
-				block_confirm ();
-			}
-			else if (action == "blocks")
-			{
-				blocks ();
-			}
-			else if (action == "blocks_info")
-			{
-				blocks_info ();
-			}
-			else if (action == "block_account")
-			{
-				block_account ();
-			}
-			else if (action == "block_count")
-			{
-				block_count ();
-			}
-			else if (action == "block_count_type")
-			{
-				block_count_type ();
-			}
-			else if (action == "block_create")
-			{
-				block_create ();
-			}
-			else if (action == "block_hash")
-			{
-				block_hash ();
-			}
-			else if (action == "successors")
-			{
-				chain (true);
-			}
-			else if (action == "bootstrap")
-			{
-				bootstrap ();
-			}
-			else if (action == "bootstrap_any")
-			{
-				bootstrap_any ();
-			}
-			else if (action == "bootstrap_lazy")
-			{
-				bootstrap_lazy ();
-			}
-			else if (action == "bootstrap_status")
-			{
-				bootstrap_status ();
-			}
-			else if (action == "chain")
-			{
-				chain ();
-			}
-			else if (action == "delegators")
-			{
-				delegators ();
-			}
-			else if (action == "delegators_count")
-			{
-				delegators_count ();
-			}
-			else if (action == "deterministic_key")
-			{
-				deterministic_key ();
-			}
-			else if (action == "confirmation_active")
-			{
-				confirmation_active ();
-			}
-			else if (action == "confirmation_history")
-			{
-				confirmation_history ();
-			}
-			else if (action == "confirmation_info")
-			{
-				confirmation_info ();
-			}
-			else if (action == "confirmation_quorum")
-			{
-				confirmation_quorum ();
-			}
-			else if (action == "frontiers")
-			{
-				frontiers ();
-			}
-			else if (action == "frontier_count")
-			{
-				account_count ();
-			}
-			else if (action == "history")
+			auto first (body.find_first_not_of (" \t\r\n"));
+			if (first != std::string::npos && body[first] == '[')
 			{
-				request.put ("head", request.get<std::string> ("hash"));
-				account_history ();
+				// A JSON array body is shorthand for a batch of its elements
+				boost::property_tree::ptree requests;
+				requests.swap (request);
+				request.put ("action", "batch");
+				request.add_child ("requests", requests);
 			}
-			else if (action == "keepalive")
-			{
-				keepalive ();
-			}
-			else if (action == "key_create")
-			{
-				key_create ();
-			}
-			else if (action == "key_expand")
-			{
-				key_expand ();
-			}
-			else if (action == "k_from_raw" || action == "kflr_from_raw")
-			{
-				mFLR_from_raw (nano::kFLR_ratio);
-			}
-			else if (action == "k_to_raw" || action == "kflr_to_raw")
-			{
-				mFLR_to_raw (nano::kFLR_ratio);
-			}
-			else if (action == "ledger")
-			{
-				ledger ();
-			}
-			else if (action == "m_from_raw" || action == "flr_from_raw")
-			{
-				mFLR_from_raw ();
-			}
-			else if (action == "m_to_raw" || action == "flr_to_raw")
-			{
-				mFLR_to_raw ();
-			}
-			else if (action == "node_id")
-			{
-				node_id ();
-			}
-			else if (action == "node_id_delete")
-			{
-				node_id_delete ();
-			}
-			else if (action == "password_change")
-			{
-				password_change ();
-			}
-			else if (action == "password_enter")
-			{
-				password_enter ();
-			}
-			else if (action == "password_valid")
-			{
-				password_valid ();
-			}
-			else if (action == "payment_begin")
-			{
-				payment_begin ();
-			}
-			else if (action == "payment_init")
-			{
-				payment_init ();
-			}
-			else if (action == "payment_end")
-			{
-				payment_end ();
-			}
-			else if (action == "payment_wait")
-			{
-				payment_wait ();
-			}
-			else if (action == "peers")
-			{
-				peers ();
-			}
-			else if (action == "pending")
-			{
-				pending ();
-			}
-			else if (action == "pending_exists")
-			{
-				pending_exists ();
-			}
-			else if (action == "process")
-			{
-				process ();
-			}
-			else if (action == "nano_from_raw" || action == "raw_from_raw")
-			{
-				mFLR_from_raw (nano::FLR_ratio);
-			}
-			else if (action == "nano_to_raw" || action == "raw_to_raw")
-			{
-				mFLR_to_raw (nano::FLR_ratio);
-			}
-			else if (action == "receive")
-			{
-				receive ();
-			}
-			else if (action == "receive_minimum")
-			{
-				receive_minimum ();
-			}
-			else if (action == "receive_minimum_set")
-			{
-				receive_minimum_set ();
-			}
-			else if (action == "representatives")
-			{
-				representatives ();
-			}
-			else if (action == "representatives_online")
-			{
-				representatives_online ();
-			}
-			else if (action == "republish")
-			{
-				republish ();
-			}
-			else if (action == "search_pending")
-			{
-				search_pending ();
-			}
-			else if (action == "search_pending_all")
-			{
-				search_pending_all ();
-			}
-			else if (action == "send")
-			{
-				send ();
-			}
-			else if (action == "sign")
-			{
-				sign ();
-			}
-			else if (action == "stats")
-			{
-				stats ();
-			}
-			else if (action == "stats_clear")
-			{
-				stats_clear ();
-			}
-			else if (action == "stop")
-			{
-				stop ();
-			}
-			else if (action == "unchecked")
-			{
-				unchecked ();
-			}
-			else if (action == "unchecked_clear")
-			{
-				unchecked_clear ();
-			}
-			else if (action == "unchecked_get")
-			{
-				unchecked_get ();
-			}
-			else if (action == "unchecked_keys")
-			{
-				unchecked_keys ();
-			}
-			else if (action == "uptime")
-			{
-				uptime ();
-			}
-			else if (action == "validate_account_number")
-			{
-				validate_account_number ();
-			}
-			else if (action == "version")
-			{
-				version ();
-			}
-			else if (action == "wallet_add")
-			{
-				wallet_add ();
-			}
-			else if (action == "wallet_add_watch")
-			{
-				wallet_add_watch ();
-			}
-			// Obsolete
-			else if (action == "wallet_balance_total")
-			{
-				wallet_info ();
-			}
-			else if (action == "wallet_balances")
-			{
-				wallet_balances ();
-			}
-			else if (action == "wallet_change_seed")
-			{
-				wallet_change_seed ();
-			}
-			else if (action == "wallet_contains")
-			{
-				wallet_contains ();
-			}
-			else if (action == "wallet_create")
-			{
-				wallet_create ();
-			}
-			else if (action == "wallet_destroy")
-			{
-				wallet_destroy ();
-			}
-			else if (action == "wallet_export")
-			{
-				wallet_export ();
-			}
-			else if (action == "wallet_frontiers")
-			{
-				wallet_frontiers ();
-			}
-			else if (action == "wallet_history")
-			{
-				wallet_history ();
-			}
-			else if (action == "wallet_info")
-			{
-				wallet_info ();
-			}
-			else if (action == "wallet_key_valid")
-			{
-				wallet_key_valid ();
-			}
-			else if (action == "wallet_ledger")
-			{
-				wallet_ledger ();
-			}
-			else if (action == "wallet_lock")
-			{
-				wallet_lock ();
-			}
-			else if (action == "wallet_locked")
-			{
-				password_valid (true);
-			}
-			else if (action == "wallet_pending")
-			{
-				wallet_pending ();
-			}
-			else if (action == "wallet_representative")
-			{
-				wallet_representative ();
-			}
-			else if (action == "wallet_representative_set")
-			{
-				wallet_representative_set ();
-			}
-			else if (action == "wallet_republish")
-			{
-				wallet_republish ();
-			}
-			else if (action == "wallet_unlock")
+			if (node.config.logging.log_rpc ())
 			{
-				password_enter ();
-			}
-			else if (action == "wallet_work_get")
-			{
-				wallet_work_get ();
-			}
-			else if (action == "work_generate")
-			{
-				work_generate ();
-			}
-			else if (action == "work_cancel")
-			{
-				work_cancel ();
-			}
-			else if (action == "work_get")
-			{
-				work_get ();
-			}
-			else if (action == "work_set")
-			{
-				work_set ();
-			}
-			else if (action == "work_validate")
-			{
-				work_validate ();
-			}
-			else if (action == "work_peer_add")
-			{
-				work_peer_add ();
-			}
-			else if (action == "work_peers")
-			{
-				work_peers ();
-			}
-			else if (action == "work_peers_clear")
-			{
-				work_peers_clear ();
-			}
-			else
-			{
-				error_response (response, "Unknown command");
+				BOOST_LOG (node.log) << boost::str (boost::format ("%1% ") % request_id) << filter_request (request);
 			}
+			error = false;
+		}
+	}
+	catch (std::runtime_error const &)
+	{
+		error_response (response, "Unable to parse JSON");
+	}
+	catch (...)
+	{
+		error_response (response, "Internal server error in RPC");
+	}
+	return error;
+}
+
+void nano::rpc_handler::process_request ()
+{
+	if (!parse_request ())
+	{
+		process_action ();
+	}
+}
+
+void nano::rpc_handler::queue_request (std::function<void(std::string const &)> const & unavailable_a)
+{
+	if (!parse_request ())
+	{
+		auto this_l (shared_from_this ());
+		auto unavailable (unavailable_a ? unavailable_a : response);
+		if (rpc.workers.push (nano::rpc_workers::classify (request.get<std::string> ("action", "")), [this_l]() { this_l->process_action (); }, [unavailable]() { error_response (unavailable, std::error_code (nano::error_rpc::stopping).message ()); }))
+		{
+			error_response (unavailable, std::error_code (nano::error_rpc::queue_full).message ());
+		}
+	}
+}
+
+void nano::rpc_handler::process_action ()
+{
+	try
+	{
+		std::string action (request.get<std::string> ("action"));
+		if (action == "account_balance")
+		{
+			account_balance ();
+		}
+		else if (action == "account_block_count")
+		{
+			account_block_count ();
+		}
+		else if (action == "account_count")
+		{
+			account_count ();
+		}
+		else if (action == "account_create")
+		{
+			account_create ();
+		}
+		else if (action == "account_get")
+		{
+			account_get ();
+		}
+		else if (action == "account_history")
+		{
+			account_history ();
+		}
+		else if (action == "account_info")
+		{
+			account_info ();
+		}
+		else if (action == "account_key")
+		{
+			account_key ();
+		}
+		else if (action == "account_list")
+		{
+			account_list ();
+		}
+		else if (action == "account_move")
+		{
+			account_move ();
+		}
+		else if (action == "account_remove")
+		{
+			account_remove ();
+		}
+		else if (action == "account_representative")
+		{
+			account_representative ();
+		}
+		else if (action == "account_representative_set")
+		{
+			account_representative_set ();
+		}
+		else if (action == "account_weight")
+		{
+			account_weight ();
+		}
+		else if (action == "accounts_balances")
+		{
+			accounts_balances ();
+		}
+		else if (action == "accounts_create")
+		{
+			accounts_create ();
+		}
+		else if (action == "accounts_frontiers")
+		{
+			accounts_frontiers ();
+		}
+		else if (action == "accounts_pending")
+		{
+			accounts_pending ();
+		}
+		else if (action == "available_supply")
+		{
+			available_supply ();
+		}
+		else if (action == "batch")
+		{
+			batch ();
+		}
+		else if (action == "block")
+		{
+			block_info ();
+		}
+		else if (action == "block_info")
+		{
+			block_info ();
+		}
+		else if (action == "block_confirm")
+		{
+			block_confirm ();
+		}
+		else if (action == "blocks")
+		{
+			blocks ();
+		}
+		else if (action == "blocks_info")
+		{
+			blocks_info ();
+		}
+		else if (action == "block_account")
+		{
+			block_account ();
+		}
+		else if (action == "block_count")
+		{
+			block_count ();
+		}
+		else if (action == "block_count_type")
+		{
+			block_count_type ();
+		}
+		else if (action == "block_create")
+		{
+			block_create ();
+		}
+		else if (action == "block_hash")
+		{
+			block_hash ();
+		}
+		else if (action == "successors")
+		{
+			chain (true);
+		}
+		else if (action == "bootstrap")
+		{
+			bootstrap ();
+		}
+		else if (action == "bootstrap_any")
+		{
+			bootstrap_any ();
+		}
+		else if (action == "bootstrap_lazy")
+		{
+			bootstrap_lazy ();
+		}
+		else if (action == "bootstrap_status")
+		{
+			bootstrap_status ();
+		}
+		else if (action == "chain")
+		{
+			chain ();
+		}
+		else if (action == "delegators")
+		{
+			delegators ();
+		}
+		else if (action == "delegators_count")
+		{
+			delegators_count ();
+		}
+		else if (action == "deterministic_key")
+		{
+			deterministic_key ();
+		}
+		else if (action == "confirmation_active")
+		{
+			confirmation_active ();
+		}
+		else if (action == "confirmation_history")
+		{
+			confirmation_history ();
+		}
+		else if (action == "confirmation_info")
+		{
+			confirmation_info ();
+		}
+		else if (action == "confirmation_quorum")
+		{
+			confirmation_quorum ();
+		}
+		else if (action == "frontiers")
+		{
+			frontiers ();
+		}
+		else if (action == "frontier_count")
+		{
+			account_count ();
+		}
+		else if (action == "history")
+		{
+			request.put ("head", request.get<std::string> ("hash"));
+			account_history ();
+		}
+		else if (action == "keepalive")
+		{
+			keepalive ();
+		}
+		else if (action == "key_create")
+		{
+			key_create ();
+		}
+		else if (action == "key_expand")
+		{
+			key_expand ();
+		}
+		else if (action == "k_from_raw" || action == "kflr_from_raw")
+		{
+			mFLR_from_raw (nano::kFLR_ratio);
+		}
+		else if (action == "k_to_raw" || action == "kflr_to_raw")
+		{
+			mFLR_to_raw (nano::kFLR_ratio);
+		}
+		else if (action == "ledger")
+		{
+			ledger ();
+		}
+		else if (action == "m_from_raw" || action == "flr_from_raw")
+		{
+			mFLR_from_raw ();
+		}
+		else if (action == "m_to_raw" || action == "flr_to_raw")
+		{
+			mFLR_to_raw ();
+		}
+		else if (action == "node_id")
+		{
+			node_id ();
+		}
+		else if (action == "node_id_delete")
+		{
+			node_id_delete ();
+		}
+		else if (action == "password_change")
+		{
+			password_change ();
+		}
+		else if (action == "password_enter")
+		{
+			password_enter ();
+		}
+		else if (action == "password_valid")
+		{
+			password_valid ();
+		}
+		else if (action == "payment_begin")
+		{
+			payment_begin ();
+		}
+		else if (action == "payment_init")
+		{
+			payment_init ();
+		}
+		else if (action == "payment_end")
+		{
+			payment_end ();
+		}
+		else if (action == "payment_wait")
+		{
+			payment_wait ();
+		}
+		else if (action == "peers")
+		{
+			peers ();
+		}
+		else if (action == "pending")
+		{
+			pending ();
+		}
+		else if (action == "pending_exists")
+		{
+			pending_exists ();
+		}
+		else if (action == "process")
+		{
+			process ();
+		}
+		else if (action == "nano_from_raw" || action == "raw_from_raw")
+		{
+			mFLR_from_raw (nano::FLR_ratio);
+		}
+		else if (action == "nano_to_raw" || action == "raw_to_raw")
+		{
+			mFLR_to_raw (nano::FLR_ratio);
+		}
+		else if (action == "receive")
+		{
+			receive ();
+		}
+		else if (action == "receive_minimum")
+		{
+			receive_minimum ();
+		}
+		else if (action == "receive_minimum_set")
+		{
+			receive_minimum_set ();
+		}
+		else if (action == "representatives")
+		{
+			representatives ();
+		}
+		else if (action == "representatives_online")
+		{
+			representatives_online ();
+		}
+		else if (action == "republish")
+		{
+			republish ();
+		}
+		else if (action == "search_pending")
+		{
+			search_pending ();
+		}
+		else if (action == "search_pending_all")
+		{
+			search_pending_all ();
+		}
+		else if (action == "send")
+		{
+			send ();
+		}
+		else if (action == "sign")
+		{
+			sign ();
+		}
+		else if (action == "stats")
+		{
+			stats ();
+		}
+		else if (action == "stats_clear")
+		{
+			stats_clear ();
+		}
+		else if (action == "stop")
+		{
+			stop ();
+		}
+		else if (action == "unchecked")
+		{
+			unchecked ();
+		}
+		else if (action == "unchecked_clear")
+		{
+			unchecked_clear ();
+		}
+		else if (action == "unchecked_get")
+		{
+			unchecked_get ();
+		}
+		else if (action == "unchecked_keys")
+		{
+			unchecked_keys ();
+		}
+		else if (action == "uptime")
+		{
+			uptime ();
+		}
+		else if (action == "validate_account_number")
+		{
+			validate_account_number ();
+		}
+		else if (action == "version")
+		{
+			version ();
+		}
+		else if (action == "wallet_add")
+		{
+			wallet_add ();
+		}
+		else if (action == "wallet_add_watch")
+		{
+			wallet_add_watch ();
+		}
+		// Obsolete
+		else if (action == "wallet_balance_total")
+		{
+			wallet_info ();
+		}
+		else if (action == "wallet_balances")
+		{
+			wallet_balances ();
+		}
+		else if (action == "wallet_change_seed")
+		{
+			wallet_change_seed ();
+		}
+		else if (action == "wallet_contains")
+		{
+			wallet_contains ();
+		}
+		else if (action == "wallet_create")
+		{
+			wallet_create ();
+		}
+		else if (action == "wallet_destroy")
+		{
+			wallet_destroy ();
+		}
+		else if (action == "wallet_export")
+		{
+			wallet_export ();
+		}
+		else if (action == "wallet_frontiers")
+		{
+			wallet_frontiers ();
+		}
+		else if (action == "wallet_history")
+		{
+			wallet_history ();
+		}
+		else if (action == "wallet_info")
+		{
+			wallet_info ();
+		}
+		else if (action == "wallet_key_valid")
+		{
+			wallet_key_valid ();
+		}
+		else if (action == "wallet_ledger")
+		{
+			wallet_ledger ();
+		}
+		else if (action == "wallet_lock")
+		{
+			wallet_lock ();
+		}
+		else if (action == "wallet_locked")
+		{
+			password_valid (true);
+		}
+		else if (action == "wallet_pending")
+		{
+			wallet_pending ();
+		}
+		else if (action == "wallet_representative")
+		{
+			wallet_representative ();
+		}
+		else if (action == "wallet_representative_set")
+		{
+			wallet_representative_set ();
+		}
+		else if (action == "wallet_republish")
+		{
+			wallet_republish ();
+		}
+		else if (action == "wallet_unlock")
+		{
+			password_enter ();
+		}
+		else if (action == "wallet_work_get")
+		{
+			wallet_work_get ();
+		}
+		else if (action == "work_generate")
+		{
+			work_generate ();
+		}
+		else if (action == "work_cancel")
+		{
+			work_cancel ();
+		}
+		else if (action == "work_get")
+		{
+			work_get ();
+		}
+		else if (action == "work_set")
+		{
+			work_set ();
+		}
+		else if (action == "work_validate")
+		{
+			work_validate ();
+		}
+		else if (action == "work_peer_add")
+		{
+			work_peer_add ();
+		}
+		else if (action == "work_peers")
+		{
+			work_peers ();
+		}
+		else if (action == "work_peers_clear")
+		{
+			work_peers_clear ();
+		}
+		else
+		{
+			error_response (response, "Unknown command");
 		}
 	}
 	catch (std::runtime_error const &)
@@ -4756,7 +5682,7 @@ void nano::rpc_handler::process_request ()
 	}
 }
 
-nano::payment_observer::payment_observer (std::function<void(boost::property_tree::ptree const &)> const & response_a, nano::rpc & rpc_a, nano::account const & account_a, nano::amount const & amount_a) :
+nano::payment_observer::payment_observer (std::function<void(std::string const &)> const & response_a, nano::rpc & rpc_a, nano::account const & account_a, nano::amount const & amount_a) :
 rpc (rpc_a),
 account (account_a),
 amount (amount_a),
@@ -4768,7 +5694,7 @@ response (response_a)
 void nano::payment_observer::start (uint64_t timeout)
 {
 	auto this_l (shared_from_this ());
-	rpc.node.alarm.add (std::chrono::steady_clock::now () + std::chrono::milliseconds (timeout), [this_l]() {
+	rpc.node.alarm.add (rpc.node.alarm.now () + std::chrono::milliseconds (timeout), [this_l]() {
 		this_l->complete (nano::payment_status::nothing);
 	});
 }
@@ -4800,14 +5726,14 @@ void nano::payment_observer::complete (nano::payment_status status)
 			{
 				boost::property_tree::ptree response_l;
 				response_l.put ("status", "nothing");
-				response (response_l);
+				response (nano::json_string (response_l));
 				break;
 			}
 			case nano::payment_status::success:
 			{
 				boost::property_tree::ptree response_l;
 				response_l.put ("status", "success");
-				response (response_l);
+				response (nano::json_string (response_l));
 				break;
 			}
 			default:
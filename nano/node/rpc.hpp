@@ -5,6 +5,9 @@
 #include <boost/beast.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <boost/thread/thread.hpp>
+#include <condition_variable>
+#include <deque>
 #include <nano/lib/blocks.hpp>
 #include <nano/lib/errors.hpp>
 #include <nano/lib/jsonconfig.hpp>
@@ -14,7 +17,10 @@
 
 namespace nano
 {
-void error_response (std::function<void(boost::property_tree::ptree const &)> response_a, std::string const & message_a);
+/** Serializes a response tree, streamed responses are written in the same layout by nano::json_writer */
+std::string json_string (boost::property_tree::ptree const &);
+void error_response (std::function<void(std::string const &)> response_a, std::string const & message_a);
+class alarm;
 class node;
 /** Configuration options for RPC TLS */
 class rpc_secure_config
@@ -53,6 +59,27 @@ public:
 	rpc_secure_config secure;
 	uint8_t max_json_depth;
 	bool enable_sign_hash;
+	/** Maximum number of sub-requests in a batch request */
+	uint64_t batch_request_limit;
+	/** Worker threads and queue limit of each request class, see nano::rpc_request_class */
+	unsigned read_threads;
+	uint64_t read_queue_limit;
+	unsigned heavy_threads;
+	uint64_t heavy_queue_limit;
+	unsigned mutation_threads;
+	uint64_t mutation_queue_limit;
+	/** Seconds a persistent connection may wait for its next request before it's closed */
+	uint64_t keep_alive_timeout;
+	/** Requests served on a connection before it's closed, 1 disables keep-alive */
+	uint64_t keep_alive_max_requests;
+	/** Open cursors, including those whose page is being read. Each one holds a read snapshot and with the worker threads they may use at most half of LMDB's reader slots */
+	uint64_t cursor_limit;
+	/** Maximum entries in a page read through a cursor */
+	uint64_t cursor_page_limit;
+	/** Seconds a cursor is kept without its next page being requested */
+	uint64_t cursor_timeout;
+	/** Seconds after opening a cursor when its snapshot is released even if pages are still being read */
+	uint64_t cursor_lifetime;
 };
 enum class payment_status
 {
@@ -64,6 +91,124 @@ enum class payment_status
 	//success_fork, // Amount received but it involved a fork
 	success // Amount received
 };
+/** Requests are queued by class so a burst of one kind can't delay the others */
+enum class rpc_request_class
+{
+	/** Point lookups and other cheap reads */
+	read,
+	/** Actions iterating over accounts, chains or wallets */
+	heavy,
+	/** Wallet, work, node and ledger mutations */
+	mutation
+};
+/**
+ * Runs RPC actions on dedicated threads instead of the node's io threads, with one bounded queue per request class.
+ * Requests arriving while their class's queue is full are rejected.
+ */
+class rpc_workers
+{
+public:
+	rpc_workers (nano::rpc_config const &);
+	~rpc_workers ();
+	/**
+	 * Queues the action, returns true if the class's queue is full or the workers are stopped. Classes without threads run the action immediately.
+	 * If the workers stop before the action runs, the optional dropped callback is called instead so the request can still be answered.
+	 */
+	bool push (nano::rpc_request_class, std::function<void()> const &, std::function<void()> const & = nullptr);
+	// Calls the dropped callback of every queued action
+	void stop ();
+	size_t threads (nano::rpc_request_class) const;
+	/** Queue sizes, rejections and wait and execution time histograms of each class */
+	void serialize (boost::property_tree::ptree &);
+	static nano::rpc_request_class classify (std::string const &);
+
+private:
+	/** Counts durations in decade buckets from 100 microseconds to 10 seconds */
+	class histogram
+	{
+	public:
+		histogram ();
+		void add (std::chrono::steady_clock::duration const &);
+		void serialize (boost::property_tree::ptree &) const;
+		static size_t constexpr bucket_count = 7;
+		std::array<uint64_t, bucket_count> buckets;
+	};
+	class item
+	{
+	public:
+		std::chrono::steady_clock::time_point queued;
+		std::function<void()> action;
+		std::function<void()> dropped;
+	};
+	class queue
+	{
+	public:
+		std::deque<item> items;
+		uint64_t limit;
+		uint64_t rejected;
+		histogram wait;
+		histogram execution;
+		std::condition_variable condition;
+		std::vector<boost::thread> threads;
+	};
+	void run (nano::rpc_workers::queue &);
+	std::mutex mutex;
+	bool stopped;
+	std::array<queue, 3> queues;
+};
+/**
+ * Position of a paged ledger-wide request. Every page reads from the snapshot taken when the cursor was opened,
+ * so a client can pull a whole table without seeing it change between pages.
+ */
+class rpc_cursor
+{
+public:
+	rpc_cursor (nano::block_store &, std::string const &, boost::property_tree::ptree const &, std::chrono::seconds const &, std::shared_ptr<std::atomic<uint64_t>> const &);
+	~rpc_cursor ();
+	std::string id;
+	std::string action;
+	// Options of the request that opened the cursor, later pages only have to name it
+	boost::property_tree::ptree request;
+	nano::transaction snapshot;
+	// First key of the next page. Unchecked pages use both fields, account pages only the first
+	nano::unchecked_key next;
+	uint64_t pages;
+	std::chrono::steady_clock::time_point expiry;
+	std::chrono::steady_clock::time_point end_of_life;
+	// Count of open cursors, decremented when this one is destroyed
+	std::shared_ptr<std::atomic<uint64_t>> open;
+};
+/**
+ * Cursors waiting for their next page. A cursor is taken out while a page is read so a request can't share it with another one,
+ * and dropped with its snapshot once it expires.
+ */
+class rpc_cursors : public std::enable_shared_from_this<nano::rpc_cursors>
+{
+public:
+	rpc_cursors (nano::rpc_config const &);
+	// Returns nullptr if the limit of open cursors is reached
+	std::shared_ptr<nano::rpc_cursor> open (nano::block_store &, std::string const &, boost::property_tree::ptree const &);
+	// Removes and returns the cursor, nullptr if it doesn't exist, expired or belongs to another action
+	std::shared_ptr<nano::rpc_cursor> take (std::string const &, std::string const &);
+	// Keeps the cursor for its next page unless it has reached the end of its life
+	void put (std::shared_ptr<nano::rpc_cursor> const &);
+	void cleanup ();
+	// Runs cleanup on the alarm until the cursors are destroyed
+	void ongoing_cleanup (nano::alarm &);
+	void stop ();
+	// Cursors waiting for their next page
+	size_t size ();
+	// Waiting cursors and cursors taken to read a page
+	uint64_t open_count () const;
+
+private:
+	std::mutex mutex;
+	std::unordered_map<std::string, std::shared_ptr<nano::rpc_cursor>> cursors;
+	std::shared_ptr<std::atomic<uint64_t>> open_cursors;
+	uint64_t limit;
+	std::chrono::seconds timeout;
+	std::chrono::seconds lifetime;
+};
 class wallet;
 class payment_observer;
 class rpc
@@ -88,6 +233,9 @@ public:
 	nano::node & node;
 	bool on;
 	static uint16_t const rpc_port = nano::is_live_network ? 8086 : 55000;
+	std::shared_ptr<nano::rpc_cursors> cursors;
+	// Declared last so running actions are joined before the rest of the rpc is destroyed
+	nano::rpc_workers workers;
 };
 class rpc_connection : public std::enable_shared_from_this<nano::rpc_connection>
 {
@@ -98,18 +246,28 @@ public:
 	virtual void read ();
 	virtual void prepare_head (unsigned version, boost::beast::http::status status = boost::beast::http::status::ok);
 	virtual void write_result (std::string body, unsigned version, boost::beast::http::status status = boost::beast::http::status::ok);
+	/** Closes the socket unless the next request is read before the keep-alive timeout, cancelled by the read handler */
+	void idle_timeout ();
+	/** Decides whether the connection stays open after responding to the request just read */
+	void update_keep_alive ();
+	/** Clears the previous exchange so the next request on the connection can be read */
+	void reset ();
 	std::shared_ptr<nano::node> node;
 	nano::rpc & rpc;
 	boost::asio::ip::tcp::socket socket;
+	// Pipelined requests stay in the buffer and are read after the previous response is written, so responses are in request order
 	boost::beast::flat_buffer buffer;
 	boost::beast::http::request<boost::beast::http::string_body> request;
 	boost::beast::http::response<boost::beast::http::string_body> res;
 	std::atomic_flag responded;
+	boost::asio::steady_timer timer;
+	uint64_t requests;
+	bool keep_alive;
 };
 class payment_observer : public std::enable_shared_from_this<nano::payment_observer>
 {
 public:
-	payment_observer (std::function<void(boost::property_tree::ptree const &)> const &, nano::rpc &, nano::account const &, nano::amount const &);
+	payment_observer (std::function<void(std::string const &)> const &, nano::rpc &, nano::account const &, nano::amount const &);
 	~payment_observer ();
 	void start (uint64_t);
 	void observe ();
@@ -120,14 +278,29 @@ public:
 	nano::rpc & rpc;
 	nano::account account;
 	nano::amount amount;
-	std::function<void(boost::property_tree::ptree const &)> response;
+	std::function<void(std::string const &)> response;
 	std::atomic_flag completed;
 };
+/** Read transaction of a request, borrowing the batch snapshot when the request is part of a batch */
+class rpc_read_transaction
+{
+public:
+	rpc_read_transaction (nano::block_store &, nano::transaction const *);
+	operator nano::transaction const & () const;
+
+private:
+	nano::transaction owned;
+	nano::transaction const * shared;
+};
 class rpc_handler : public std::enable_shared_from_this<nano::rpc_handler>
 {
 public:
-	rpc_handler (nano::node &, nano::rpc &, std::string const &, std::string const &, std::function<void(boost::property_tree::ptree const &)> const &);
+	rpc_handler (nano::node &, nano::rpc &, std::string const &, std::string const &, std::function<void(std::string const &)> const &);
 	void process_request ();
+	// Like process_request but runs the action on the rpc's workers. If the action's queue is full or the workers stop before it runs, the error is sent to the optional callback instead of the response
+	void queue_request (std::function<void(std::string const &)> const & = nullptr);
+	// Runs the action of an already parsed request
+	void process_action ();
 	void account_balance ();
 	void account_block_count ();
 	void account_count ();
@@ -147,6 +320,7 @@ public:
 	void accounts_frontiers ();
 	void accounts_pending ();
 	void available_supply ();
+	void batch ();
 	void block_info ();
 	void block_confirm ();
 	void blocks ();
@@ -241,10 +415,17 @@ public:
 	nano::node & node;
 	nano::rpc & rpc;
 	boost::property_tree::ptree request;
-	std::function<void(boost::property_tree::ptree const &)> response;
+	std::function<void(std::string const &)> response;
 	void response_errors ();
+	// Sends a body written with nano::json_writer, or the error if one was set while writing it
+	void response_stream (std::string const &);
 	std::error_code ec;
 	boost::property_tree::ptree response_l;
+	/** Set on the sub-requests of a batch, they read from the batch's snapshot instead of starting their own */
+	nano::transaction const * snapshot;
+	nano::rpc_read_transaction tx_begin_read ();
+	// Parses the body into request, returns true and responds with the error if it couldn't be parsed
+	bool parse_request ();
 	std::shared_ptr<nano::wallet> wallet_impl ();
 	bool wallet_locked_impl (nano::transaction const &, std::shared_ptr<nano::wallet>);
 	bool wallet_account_impl (nano::transaction const &, std::shared_ptr<nano::wallet>, nano::account const &);
@@ -258,6 +439,13 @@ public:
 	uint64_t count_optional_impl (uint64_t = std::numeric_limits<uint64_t>::max ());
 	uint64_t offset_optional_impl (uint64_t = 0);
 	bool rpc_control_impl ();
+	// Opens a cursor if the request sets "paged" or resumes the one named by "cursor", restoring the options of the request that opened it.
+	// Must run before the action reads its options. Returns nullptr for requests that aren't paged
+	std::shared_ptr<nano::rpc_cursor> cursor_impl ();
+	// Page size of the request, capped for paged requests
+	uint64_t cursor_count (std::shared_ptr<nano::rpc_cursor> const &, uint64_t);
+	// Keeps the cursor for a next page starting at the key and returns its id, or closes it and returns an empty string if this was the last page
+	std::string cursor_finish (std::shared_ptr<nano::rpc_cursor> const &, bool, nano::unchecked_key const & = nano::unchecked_key (0, 0));
 };
 /** Returns the correct RPC implementation based on TLS configuration */
 std::unique_ptr<nano::rpc> get_rpc (boost::asio::io_context & io_ctx_a, nano::node & node_a, nano::rpc_config const & config_a);
@@ -132,8 +132,8 @@ void nano::rpc_connection_secure::parse_connection ()
 
 void nano::rpc_connection_secure::on_shutdown (const boost::system::error_code & error)
 {
-	// No-op. We initiate the shutdown (since the RPC server kills the connection after each request)
-	// and we'll thus get an expected EOF error. If the client disconnects, a short-read error will be expected.
+	// No-op. We initiate the shutdown once the connection is done with (after the last request it may serve, or
+	// the first one if the client didn't ask for keep-alive) and we'll thus get an expected EOF error. If the client disconnects, a short-read error will be expected.
 }
 
 void nano::rpc_connection_secure::handle_handshake (const boost::system::error_code & error)
@@ -151,24 +151,31 @@ void nano::rpc_connection_secure::handle_handshake (const boost::system::error_c
 void nano::rpc_connection_secure::read ()
 {
 	auto this_l (std::static_pointer_cast<nano::rpc_connection_secure> (shared_from_this ()));
+	idle_timeout ();
 	boost::beast::http::async_read (stream, buffer, request, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
+		this_l->timer.cancel ();
 		if (!ec)
 		{
+			this_l->update_keep_alive ();
 			this_l->node->background ([this_l]() {
 				auto start (std::chrono::steady_clock::now ());
 				auto version (this_l->request.version ());
 				std::string request_id (boost::str (boost::format ("%1%") % boost::io::group (std::hex, std::showbase, reinterpret_cast<uintptr_t> (this_l.get ()))));
-				auto response_handler ([this_l, version, start, request_id](boost::property_tree::ptree const & tree_a) {
-					std::stringstream ostream;
-					boost::property_tree::write_json (ostream, tree_a);
-					ostream.flush ();
-					auto body (ostream.str ());
-					this_l->write_result (body, version);
+				auto write_response ([this_l, version, start, request_id](std::string const & body_a, boost::beast::http::status status_a) {
+					this_l->write_result (body_a, version, status_a);
 					boost::beast::http::async_write (this_l->stream, this_l->res, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
-						// Perform the SSL shutdown
-						this_l->stream.async_shutdown ([this_l](auto const & ec_shutdown) {
-							this_l->on_shutdown (ec_shutdown);
-						});
+						if (!ec && this_l->keep_alive)
+						{
+							this_l->reset ();
+							this_l->read ();
+						}
+						else
+						{
+							// Perform the SSL shutdown
+							this_l->stream.async_shutdown ([this_l](auto const & ec_shutdown) {
+								this_l->on_shutdown (ec_shutdown);
+							});
+						}
 					});
 
 					if (this_l->node->config.logging.log_rpc ())
@@ -176,13 +183,18 @@ void nano::rpc_connection_secure::read ()
 						BOOST_LOG (this_l->node->log) << boost::str (boost::format ("TLS: RPC request %2% completed in: %1% microseconds") % std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now () - start).count () % request_id);
 					}
 				});
+				auto response_handler ([write_response](std::string const & body_a) {
+					write_response (body_a, boost::beast::http::status::ok);
+				});
 				auto method = this_l->request.method ();
 				switch (method)
 				{
 					case boost::beast::http::verb::post:
 					{
 						auto handler (std::make_shared<nano::rpc_handler> (*this_l->node, this_l->rpc, this_l->request.body (), request_id, response_handler));
-						handler->process_request ();
+						handler->queue_request ([write_response](std::string const & body_a) {
+							write_response (body_a, boost::beast::http::status::service_unavailable);
+						});
 						break;
 					}
 					case boost::beast::http::verb::options:
@@ -191,14 +203,20 @@ void nano::rpc_connection_secure::read ()
 						this_l->res.set (boost::beast::http::field::allow, "POST, OPTIONS");
 						this_l->res.prepare_payload ();
 						boost::beast::http::async_write (this_l->stream, this_l->res, [this_l](boost::system::error_code const & ec, size_t bytes_transferred) {
-
-							// Perform the SSL shutdown
-							this_l->stream.async_shutdown (
-							std::bind (
-							&nano::rpc_connection_secure::on_shutdown,
-							this_l,
-							std::placeholders::_1));
-
+							if (!ec && this_l->keep_alive)
+							{
+								this_l->reset ();
+								this_l->read ();
+							}
+							else
+							{
+								// Perform the SSL shutdown
+								this_l->stream.async_shutdown (
+								std::bind (
+								&nano::rpc_connection_secure::on_shutdown,
+								this_l,
+								std::placeholders::_1));
+							}
 						});
 						break;
 					}
@@ -210,7 +228,7 @@ void nano::rpc_connection_secure::read ()
 				}
 			});
 		}
-		else
+		else if (ec != boost::beast::http::error::end_of_stream && ec != boost::asio::error::operation_aborted)
 		{
 			BOOST_LOG (this_l->node->log) << "TLS: Read error: " << ec.message () << std::endl;
 		}
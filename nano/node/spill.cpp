@@ -0,0 +1,190 @@
+#include <nano/node/spill.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/format.hpp>
+#include <boost/log/sources/record_ostream.hpp>
+
+nano::spill_store::spill_store (boost::filesystem::path const & path_a, size_t memory_limit_a, boost::log::sources::logger_mt & log_a) :
+memory_used (0),
+memory_limit (memory_limit_a),
+path (path_a),
+log (log_a),
+failed (false)
+{
+}
+
+nano::spill_store::~spill_store ()
+{
+	// A failed open may still have created the files
+	write.impl.reset ();
+	env.reset ();
+	boost::system::error_code ec;
+	boost::filesystem::remove (path, ec);
+	boost::filesystem::remove (path.string () + "-lock", ec);
+}
+
+void nano::spill_store::remove_stale (boost::filesystem::path const & directory_a, std::string const & prefix_a)
+{
+	boost::system::error_code ec;
+	std::vector<boost::filesystem::path> stale;
+	for (boost::filesystem::directory_iterator i (directory_a, ec), n; !ec && i != n; i.increment (ec))
+	{
+		auto filename (i->path ().filename ().string ());
+		if (filename.compare (0, prefix_a.size (), prefix_a) == 0)
+		{
+			stale.push_back (i->path ());
+		}
+	}
+	for (auto & path_l : stale)
+	{
+		boost::filesystem::remove (path_l, ec);
+	}
+}
+
+bool nano::spill_store::reserve (size_t bytes_a)
+{
+	auto result (memory_used + bytes_a > memory_limit);
+	if (!result)
+	{
+		memory_used += bytes_a;
+	}
+	return result;
+}
+
+void nano::spill_store::overcommit (size_t bytes_a)
+{
+	memory_used += bytes_a;
+}
+
+void nano::spill_store::release (size_t bytes_a)
+{
+	assert (memory_used >= bytes_a);
+	memory_used -= bytes_a;
+}
+
+MDB_dbi nano::spill_store::table (std::string const & name_a)
+{
+	MDB_dbi result (0);
+	auto error (failed);
+	if (!error && env == nullptr)
+	{
+		env = std::make_unique<nano::mdb_env> (error, path, 16);
+		if (!error)
+		{
+			// Spilled entries are worthless after a restart, don't pay for durability
+			mdb_env_set_flags (*env, MDB_NOSYNC | MDB_NOMETASYNC, 1);
+		}
+	}
+	if (!error)
+	{
+		error = mdb_dbi_open (env->tx (write_transaction ()), name_a.c_str (), MDB_CREATE, &result) != 0;
+	}
+	if (error && !failed)
+	{
+		failed = true;
+		BOOST_LOG (log) << boost::str (boost::format ("Unable to open temporary database %1%, keeping entries in memory") % path.string ());
+	}
+	return error ? 0 : result;
+}
+
+bool nano::spill_store::get (MDB_dbi dbi_a, nano::block_hash const & key_a, void * value_a, size_t size_a)
+{
+	nano::mdb_val value;
+	auto result (true);
+	// Pending writes are only visible through the write transaction
+	if (write.impl != nullptr)
+	{
+		result = mdb_get (env->tx (write), dbi_a, nano::mdb_val (key_a), value) != 0;
+	}
+	else
+	{
+		auto transaction (env->tx_begin (false));
+		result = mdb_get (env->tx (transaction), dbi_a, nano::mdb_val (key_a), value) != 0;
+	}
+	if (!result && value_a != nullptr)
+	{
+		assert (value.size () == size_a);
+		std::copy (reinterpret_cast<uint8_t const *> (value.data ()), reinterpret_cast<uint8_t const *> (value.data ()) + size_a, reinterpret_cast<uint8_t *> (value_a));
+	}
+	return result;
+}
+
+bool nano::spill_store::put (MDB_dbi dbi_a, nano::block_hash const & key_a, void const * value_a, size_t size_a)
+{
+	auto & transaction (write_transaction ());
+	nano::mdb_val value (size_a, const_cast<void *> (value_a));
+	auto status (mdb_put (env->tx (transaction), dbi_a, nano::mdb_val (key_a), value, MDB_NOOVERWRITE));
+	auto result (status == MDB_KEYEXIST);
+	if (result)
+	{
+		status = mdb_put (env->tx (transaction), dbi_a, nano::mdb_val (key_a), value, 0);
+	}
+	release_assert (status == 0);
+	return result;
+}
+
+bool nano::spill_store::del (MDB_dbi dbi_a, nano::block_hash const & key_a)
+{
+	return mdb_del (env->tx (write_transaction ()), dbi_a, nano::mdb_val (key_a), nullptr) != 0;
+}
+
+void nano::spill_store::drop (MDB_dbi dbi_a)
+{
+	auto status (mdb_drop (env->tx (write_transaction ()), dbi_a, 0));
+	release_assert (status == 0);
+}
+
+void nano::spill_store::flush ()
+{
+	// nano::mdb_txn commits on destruction
+	write.impl.reset ();
+}
+
+nano::transaction const & nano::spill_store::write_transaction ()
+{
+	if (write.impl == nullptr)
+	{
+		write = env->tx_begin (true);
+	}
+	return write;
+}
+
+nano::spill_set::spill_set (nano::spill_store & store_a, std::string const & name_a) :
+map (store_a, name_a)
+{
+}
+
+bool nano::spill_set::exists (nano::block_hash const & key_a)
+{
+	return map.exists (key_a);
+}
+
+void nano::spill_set::insert (nano::block_hash const & key_a)
+{
+	map.put (key_a, 0);
+}
+
+void nano::spill_set::erase (nano::block_hash const & key_a)
+{
+	map.erase (key_a);
+}
+
+void nano::spill_set::clear ()
+{
+	map.clear ();
+}
+
+size_t nano::spill_set::size () const
+{
+	return map.size ();
+}
+
+size_t nano::spill_set::memory_count () const
+{
+	return map.memory_count ();
+}
+
+size_t nano::spill_set::spilled () const
+{
+	return map.spilled ();
+}
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <nano/node/lmdb.hpp>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/log/sources/logger.hpp>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace nano
+{
+/**
+ * Shared memory budget and temporary LMDB environment for spill_map tables
+ * The environment is only created once a table exceeds the budget and its files are deleted on destruction.
+ * If it can't be opened the error is logged once and tables stay in memory past the budget.
+ * Puts and deletes share one write transaction until flush, so a caller writing several entries pays for a single commit.
+ * Not thread-safe, tables sharing a store must be accessed under the same lock and flushed before it's released,
+ * LMDB requires the thread that began a write transaction to commit it.
+ */
+class spill_store
+{
+public:
+	// memory_limit is the combined byte size of all in-memory tables
+	spill_store (boost::filesystem::path const &, size_t, boost::log::sources::logger_mt &);
+	~spill_store ();
+	// Returns true if the bytes would exceed the budget, otherwise accounts for them
+	bool reserve (size_t);
+	// Accounts for bytes past the budget, for tables that can't spill
+	void overcommit (size_t);
+	void release (size_t);
+	// Opens the named table, creating the environment on first use. Returns 0 if the environment or table couldn't be opened
+	MDB_dbi table (std::string const &);
+	// Returns true if the key isn't in the table
+	bool get (MDB_dbi, nano::block_hash const &, void *, size_t);
+	// Returns true if the key was already in the table, the value is overwritten either way
+	bool put (MDB_dbi, nano::block_hash const &, void const *, size_t);
+	// Returns true if the key wasn't in the table
+	bool del (MDB_dbi, nano::block_hash const &);
+	void drop (MDB_dbi);
+	// Commits the pending writes, if any
+	void flush ();
+	// Deletes files left in the directory by stores that weren't destroyed, such as after a crash
+	static void remove_stale (boost::filesystem::path const &, std::string const &);
+	size_t memory_used;
+	size_t memory_limit;
+
+private:
+	// Starts the shared write transaction if none is open
+	nano::transaction const & write_transaction ();
+	boost::filesystem::path path;
+	boost::log::sources::logger_mt & log;
+	std::unique_ptr<nano::mdb_env> env;
+	// Write transaction pending until flush, impl is null while none is open
+	nano::transaction write;
+	// Set once opening the environment or a table failed, it isn't retried
+	bool failed;
+};
+
+/**
+ * Hash map from block hashes to fixed-size values, kept in a flat open-addressing table while the store's memory budget allows
+ * and moved to an LMDB table past it. Entries don't migrate back to memory, lookups only touch LMDB once something was spilled.
+ * The zero hash marks empty slots and can't be used as a key.
+ */
+template <typename T>
+class spill_map
+{
+	static_assert (std::is_trivially_copyable<T>::value, "Spilled values are copied bytewise");
+
+public:
+	spill_map (nano::spill_store & store_a, std::string const & name_a) :
+	store (store_a),
+	name (name_a),
+	dbi (0),
+	count (0),
+	spill_count (0)
+	{
+	}
+	~spill_map ()
+	{
+		store.release (table.size () * sizeof (entry));
+	}
+	// Returns true if the key isn't present
+	bool get (nano::block_hash const & key_a, T & value_a)
+	{
+		auto result (true);
+		auto index (find (key_a));
+		if (index != npos)
+		{
+			value_a = table[index].value;
+			result = false;
+		}
+		else if (spill_count > 0)
+		{
+			result = store.get (dbi, key_a, &value_a, sizeof (value_a));
+		}
+		return result;
+	}
+	bool exists (nano::block_hash const & key_a)
+	{
+		T value;
+		return !get (key_a, value);
+	}
+	void put (nano::block_hash const & key_a, T const & value_a)
+	{
+		assert (!key_a.is_zero ());
+		auto index (find (key_a));
+		if (index != npos)
+		{
+			table[index].value = value_a;
+		}
+		else if (spill_count > 0 && !store.get (dbi, key_a, nullptr, 0))
+		{
+			store.put (dbi, key_a, &value_a, sizeof (value_a));
+		}
+		else if (!full () || grow ())
+		{
+			insert (key_a, value_a);
+		}
+		else
+		{
+			if (dbi == 0)
+			{
+				dbi = store.table (name);
+			}
+			if (dbi != 0)
+			{
+				store.put (dbi, key_a, &value_a, sizeof (value_a));
+				++spill_count;
+			}
+			else
+			{
+				// Nowhere to spill to, exceeding the budget is better than losing the entry
+				auto capacity (table.empty () ? initial_capacity : table.size () * 2);
+				store.overcommit ((capacity - table.size ()) * sizeof (entry));
+				resize (capacity);
+				insert (key_a, value_a);
+			}
+		}
+	}
+	void erase (nano::block_hash const & key_a)
+	{
+		auto index (find (key_a));
+		if (index != npos)
+		{
+			erase_slot (index);
+			--count;
+		}
+		else if (spill_count > 0 && !store.del (dbi, key_a))
+		{
+			--spill_count;
+		}
+	}
+	void clear ()
+	{
+		store.release (table.size () * sizeof (entry));
+		table.clear ();
+		table.shrink_to_fit ();
+		count = 0;
+		if (spill_count > 0)
+		{
+			store.drop (dbi);
+			spill_count = 0;
+		}
+	}
+	size_t size () const
+	{
+		return count + spill_count;
+	}
+	bool empty () const
+	{
+		return size () == 0;
+	}
+	// Entries held in memory
+	size_t memory_count () const
+	{
+		return count;
+	}
+	// Entries moved to LMDB
+	size_t spilled () const
+	{
+		return spill_count;
+	}
+	class entry
+	{
+	public:
+		nano::block_hash key;
+		T value;
+	};
+	static size_t constexpr initial_capacity = 1024;
+
+private:
+	static size_t constexpr npos = std::numeric_limits<size_t>::max ();
+	size_t home (nano::block_hash const & key_a) const
+	{
+		// Block hashes are uniformly distributed, the low qword is as good as any hash of them
+		return static_cast<size_t> (key_a.qwords[0]) & (table.size () - 1);
+	}
+	size_t find (nano::block_hash const & key_a) const
+	{
+		auto result (npos);
+		if (!table.empty ())
+		{
+			for (auto slot (home (key_a)); result == npos && !table[slot].key.is_zero (); slot = (slot + 1) & (table.size () - 1))
+			{
+				if (table[slot].key == key_a)
+				{
+					result = slot;
+				}
+			}
+		}
+		return result;
+	}
+	// Keep the load factor under 3/4 so probe sequences stay short
+	bool full () const
+	{
+		return table.empty () || (count + 1) * 4 > table.size () * 3;
+	}
+	// Doubles the table if the budget allows, returns true on success
+	bool grow ()
+	{
+		auto capacity (table.empty () ? initial_capacity : table.size () * 2);
+		auto result (!store.reserve ((capacity - table.size ()) * sizeof (entry)));
+		if (result)
+		{
+			resize (capacity);
+		}
+		return result;
+	}
+	void resize (size_t capacity_a)
+	{
+		std::vector<entry> old (capacity_a);
+		old.swap (table);
+		for (auto & item : old)
+		{
+			if (!item.key.is_zero ())
+			{
+				auto slot (home (item.key));
+				while (!table[slot].key.is_zero ())
+				{
+					slot = (slot + 1) & (table.size () - 1);
+				}
+				table[slot] = item;
+			}
+		}
+	}
+	// Adds a key that isn't in the table, there must be room for it
+	void insert (nano::block_hash const & key_a, T const & value_a)
+	{
+		auto slot (home (key_a));
+		while (!table[slot].key.is_zero ())
+		{
+			slot = (slot + 1) & (table.size () - 1);
+		}
+		table[slot].key = key_a;
+		table[slot].value = value_a;
+		++count;
+	}
+	// Backward shift deletion, moves later entries of the probe sequence into the hole so no tombstones are needed
+	void erase_slot (size_t hole_a)
+	{
+		auto mask (table.size () - 1);
+		auto next ((hole_a + 1) & mask);
+		while (!table[next].key.is_zero ())
+		{
+			auto slot (home (table[next].key));
+			auto stays (hole_a <= next ? (hole_a < slot && slot <= next) : (hole_a < slot || slot <= next));
+			if (!stays)
+			{
+				table[hole_a] = table[next];
+				hole_a = next;
+			}
+			next = (next + 1) & mask;
+		}
+		table[hole_a].key.clear ();
+	}
+	nano::spill_store & store;
+	std::string name;
+	MDB_dbi dbi;
+	std::vector<entry> table;
+	size_t count;
+	size_t spill_count;
+};
+
+template <typename T>
+size_t constexpr spill_map<T>::initial_capacity;
+template <typename T>
+size_t constexpr spill_map<T>::npos;
+
+/** Set of block hashes with the same memory bounds as spill_map */
+class spill_set
+{
+public:
+	spill_set (nano::spill_store &, std::string const &);
+	bool exists (nano::block_hash const &);
+	void insert (nano::block_hash const &);
+	void erase (nano::block_hash const &);
+	void clear ();
+	size_t size () const;
+	size_t memory_count () const;
+	size_t spilled () const;
+
+private:
+	nano::spill_map<uint8_t> map;
+};
+}
@@ -351,6 +351,12 @@ std::string nano::stat::type_to_string (uint32_t key)
 		case nano::stat::type::udp:
 			res = "udp";
 			break;
+		case nano::stat::type::tcp:
+			res = "tcp";
+			break;
+		case nano::stat::type::message_buffer:
+			res = "message_buffer";
+			break;
 		case nano::stat::type::peering:
 			res = "peering";
 			break;
@@ -369,6 +375,9 @@ std::string nano::stat::type_to_string (uint32_t key)
 		case nano::stat::type::message:
 			res = "message";
 			break;
+		case nano::stat::type::unchecked:
+			res = "unchecked";
+			break;
 	}
 	return res;
 }
@@ -412,9 +421,21 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::frontier_req:
 			res = "frontier_req";
 			break;
+		case nano::stat::detail::frontier_req_incremental:
+			res = "frontier_req_incremental";
+			break;
 		case nano::stat::detail::handshake:
 			res = "handshake";
 			break;
+		case nano::stat::detail::serialize:
+			res = "serialize";
+			break;
+		case nano::stat::detail::cached:
+			res = "cached";
+			break;
+		case nano::stat::detail::allocate:
+			res = "allocate";
+			break;
 		case nano::stat::detail::http_callback:
 			res = "http_callback";
 			break;
@@ -433,6 +454,15 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::invocations:
 			res = "invocations";
 			break;
+		case nano::stat::detail::subscribe:
+			res = "subscribe";
+			break;
+		case nano::stat::detail::push:
+			res = "push";
+			break;
+		case nano::stat::detail::eviction:
+			res = "eviction";
+			break;
 		case nano::stat::detail::keepalive:
 			res = "keepalive";
 			break;
@@ -508,6 +538,27 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::outdated_version:
 			res = "outdated_version";
 			break;
+		case nano::stat::detail::put:
+			res = "put";
+			break;
+		case nano::stat::detail::spill:
+			res = "spill";
+			break;
+		case nano::stat::detail::memory_hit:
+			res = "memory_hit";
+			break;
+		case nano::stat::detail::table_hit:
+			res = "table_hit";
+			break;
+		case nano::stat::detail::retry:
+			res = "retry";
+			break;
+		case nano::stat::detail::drop:
+			res = "drop";
+			break;
+		case nano::stat::detail::batch:
+			res = "batch";
+			break;
 	}
 	return res;
 }
@@ -228,7 +228,10 @@ public:
 		http_callback,
 		peering,
 		ipc,
-		udp
+		udp,
+		tcp,
+		message_buffer,
+		unchecked
 	};
 
 	/** Optional detail type */
@@ -269,6 +272,7 @@ public:
 		bulk_push,
 		bulk_pull_account,
 		frontier_req,
+		frontier_req_incremental,
 
 		// vote specific
 		vote_valid,
@@ -276,7 +280,7 @@ public:
 		vote_invalid,
 		vote_overflow,
 
-		// udp
+		// udp, tcp
 		blocking,
 		overflow,
 		invalid_magic,
@@ -292,9 +296,28 @@ public:
 
 		// ipc
 		invocations,
+		subscribe,
+		push,
+		eviction,
 
-		// peering
+		// peering, tcp
 		handshake,
+
+		// message_buffer
+		serialize,
+		cached,
+		allocate,
+
+		// unchecked
+		put,
+		spill,
+		memory_hit,
+		table_hit,
+
+		// http_callback
+		retry,
+		drop,
+		batch,
 	};
 
 	/** Direction of the stat. If the direction is irrelevant, use in */
@@ -0,0 +1,198 @@
+#include <nano/node/tcp.hpp>
+
+#include <nano/node/node.hpp>
+
+nano::tcp_channel::tcp_channel (std::shared_ptr<nano::node> node_a, nano::endpoint const & endpoint_a, nano::account const & node_id_a) :
+node (node_a),
+socket (std::make_shared<nano::socket> (node_a)),
+endpoint (endpoint_a),
+node_id (node_id_a),
+writing (false),
+ready (false),
+closed (false),
+receive_buffer (std::make_shared<std::vector<uint8_t>> ())
+{
+	receive_buffer->resize (nano::message_parser::max_tcp_realtime_message_size);
+}
+
+nano::tcp_channel::~tcp_channel ()
+{
+	close ();
+}
+
+void nano::tcp_channel::start ()
+{
+	cookie = node->peers.assign_syn_cookie (endpoint);
+	if (cookie)
+	{
+		auto this_l (shared_from_this ());
+		socket->async_connect (nano::tcp_endpoint (endpoint.address (), endpoint.port ()), [this_l](boost::system::error_code const & ec) {
+			if (!ec)
+			{
+				this_l->send_handshake (this_l->cookie, boost::none);
+				this_l->receive_handshake ();
+			}
+			else
+			{
+				this_l->fail (boost::str (boost::format ("connect error %1%") % ec.message ()));
+			}
+		});
+	}
+	else
+	{
+		fail ("no syn cookie available");
+	}
+}
+
+void nano::tcp_channel::send_buffer (uint8_t const * data_a, size_t size_a, std::function<void(boost::system::error_code const &, size_t)> const & callback_a)
+{
+	auto buffer (std::make_shared<std::vector<uint8_t>> (data_a, data_a + size_a));
+	auto overflow (false);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		if (queue.size () < max_queue)
+		{
+			queue.emplace_back (buffer, callback_a);
+			if (!writing)
+			{
+				write_next ();
+			}
+		}
+		else
+		{
+			overflow = true;
+		}
+	}
+	if (overflow)
+	{
+		node->stats.inc (nano::stat::type::tcp, nano::stat::detail::overflow, nano::stat::dir::out);
+		if (callback_a)
+		{
+			callback_a (boost::system::errc::make_error_code (boost::system::errc::no_buffer_space), 0);
+		}
+	}
+}
+
+void nano::tcp_channel::write_next ()
+{
+	assert (!queue.empty ());
+	writing = true;
+	auto this_l (shared_from_this ());
+	socket->async_write (queue.front ().first, [this_l](boost::system::error_code const & ec, size_t size_a) {
+		std::function<void(boost::system::error_code const &, size_t)> callback;
+		{
+			std::lock_guard<std::mutex> lock (this_l->mutex);
+			callback = std::move (this_l->queue.front ().second);
+			this_l->queue.pop_front ();
+			if (!ec && !this_l->queue.empty ())
+			{
+				this_l->write_next ();
+			}
+			else
+			{
+				this_l->writing = false;
+			}
+		}
+		if (callback)
+		{
+			callback (ec, size_a);
+		}
+		if (ec)
+		{
+			this_l->fail (boost::str (boost::format ("write error %1%") % ec.message ()));
+		}
+	});
+}
+
+void nano::tcp_channel::send_handshake (boost::optional<nano::uint256_union> const & query_a, boost::optional<nano::uint256_union> const & respond_to_a)
+{
+	boost::optional<std::pair<nano::account, nano::signature>> response (boost::none);
+	if (respond_to_a)
+	{
+		response = std::make_pair (node->node_id.pub, nano::sign_message (node->node_id.prv, node->node_id.pub, *respond_to_a));
+	}
+	nano::node_id_handshake message (query_a, response);
+	auto bytes (message.to_bytes ());
+	node->stats.inc (nano::stat::type::message, nano::stat::detail::node_id_handshake, nano::stat::dir::out);
+	send_buffer (bytes->data (), bytes->size (), nullptr);
+}
+
+void nano::tcp_channel::receive_handshake ()
+{
+	auto this_l (shared_from_this ());
+	socket->async_read (receive_buffer, nano::bootstrap_message_header_size, [this_l](boost::system::error_code const & ec, size_t size_a) {
+		if (!ec)
+		{
+			auto error (false);
+			nano::bufferstream stream (this_l->receive_buffer->data (), size_a);
+			nano::message_header header (error, stream);
+			if (!error && header.type == nano::message_type::node_id_handshake && header.payload_length_bytes () > 0 && header.payload_length_bytes () <= this_l->receive_buffer->size ())
+			{
+				this_l->socket->async_read (this_l->receive_buffer, header.payload_length_bytes (), [this_l, header](boost::system::error_code const & ec, size_t size_a) {
+					this_l->received_handshake (ec, size_a, header);
+				});
+			}
+			else
+			{
+				this_l->fail ("unexpected handshake header");
+			}
+		}
+		else
+		{
+			this_l->fail (boost::str (boost::format ("handshake read error %1%") % ec.message ()));
+		}
+	});
+}
+
+void nano::tcp_channel::received_handshake (boost::system::error_code const & ec, size_t size_a, nano::message_header const & header_a)
+{
+	if (!ec)
+	{
+		auto error (false);
+		nano::bufferstream stream (receive_buffer->data (), size_a);
+		nano::node_id_handshake message (error, stream, header_a);
+		if (!error && message.query && message.response && message.response->first == node_id && !node->peers.validate_syn_cookie (endpoint, message.response->first, message.response->second))
+		{
+			node->stats.inc (nano::stat::type::message, nano::stat::detail::node_id_handshake, nano::stat::dir::in);
+			send_handshake (boost::none, message.query);
+			ready = true;
+			node->stats.inc (nano::stat::type::tcp, nano::stat::detail::handshake, nano::stat::dir::out);
+			if (node->config.logging.network_node_id_handshake_logging ())
+			{
+				BOOST_LOG (node->log) << boost::str (boost::format ("TCP realtime channel established to %1% with node ID %2%") % endpoint % node_id.to_account ());
+			}
+		}
+		else
+		{
+			fail ("invalid handshake response");
+		}
+	}
+	else
+	{
+		fail (boost::str (boost::format ("handshake read error %1%") % ec.message ()));
+	}
+}
+
+void nano::tcp_channel::fail (std::string const & reason_a)
+{
+	if (!closed && node->config.logging.network_node_id_handshake_logging ())
+	{
+		BOOST_LOG (node->log) << boost::str (boost::format ("Closing TCP realtime channel to %1%: %2%") % endpoint % reason_a);
+	}
+	close ();
+	node->peers.tcp_channel_erase (endpoint, this);
+}
+
+void nano::tcp_channel::close ()
+{
+	ready = false;
+	if (!closed.exchange (true))
+	{
+		socket->close ();
+	}
+}
+
+bool nano::tcp_channel::established () const
+{
+	return ready;
+}
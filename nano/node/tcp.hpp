@@ -0,0 +1,48 @@
+#pragma once
+
+#include <nano/node/bootstrap.hpp>
+#include <nano/node/common.hpp>
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+namespace nano
+{
+class node;
+/**
+ * A long-lived TCP connection to a peer's bootstrap port carrying realtime messages (keepalive, publish, confirm_req, confirm_ack).
+ * The connection is authenticated with a node_id_handshake exchange, after which messages are written in order using the
+ * regular message_header framing. The channel only writes; the remote node opens its own channel for the opposite direction.
+ */
+class tcp_channel : public std::enable_shared_from_this<nano::tcp_channel>
+{
+public:
+	tcp_channel (std::shared_ptr<nano::node>, nano::endpoint const &, nano::account const &);
+	~tcp_channel ();
+	void start ();
+	void send_buffer (uint8_t const *, size_t, std::function<void(boost::system::error_code const &, size_t)> const &);
+	void close ();
+	bool established () const;
+	std::shared_ptr<nano::node> node;
+	std::shared_ptr<nano::socket> socket;
+	// UDP endpoint identifying the peer in peer_container
+	nano::endpoint endpoint;
+	nano::account node_id;
+	static size_t constexpr max_queue = 1024;
+
+private:
+	void send_handshake (boost::optional<nano::uint256_union> const &, boost::optional<nano::uint256_union> const &);
+	void receive_handshake ();
+	void received_handshake (boost::system::error_code const &, size_t, nano::message_header const &);
+	void write_next ();
+	void fail (std::string const &);
+	std::mutex mutex;
+	std::deque<std::pair<std::shared_ptr<std::vector<uint8_t>>, std::function<void(boost::system::error_code const &, size_t)>>> queue;
+	bool writing;
+	std::atomic<bool> ready;
+	std::atomic<bool> closed;
+	boost::optional<nano::uint256_union> cookie;
+	std::shared_ptr<std::vector<uint8_t>> receive_buffer;
+};
+}
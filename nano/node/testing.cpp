@@ -4,6 +4,8 @@
 #include <nano/node/common.hpp>
 #include <nano/node/testing.hpp>
 
+#include <thread>
+
 std::string nano::error_system_messages::message (int ev) const
 {
 	switch (static_cast<nano::error_system> (ev))
@@ -63,6 +65,48 @@ work (1, nullptr)
 	}
 }
 
+nano::system::system (uint16_t port_a, uint16_t count_a, std::shared_ptr<nano::network_simulator> const & simulator_a) :
+alarm (io_ctx, simulator_a->clock),
+work (1, nullptr)
+{
+	logging.init (nano::unique_path ());
+	nodes.reserve (count_a);
+	// Bootstrap runs over TCP, which isn't simulated
+	nano::node_flags flags;
+	flags.disable_backup = true;
+	flags.disable_lazy_bootstrap = true;
+	flags.disable_legacy_bootstrap = true;
+	flags.disable_wallet_bootstrap = true;
+	flags.disable_bootstrap_listener = true;
+	for (uint16_t i (0); i < count_a; ++i)
+	{
+		nano::node_init init;
+		nano::node_config config (port_a + i, logging);
+		// Hundreds of nodes may share the machine, packets are delivered by the simulator rather than read from the socket
+		config.network_threads = 1;
+		config.signature_checker_threads = 0;
+		auto node (std::make_shared<nano::node> (init, io_ctx, nano::unique_path (), alarm, config, work, flags, simulator_a));
+		assert (!init.error ());
+		simulator_a->attach (*node);
+		node->start ();
+		nano::uint256_union wallet;
+		nano::random_pool::generate_block (wallet.bytes.data (), wallet.bytes.size ());
+		node->wallets.create (wallet);
+		nodes.push_back (node);
+	}
+	// Keepalives over the simulator would take several rounds of virtual time to spread the peer lists
+	for (auto & i : nodes)
+	{
+		for (auto & j : nodes)
+		{
+			if (i != j)
+			{
+				i->peers.insert (j->network.endpoint (), nano::protocol_version);
+			}
+		}
+	}
+}
+
 nano::system::~system ()
 {
 	for (auto & i : nodes)
@@ -135,7 +179,7 @@ public:
 		if (count_l > 0)
 		{
 			auto this_l (shared_from_this ());
-			node->alarm.add (std::chrono::steady_clock::now () + std::chrono::milliseconds (wait), [this_l]() { this_l->run (); });
+			node->alarm.add (node->alarm.now () + std::chrono::milliseconds (wait), [this_l]() { this_l->run (); });
 		}
 	}
 	std::vector<nano::account> accounts;
@@ -356,6 +400,206 @@ void nano::system::stop ()
 	work.stop ();
 }
 
+nano::virtual_clock::virtual_clock () :
+time (std::chrono::steady_clock::now ())
+{
+}
+
+std::chrono::steady_clock::time_point nano::virtual_clock::now ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return time;
+}
+
+void nano::virtual_clock::wait_until (std::unique_lock<std::mutex> & lock_a, std::condition_variable & condition_a, std::chrono::steady_clock::time_point const & time_a)
+{
+	std::unique_lock<std::mutex> lock (mutex);
+	woken.erase (std::this_thread::get_id ());
+	auto status (std::cv_status::timeout);
+	if (time < time_a)
+	{
+		auto waiter (waiters.emplace (time_a, &condition_a));
+		while (time < time_a && status == std::cv_status::timeout)
+		{
+			lock.unlock ();
+			// advance doesn't hold the caller's mutex when it notifies, the timeout covers a notification sent just before waiting
+			status = condition_a.wait_for (lock_a, std::chrono::milliseconds (10));
+			lock.lock ();
+		}
+		waiters.erase (waiter);
+	}
+	if (time >= time_a)
+	{
+		woken.insert (std::this_thread::get_id ());
+	}
+}
+
+void nano::virtual_clock::wait (std::unique_lock<std::mutex> & lock_a, std::condition_variable & condition_a)
+{
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		woken.erase (std::this_thread::get_id ());
+	}
+	condition_a.wait (lock_a);
+}
+
+void nano::virtual_clock::advance (std::chrono::steady_clock::time_point const & time_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	assert (time_a >= time);
+	time = time_a;
+	for (auto i (waiters.begin ()), n (waiters.upper_bound (time)); i != n; ++i)
+	{
+		i->second->notify_all ();
+	}
+}
+
+std::chrono::steady_clock::time_point nano::virtual_clock::next_deadline ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return waiters.empty () ? std::chrono::steady_clock::time_point::max () : waiters.begin ()->first;
+}
+
+bool nano::virtual_clock::waking ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return !woken.empty () || (!waiters.empty () && waiters.begin ()->first <= time);
+}
+
+nano::network_simulator::network_simulator (uint64_t seed_a) :
+clock (std::make_shared<nano::virtual_clock> ()),
+latency (std::chrono::milliseconds (50)),
+jitter (std::chrono::milliseconds (10)),
+loss (0.0),
+delivered (0),
+dropped (0),
+random (seed_a),
+epoch (clock->now ()),
+sequence (0)
+{
+}
+
+void nano::network_simulator::attach (nano::node & node_a)
+{
+	assert (node_a.network.transport.get () == this);
+	auto endpoint (node_a.network.endpoint ());
+	std::lock_guard<std::mutex> lock (mutex);
+	nodes[endpoint] = &node_a;
+	endpoints[&node_a] = endpoint;
+}
+
+void nano::network_simulator::send (nano::node & node_a, nano::endpoint const & endpoint_a, uint8_t const * data_a, size_t size_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	auto source (endpoints.find (&node_a));
+	auto destination (nodes.find (endpoint_a));
+	if (source != endpoints.end () && destination != nodes.end () && std::uniform_real_distribution<double> () (random) >= loss)
+	{
+		auto delay (latency + std::chrono::microseconds (std::uniform_int_distribution<int64_t> (0, jitter.count ()) (random)));
+		events.push (event{ clock->now () + delay, sequence++, source->second, destination->second, std::vector<uint8_t> (data_a, data_a + size_a) });
+	}
+	else
+	{
+		++dropped;
+	}
+}
+
+bool nano::network_simulator::step ()
+{
+	quiesce ();
+	std::vector<event> due;
+	auto next (clock->next_deadline ());
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		if (!events.empty ())
+		{
+			next = std::min (next, events.top ().time);
+		}
+		if (next != std::chrono::steady_clock::time_point::max ())
+		{
+			clock->advance (next);
+			while (!events.empty () && events.top ().time <= next)
+			{
+				due.push_back (events.top ());
+				events.pop ();
+			}
+		}
+	}
+	for (auto & i : due)
+	{
+		nano::udp_data data{ i.data.data (), i.data.size (), i.source };
+		i.destination->network.receive_action (&data, i.destination->network.endpoint ());
+		++delivered;
+	}
+	return next != std::chrono::steady_clock::time_point::max ();
+}
+
+bool nano::network_simulator::run_until (std::function<bool()> const & predicate_a, std::chrono::microseconds limit_a, std::chrono::milliseconds idle_timeout_a)
+{
+	auto idle_since (std::chrono::steady_clock::now ());
+	auto error (false);
+	while (!error && !predicate_a ())
+	{
+		if (step ())
+		{
+			idle_since = std::chrono::steady_clock::now ();
+			error = now () >= limit_a;
+		}
+		else
+		{
+			// Nothing in flight and no timer pending, wait for a thread outside the clock to send something
+			std::this_thread::sleep_for (std::chrono::milliseconds (1));
+			error = std::chrono::steady_clock::now () - idle_since >= idle_timeout_a;
+		}
+	}
+	return error;
+}
+
+std::chrono::microseconds nano::network_simulator::now ()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds> (clock->now () - epoch);
+}
+
+void nano::network_simulator::quiesce ()
+{
+	// Bounded in case a thread woken by a deadline exits instead of waiting again, such as a node stopping
+	auto cutoff (std::chrono::steady_clock::now () + std::chrono::milliseconds (100));
+	while (clock->waking () && std::chrono::steady_clock::now () < cutoff)
+	{
+		std::this_thread::yield ();
+	}
+	std::vector<nano::node *> nodes_l;
+	std::unordered_set<boost::asio::io_context *> io_contexts;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		for (auto & i : endpoints)
+		{
+			nodes_l.push_back (i.first);
+			io_contexts.insert (&i.first->io_ctx);
+		}
+	}
+	// Alarm operations and background work are posted to the io context, run them here so they act at the current time
+	size_t handled (0);
+	do
+	{
+		for (auto node : nodes_l)
+		{
+			node->block_processor.flush ();
+			node->vote_processor.flush ();
+		}
+		handled = 0;
+		for (auto io_ctx : io_contexts)
+		{
+			handled += io_ctx->poll ();
+		}
+	} while (handled > 0);
+}
+
+bool nano::network_simulator::event::operator> (event const & other_a) const
+{
+	return time > other_a.time || (time == other_a.time && sequence > other_a.sequence);
+}
+
 nano::landing_store::landing_store ()
 {
 }
@@ -517,7 +761,7 @@ void nano::landing::distribute_ongoing ()
 {
 	distribute_one ();
 	BOOST_LOG (node.log) << "Waiting for next distribution cycle";
-	node.alarm.add (std::chrono::steady_clock::now () + sleep_seconds, [this]() { distribute_ongoing (); });
+	node.alarm.add (node.alarm.now () + sleep_seconds, [this]() { distribute_ongoing (); });
 }
 
 std::chrono::seconds constexpr nano::landing::distribution_interval;
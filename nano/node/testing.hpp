@@ -4,8 +4,15 @@
 #include <nano/lib/errors.hpp>
 #include <nano/node/node.hpp>
 
+#include <map>
+#include <queue>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
 namespace nano
 {
+class network_simulator;
 /** Test-system related error codes */
 enum class error_system
 {
@@ -16,6 +23,8 @@ class system
 {
 public:
 	system (uint16_t, uint16_t);
+	// Nodes exchange UDP traffic over the simulator and run their timers on its clock, every node starts with all others as peers
+	system (uint16_t, uint16_t, std::shared_ptr<nano::network_simulator> const &);
 	~system ();
 	void generate_activity (nano::node &, std::vector<nano::account> &);
 	void generate_mass_activity (uint32_t, nano::node &);
@@ -46,6 +55,80 @@ public:
 	std::chrono::time_point<std::chrono::steady_clock, std::chrono::duration<double>> deadline{ std::chrono::steady_clock::time_point::max () };
 	double deadline_scaling_factor{ 1.0 };
 };
+/**
+ * Clock that only moves when advanced. Threads waiting on it register their deadline so the simulator knows when the next timer
+ * is due, and a thread woken by a deadline counts as running until it waits again so time doesn't move while it's acting.
+ */
+class virtual_clock : public nano::clock
+{
+public:
+	virtual_clock ();
+	std::chrono::steady_clock::time_point now () override;
+	void wait_until (std::unique_lock<std::mutex> &, std::condition_variable &, std::chrono::steady_clock::time_point const &) override;
+	void wait (std::unique_lock<std::mutex> &, std::condition_variable &) override;
+	// Moves time forward and wakes the waiters that became due
+	void advance (std::chrono::steady_clock::time_point const &);
+	// Earliest deadline of a waiting thread, time_point::max () if there's none
+	std::chrono::steady_clock::time_point next_deadline ();
+	// Returns true while a thread woken by a deadline hasn't waited again
+	bool waking ();
+
+private:
+	std::mutex mutex;
+	std::chrono::steady_clock::time_point time;
+	std::multimap<std::chrono::steady_clock::time_point, std::condition_variable *> waiters;
+	std::unordered_set<std::thread::id> woken;
+};
+/**
+ * In-process replacement for UDP between nodes of a test system, used to measure propagation and confirmation with many nodes.
+ * Datagrams sent by attached nodes are delivered on a virtual clock after a configurable latency, or dropped with a configurable
+ * probability, in an order that only depends on the seed and the order messages were sent in.
+ * Nodes built on the simulator send through it and schedule alarms, elections and vote generation on its clock. Time jumps to the
+ * next delivery or timer once the timers due so far have run and the processors and io handlers of every node have drained,
+ * so messages sent in response are stamped with the time of what caused them.
+ */
+class network_simulator : public nano::datagram_transport
+{
+public:
+	network_simulator (uint64_t = 0);
+	// Delivers datagrams addressed to the node's endpoint, the node must have been created with the simulator as its transport
+	void attach (nano::node &);
+	void send (nano::node &, nano::endpoint const &, uint8_t const *, size_t) override;
+	// Advances to the next delivery or timer and delivers the datagrams due then, returns false if nothing is pending
+	bool step ();
+	// Steps until the predicate holds, returns true if the virtual time limit was reached or the network stayed idle for the wall clock timeout first
+	bool run_until (std::function<bool()> const &, std::chrono::microseconds, std::chrono::milliseconds = std::chrono::milliseconds (5000));
+	// Virtual time since the simulator was created
+	std::chrono::microseconds now ();
+	std::shared_ptr<nano::virtual_clock> const clock;
+	// One way delay is latency plus a uniformly distributed value up to jitter
+	std::chrono::microseconds latency;
+	std::chrono::microseconds jitter;
+	// Probability of a datagram being dropped
+	double loss;
+	std::atomic<uint64_t> delivered;
+	std::atomic<uint64_t> dropped;
+
+private:
+	class event
+	{
+	public:
+		std::chrono::steady_clock::time_point time;
+		uint64_t sequence;
+		nano::endpoint source;
+		nano::node * destination;
+		std::vector<uint8_t> data;
+		bool operator> (event const &) const;
+	};
+	void quiesce ();
+	std::mutex mutex;
+	std::mt19937_64 random;
+	std::chrono::steady_clock::time_point const epoch;
+	uint64_t sequence;
+	std::priority_queue<event, std::vector<event>, std::greater<event>> events;
+	std::unordered_map<nano::endpoint, nano::node *> nodes;
+	std::unordered_map<nano::node *, nano::endpoint> endpoints;
+};
 class landing_store
 {
 public:
@@ -0,0 +1,292 @@
+#include <nano/node/unchecked.hpp>
+
+#include <nano/node/stats.hpp>
+#include <nano/secure/blockstore.hpp>
+
+nano::unchecked_map::unchecked_map (nano::block_store & store_a, nano::stat & stats_a, size_t memory_limit_a) :
+store (store_a),
+stats (stats_a),
+memory_used (0),
+memory_limit (memory_limit_a)
+{
+}
+
+size_t nano::unchecked_map::entry_size (nano::unchecked_info const & info_a)
+{
+	// Ordered and sequenced index nodes add five pointers per entry
+	return sizeof (entry) + 5 * sizeof (void *) + nano::block::size (info_a.block->type ());
+}
+
+template <typename T>
+void nano::unchecked_map::touch (T const & iterator_a)
+{
+	auto & sequence (entries.get<1> ());
+	sequence.relocate (sequence.end (), entries.project<1> (iterator_a));
+}
+
+void nano::unchecked_map::put (nano::transaction const & transaction_a, nano::unchecked_key const & key_a, nano::unchecked_info const & info_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	auto existing (entries.find (key_a));
+	if (existing == entries.end ())
+	{
+		entries.get<1> ().push_back (entry{ key_a, info_a });
+		memory_used += entry_size (info_a);
+		stats.inc (nano::stat::type::unchecked, nano::stat::detail::put);
+		spill (transaction_a);
+	}
+	else
+	{
+		entries.modify (existing, [&info_a](entry & entry_a) {
+			entry_a.info = info_a;
+		});
+		touch (existing);
+	}
+}
+
+void nano::unchecked_map::spill (nano::transaction const & transaction_a)
+{
+	auto & sequence (entries.get<1> ());
+	while (memory_used > memory_limit && !sequence.empty ())
+	{
+		auto & oldest (sequence.front ());
+		store.unchecked_put (transaction_a, oldest.key, oldest.info);
+		memory_used -= entry_size (oldest.info);
+		sequence.pop_front ();
+		stats.inc (nano::stat::type::unchecked, nano::stat::detail::spill);
+	}
+}
+
+std::vector<nano::unchecked_info> nano::unchecked_map::get (nano::transaction const & transaction_a, nano::block_hash const & hash_a)
+{
+	std::vector<nano::unchecked_info> result;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		for (auto i (entries.lower_bound (nano::unchecked_key (hash_a, 0))), n (entries.end ()); i != n && i->key.account == hash_a; ++i)
+		{
+			result.push_back (i->info);
+			touch (i);
+		}
+	}
+	if (store.unchecked_count (transaction_a) > 0)
+	{
+		auto stored (store.unchecked_get (transaction_a, hash_a));
+		result.insert (result.end (), stored.begin (), stored.end ());
+	}
+	return result;
+}
+
+std::vector<nano::unchecked_info> nano::unchecked_map::take (nano::transaction const & transaction_a, nano::block_hash const & hash_a, bool del_a)
+{
+	std::vector<nano::unchecked_info> result;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		auto i (entries.lower_bound (nano::unchecked_key (hash_a, 0)));
+		while (i != entries.end () && i->key.account == hash_a)
+		{
+			result.push_back (i->info);
+			if (del_a)
+			{
+				memory_used -= entry_size (i->info);
+				i = entries.erase (i);
+			}
+			else
+			{
+				touch (i);
+				++i;
+			}
+		}
+	}
+	auto memory_hits (result.size ());
+	// The table is usually empty outside of large bootstraps, checking its size is cheaper than a cursor seek
+	if (store.unchecked_count (transaction_a) > 0)
+	{
+		auto stored (store.unchecked_get (transaction_a, hash_a));
+		for (auto & info : stored)
+		{
+			if (del_a)
+			{
+				store.unchecked_del (transaction_a, nano::unchecked_key (hash_a, info.block->hash ()));
+			}
+			result.push_back (info);
+		}
+	}
+	if (memory_hits > 0)
+	{
+		stats.add (nano::stat::type::unchecked, nano::stat::detail::memory_hit, nano::stat::dir::in, memory_hits);
+	}
+	if (result.size () > memory_hits)
+	{
+		stats.add (nano::stat::type::unchecked, nano::stat::detail::table_hit, nano::stat::dir::in, result.size () - memory_hits);
+	}
+	return result;
+}
+
+void nano::unchecked_map::del (nano::transaction const & transaction_a, nano::unchecked_key const & key_a)
+{
+	auto erased (false);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		auto existing (entries.find (key_a));
+		if (existing != entries.end ())
+		{
+			memory_used -= entry_size (existing->info);
+			entries.erase (existing);
+			erased = true;
+		}
+	}
+	if (!erased)
+	{
+		store.unchecked_del (transaction_a, key_a);
+	}
+}
+
+bool nano::unchecked_map::exists (nano::transaction const & transaction_a, nano::unchecked_key const & key_a)
+{
+	auto result (false);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		auto existing (entries.find (key_a));
+		if (existing != entries.end ())
+		{
+			touch (existing);
+			result = true;
+		}
+	}
+	return result || store.unchecked_exists (transaction_a, key_a);
+}
+
+bool nano::unchecked_map::find (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::unchecked_info & info_a)
+{
+	auto error (true);
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		for (auto i (entries.begin ()), n (entries.end ()); error && i != n; ++i)
+		{
+			if (i->key.hash == hash_a)
+			{
+				info_a = i->info;
+				touch (i);
+				error = false;
+			}
+		}
+	}
+	for (auto i (store.unchecked_begin (transaction_a)), n (store.unchecked_end ()); error && i != n; ++i)
+	{
+		nano::unchecked_key key (i->first);
+		if (key.hash == hash_a)
+		{
+			info_a = nano::unchecked_info (i->second);
+			error = false;
+		}
+	}
+	return error;
+}
+
+std::vector<std::pair<nano::unchecked_key, nano::unchecked_info>> nano::unchecked_map::list (nano::transaction const & transaction_a, nano::unchecked_key const & start_a, size_t count_a)
+{
+	std::vector<std::pair<nano::unchecked_key, nano::unchecked_info>> memory;
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		for (auto i (entries.lower_bound (start_a)), n (entries.end ()); i != n && memory.size () < count_a; ++i)
+		{
+			memory.emplace_back (i->key, i->info);
+		}
+	}
+	std::vector<std::pair<nano::unchecked_key, nano::unchecked_info>> stored;
+	for (auto i (store.unchecked_begin (transaction_a, start_a)), n (store.unchecked_end ()); i != n && stored.size () < count_a; ++i)
+	{
+		stored.emplace_back (nano::unchecked_key (i->first), nano::unchecked_info (i->second));
+	}
+	// Both sources are in key order, merge them keeping the first count entries
+	std::vector<std::pair<nano::unchecked_key, nano::unchecked_info>> result;
+	nano::unchecked_key_less less;
+	auto i (memory.begin ());
+	auto j (stored.begin ());
+	while (result.size () < count_a && (i != memory.end () || j != stored.end ()))
+	{
+		if (j == stored.end () || (i != memory.end () && less (i->first, j->first)))
+		{
+			result.push_back (*i++);
+		}
+		else
+		{
+			if (i != memory.end () && i->first == j->first)
+			{
+				++i;
+			}
+			result.push_back (*j++);
+		}
+	}
+	return result;
+}
+
+size_t nano::unchecked_map::count (nano::transaction const & transaction_a)
+{
+	return memory_count () + store.unchecked_count (transaction_a);
+}
+
+void nano::unchecked_map::clear (nano::transaction const & transaction_a)
+{
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		entries.clear ();
+		memory_used = 0;
+	}
+	store.unchecked_clear (transaction_a);
+}
+
+size_t nano::unchecked_map::cleanup (uint64_t cutoff_a)
+{
+	size_t result (0);
+	std::lock_guard<std::mutex> lock (mutex);
+	for (auto i (entries.begin ()); i != entries.end ();)
+	{
+		if (i->info.modified < cutoff_a)
+		{
+			memory_used -= entry_size (i->info);
+			i = entries.erase (i);
+			++result;
+		}
+		else
+		{
+			++i;
+		}
+	}
+	return result;
+}
+
+void nano::unchecked_map::flush (nano::transaction const & transaction_a)
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	for (auto & item : entries)
+	{
+		store.unchecked_put (transaction_a, item.key, item.info);
+	}
+	entries.clear ();
+	memory_used = 0;
+}
+
+size_t nano::unchecked_map::memory_count ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return entries.size ();
+}
+
+size_t nano::unchecked_map::memory_size ()
+{
+	std::lock_guard<std::mutex> lock (mutex);
+	return memory_used;
+}
+
+namespace nano
+{
+std::unique_ptr<seq_con_info_component> collect_seq_con_info (unchecked_map & unchecked_map, const std::string & name)
+{
+	auto count (unchecked_map.memory_count ());
+	auto size (unchecked_map.memory_size ());
+	auto composite = std::make_unique<seq_con_info_composite> (name);
+	composite->add_component (std::make_unique<seq_con_info_leaf> (seq_con_info{ "entries", count, count > 0 ? size / count : 0 }));
+	return composite;
+}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <nano/lib/utility.hpp>
+#include <nano/secure/common.hpp>
+
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+
+#include <mutex>
+#include <vector>
+
+namespace nano
+{
+class block_store;
+class stat;
+class transaction;
+/** Orders keys like the unchecked table, by dependency then by block hash */
+class unchecked_key_less
+{
+public:
+	bool operator() (nano::unchecked_key const & first_a, nano::unchecked_key const & second_a) const
+	{
+		return first_a.account < second_a.account || (first_a.account == second_a.account && first_a.hash < second_a.hash);
+	}
+};
+
+/**
+ * Blocks waiting on a missing previous or source block, keyed by the missing dependency like the unchecked table.
+ * New entries are held in memory so a gap closed soon after it was found never touches the table, once the memory budget
+ * is exceeded the least recently used entries are moved to the table. Lookups check both. Thread-safe.
+ */
+class unchecked_map
+{
+public:
+	unchecked_map (nano::block_store &, nano::stat &, size_t);
+	// Requires a write transaction, entries over the memory budget are written to the table
+	void put (nano::transaction const &, nano::unchecked_key const &, nano::unchecked_info const &);
+	std::vector<nano::unchecked_info> get (nano::transaction const &, nano::block_hash const &);
+	// Returns the entries depending on the hash, removing them from memory and the table only if the flag is set
+	std::vector<nano::unchecked_info> take (nano::transaction const &, nano::block_hash const &, bool = true);
+	void del (nano::transaction const &, nano::unchecked_key const &);
+	bool exists (nano::transaction const &, nano::unchecked_key const &);
+	// Returns true if no entry holds the block
+	bool find (nano::transaction const &, nano::block_hash const &, nano::unchecked_info &);
+	// Up to count entries starting at the key, in table order
+	std::vector<std::pair<nano::unchecked_key, nano::unchecked_info>> list (nano::transaction const &, nano::unchecked_key const &, size_t);
+	size_t count (nano::transaction const &);
+	void clear (nano::transaction const &);
+	// Removes in-memory entries modified before the cutoff in seconds since epoch, returns how many were removed
+	size_t cleanup (uint64_t);
+	// Moves every in-memory entry to the table
+	void flush (nano::transaction const &);
+	size_t memory_count ();
+	size_t memory_size ();
+
+private:
+	class entry
+	{
+	public:
+		nano::unchecked_key key;
+		nano::unchecked_info info;
+	};
+	// Approximate bytes held by an entry including its block and container nodes
+	static size_t entry_size (nano::unchecked_info const &);
+	// Requires mutex to be held
+	void spill (nano::transaction const &);
+	// Marks the entry as most recently used so it's spilled last. Requires mutex to be held
+	template <typename T>
+	void touch (T const &);
+	nano::block_store & store;
+	nano::stat & stats;
+	size_t memory_used;
+	size_t memory_limit;
+	boost::multi_index_container<
+	entry,
+	boost::multi_index::indexed_by<
+	boost::multi_index::ordered_unique<boost::multi_index::member<entry, nano::unchecked_key, &entry::key>, nano::unchecked_key_less>,
+	boost::multi_index::sequenced<>>>
+	entries;
+	std::mutex mutex;
+};
+
+std::unique_ptr<seq_con_info_component> collect_seq_con_info (unchecked_map & unchecked_map, const std::string & name);
+}
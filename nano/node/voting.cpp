@@ -72,7 +72,7 @@ void nano::vote_generator::run ()
 	auto cutoff (min);
 	while (!stopped)
 	{
-		auto now (std::chrono::steady_clock::now ());
+		auto now (node.alarm.now ());
 		if (hashes.size () >= 12)
 		{
 			send (lock);
@@ -80,11 +80,11 @@ void nano::vote_generator::run ()
 		else if (cutoff == min) // && hashes.size () < 12
 		{
 			cutoff = now + wait;
-			condition.wait_until (lock, cutoff);
+			node.alarm.clock->wait_until (lock, condition, cutoff);
 		}
 		else if (now < cutoff) // && hashes.size () < 12
 		{
-			condition.wait_until (lock, cutoff);
+			node.alarm.clock->wait_until (lock, condition, cutoff);
 		}
 		else // now >= cutoff && hashes.size () < 12
 		{
@@ -95,7 +95,7 @@ void nano::vote_generator::run ()
 			}
 			else
 			{
-				condition.wait (lock);
+				node.alarm.clock->wait (lock, condition);
 			}
 		}
 	}
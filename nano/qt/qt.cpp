@@ -897,7 +897,7 @@ std::string nano_qt::status::text ()
 	{
 		auto transaction (wallet.wallet_m->wallets.node.store.tx_begin_read ());
 		auto size (wallet.wallet_m->wallets.node.store.block_count (transaction));
-		unchecked = wallet.wallet_m->wallets.node.store.unchecked_count (transaction);
+		unchecked = wallet.wallet_m->wallets.node.unchecked.count (transaction);
 		count_string = std::to_string (size.sum ());
 	}
 
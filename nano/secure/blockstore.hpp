@@ -230,6 +230,10 @@ public:
 	virtual void account_del (nano::transaction const &, nano::account const &) = 0;
 	virtual bool account_exists (nano::transaction const &, nano::account const &) = 0;
 	virtual size_t account_count (nano::transaction const &) = 0;
+	// Hash of the block at a height of an account chain, maintained by ledger::change_latest. Returns zero if it isn't indexed
+	virtual nano::block_hash account_height_get (nano::transaction const &, nano::account const &, uint64_t) = 0;
+	virtual void account_height_put (nano::transaction const &, nano::account const &, uint64_t, nano::block_hash const &) = 0;
+	virtual void account_height_del (nano::transaction const &, nano::account const &, uint64_t) = 0;
 	virtual nano::store_iterator<nano::account, nano::account_info> latest_v0_begin (nano::transaction const &, nano::account const &) = 0;
 	virtual nano::store_iterator<nano::account, nano::account_info> latest_v0_begin (nano::transaction const &) = 0;
 	virtual nano::store_iterator<nano::account, nano::account_info> latest_v0_end () = 0;
@@ -253,6 +257,11 @@ public:
 	virtual nano::store_iterator<nano::pending_key, nano::pending_info> pending_begin (nano::transaction const &, nano::pending_key const &) = 0;
 	virtual nano::store_iterator<nano::pending_key, nano::pending_info> pending_begin (nano::transaction const &) = 0;
 	virtual nano::store_iterator<nano::pending_key, nano::pending_info> pending_end () = 0;
+	// Count and total of the account's pending entries, maintained by pending_put and pending_del
+	virtual nano::pending_summary pending_summary_get (nano::transaction const &, nano::account const &) = 0;
+	// Pending entries ordered by destination account then descending amount, mapped to the source account
+	virtual nano::store_iterator<nano::pending_amount_key, nano::account> pending_amount_begin (nano::transaction const &, nano::pending_amount_key const &) = 0;
+	virtual nano::store_iterator<nano::pending_amount_key, nano::account> pending_amount_end () = 0;
 
 	virtual bool block_info_get (nano::transaction const &, nano::block_hash const &, nano::block_info &) = 0;
 	virtual nano::uint128_t block_balance (nano::transaction const &, nano::block_hash const &) = 0;
@@ -263,6 +272,15 @@ public:
 	virtual void representation_add (nano::transaction const &, nano::account const &, nano::uint128_t const &) = 0;
 	virtual nano::store_iterator<nano::account, nano::uint128_union> representation_begin (nano::transaction const &) = 0;
 	virtual nano::store_iterator<nano::account, nano::uint128_union> representation_end () = 0;
+	// Representatives ordered by descending weight, maintained by representation_put
+	virtual nano::store_iterator<nano::representative_weight_key, nano::no_value> representative_weights_begin (nano::transaction const &) = 0;
+	virtual nano::store_iterator<nano::representative_weight_key, nano::no_value> representative_weights_end () = 0;
+
+	// Accounts grouped by representative, maintained by ledger::change_latest
+	virtual void delegator_put (nano::transaction const &, nano::delegator_key const &) = 0;
+	virtual void delegator_del (nano::transaction const &, nano::delegator_key const &) = 0;
+	virtual nano::store_iterator<nano::delegator_key, nano::no_value> delegators_begin (nano::transaction const &, nano::account const &) = 0;
+	virtual nano::store_iterator<nano::delegator_key, nano::no_value> delegators_end () = 0;
 
 	virtual void unchecked_clear (nano::transaction const &) = 0;
 	virtual void unchecked_put (nano::transaction const &, nano::unchecked_key const &, nano::unchecked_info const &) = 0;
@@ -274,6 +292,8 @@ public:
 	virtual nano::store_iterator<nano::unchecked_key, nano::unchecked_info> unchecked_begin (nano::transaction const &, nano::unchecked_key const &) = 0;
 	virtual nano::store_iterator<nano::unchecked_key, nano::unchecked_info> unchecked_end () = 0;
 	virtual size_t unchecked_count (nano::transaction const &) = 0;
+	// Deletes up to count entries modified before the cutoff, oldest first, and returns how many were deleted
+	virtual size_t unchecked_cleanup (nano::transaction const &, uint64_t, size_t) = 0;
 
 	// Return latest vote for an account from store
 	virtual std::shared_ptr<nano::vote> vote_get (nano::transaction const &, nano::account const &) = 0;
@@ -323,6 +323,86 @@ nano::block_hash nano::pending_key::key () const
 	return account;
 }
 
+nano::pending_summary::pending_summary () :
+count (0),
+total (0)
+{
+}
+
+nano::pending_summary::pending_summary (uint64_t count_a, nano::amount const & total_a) :
+count (count_a),
+total (total_a)
+{
+}
+
+bool nano::pending_summary::operator== (nano::pending_summary const & other_a) const
+{
+	return count == other_a.count && total == other_a.total;
+}
+
+nano::pending_amount_key::pending_amount_key () :
+account (0),
+inverted_amount (0),
+hash (0)
+{
+}
+
+nano::pending_amount_key::pending_amount_key (nano::account const & account_a, nano::amount const & amount_a, nano::block_hash const & hash_a) :
+account (account_a),
+inverted_amount (std::numeric_limits<nano::uint128_t>::max () - amount_a.number ()),
+hash (hash_a)
+{
+}
+
+bool nano::pending_amount_key::operator== (nano::pending_amount_key const & other_a) const
+{
+	return account == other_a.account && inverted_amount == other_a.inverted_amount && hash == other_a.hash;
+}
+
+nano::amount nano::pending_amount_key::amount () const
+{
+	return std::numeric_limits<nano::uint128_t>::max () - inverted_amount.number ();
+}
+
+nano::delegator_key::delegator_key () :
+representative (0),
+account (0)
+{
+}
+
+nano::delegator_key::delegator_key (nano::account const & representative_a, nano::account const & account_a) :
+representative (representative_a),
+account (account_a)
+{
+}
+
+bool nano::delegator_key::operator== (nano::delegator_key const & other_a) const
+{
+	return representative == other_a.representative && account == other_a.account;
+}
+
+nano::representative_weight_key::representative_weight_key () :
+inverted_weight (0),
+representative (0)
+{
+}
+
+nano::representative_weight_key::representative_weight_key (nano::amount const & weight_a, nano::account const & representative_a) :
+inverted_weight (std::numeric_limits<nano::uint128_t>::max () - weight_a.number ()),
+representative (representative_a)
+{
+}
+
+bool nano::representative_weight_key::operator== (nano::representative_weight_key const & other_a) const
+{
+	return inverted_weight == other_a.inverted_weight && representative == other_a.representative;
+}
+
+nano::amount nano::representative_weight_key::weight () const
+{
+	return std::numeric_limits<nano::uint128_t>::max () - inverted_weight.number ();
+}
+
 nano::unchecked_info::unchecked_info () :
 block (nullptr),
 account (0),
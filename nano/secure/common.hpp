@@ -36,9 +36,13 @@ struct hash<::nano::uint512_union>
 }
 namespace nano
 {
-const uint8_t protocol_version = 0x10;
+const uint8_t protocol_version = 0x11;
 const uint8_t protocol_version_min = 0x0d;
 const uint8_t node_id_version = 0x0c;
+/** Peers from this version frame realtime messages by header and accept them over TCP */
+const uint8_t tcp_realtime_version = 0x11;
+/** Peers from this version end frontier replies at the end of the requested range */
+const uint8_t frontier_req_end_version = 0x11;
 
 /*
  * Do not bootstrap from nodes older than this version.
@@ -123,6 +127,58 @@ public:
 	nano::block_hash hash;
 	nano::block_hash key () const;
 };
+/**
+ * Number and sum of the pending entries destined to an account
+ */
+class pending_summary
+{
+public:
+	pending_summary ();
+	pending_summary (uint64_t, nano::amount const &);
+	bool operator== (nano::pending_summary const &) const;
+	uint64_t count;
+	nano::amount total;
+};
+/**
+ * Key ordering an account's pending entries from the largest amount to the smallest
+ * The amount is stored subtracted from the maximum so byte order is descending amount order.
+ */
+class pending_amount_key
+{
+public:
+	pending_amount_key ();
+	pending_amount_key (nano::account const &, nano::amount const &, nano::block_hash const &);
+	bool operator== (nano::pending_amount_key const &) const;
+	nano::amount amount () const;
+	nano::account account;
+	nano::amount inverted_amount;
+	nano::block_hash hash;
+};
+/**
+ * Key grouping accounts by the representative they delegate to
+ */
+class delegator_key
+{
+public:
+	delegator_key ();
+	delegator_key (nano::account const &, nano::account const &);
+	bool operator== (nano::delegator_key const &) const;
+	nano::account representative;
+	nano::account account;
+};
+/**
+ * Key ordering representatives from the highest weight to the lowest, the weight is inverted like in pending_amount_key
+ */
+class representative_weight_key
+{
+public:
+	representative_weight_key ();
+	representative_weight_key (nano::amount const &, nano::account const &);
+	bool operator== (nano::representative_weight_key const &) const;
+	nano::amount weight () const;
+	nano::amount inverted_weight;
+	nano::account representative;
+};
 
 class endpoint_key
 {
@@ -247,6 +303,9 @@ public:
 	nano::account account;
 	// Signature of sequence + block hashes
 	nano::signature signature;
+	// Serialized confirm_ack message set by the node the first time the vote is sent, not copied with the vote.
+	// Accessed with std::atomic_load/std::atomic_store.
+	mutable std::shared_ptr<std::vector<uint8_t>> confirm_ack_bytes;
 	static const std::string hash_prefix;
 };
 /**
@@ -82,8 +82,9 @@ public:
 		auto balance (ledger.balance (transaction, block_a.hashables.previous));
 		ledger.store.representation_add (transaction, representative, balance);
 		ledger.store.representation_add (transaction, hash, 0 - balance);
-		ledger.store.block_del (transaction, hash);
+		// change_latest reads the representative of the rolled back block to update the delegator index
 		ledger.change_latest (transaction, account, block_a.hashables.previous, representative, info.balance, info.block_count - 1);
+		ledger.store.block_del (transaction, hash);
 		ledger.store.frontier_del (transaction, hash);
 		ledger.store.frontier_put (transaction, block_a.hashables.previous, account);
 		ledger.store.block_successor_clear (transaction, block_a.hashables.previous);
@@ -687,16 +688,24 @@ nano::uint128_t nano::ledger::account_balance (nano::transaction const & transac
 nano::uint128_t nano::ledger::account_pending (nano::transaction const & transaction_a, nano::account const & account_a)
 {
 	nano::uint128_t result (0);
-	nano::account end (account_a.number () + 1);
-	for (auto i (store.pending_v0_begin (transaction_a, nano::pending_key (account_a, 0))), n (store.pending_v0_begin (transaction_a, nano::pending_key (end, 0))); i != n; ++i)
+	// Pending summaries are built by the version 15 upgrade, which waits for the background sideband upgrade on older ledgers
+	if (store.version_get (transaction_a) >= 15)
 	{
-		nano::pending_info info (i->second);
-		result += info.amount.number ();
+		result = store.pending_summary_get (transaction_a, account_a).total.number ();
 	}
-	for (auto i (store.pending_v1_begin (transaction_a, nano::pending_key (account_a, 0))), n (store.pending_v1_begin (transaction_a, nano::pending_key (end, 0))); i != n; ++i)
+	else
 	{
-		nano::pending_info info (i->second);
-		result += info.amount.number ();
+		nano::account end (account_a.number () + 1);
+		for (auto i (store.pending_v0_begin (transaction_a, nano::pending_key (account_a, 0))), n (store.pending_v0_begin (transaction_a, nano::pending_key (end, 0))); i != n; ++i)
+		{
+			nano::pending_info info (i->second);
+			result += info.amount.number ();
+		}
+		for (auto i (store.pending_v1_begin (transaction_a, nano::pending_key (account_a, 0))), n (store.pending_v1_begin (transaction_a, nano::pending_key (end, 0))); i != n; ++i)
+		{
+			nano::pending_info info (i->second);
+			result += info.amount.number ();
+		}
 	}
 	return result;
 }
@@ -970,6 +979,39 @@ void nano::ledger::change_latest (nano::transaction const & transaction_a, nano:
 		assert (store.block_get (transaction_a, hash_a)->previous ().is_zero ());
 		info.open_block = hash_a;
 	}
+	if (!exists || hash_a.is_zero () || info.rep_block != rep_block_a)
+	{
+		nano::account old_representative (0);
+		if (exists)
+		{
+			old_representative = store.block_get (transaction_a, info.rep_block)->representative ();
+		}
+		nano::account new_representative (0);
+		if (!hash_a.is_zero ())
+		{
+			new_representative = store.block_get (transaction_a, rep_block_a)->representative ();
+		}
+		if (old_representative != new_representative)
+		{
+			if (exists)
+			{
+				store.delegator_del (transaction_a, nano::delegator_key (old_representative, account_a));
+			}
+			if (!hash_a.is_zero ())
+			{
+				store.delegator_put (transaction_a, nano::delegator_key (new_representative, account_a));
+			}
+		}
+	}
+	// Rollbacks remove the head one block at a time
+	if (exists && (hash_a.is_zero () || block_count_a < info.block_count))
+	{
+		store.account_height_del (transaction_a, account_a, info.block_count);
+	}
+	else if (!hash_a.is_zero ())
+	{
+		store.account_height_put (transaction_a, account_a, block_count_a, hash_a);
+	}
 	if (!hash_a.is_zero ())
 	{
 		info.head = hash_a;
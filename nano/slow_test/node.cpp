@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <nano/node/ipc.hpp>
+#include <nano/node/rpc.hpp>
 #include <nano/node/testing.hpp>
 
 #include <thread>
@@ -392,6 +394,32 @@ TEST (store, unchecked_load)
 	(void)count;
 }
 
+TEST (store, unchecked_cleanup_timing)
+{
+	nano::system system (24000, 1);
+	auto & node (*system.nodes[0]);
+	auto block (std::make_shared<nano::send_block> (0, 0, 0, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	auto now (nano::seconds_since_epoch ());
+	auto expired (now - node.config.unchecked_cutoff_time.count () - 1);
+	size_t const count (1000000);
+	for (size_t i (0); i < count; i += 10000)
+	{
+		auto transaction (node.store.tx_begin_write ());
+		for (auto j (i); j < i + 10000; ++j)
+		{
+			// Every other entry is past the cutoff, interleaved in key order so a table scan would visit all of them
+			nano::unchecked_info info (block, 0, j % 2 == 0 ? expired : now);
+			node.store.unchecked_put (transaction, nano::unchecked_key (j + 1, block->hash ()), info);
+		}
+	}
+	auto begin (std::chrono::steady_clock::now ());
+	node.unchecked_cleanup ();
+	auto seconds (std::chrono::duration<double> (std::chrono::steady_clock::now () - begin).count ());
+	auto transaction (node.store.tx_begin_read ());
+	ASSERT_EQ (count / 2, node.store.unchecked_count (transaction));
+	std::cerr << boost::str (boost::format ("Cleaned up %1% of %2% unchecked entries in %3$.2fs") % (count / 2) % count % seconds) << std::endl;
+}
+
 TEST (store, vote_load)
 {
 	nano::system system (24000, 1);
@@ -442,3 +470,398 @@ TEST (node, mass_vote_by_hash)
 		system.nodes[0]->block_processor.add (*i, nano::seconds_since_epoch ());
 	}
 }
+
+namespace
+{
+/** Publishes a chain of blocks from the first node and sets \p time_a to the time until every node has the last one */
+void propagation_time (bool tcp_realtime_a, size_t node_count_a, size_t block_count_a, std::chrono::milliseconds & time_a)
+{
+	nano::system system (24000, 1);
+	for (size_t i (0); i < node_count_a; ++i)
+	{
+		nano::node_init init;
+		nano::node_config config (24001 + i, system.logging);
+		config.tcp_realtime = tcp_realtime_a;
+		auto node (std::make_shared<nano::node> (init, system.io_ctx, nano::unique_path (), system.alarm, config, system.work));
+		node->start ();
+		if (!system.nodes.empty ())
+		{
+			node->network.send_keepalive (system.nodes.back ()->network.endpoint ());
+		}
+		system.nodes.push_back (node);
+	}
+	system.deadline_set (std::chrono::seconds (30));
+	while (std::any_of (system.nodes.begin () + 1, system.nodes.end (), [node_count_a](std::shared_ptr<nano::node> const & node_a) { return node_a->peers.size () < node_count_a - 1; }))
+	{
+		ASSERT_FALSE (system.poll ());
+	}
+	if (tcp_realtime_a)
+	{
+		while (std::any_of (system.nodes.begin () + 1, system.nodes.end (), [node_count_a](std::shared_ptr<nano::node> const & node_a) { return node_a->stats.count (nano::stat::type::tcp, nano::stat::detail::handshake, nano::stat::dir::out) < node_count_a - 1; }))
+		{
+			ASSERT_FALSE (system.poll ());
+		}
+	}
+	nano::genesis genesis;
+	nano::block_hash previous (genesis.hash ());
+	std::vector<std::shared_ptr<nano::block>> blocks;
+	for (size_t i (0); i < block_count_a; ++i)
+	{
+		auto block (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, previous, nano::test_genesis_key.pub, nano::genesis_amount - (i + 1), nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (previous)));
+		previous = block->hash ();
+		blocks.push_back (block);
+	}
+	auto begin (std::chrono::steady_clock::now ());
+	for (auto & block : blocks)
+	{
+		system.nodes[1]->process_active (block);
+	}
+	system.deadline_set (std::chrono::seconds (60));
+	while (std::any_of (system.nodes.begin () + 1, system.nodes.end (), [&previous](std::shared_ptr<nano::node> const & node_a) { return node_a->block (previous) == nullptr; }))
+	{
+		ASSERT_FALSE (system.poll (std::chrono::milliseconds (1)));
+	}
+	time_a = std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - begin);
+	uint64_t tcp_messages (0);
+	for (auto & node : system.nodes)
+	{
+		auto transaction (node->store.tx_begin_read ());
+		ASSERT_EQ (block_count_a + 1, node->store.block_count (transaction).sum ());
+		tcp_messages += node->stats.count (nano::stat::type::tcp, nano::stat::dir::in);
+	}
+	// Realtime messages only go over TCP when it's enabled
+	ASSERT_EQ (tcp_realtime_a, tcp_messages > 0);
+}
+}
+
+TEST (network, tcp_realtime_propagation)
+{
+	std::chrono::milliseconds udp (0);
+	std::chrono::milliseconds tcp (0);
+	propagation_time (false, 8, 1000, udp);
+	ASSERT_FALSE (HasFatalFailure ());
+	propagation_time (true, 8, 1000, tcp);
+	ASSERT_FALSE (HasFatalFailure ());
+	std::cerr << "Propagation UDP: " << udp.count () << "ms TCP: " << tcp.count () << "ms" << std::endl;
+	ASSERT_GT (udp.count (), 0);
+	ASSERT_GT (tcp.count (), 0);
+}
+
+namespace
+{
+/**
+ * Publishes blocks from the first node in bursts over a simulated network and returns the virtual time from each burst
+ * until every node confirmed each of its blocks, sorted ascending.
+ * Fanout follows the square root of the peer count, so it's varied through the node count.
+ */
+std::vector<std::chrono::microseconds> simulated_confirmation_latency (size_t node_count_a, size_t burst_size_a, size_t burst_count_a, double loss_a)
+{
+	auto simulator (std::make_shared<nano::network_simulator> (node_count_a));
+	simulator->loss = loss_a;
+	nano::system system (24000, node_count_a, simulator);
+	system.wallet (0)->insert_adhoc (nano::test_genesis_key.prv);
+	std::mutex mutex;
+	std::unordered_map<nano::block_hash, std::chrono::microseconds> published;
+	std::vector<std::chrono::microseconds> latencies;
+	for (auto & node : system.nodes)
+	{
+		node->observers.blocks.add ([&](std::shared_ptr<nano::block> block_a, nano::account const &, nano::uint128_t const &, bool) {
+			auto now (simulator->now ());
+			std::lock_guard<std::mutex> lock (mutex);
+			auto existing (published.find (block_a->hash ()));
+			if (existing != published.end ())
+			{
+				latencies.push_back (now - existing->second);
+			}
+		});
+	}
+	nano::genesis genesis;
+	nano::block_hash previous (genesis.hash ());
+	auto balance (nano::genesis_amount);
+	for (size_t i (0); i < burst_count_a; ++i)
+	{
+		std::vector<std::shared_ptr<nano::block>> blocks;
+		for (size_t j (0); j < burst_size_a; ++j)
+		{
+			balance -= 1;
+			auto block (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, previous, nano::test_genesis_key.pub, balance, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (previous)));
+			previous = block->hash ();
+			blocks.push_back (block);
+		}
+		{
+			std::lock_guard<std::mutex> lock (mutex);
+			for (auto & block : blocks)
+			{
+				published[block->hash ()] = simulator->now ();
+			}
+		}
+		for (auto & block : blocks)
+		{
+			system.nodes[0]->process_active (block);
+		}
+		auto expected ((i + 1) * burst_size_a * node_count_a);
+		simulator->run_until ([&]() {
+			std::lock_guard<std::mutex> lock (mutex);
+			return latencies.size () >= expected;
+		},
+		simulator->now () + std::chrono::seconds (60));
+	}
+	// Stop observers from firing into locals that are about to go out of scope
+	system.stop ();
+	std::sort (latencies.begin (), latencies.end ());
+	return latencies;
+}
+
+std::chrono::microseconds percentile (std::vector<std::chrono::microseconds> const & sorted_a, double fraction_a)
+{
+	return sorted_a.empty () ? std::chrono::microseconds (0) : sorted_a[std::min (sorted_a.size () - 1, static_cast<size_t> (sorted_a.size () * fraction_a))];
+}
+}
+
+TEST (network_simulator, confirmation_latency)
+{
+	// Every node has its own ledger and threads, a few hundred is what fits on one machine
+	for (auto node_count : { 64, 256 })
+	{
+		for (auto burst_size : { 1, 16 })
+		{
+			for (auto loss : { 0.0, 0.05 })
+			{
+				size_t burst_count (4);
+				auto latencies (simulated_confirmation_latency (node_count, burst_size, burst_count, loss));
+				std::cerr << boost::str (boost::format ("nodes %1% burst %2% loss %3$.2f: confirmed %4%/%5% p50 %6%ms p90 %7%ms p99 %8%ms") % node_count % burst_size % loss % latencies.size () % (node_count * burst_size * burst_count) % (percentile (latencies, 0.5).count () / 1000) % (percentile (latencies, 0.9).count () / 1000) % (percentile (latencies, 0.99).count () / 1000)) << std::endl;
+			}
+		}
+	}
+}
+
+TEST (bootstrap, serve_throughput)
+{
+	nano::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	size_t block_count (20000);
+	nano::genesis genesis;
+	nano::block_hash previous (genesis.hash ());
+	{
+		auto transaction (node1.store.tx_begin_write ());
+		for (size_t i (0); i < block_count; ++i)
+		{
+			nano::state_block block (nano::test_genesis_key.pub, previous, nano::test_genesis_key.pub, nano::genesis_amount - (i + 1), nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (previous));
+			ASSERT_EQ (nano::process_result::progress, node1.ledger.process (transaction, block).code);
+			previous = block.hash ();
+		}
+	}
+	nano::node_init init;
+	auto node2 (std::make_shared<nano::node> (init, system.io_ctx, 24001, nano::unique_path (), system.alarm, system.logging, system.work));
+	ASSERT_FALSE (init.error ());
+	node2->start ();
+	system.nodes.push_back (node2);
+	auto begin (std::chrono::steady_clock::now ());
+	node2->bootstrap_initiator.bootstrap (node1.network.endpoint ());
+	system.deadline_set (std::chrono::seconds (300));
+	while (node2->latest (nano::test_genesis_key.pub) != previous)
+	{
+		ASSERT_FALSE (system.poll ());
+	}
+	auto seconds (std::chrono::duration<double> (std::chrono::steady_clock::now () - begin).count ());
+	std::cerr << boost::str (boost::format ("Served %1% blocks in %2$.2fs, %3$.0f blocks/s") % block_count % seconds % (block_count / seconds)) << std::endl;
+}
+
+TEST (bootstrap, lazy_memory_cap)
+{
+	nano::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	size_t block_count (5000);
+	nano::genesis genesis;
+	nano::block_hash previous (genesis.hash ());
+	{
+		auto transaction (node1.store.tx_begin_write ());
+		for (size_t i (0); i < block_count; ++i)
+		{
+			nano::state_block block (nano::test_genesis_key.pub, previous, nano::test_genesis_key.pub, nano::genesis_amount - (i + 1), nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (previous));
+			ASSERT_EQ (nano::process_result::progress, node1.ledger.process (transaction, block).code);
+			previous = block.hash ();
+		}
+	}
+	// A zero budget keeps all lazy bootstrap state in the temporary LMDB file
+	nano::node_config config (24001, system.logging);
+	config.lazy_bootstrap_memory_mb = 0;
+	nano::node_init init;
+	auto node2 (std::make_shared<nano::node> (init, system.io_ctx, nano::unique_path (), system.alarm, config, system.work));
+	ASSERT_FALSE (init.error ());
+	node2->start ();
+	system.nodes.push_back (node2);
+	node2->peers.insert (node1.network.endpoint (), nano::protocol_version);
+	auto begin (std::chrono::steady_clock::now ());
+	node2->bootstrap_initiator.bootstrap_lazy (previous);
+	size_t spilled (0);
+	system.deadline_set (std::chrono::seconds (600));
+	while (node2->latest (nano::test_genesis_key.pub) != previous)
+	{
+		if (auto attempt = node2->bootstrap_initiator.current_attempt ())
+		{
+			std::lock_guard<std::mutex> lock (attempt->lazy_mutex);
+			ASSERT_EQ (0, attempt->lazy_spill.memory_used);
+			spilled = std::max (spilled, attempt->lazy_blocks.spilled ());
+		}
+		ASSERT_FALSE (system.poll ());
+	}
+	ASSERT_GT (spilled, 0);
+	auto seconds (std::chrono::duration<double> (std::chrono::steady_clock::now () - begin).count ());
+	std::cerr << boost::str (boost::format ("Lazily bootstrapped %1% blocks in %2$.2fs with up to %3% spilled block hashes") % block_count % seconds % spilled) << std::endl;
+}
+
+TEST (rpc, streaming_throughput)
+{
+	nano::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	size_t block_count (10000);
+	nano::genesis genesis;
+	nano::block_hash previous (genesis.hash ());
+	std::vector<std::string> hashes;
+	{
+		auto transaction (node1.store.tx_begin_write ());
+		for (size_t i (0); i < block_count; ++i)
+		{
+			nano::state_block block (nano::test_genesis_key.pub, previous, nano::test_genesis_key.pub, nano::genesis_amount - (i + 1), nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, system.work.generate (previous));
+			ASSERT_EQ (nano::process_result::progress, node1.ledger.process (transaction, block).code);
+			previous = block.hash ();
+			hashes.push_back (previous.to_string ());
+		}
+	}
+	nano::rpc rpc (system.io_ctx, node1, nano::rpc_config (true));
+	auto run = [&](boost::property_tree::ptree const & request_a) {
+		std::string result;
+		auto handler (std::make_shared<nano::rpc_handler> (node1, rpc, nano::json_string (request_a), "0", [&result](std::string const & body_a) {
+			result = body_a;
+		}));
+		auto begin (std::chrono::steady_clock::now ());
+		handler->process_request ();
+		auto handled (std::chrono::steady_clock::now () - begin);
+		// Rebuilding the response as a tree gives the bytes the ptree path produced and the cost it paid to serialize them
+		boost::property_tree::ptree tree;
+		std::stringstream stream (result);
+		boost::property_tree::read_json (stream, tree);
+		begin = std::chrono::steady_clock::now ();
+		auto serialized (nano::json_string (tree));
+		auto written (std::chrono::steady_clock::now () - begin);
+		ASSERT_EQ (serialized, result);
+		std::cerr << boost::str (boost::format ("%1%: %2% bytes, handled in %3%ms, write_json alone %4%ms") % request_a.get<std::string> ("action") % result.size () % std::chrono::duration_cast<std::chrono::milliseconds> (handled).count () % std::chrono::duration_cast<std::chrono::milliseconds> (written).count ()) << std::endl;
+	};
+	boost::property_tree::ptree history;
+	history.put ("action", "account_history");
+	history.put ("account", nano::test_genesis_key.pub.to_account ());
+	history.put ("count", std::to_string (block_count));
+	history.put ("raw", "true");
+	run (history);
+	boost::property_tree::ptree blocks_info;
+	blocks_info.put ("action", "blocks_info");
+	boost::property_tree::ptree hashes_tree;
+	for (auto & hash : hashes)
+	{
+		boost::property_tree::ptree entry;
+		entry.put ("", hash);
+		hashes_tree.push_back (std::make_pair ("", entry));
+	}
+	blocks_info.add_child ("hashes", hashes_tree);
+	blocks_info.put ("pending", "true");
+	blocks_info.put ("source", "true");
+	run (blocks_info);
+	boost::property_tree::ptree ledger;
+	ledger.put ("action", "ledger");
+	ledger.put ("representative", "true");
+	ledger.put ("weight", "true");
+	ledger.put ("pending", "true");
+	run (ledger);
+}
+
+TEST (ipc, binary_throughput)
+{
+	nano::system system (24000, 1);
+	auto & node1 (*system.nodes[0]);
+	nano::rpc rpc (system.io_ctx, node1, nano::rpc_config (true));
+	node1.config.ipc_config.transport_tcp.enabled = true;
+	node1.config.ipc_config.transport_tcp.port = 24077;
+	nano::ipc::ipc_server ipc (node1, rpc);
+	size_t request_count (20000);
+	std::atomic<bool> done{ false };
+	std::thread client_thread ([&node1, &done, request_count]() {
+		nano::ipc::rpc_ipc_client json_client (node1.io_ctx);
+		json_client.connect ("::1", 24077);
+		std::string json_request (boost::str (boost::format (R"({"action": "account_info", "account": "%1%"})") % nano::test_genesis_key.pub.to_account ()));
+		auto begin (std::chrono::steady_clock::now ());
+		for (size_t i (0); i < request_count; ++i)
+		{
+			json_client.request (json_request);
+		}
+		auto json_elapsed (std::chrono::duration<double> (std::chrono::steady_clock::now () - begin).count ());
+		nano::ipc::binary_ipc_client binary_client (node1.io_ctx);
+		binary_client.connect ("::1", 24077);
+		std::vector<uint8_t> binary_request (1, static_cast<uint8_t> (nano::ipc::binary_action::account_info));
+		binary_request.insert (binary_request.end (), nano::test_genesis_key.pub.bytes.begin (), nano::test_genesis_key.pub.bytes.end ());
+		begin = std::chrono::steady_clock::now ();
+		for (size_t i (0); i < request_count; ++i)
+		{
+			binary_client.request (binary_request);
+		}
+		auto binary_elapsed (std::chrono::duration<double> (std::chrono::steady_clock::now () - begin).count ());
+		std::cerr << boost::str (boost::format ("account_info: json_legacy %1$.0f/s, binary %2$.0f/s") % (request_count / json_elapsed) % (request_count / binary_elapsed)) << std::endl;
+		done = true;
+	});
+	client_thread.detach ();
+	while (!done)
+	{
+		system.poll ();
+	}
+}
+
+TEST (rpc, keep_alive_throughput)
+{
+	nano::system system (24000, 1);
+	nano::rpc rpc (system.io_ctx, *system.nodes[0], nano::rpc_config (true));
+	rpc.config.keep_alive_max_requests = std::numeric_limits<uint64_t>::max ();
+	rpc.start ();
+	size_t request_count (5000);
+	std::atomic<bool> done{ false };
+	std::thread client ([&rpc, &done, request_count]() {
+		boost::asio::io_context io_ctx;
+		nano::tcp_endpoint endpoint (boost::asio::ip::address_v6::loopback (), rpc.config.port);
+		boost::beast::http::request<boost::beast::http::string_body> request (boost::beast::http::verb::post, "/", 11);
+		request.body () = R"({"action": "block_count"})";
+		request.prepare_payload ();
+		auto exchange = [&request](boost::asio::ip::tcp::socket & socket_a, boost::beast::flat_buffer & buffer_a) {
+			boost::beast::http::response<boost::beast::http::string_body> response;
+			boost::beast::http::write (socket_a, request);
+			boost::beast::http::read (socket_a, buffer_a, response);
+		};
+		request.keep_alive (false);
+		auto begin (std::chrono::steady_clock::now ());
+		for (size_t i (0); i < request_count; ++i)
+		{
+			boost::asio::ip::tcp::socket socket (io_ctx);
+			socket.connect (endpoint);
+			boost::beast::flat_buffer buffer;
+			exchange (socket, buffer);
+		}
+		auto close_elapsed (std::chrono::duration<double> (std::chrono::steady_clock::now () - begin).count ());
+		request.keep_alive (true);
+		begin = std::chrono::steady_clock::now ();
+		{
+			boost::asio::ip::tcp::socket socket (io_ctx);
+			socket.connect (endpoint);
+			boost::beast::flat_buffer buffer;
+			for (size_t i (0); i < request_count; ++i)
+			{
+				exchange (socket, buffer);
+			}
+		}
+		auto keep_alive_elapsed (std::chrono::duration<double> (std::chrono::steady_clock::now () - begin).count ());
+		std::cerr << boost::str (boost::format ("block_count: connection per request %1$.0f/s, keep-alive %2$.0f/s") % (request_count / close_elapsed) % (request_count / keep_alive_elapsed)) << std::endl;
+		done = true;
+	});
+	client.detach ();
+	while (!done)
+	{
+		system.poll ();
+	}
+}